@@ -1,12 +1,28 @@
 #ifndef AST_H
 #define AST_H
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include "Token.h"
+#include "TipoDeDado.h"
 
 using namespace std;
 
+// Ligação de um nome resolvida pelo Resolver: profundidade do escopo onde
+// o nome foi declarado (0 = global) e slot no quadro da função (ou na tabela
+// de globais, quando depth == 0)
+struct Binding
+{
+  int depth;
+  int slot;
+
+  Binding() : depth(-1), slot(-1) {}
+  Binding(int depth, int slot) : depth(depth), slot(slot) {}
+  bool isResolved() const { return slot >= 0; }
+  bool isGlobal() const { return depth == 0; }
+};
+
 class ASTNode
 {
 public:
@@ -18,6 +34,12 @@ class ExpressionNode : public ASTNode
 {
 public:
   virtual ~ExpressionNode() = default;
+  // Tipo atribuído pelo TypeChecker
+  TipoDeDado getTipo() const { return tipo; }
+  void setTipo(TipoDeDado t) { tipo = t; }
+
+private:
+  TipoDeDado tipo = TipoDeDado::INDEFINIDO;
 };
 
 class StatementNode : public ASTNode
@@ -26,11 +48,42 @@ public:
   virtual ~StatementNode() = default;
 };
 
+// Literais carregam o valor já convertido pelo parser, para que nenhum
+// consumidor precise reinterpretar o lexema
 class LiteralNode : public ExpressionNode
 {
 public:
-  LiteralNode(const string &value) : value(value) {}
+  virtual ~LiteralNode() = default;
+};
+
+class IntLiteralNode : public LiteralNode
+{
+public:
+  IntLiteralNode(int64_t value) : value(value) { setTipo(TipoDeDado::INT); }
   string toString(int indent = 0) const override;
+  int64_t getValue() const { return value; }
+
+private:
+  int64_t value;
+};
+
+class RealLiteralNode : public LiteralNode
+{
+public:
+  RealLiteralNode(double value) : value(value) { setTipo(TipoDeDado::DOUBLE); }
+  string toString(int indent = 0) const override;
+  double getValue() const { return value; }
+
+private:
+  double value;
+};
+
+class StringLiteralNode : public LiteralNode
+{
+public:
+  StringLiteralNode(const string &value) : value(value) { setTipo(TipoDeDado::STRING); }
+  string toString(int indent = 0) const override;
+  const string &getValue() const { return value; }
 
 private:
   string value;
@@ -42,9 +95,12 @@ public:
   IdentifierNode(const string &name) : name(name) {}
   string toString(int indent = 0) const override;
   string getName() const { return name; }
+  Binding getBinding() const { return binding; }
+  void setBinding(Binding b) { binding = b; }
 
 private:
   string name;
+  Binding binding;
 };
 
 class ArrayAccessNode : public ExpressionNode
@@ -54,23 +110,39 @@ public:
       : name(name), index(index) {}
   ~ArrayAccessNode();
   string toString(int indent = 0) const override;
+  string getName() const { return name; }
+  ExpressionNode *getIndex() const { return index; }
+  void setIndex(ExpressionNode *i) { index = i; }
+  Binding getBinding() const { return binding; }
+  void setBinding(Binding b) { binding = b; }
+  // Falso quando o BoundsCheckEliminator provou que o índice está no array
+  bool needsBoundsCheck() const { return boundsCheck; }
+  void setNeedsBoundsCheck(bool check) { boundsCheck = check; }
 
 private:
   string name;
   ExpressionNode *index;
+  Binding binding;
+  bool boundsCheck = true;
 };
 
 class UnaryOpNode : public ExpressionNode
 {
 public:
-  UnaryOpNode(const string &op, ExpressionNode *operand)
-      : op(op), operand(operand) {}
+  UnaryOpNode(const string &op, ExpressionNode *operand, bool postfix = false)
+      : op(op), operand(operand), postfix(postfix) {}
   ~UnaryOpNode();
   string toString(int indent = 0) const override;
+  string getOp() const { return op; }
+  ExpressionNode *getOperand() const { return operand; }
+  void setOperand(ExpressionNode *o) { operand = o; }
+  // "x++"/"x--": o valor da expressão é o anterior ao incremento
+  bool isPostfix() const { return postfix; }
 
 private:
   string op;
   ExpressionNode *operand;
+  bool postfix;
 };
 
 class BinaryOpNode : public ExpressionNode
@@ -80,6 +152,11 @@ public:
       : left(left), op(op), right(right) {}
   ~BinaryOpNode();
   string toString(int indent = 0) const override;
+  ExpressionNode *getLeft() const { return left; }
+  string getOp() const { return op; }
+  ExpressionNode *getRight() const { return right; }
+  void setLeft(ExpressionNode *l) { left = l; }
+  void setRight(ExpressionNode *r) { right = r; }
 
 private:
   ExpressionNode *left;
@@ -87,6 +164,20 @@ private:
   ExpressionNode *right;
 };
 
+// Conversão implícita inserida pelo TypeChecker (atualmente apenas int -> double)
+class ConversionNode : public ExpressionNode
+{
+public:
+  ConversionNode(ExpressionNode *operand, TipoDeDado tipo) : operand(operand) { setTipo(tipo); }
+  ~ConversionNode();
+  string toString(int indent = 0) const override;
+  ExpressionNode *getOperand() const { return operand; }
+  void setOperand(ExpressionNode *o) { operand = o; }
+
+private:
+  ExpressionNode *operand;
+};
+
 class FunctionCallNode : public ExpressionNode
 {
 public:
@@ -94,10 +185,20 @@ public:
       : name(name), args(args) {}
   ~FunctionCallNode();
   string toString(int indent = 0) const override;
+  string getName() const { return name; }
+  const vector<ExpressionNode *> &getArgs() const { return args; }
+  void setArg(size_t i, ExpressionNode *arg) { args[i] = arg; }
+  int getFunctionIndex() const { return functionIndex; }
+  void setFunctionIndex(int index) { functionIndex = index; }
+  bool isBuiltin() const { return builtinIndex >= 0; }
+  int getBuiltinIndex() const { return builtinIndex; }
+  void setBuiltinIndex(int index) { builtinIndex = index; }
 
 private:
   string name;
   vector<ExpressionNode *> args;
+  int functionIndex = -1; // índice em ProgramNode::getFunctions()
+  int builtinIndex = -1;  // índice em BUILTINS (Builtins.h), para funções embutidas
 };
 
 class BlockNode : public StatementNode
@@ -107,6 +208,7 @@ public:
   ~BlockNode();
   string toString(int indent = 0) const override;
   vector<StatementNode *> getStatements() const { return statements; }
+  void setStatements(const vector<StatementNode *> &stmts) { statements = stmts; }
 
 private:
   vector<StatementNode *> statements;
@@ -115,28 +217,53 @@ private:
 class VariableDeclarationNode : public StatementNode
 {
 public:
-  VariableDeclarationNode(const string &type, const string &name, ExpressionNode *initialValue = nullptr)
-      : type(type), name(name), initialValue(initialValue) {}
+  VariableDeclarationNode(const string &type, const string &name, ExpressionNode *initialValue = nullptr,
+                          int64_t arraySize = -1)
+      : type(type), name(name), initialValue(initialValue), arraySize(arraySize) {}
   ~VariableDeclarationNode();
   string toString(int indent = 0) const override;
+  string getType() const { return type; }
+  string getName() const { return name; }
+  ExpressionNode *getInitialValue() const { return initialValue; }
+  void setInitialValue(ExpressionNode *value) { initialValue = value; }
+  // "int a[N]": "type" é o tipo dos elementos e N, o número deles
+  bool isArray() const { return arraySize >= 0; }
+  int64_t getArraySize() const { return arraySize; }
+  Binding getBinding() const { return binding; }
+  void setBinding(Binding b) { binding = b; }
 
 private:
   string type;
   string name;
   ExpressionNode *initialValue;
+  int64_t arraySize;
+  Binding binding;
 };
 
 class AssignmentNode : public StatementNode
 {
 public:
-  AssignmentNode(const string &name, ExpressionNode *value)
-      : name(name), value(value) {}
+  // "name = value;" ou, com índice, "name[index] = value;"
+  AssignmentNode(const string &name, ExpressionNode *value, ExpressionNode *index = nullptr)
+      : name(name), value(value), index(index) {}
   ~AssignmentNode();
   string toString(int indent = 0) const override;
+  string getName() const { return name; }
+  ExpressionNode *getValue() const { return value; }
+  void setValue(ExpressionNode *v) { value = v; }
+  ExpressionNode *getIndex() const { return index; }
+  void setIndex(ExpressionNode *i) { index = i; }
+  Binding getBinding() const { return binding; }
+  void setBinding(Binding b) { binding = b; }
+  bool needsBoundsCheck() const { return boundsCheck; }
+  void setNeedsBoundsCheck(bool check) { boundsCheck = check; }
 
 private:
   string name;
   ExpressionNode *value;
+  ExpressionNode *index;
+  Binding binding;
+  bool boundsCheck = true;
 };
 
 class IfStatementNode : public StatementNode
@@ -146,6 +273,12 @@ public:
       : condition(condition), thenBlock(thenBlock), elseBlock(elseBlock) {}
   ~IfStatementNode();
   string toString(int indent = 0) const override;
+  ExpressionNode *getCondition() const { return condition; }
+  void setCondition(ExpressionNode *c) { condition = c; }
+  BlockNode *getThenBlock() const { return thenBlock; }
+  BlockNode *getElseBlock() const { return elseBlock; }
+  void setThenBlock(BlockNode *block) { thenBlock = block; }
+  void setElseBlock(BlockNode *block) { elseBlock = block; }
 
 private:
   ExpressionNode *condition;
@@ -160,6 +293,9 @@ public:
       : condition(condition), body(body) {}
   ~WhileStatementNode();
   string toString(int indent = 0) const override;
+  ExpressionNode *getCondition() const { return condition; }
+  void setCondition(ExpressionNode *c) { condition = c; }
+  BlockNode *getBody() const { return body; }
 
 private:
   ExpressionNode *condition;
@@ -173,6 +309,13 @@ public:
       : init(init), condition(condition), update(update), body(body) {}
   ~ForStatementNode();
   string toString(int indent = 0) const override;
+  StatementNode *getInit() const { return init; }
+  void setInit(StatementNode *i) { init = i; }
+  ExpressionNode *getCondition() const { return condition; }
+  void setCondition(ExpressionNode *c) { condition = c; }
+  ExpressionNode *getUpdate() const { return update; }
+  void setUpdate(ExpressionNode *u) { update = u; }
+  BlockNode *getBody() const { return body; }
 
 private:
   StatementNode *init;
@@ -187,6 +330,8 @@ public:
   ReturnStatementNode(ExpressionNode *value = nullptr) : value(value) {}
   ~ReturnStatementNode();
   string toString(int indent = 0) const override;
+  ExpressionNode *getValue() const { return value; }
+  void setValue(ExpressionNode *v) { value = v; }
 
 private:
   ExpressionNode *value;
@@ -198,6 +343,8 @@ public:
   ExpressionStatementNode(ExpressionNode *expr) : expr(expr) {}
   ~ExpressionStatementNode();
   string toString(int indent = 0) const override;
+  ExpressionNode *getExpression() const { return expr; }
+  void setExpression(ExpressionNode *e) { expr = e; }
 
 private:
   ExpressionNode *expr;
@@ -209,10 +356,13 @@ public:
   ParameterNode(const string &type, const string &name) : type(type), name(name) {}
   string getType() const { return type; }
   string getName() const { return name; }
+  Binding getBinding() const { return binding; }
+  void setBinding(Binding b) { binding = b; }
 
 private:
   string type;
   string name;
+  Binding binding;
 };
 
 class FunctionNode : public ASTNode
@@ -222,12 +372,25 @@ public:
       : returnType(returnType), name(name), params(params), body(body) {}
   ~FunctionNode();
   string toString(int indent = 0) const override;
+  string getReturnType() const { return returnType; }
+  string getName() const { return name; }
+  const vector<ParameterNode *> &getParams() const { return params; }
+  BlockNode *getBody() const { return body; }
+  // Funções "__global__" são criadas pelo parser para o código de nível de programa
+  bool isGlobalWrapper() const { return name == "__global__"; }
+  int getFrameSize() const { return frameSize; }
+  void setFrameSize(int size) { frameSize = size; }
+  // Tipo de cada slot do quadro, preenchido pelo TypeChecker
+  const vector<TipoDeDado> &getSlotTypes() const { return slotTypes; }
+  void setSlotTypes(const vector<TipoDeDado> &types) { slotTypes = types; }
 
 private:
   string returnType;
   string name;
   vector<ParameterNode *> params;
   BlockNode *body;
+  int frameSize = 0; // número de slots locais (parâmetros inclusos)
+  vector<TipoDeDado> slotTypes;
 };
 
 class ProgramNode : public ASTNode
@@ -236,9 +399,16 @@ public:
   ProgramNode(vector<FunctionNode *> functions) : functions(functions) {}
   ~ProgramNode();
   string toString(int indent = 0) const override;
+  const vector<FunctionNode *> &getFunctions() const { return functions; }
+  int getGlobalCount() const { return globalCount; }
+  void setGlobalCount(int count) { globalCount = count; }
+  const vector<TipoDeDado> &getGlobalTypes() const { return globalTypes; }
+  void setGlobalTypes(const vector<TipoDeDado> &types) { globalTypes = types; }
 
 private:
   vector<FunctionNode *> functions;
+  int globalCount = 0; // número de variáveis globais
+  vector<TipoDeDado> globalTypes;
 };
 
 #endif // AST_H
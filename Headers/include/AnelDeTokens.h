@@ -0,0 +1,108 @@
+#ifndef ANELDETOKENS_H
+#define ANELDETOKENS_H
+
+#include "FluxoDeTokens.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Fila circular de tokens sem travas entre exatamente um produtor (o Lexer)
+// e um consumidor (o Parser), usada na análise em pipeline. Os tokens
+// passam em lotes: o produtor copia vários e só então publica o novo total
+// escrito, e o consumidor copia tudo o que está disponível e publica o
+// total lido. Com o anel cheio o produtor espera o consumidor
+// (contrapressão); vazio, o consumidor espera o produtor.
+//
+// Os contadores só crescem; a posição no anel é o contador módulo a
+// capacidade, que é uma potência de 2. Cada um fica na sua linha de cache
+// para que as escritas de um lado não invalidem as leituras do outro.
+class AnelDeTokens
+{
+public:
+    explicit AnelDeTokens(size_t capacidade) : escritos(0), lidos(0), fechado(false) {
+        size_t tamanho = 1;
+        while (tamanho < capacidade) {
+            tamanho <<= 1;
+        }
+        mascara = tamanho - 1;
+        tipos.resize(tamanho);
+        inicios.resize(tamanho);
+        tamanhos.resize(tamanho);
+    }
+    AnelDeTokens(const AnelDeTokens &) = delete;
+    AnelDeTokens &operator=(const AnelDeTokens &) = delete;
+
+    // Produtor: copia o lote para o anel, esperando espaço quando cheio
+    void enviar(const FluxoDeTokens &lote) {
+        size_t escrita = escritos.load(memory_order_relaxed);
+        size_t enviados = 0;
+        while (enviados < lote.size()) {
+            size_t livres = mascara + 1 - (escrita - lidos.load(memory_order_acquire));
+            if (livres == 0) {
+                this_thread::yield();
+                continue;
+            }
+            size_t n = min(livres, lote.size() - enviados);
+            for (size_t k = 0; k < n; k++, enviados++, escrita++) {
+                size_t posicao = escrita & mascara;
+                tipos[posicao] = static_cast<uint8_t>(lote.getTipo(enviados));
+                inicios[posicao] = lote.getInicio(enviados);
+                tamanhos[posicao] = lote.getTamanho(enviados);
+            }
+            escritos.store(escrita, memory_order_release);
+        }
+    }
+
+    // Produtor: não há mais tokens; "erro" não é vazio se a análise falhou
+    void fechar(const string &erro = "") {
+        this->erro = erro;
+        fechado.store(true, memory_order_release);
+    }
+
+    // Consumidor: acrescenta a "destino" até "maximo" tokens disponíveis,
+    // esperando haver pelo menos um; retorna 0 quando o anel foi fechado e
+    // não há mais tokens
+    size_t receber(FluxoDeTokens &destino, size_t maximo) {
+        size_t leitura = lidos.load(memory_order_relaxed);
+        while (true) {
+            size_t disponiveis = escritos.load(memory_order_acquire) - leitura;
+            if (disponiveis > 0) {
+                size_t n = min(disponiveis, maximo);
+                for (size_t k = 0; k < n; k++) {
+                    size_t posicao = (leitura + k) & mascara;
+                    destino.adicionar(static_cast<TipoDeToken>(tipos[posicao]), inicios[posicao], tamanhos[posicao]);
+                }
+                lidos.store(leitura + n, memory_order_release);
+                return n;
+            }
+            // Os últimos tokens são publicados antes de fechar
+            if (fechado.load(memory_order_acquire) && escritos.load(memory_order_acquire) == leitura) {
+                return 0;
+            }
+            this_thread::yield();
+        }
+    }
+
+    // Consumidor: mensagem do erro do produtor, depois de receber() retornar 0
+    const string &getErro() const {
+        return erro;
+    }
+
+private:
+    vector<uint8_t> tipos;
+    vector<uint32_t> inicios;
+    vector<uint32_t> tamanhos;
+    size_t mascara;
+    string erro;
+
+    alignas(64) atomic<size_t> escritos; // só o produtor escreve
+    alignas(64) atomic<size_t> lidos;    // só o consumidor escreve
+    alignas(64) atomic<bool> fechado;
+};
+
+#endif
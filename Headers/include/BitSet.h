@@ -0,0 +1,130 @@
+#ifndef BITSET_H
+#define BITSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Conjunto denso de inteiros em [0, tamanho), guardado em palavras de 64
+// bits. União, interseção e diferença processam 64 elementos por operação,
+// o que torna as análises de fluxo de dados baratas mesmo em funções com
+// milhares de valores. Os métodos são inline: ficam no laço mais interno
+// das análises.
+class BitSet
+{
+public:
+  BitSet() : numBits(0) {}
+  explicit BitSet(size_t tamanho) : numBits(tamanho), palavras((tamanho + 63) / 64, 0) {}
+
+  size_t tamanho() const { return numBits; }
+  bool contem(size_t i) const { return (palavras[i >> 6] >> (i & 63)) & 1; }
+  void ativar(size_t i) { palavras[i >> 6] |= uint64_t(1) << (i & 63); }
+  void desativar(size_t i) { palavras[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+
+  void limpar()
+  {
+    for (auto &palavra : palavras)
+      palavra = 0;
+  }
+
+  // As operações retornam true se o conjunto mudou
+  bool unir(const BitSet &outro)
+  {
+    uint64_t mudou = 0;
+    for (size_t i = 0; i < palavras.size(); i++)
+    {
+      uint64_t novo = palavras[i] | outro.palavras[i];
+      mudou |= novo ^ palavras[i];
+      palavras[i] = novo;
+    }
+    return mudou != 0;
+  }
+
+  bool interseccionar(const BitSet &outro)
+  {
+    uint64_t mudou = 0;
+    for (size_t i = 0; i < palavras.size(); i++)
+    {
+      uint64_t novo = palavras[i] & outro.palavras[i];
+      mudou |= novo ^ palavras[i];
+      palavras[i] = novo;
+    }
+    return mudou != 0;
+  }
+
+  bool subtrair(const BitSet &outro)
+  {
+    uint64_t mudou = 0;
+    for (size_t i = 0; i < palavras.size(); i++)
+    {
+      uint64_t novo = palavras[i] & ~outro.palavras[i];
+      mudou |= novo ^ palavras[i];
+      palavras[i] = novo;
+    }
+    return mudou != 0;
+  }
+
+  // this = gen | (entrada & ~kill): a função de transferência das análises
+  // de fluxo de dados, numa única passada
+  bool transferir(const BitSet &gen, const BitSet &entrada, const BitSet &kill)
+  {
+    uint64_t mudou = 0;
+    for (size_t i = 0; i < palavras.size(); i++)
+    {
+      uint64_t novo = gen.palavras[i] | (entrada.palavras[i] & ~kill.palavras[i]);
+      mudou |= novo ^ palavras[i];
+      palavras[i] = novo;
+    }
+    return mudou != 0;
+  }
+
+  size_t contar() const
+  {
+    size_t total = 0;
+    for (uint64_t palavra : palavras)
+      total += __builtin_popcountll(palavra);
+    return total;
+  }
+
+  // Menor elemento >= i, ou tamanho() se não houver
+  size_t proximo(size_t i) const
+  {
+    if (i >= numBits)
+      return numBits;
+    size_t p = i >> 6;
+    uint64_t palavra = palavras[p] & (~uint64_t(0) << (i & 63));
+    while (palavra == 0)
+    {
+      if (++p == palavras.size())
+        return numBits;
+      palavra = palavras[p];
+    }
+    return p * 64 + __builtin_ctzll(palavra);
+  }
+
+  // Chama f(i) para cada elemento, em ordem crescente
+  template <typename F>
+  void paraCada(F f) const
+  {
+    for (size_t p = 0; p < palavras.size(); p++)
+    {
+      uint64_t palavra = palavras[p];
+      while (palavra)
+      {
+        f(p * 64 + __builtin_ctzll(palavra));
+        palavra &= palavra - 1;
+      }
+    }
+  }
+
+  bool operator==(const BitSet &outro) const { return numBits == outro.numBits && palavras == outro.palavras; }
+  bool operator!=(const BitSet &outro) const { return !(*this == outro); }
+
+private:
+  size_t numBits;
+  vector<uint64_t> palavras;
+};
+
+#endif // BITSET_H
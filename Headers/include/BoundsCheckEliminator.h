@@ -0,0 +1,54 @@
+#ifndef BOUNDSCHECKELIMINATOR_H
+#define BOUNDSCHECKELIMINATOR_H
+
+#include <cstdint>
+#include <unordered_map>
+#include "AST.h"
+
+using namespace std;
+
+// Remove verificações de limites de arrays provadas desnecessárias (executar
+// depois do TypeChecker e das otimizações que reescrevem a AST).
+//
+// Num laço "for (int i = L; i < U; i++) corpo" (também "i <= U",
+// "i = i + k" com k > 0 e inicialização por atribuição) em que i é local e
+// o corpo não atribui a i, vale L <= i < U dentro do corpo. L e U podem ser
+// literais ou expressões de variáveis de laços externos, com intervalos já
+// conhecidos. Um acesso a[e] cujo índice e (literais, variáveis de laço, +
+// e -) fica sempre em [0, N), sendo N o tamanho declarado de a, é marcado
+// como sem verificação; a VM e o Interpreter então leem e escrevem o
+// elemento diretamente.
+class BoundsCheckEliminator
+{
+public:
+  BoundsCheckEliminator();
+  void otimizar(ProgramNode *program);
+  // Acessos sem verificação e acessos que continuam verificados, na última execução
+  int getEliminadas() const { return eliminadas; }
+  int getMantidas() const { return mantidas; }
+
+private:
+  struct Intervalo
+  {
+    int64_t minimo;
+    int64_t maximo;
+  };
+
+  unordered_map<int, int64_t> tamanhos;      // tamanho de cada array, por chave()
+  unordered_map<int, Intervalo> intervalos;  // variáveis dos laços que envolvem o ponto atual
+  int eliminadas;
+  int mantidas;
+
+  static int chave(Binding binding);
+  void analisarBloco(BlockNode *block);
+  void analisarStatement(StatementNode *stmt);
+  void analisarExpressao(ExpressionNode *expr);
+  void analisarFor(ForStatementNode *forStmt);
+  // Decide a verificação de um acesso a "binding" com o índice "index"
+  bool precisaVerificar(Binding binding, ExpressionNode *index);
+  bool intervaloDe(ExpressionNode *expr, Intervalo &intervalo);
+  // Variável e intervalo de um for na forma aceita, se houver
+  bool variavelDeLaco(ForStatementNode *forStmt, Binding &variavel, Intervalo &intervalo);
+};
+
+#endif // BOUNDSCHECKELIMINATOR_H
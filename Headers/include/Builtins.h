@@ -0,0 +1,53 @@
+#ifndef BUILTINS_H
+#define BUILTINS_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include "TipoDeDado.h"
+#include "Valor.h"
+
+using namespace std;
+
+// Funções embutidas da linguagem (print, matemática, strings), escritas em
+// C++ e chamadas pelo índice na tabela BUILTINS.
+//
+// O nome é buscado uma única vez: o Resolver anota em cada FunctionCallNode
+// a primeira versão com aquele nome e o TypeChecker escolhe, pelos tipos
+// dos argumentos, a versão chamada (print tem uma por tipo), verificando
+// número e tipos e inserindo as conversões int -> double. Em execução o
+// Interpreter e a VM só indexam a tabela e chamam o ponteiro, com os
+// argumentos já no lugar (na VM, no topo da própria pilha).
+const int MAX_PARAMETROS_BUILTIN = 3;
+
+// Recebe os argumentos já convertidos para os tipos dos parâmetros
+typedef Valor (*ImplementacaoBuiltin)(const Valor *argumentos);
+// Mesma função na convenção do código do Jit (FuncaoNativa): inteiros, ou
+// os bits de um double, num vetor de 64 bits. Não pode lançar exceções,
+// que não atravessam o código nativo.
+typedef uint64_t (*ImplementacaoEmBits)(const uint64_t *argumentos);
+
+struct Builtin
+{
+  const char *nome;
+  TipoDeDado tipoRetorno;
+  int numParametros;
+  TipoDeDado parametros[MAX_PARAMETROS_BUILTIN];
+  ImplementacaoBuiltin implementacao;
+  ImplementacaoEmBits emBits; // nullptr se usa strings
+  const char *emC;            // função chamada no código do CBackend
+};
+
+// As versões de um mesmo nome ficam em posições consecutivas
+extern const Builtin BUILTINS[];
+extern const int NUM_BUILTINS;
+
+// Índice da primeira versão da função embutida "nome", ou -1
+int buscarBuiltin(const string &nome);
+
+// Destino do print na thread atual; nullptr (o padrão) é cout. O
+// Compilador aponta para o seu próprio buffer enquanto executa
+void setSaidaDosBuiltins(ostream *saida);
+ostream *getSaidaDosBuiltins();
+
+#endif // BUILTINS_H
@@ -0,0 +1,131 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "TipoDeDado.h"
+#include "Valor.h"
+
+using namespace std;
+
+// Bytecode de pilha executado pela VM. As operações já vêm especializadas
+// pelo tipo dos operandos (anotado pelo TypeChecker), de modo que a VM não
+// testa tipos em tempo de execução.
+enum class OpBC : uint8_t
+{
+  CONST,         // a = índice em FuncaoBC::constantes
+  LOAD_LOCAL,    // a = slot
+  STORE_LOCAL,   // a = slot; desempilha o valor
+  LOAD_GLOBAL,   // a = slot global
+  STORE_GLOBAL,  // a = slot global; desempilha o valor
+  POP,
+  DUP,
+  ADD_INT,
+  SUB_INT,
+  MUL_INT,
+  DIV_INT,
+  ADD_REAL,
+  SUB_REAL,
+  MUL_REAL,
+  DIV_REAL,
+  CONCAT,
+  LT_INT,        // comparações empilham int (0 ou 1)
+  GT_INT,
+  LE_INT,
+  GE_INT,
+  EQ_INT,
+  NE_INT,
+  LT_REAL,
+  GT_REAL,
+  LE_REAL,
+  GE_REAL,
+  EQ_REAL,
+  NE_REAL,
+  LT_STR,
+  GT_STR,
+  LE_STR,
+  GE_STR,
+  EQ_STR,
+  NE_STR,
+  NOT,
+  INT_TO_DOUBLE,
+  JUMP,          // a = destino
+  JUMP_IF_FALSE, // a = destino; desempilha a condição
+  JUMP_IF_TRUE,
+  CALL,          // a = função, b = número de argumentos; empilha o resultado
+  CALL_BUILTIN,  // a = índice em BUILTINS, b = número de argumentos; idem
+  RETURN,        // desempilha o valor retornado
+  RETURN_VOID,
+  NEW_ARRAY,     // a = tamanho, b = tipo do array (TipoDeDado); empilha o array zerado
+  LOAD_ELEM,     // a = slot do array, b = 1 se global: desempilha o índice e empilha o elemento
+  STORE_ELEM,    // a, b como em LOAD_ELEM: desempilha o índice e depois o valor
+  LOAD_ELEM_NC,  // LOAD_ELEM e STORE_ELEM sem verificação do índice, quando o
+  STORE_ELEM_NC, // BoundsCheckEliminator provou que ele está no array
+  // Superinstruções, criadas pelo PeepholeOptimizer
+  LOAD_LOCAL_2,     // a, b = slots: empilha os dois
+  LOAD_LOCAL_CONST, // a = slot, b = constante
+  ADD_INT_LL,       // a, b = slots: empilha local[a] + local[b]
+  INC_LOCAL,        // a = slot, b = incremento: local[a] += b
+  JUMP_IF_NOT_CMP,  // a = destino, b = comparação inteira (OpBC): desempilha dois inteiros
+  LOAD_ELEM_L,      // a = slot do array local, b = slot do índice: empilha o elemento
+  LOAD_ELEM_L_NC,   // LOAD_ELEM_L sem verificação do índice
+  NUM_OPS
+};
+
+const int NUM_OPS_BC = int(OpBC::NUM_OPS);
+
+struct InstrucaoBC
+{
+  OpBC op;
+  int32_t a;
+  int32_t b;
+
+  InstrucaoBC(OpBC op, int32_t a = 0, int32_t b = 0) : op(op), a(a), b(b) {}
+};
+
+struct FuncaoBC
+{
+  string nome;
+  vector<InstrucaoBC> codigo;
+  vector<Valor> constantes;
+  vector<TipoDeDado> tiposSlots; // os parâmetros ocupam os primeiros slots
+  int numParametros = 0;
+  TipoDeDado tipoRetorno = TipoDeDado::VOID;
+  bool isGlobalWrapper = false;
+
+  int adicionarConstante(const Valor &valor);
+  string toString() const;
+};
+
+class ProgramaBC
+{
+public:
+  vector<FuncaoBC> funcoes;  // mesma ordem de ProgramNode::getFunctions()
+  vector<TipoDeDado> tiposGlobais;
+  int principal = -1;        // função main sem parâmetros, se existir
+  TabelaDeLiterais literais; // strings das constantes, uma por conteúdo
+  string toString() const;
+};
+
+string opBCParaString(OpBC op);
+bool isSaltoBC(OpBC op);
+
+// Frequência dos pares de operações executadas em sequência numa mesma
+// função, coletada pela VM
+class PerfilBC
+{
+public:
+  PerfilBC();
+  void registrar(OpBC anterior, OpBC atual) { pares[int(anterior) * NUM_OPS_BC + int(atual)]++; }
+  uint64_t getContagem(OpBC anterior, OpBC atual) const { return pares[int(anterior) * NUM_OPS_BC + int(atual)]; }
+  uint64_t getTotal() const;
+  void limpar();
+  // Os n pares mais frequentes, com a fração do total
+  string relatorio(size_t n) const;
+
+private:
+  vector<uint64_t> pares;
+};
+
+#endif // BYTECODE_H
@@ -0,0 +1,47 @@
+#ifndef BYTECODECOMPILER_H
+#define BYTECODECOMPILER_H
+
+#include <string>
+#include "AST.h"
+#include "Bytecode.h"
+
+using namespace std;
+
+// Traduz a AST tipada (após Resolver e TypeChecker) para o bytecode da VM.
+//
+// Cada função vira uma sequência linear de instruções de pilha; os slots do
+// quadro são os do Resolver (parâmetros primeiro). Expressões cujo valor é
+// descartado (statements de expressão e o update do for) não deixam nada na
+// pilha: "i++" e "i = i + 1" viram a mesma sequência load/const/add/store.
+class BytecodeCompiler
+{
+public:
+  BytecodeCompiler();
+  ProgramaBC *gerar(ProgramNode *program);
+
+private:
+  ProgramaBC *programa;
+  FuncaoBC *funcao;
+
+  void gerarFuncao(FunctionNode *function, FuncaoBC &destino);
+  void gerarBloco(BlockNode *block);
+  void gerarStatement(StatementNode *stmt);
+  // Com "descartar", o valor da expressão não fica na pilha
+  void gerarExpressao(ExpressionNode *expr, bool descartar = false);
+  void gerarBinaria(BinaryOpNode *binary, bool descartar);
+  void gerarLogica(BinaryOpNode *binary);
+  void gerarIncremento(UnaryOpNode *unary, bool descartar);
+
+  int emitir(OpBC op, int32_t a = 0, int32_t b = 0);
+  void constante(const Valor &valor);
+  void carregar(Binding binding);
+  void armazenar(Binding binding);
+  // LOAD_ELEM/STORE_ELEM (ou as variantes sem verificação) do array "binding"
+  void emitirElemento(OpBC op, Binding binding);
+  // Destino de um salto emitido antes: a próxima instrução
+  void ajustarSalto(int salto);
+
+  void erro(const string &msg);
+};
+
+#endif // BYTECODECOMPILER_H
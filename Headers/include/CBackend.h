@@ -0,0 +1,74 @@
+#ifndef CBACKEND_H
+#define CBACKEND_H
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include "AST.h"
+
+using namespace std;
+
+// Backend que traduz a AST analisada (depois do Resolver e do TypeChecker,
+// opcionalmente das otimizações) para um programa C99 autônomo, compilável
+// pelo compilador C do sistema.
+//
+// int vira int64_t, double vira double e string vira const char *, com
+// funções auxiliares de concatenação e comparação. Arrays viram arrays C
+// de int64_t ou double (os locais na pilha, com até 65536 elementos), e os
+// índices não provados pelo BoundsCheckEliminator passam por rt_indice.
+//
+// Cada variável é nomeada pelo seu nome e slot ("x_3", globais "x_g0") e
+// cada função recebe o sufixo "_f", o que evita colisões com palavras
+// reservadas e com a biblioteca C. Depois do último "_", um nome de
+// variável só tem dígitos ou "g" e dígitos e um de função só "f"; os
+// temporários ("t0") e os inicializadores ("global0") não têm "_". Assim
+// nenhum nome gerado coincide com outro, quaisquer que sejam os nomes do
+// programa. As funções "__global__" viram inicializadores chamados, na
+// ordem do programa, pelo main do C, que em seguida chama a função main do
+// programa (se existir, sem parâmetros) e imprime o valor retornado.
+//
+// A ordem de avaliação dos operandos em C não é especificada: quando um
+// operando tem efeitos colaterais, os anteriores são avaliados antes em
+// temporários, com o operador vírgula. A aritmética inteira dá a volta no
+// estouro, como no ConstantFolder; por isso o código deve ser compilado com
+// -fwrapv (compilar() já o faz).
+class CBackend
+{
+public:
+  CBackend();
+  string gerar(ProgramNode *program);
+  // Compila o código C com $CC (ou cc) -O2; lança runtime_error se falhar
+  void compilar(const string &codigoC, const string &executavel);
+  // Executa o programa compilado e retorna a sua saída padrão
+  string executar(const string &executavel);
+  // Temporários criados para fixar a ordem de avaliação na última geração
+  int getTemporarios() const { return numTemporarios; }
+
+private:
+  ProgramNode *programa;
+  FunctionNode *funcao;
+  int numTemporarios;
+  // Declarações dos temporários da função sendo gerada
+  stringstream declaracoes;
+  // Tamanho declarado dos arrays, por slot (-1 nos demais)
+  vector<int64_t> tamanhosGlobais;
+  vector<int64_t> tamanhosLocais;
+
+  void gerarFuncao(FunctionNode *function, const string &nome, stringstream &saida);
+  void gerarBloco(BlockNode *block, int indent, stringstream &saida);
+  void gerarStatement(StatementNode *stmt, int indent, stringstream &saida);
+  string expressao(ExpressionNode *expr);
+  string binaria(BinaryOpNode *binary);
+  string elemento(const string &nome, Binding binding, const string &indice, bool verificar);
+  string atribuirElemento(const string &nome, Binding binding, ExpressionNode *index, bool verificar, ExpressionNode *value);
+  // Operandos avaliados da esquerda para a direita; "prefixo" recebe as
+  // atribuições a temporários que devem precedê-los
+  vector<string> operandos(const vector<ExpressionNode *> &exprs, string &prefixo);
+  string temporario(TipoDeDado tipo);
+  string nomeDaVariavel(const string &nome, Binding binding) const;
+  string nomeDaFuncao(const string &nome) const;
+};
+
+string tipoEmC(TipoDeDado tipo);
+
+#endif // CBACKEND_H
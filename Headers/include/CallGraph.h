@@ -0,0 +1,43 @@
+#ifndef CALLGRAPH_H
+#define CALLGRAPH_H
+
+#include <string>
+#include <vector>
+#include "AST.h"
+
+using namespace std;
+
+// Grafo de chamadas entre as funções do programa (executar depois do
+// Resolver, que anota o índice da função chamada em cada FunctionCallNode).
+//
+// Os componentes fortemente conexos (algoritmo de Tarjan) identificam as
+// funções recursivas, direta ou mutuamente, e dão uma ordem em que cada
+// função aparece depois de todas as que ela chama (fora do seu componente).
+class CallGraph
+{
+public:
+  CallGraph();
+  void construir(ProgramNode *program);
+
+  // Funções chamadas por f (sem repetição) e número de chamadas por aresta
+  const vector<int> &getChamadas(int f) const { return chamadas[f]; }
+  int getNumChamadas(int de, int para) const;
+  // f pertence a um ciclo do grafo (inclusive chamando a si mesma)
+  bool isRecursiva(int f) const { return recursiva[f]; }
+  // Componentes fortemente conexos, dos chamados para os chamadores
+  const vector<vector<int>> &getComponentes() const { return componentes; }
+
+  string toString() const;
+
+private:
+  ProgramNode *programa;
+  vector<vector<int>> chamadas;
+  vector<vector<int>> contagens; // paralelo a chamadas
+  vector<bool> recursiva;
+  vector<vector<int>> componentes;
+
+  void registrarChamadas(int f, ASTNode *node);
+  void calcularComponentes();
+};
+
+#endif // CALLGRAPH_H
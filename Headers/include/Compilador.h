@@ -0,0 +1,109 @@
+#ifndef COMPILADOR_H
+#define COMPILADOR_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include "AST.h"
+#include "Bytecode.h"
+#include "Interpreter.h"
+#include "Lexer.h"
+#include "Parser.h"
+#include "VM.h"
+#include "Valor.h"
+
+using namespace std;
+
+// Motor que executa o programa compilado
+enum class Motor
+{
+  VM,         // bytecode (BytecodeCompiler, PeepholeOptimizer)
+  INTERPRETER // AST em camadas, com o Jit
+};
+
+struct OpcoesDoCompilador
+{
+  Motor motor = Motor::VM;
+  // Inliner, ConstantFolder, DeadCodeEliminator, BoundsCheckEliminator e,
+  // na VM, as superinstruções do PeepholeOptimizer
+  bool otimizar = true;
+  bool usarJit = true; // só no Interpreter
+  // Programas compilados mantidos no contexto, pelo código-fonte; ao passar
+  // do limite, sai o usado há mais tempo
+  size_t limiteDoCache = 32;
+  // Só na VM (VM::setLimites): chamadas aninhadas e instruções executadas
+  // por chamada; 0 não limita
+  int limiteDeProfundidade = 0;
+  uint64_t limiteDeDespachos = 0;
+};
+
+// Contexto de compilação para embutir o compilador em outro programa
+// (libcompilador.a / libcompilador.so): compila um código-fonte para uma
+// unidade executável, executa-a quantas vezes for preciso e é reaproveitado
+// para o programa seguinte.
+//
+// O contexto guarda o que pode ser reaproveitado entre programas: o Lexer
+// e o Parser (com os vetores de tokens já alocados), a VM (pilha e vetor
+// de globais), o buffer da saída dos prints e as últimas unidades
+// compiladas. Compilar de novo um código-fonte que está no cache só
+// seleciona a unidade (AST analisada, bytecode com os literais internados
+// e, no Interpreter, o código do Jit), de modo que execuções repetidas
+// encontram as funções quentes já compiladas.
+//
+// Não há estado global mutável no compilador: contextos diferentes podem
+// ser usados ao mesmo tempo em threads diferentes. Um mesmo contexto deve
+// ser usado por uma thread de cada vez.
+class Compilador
+{
+public:
+  Compilador(const OpcoesDoCompilador &opcoes = OpcoesDoCompilador());
+  ~Compilador();
+  Compilador(const Compilador &) = delete;
+  Compilador &operator=(const Compilador &) = delete;
+
+  // Analisa e compila o programa, substituindo a unidade anterior; lança
+  // runtime_error com a mensagem da fase que falhou ("Erro de tipo: ...")
+  void compilar(const string &codigo);
+  // Executa o código de nível de programa e a função main (se existir),
+  // retornando o valor de main; os prints vão para getSaida()
+  Valor executar();
+  // Descarta as unidades compiladas, mantendo os buffers do contexto
+  void reiniciar();
+
+  bool isCompilado() const { return atual != nullptr; }
+  // Bytecode da unidade atual (só com a VM)
+  string getBytecode() const;
+  // Saída dos prints da última execução
+  const string &getSaida() const { return saida; }
+  const OpcoesDoCompilador &getOpcoes() const { return opcoes; }
+  int getCompilacoes() const { return compilacoes; }
+  int getExecucoes() const { return execucoes; }
+  // Chamadas a compilar() resolvidas pelo cache
+  int getAcertosDoCache() const { return acertosDoCache; }
+  size_t getTamanhoDoCache() const { return cache.size(); }
+
+private:
+  struct Unidade
+  {
+    ProgramNode *ast = nullptr;
+    ProgramaBC *programa = nullptr;
+    Interpreter *interpreter = nullptr; // criado na primeira execução
+    uint64_t ultimoUso = 0;
+  };
+
+  OpcoesDoCompilador opcoes;
+  unordered_map<string, Unidade> cache; // por código-fonte
+  Lexer lexer;
+  Parser parser;
+  Unidade *atual;
+  VM *vm; // criada na primeira execução e reaproveitada
+  string saida;
+  uint64_t relogio; // ordem de uso das unidades
+  int compilacoes;
+  int execucoes;
+  int acertosDoCache;
+
+  static void liberar(Unidade &unidade);
+};
+
+#endif // COMPILADOR_H
@@ -0,0 +1,42 @@
+#ifndef COMPILADORC_H
+#define COMPILADORC_H
+
+/* Interface C do Compilador (Compilador.h), para embutir a biblioteca em
+ * programas que não são C++. Nenhuma exceção atravessa estas funções: as
+ * que podem falhar retornam 0 em caso de sucesso e -1 em caso de erro, com
+ * a mensagem em compilador_erro(). As strings retornadas pertencem ao
+ * contexto e valem até a próxima chamada que o modifique. */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+  typedef struct compilador compilador;
+
+  /* Motores aceitos por compilador_criar */
+  enum
+  {
+    COMPILADOR_VM = 0,
+    COMPILADOR_INTERPRETER = 1
+  };
+
+  compilador *compilador_criar(int motor);
+  void compilador_destruir(compilador *contexto);
+
+  int compilador_compilar(compilador *contexto, const char *codigo);
+  int compilador_executar(compilador *contexto);
+  /* Descarta os programas compilados (e o cache), mantendo os buffers do contexto */
+  void compilador_reiniciar(compilador *contexto);
+
+  /* Valor retornado por main na última execução, como texto */
+  const char *compilador_resultado(const compilador *contexto);
+  /* Saída dos prints da última execução */
+  const char *compilador_saida(const compilador *contexto);
+  const char *compilador_erro(const compilador *contexto);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMPILADORC_H */
@@ -0,0 +1,42 @@
+#ifndef CONSTANTFOLDER_H
+#define CONSTANTFOLDER_H
+
+#include <vector>
+#include "AST.h"
+
+using namespace std;
+
+// Otimização sobre a AST tipada (executar depois do TypeChecker):
+// - avalia subárvores constantes (aritméticas, relacionais, lógicas, "!",
+//   concatenação de strings e conversões int -> double)
+// - aplica identidades algébricas: x + 0, x - 0, x * 1, x / 1 e, para
+//   int, x * 0 quando x não tem efeitos colaterais
+// - remove if/while/for cujas condições são constantes, mantendo apenas o
+//   ramo que pode executar
+class ConstantFolder
+{
+public:
+  ConstantFolder();
+  void otimizar(ProgramNode *program);
+  // Número de nós simplificados na última execução
+  int getSimplificacoes() const { return simplificacoes; }
+
+private:
+  int simplificacoes;
+
+  void otimizarBloco(BlockNode *block);
+  void otimizarStatement(StatementNode *stmt, vector<StatementNode *> &saida);
+  void incorporarBloco(BlockNode *block, vector<StatementNode *> &saida);
+  ExpressionNode *dobrar(ExpressionNode *expr);
+  ExpressionNode *dobrarBinaria(BinaryOpNode *binary);
+  ExpressionNode *dobrarUnaria(UnaryOpNode *unary);
+  ExpressionNode *substituir(ExpressionNode *antigo, ExpressionNode *novo);
+  ExpressionNode *manterOperando(BinaryOpNode *binary, bool esquerdo);
+};
+
+// Verdadeiro se a avaliação da expressão não altera variáveis, não chama
+// funções e não pode lançar um erro de execução (divisão inteira por zero,
+// índice fora do array)
+bool isExpressaoPura(ExpressionNode *expr);
+
+#endif // CONSTANTFOLDER_H
@@ -0,0 +1,105 @@
+#ifndef DATAFLOW_H
+#define DATAFLOW_H
+
+#include <string>
+#include <vector>
+#include "BitSet.h"
+#include "IR.h"
+
+using namespace std;
+
+// Framework genérico de análise de fluxo de dados sobre os blocos básicos
+// da IR, com conjuntos representados por BitSet.
+//
+// Cada problema informa a direção e, por bloco, os conjuntos gen e kill;
+// o encontro entre caminhos é a união. O resolvedor usa uma lista de
+// trabalho iniciada na pós-ordem reversa (para frente) ou na pós-ordem
+// (para trás), de modo que a maioria dos blocos converge em uma ou duas
+// visitas, e só reprocessa os vizinhos de blocos cujo resultado mudou.
+enum class DirecaoDataflow
+{
+  PARA_FRENTE,
+  PARA_TRAS
+};
+
+class ProblemaDataflow
+{
+public:
+  virtual ~ProblemaDataflow() = default;
+  virtual DirecaoDataflow getDirecao() const = 0;
+  virtual size_t getNumBits() const = 0;
+  virtual void calcularGenKill(int bloco, BitSet &gen, BitSet &kill) = 0;
+  // Valor na entrada da função (para frente) ou na saída dos blocos sem
+  // sucessores (para trás); vazio por padrão
+  virtual void inicializarContorno(BitSet &valor) { (void)valor; }
+};
+
+struct ResultadoDataflow
+{
+  vector<BitSet> entrada; // por bloco
+  vector<BitSet> saida;
+  int visitas = 0;        // blocos processados pela lista de trabalho
+  double microssegundos = 0;
+};
+
+ResultadoDataflow resolverDataflow(const FuncaoIR &funcao, ProblemaDataflow &problema);
+
+// Variáveis vivas sobre a IR em SSA: o elemento i é o valor produzido pela
+// instrução i. O uso de um operando de PHI conta no fim do predecessor
+// correspondente, não no bloco do PHI.
+class AnaliseDeVivacidade : public ProblemaDataflow
+{
+public:
+  AnaliseDeVivacidade(const FuncaoIR &funcao) : funcao(funcao) {}
+  void executar() { resultado = resolverDataflow(funcao, *this); }
+  const ResultadoDataflow &getResultado() const { return resultado; }
+  const BitSet &getVivasNaEntrada(int bloco) const { return resultado.entrada[bloco]; }
+  const BitSet &getVivasNaSaida(int bloco) const { return resultado.saida[bloco]; }
+
+  DirecaoDataflow getDirecao() const override { return DirecaoDataflow::PARA_TRAS; }
+  size_t getNumBits() const override { return funcao.instrucoes.size(); }
+  void calcularGenKill(int bloco, BitSet &gen, BitSet &kill) override;
+
+private:
+  const FuncaoIR &funcao;
+  ResultadoDataflow resultado;
+};
+
+// Definições que alcançam cada ponto, sobre a IR antes da conversão para
+// SSA (IRBuilder::construir com ssa = false): as definições são as
+// instruções STORE_LOCAL. Cada slot tem ainda uma pseudodefinição "não
+// inicializado" na entrada da função, que permite detectar leituras que
+// podem acontecer antes de qualquer atribuição.
+class DefinicoesAlcancaveis : public ProblemaDataflow
+{
+public:
+  DefinicoesAlcancaveis(const FuncaoIR &funcao);
+  void executar() { resultado = resolverDataflow(funcao, *this); }
+  const ResultadoDataflow &getResultado() const { return resultado; }
+  // STORE_LOCAL correspondente a cada elemento (os demais são pseudodefinições)
+  const vector<uint32_t> &getDefinicoes() const { return definicoes; }
+  // STOREs que alcançam a instrução (um LOAD_LOCAL) e se o slot pode estar
+  // não inicializado nela
+  vector<uint32_t> definicoesQueAlcancam(uint32_t instrucao, bool &podeEstarIndefinida) const;
+  // LOAD_LOCALs que podem ler um slot nunca atribuído
+  vector<uint32_t> leiturasSemDefinicao() const;
+
+  DirecaoDataflow getDirecao() const override { return DirecaoDataflow::PARA_FRENTE; }
+  size_t getNumBits() const override { return definicoes.size() + funcao.tiposSlots.size(); }
+  void calcularGenKill(int bloco, BitSet &gen, BitSet &kill) override;
+  void inicializarContorno(BitSet &valor) override;
+
+private:
+  const FuncaoIR &funcao;
+  vector<uint32_t> definicoes;
+  vector<int> indiceDaDefinicao; // por instrução (-1 se não é STORE_LOCAL)
+  vector<BitSet> doSlot;         // por slot: as suas definições e a pseudodefinição
+  ResultadoDataflow resultado;
+
+  void aplicar(uint32_t store, BitSet &valor) const;
+};
+
+// Conjunto no formato "{%1, %5}", traduzindo cada elemento para um valor
+string formatarConjunto(const BitSet &conjunto, const vector<uint32_t> *valores = nullptr);
+
+#endif // DATAFLOW_H
@@ -0,0 +1,54 @@
+#ifndef DEADCODEELIMINATOR_H
+#define DEADCODEELIMINATOR_H
+
+#include <vector>
+#include "AST.h"
+#include "IR.h"
+
+using namespace std;
+
+// Eliminação de código morto, executada antes dos backends.
+//
+// Sobre a AST tipada (depois do Resolver e do TypeChecker):
+// - remove statements inalcançáveis (depois de um return, ou de um if cujos
+//   dois ramos retornam) e os ramos de if/while/for com condição constante
+// - análise de variáveis vivas (de trás para frente, com ponto fixo nos
+//   laços) que remove atribuições e inicializações de variáveis locais
+//   nunca lidas depois, quando o valor atribuído não tem efeitos colaterais;
+//   com efeitos colaterais, apenas a atribuição é descartada
+// - remove expressões sem efeitos usadas como statement e declarações de
+//   variáveis que deixaram de ser referenciadas
+//
+// Sobre a IR em SSA:
+// - desvios com condição constante viram saltos e os blocos que ficam
+//   inalcançáveis são removidos
+// - instruções puras e PHIs cujo valor não é usado são removidos
+class DeadCodeEliminator
+{
+public:
+  DeadCodeEliminator();
+  void otimizar(ProgramNode *program);
+  void otimizar(ProgramaIR *programa);
+  void otimizarFuncao(FuncaoIR &funcao);
+  // Número de statements, inicializações e instruções removidos na última execução
+  int getRemovidos() const { return removidos; }
+
+private:
+  typedef vector<bool> Vivas; // por slot local
+
+  int removidos;
+
+  void removerInalcancaveis(BlockNode *block);
+  bool sempreRetorna(StatementNode *stmt);
+
+  void analisarBloco(BlockNode *block, Vivas &vivas, bool remover);
+  StatementNode *analisarStatement(StatementNode *stmt, Vivas &vivas, bool remover);
+  void analisarLaco(ExpressionNode *condition, ExpressionNode *update, BlockNode *body, Vivas &vivas, bool remover);
+  void adicionarUsos(ExpressionNode *expr, Vivas &vivas);
+
+  void contarReferencias(StatementNode *stmt, vector<int> &referencias);
+  void contarReferencias(ExpressionNode *expr, vector<int> &referencias);
+  void removerDeclaracoesSemUso(BlockNode *block, const vector<int> &referencias);
+};
+
+#endif // DEADCODEELIMINATOR_H
@@ -0,0 +1,91 @@
+#ifndef FLUXODETOKENS_H
+#define FLUXODETOKENS_H
+
+#include "Token.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Sequência de tokens produzida pelo Lexer, guardada como estrutura de
+// vetores: o tipo num byte e a posição e o tamanho do lexema no
+// código-fonte em 32 bits cada, 9 bytes por token em vez dos ~40 de um
+// tipo com uma string. O Parser percorre os três vetores em sequência.
+//
+// Os lexemas não são copiados: o fluxo aponta para o código do Lexer e só
+// é válido enquanto ele existir e até o seu próximo reset.
+class FluxoDeTokens
+{
+public:
+    FluxoDeTokens() : codigo(nullptr) {}
+
+    // Esvazia o fluxo para um novo código, mantendo a capacidade dos vetores
+    void reiniciar(const string *codigo) {
+        this->codigo = codigo;
+        tipos.clear();
+        inicios.clear();
+        tamanhos.clear();
+    }
+
+    void adicionar(TipoDeToken tipo, size_t inicio, size_t tamanho) {
+        tipos.push_back(static_cast<uint8_t>(tipo));
+        inicios.push_back(static_cast<uint32_t>(inicio));
+        tamanhos.push_back(static_cast<uint32_t>(tamanho));
+    }
+
+    // Acrescenta os tokens de outro fluxo sobre o mesmo código
+    void anexar(const FluxoDeTokens &outro) {
+        tipos.insert(tipos.end(), outro.tipos.begin(), outro.tipos.end());
+        inicios.insert(inicios.end(), outro.inicios.begin(), outro.inicios.end());
+        tamanhos.insert(tamanhos.end(), outro.tamanhos.begin(), outro.tamanhos.end());
+    }
+
+    // Remove os n primeiros tokens
+    void descartarInicio(size_t n) {
+        tipos.erase(tipos.begin(), tipos.begin() + n);
+        inicios.erase(inicios.begin(), inicios.begin() + n);
+        tamanhos.erase(tamanhos.begin(), tamanhos.begin() + n);
+    }
+
+    size_t size() const {
+        return tipos.size();
+    }
+
+    bool empty() const {
+        return tipos.empty();
+    }
+
+    TipoDeToken getTipo(size_t i) const {
+        return static_cast<TipoDeToken>(tipos[i]);
+    }
+
+    uint32_t getInicio(size_t i) const {
+        return inicios[i];
+    }
+
+    uint32_t getTamanho(size_t i) const {
+        return tamanhos[i];
+    }
+
+    string getLexema(size_t i) const {
+        return codigo->substr(inicios[i], tamanhos[i]);
+    }
+
+    Token operator[](size_t i) const {
+        return Token(getTipo(i), codigo->data() + inicios[i], tamanhos[i]);
+    }
+
+    // Bytes ocupados pelos tokens (sem contar o código-fonte)
+    size_t getBytes() const {
+        return tipos.size() * (sizeof(uint8_t) + 2 * sizeof(uint32_t));
+    }
+
+private:
+    const string *codigo;
+    vector<uint8_t> tipos;
+    vector<uint32_t> inicios;
+    vector<uint32_t> tamanhos;
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef GVN_H
+#define GVN_H
+
+#include "IR.h"
+
+using namespace std;
+
+// Numeração global de valores (GVN) sobre a IR em SSA: elimina
+// computações puras repetidas (subexpressões comuns), inclusive entre
+// statements e entre blocos.
+//
+// Os blocos são visitados em pré-ordem da árvore de dominância com uma
+// tabela hash com escopo: uma instrução só pode ser substituída por outra
+// equivalente de um bloco que a domina. Operações comutativas têm os
+// operandos normalizados (a * b == b * a) e "a > b" é tratado como "b < a".
+// PHIs cujos operandos são todos o mesmo valor também são eliminados.
+class GVN
+{
+public:
+  GVN();
+  void otimizar(ProgramaIR *programa);
+  void otimizarFuncao(FuncaoIR &funcao);
+  // Número de instruções eliminadas na última execução
+  int getEliminadas() const { return eliminadas; }
+
+private:
+  int eliminadas;
+};
+
+#endif // GVN_H
@@ -0,0 +1,146 @@
+#ifndef IR_H
+#define IR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "TipoDeDado.h"
+
+using namespace std;
+
+// Representação intermediária: grafo de fluxo de controle (CFG) de blocos
+// básicos em forma SSA.
+//
+// As instruções de uma função ficam num único vetor (arena) e são
+// identificadas pelo seu índice, que também identifica o valor produzido.
+// Os operandos de todas as instruções ficam contíguos em outro vetor; cada
+// instrução guarda apenas o intervalo dos seus. Assim, construir a IR de
+// uma função enorme custa poucas alocações.
+enum class OpIR : uint8_t
+{
+  // Valores
+  CONST_INT,     // imediato
+  CONST_REAL,    // real
+  CONST_STRING,  // imediato = índice em FuncaoIR::strings
+  PARAM,         // imediato = índice do parâmetro
+  INDEFINIDO,    // valor de variável lida antes de qualquer atribuição (zero)
+  ADD,           // em string, concatenação
+  SUB,
+  MUL,
+  DIV,
+  LT,            // comparações resultam em int (0 ou 1)
+  GT,
+  LE,
+  GE,
+  EQ,
+  NE,
+  NOT,
+  INT_TO_DOUBLE,
+  PHI,           // um operando por predecessor, na ordem de BlocoIR::predecessores
+  CALL,          // imediato = índice da função; operandos = argumentos
+  CALL_BUILTIN,  // imediato = índice em BUILTINS; operandos = argumentos
+  LOAD_GLOBAL,   // imediato = slot global
+  STORE_GLOBAL,  // imediato = slot global; operando = valor
+  // Arrays: o valor do array é o endereço dos seus elementos
+  NEW_ARRAY,     // imediato = número de elementos, todos zerados
+  LOAD_ELEM,     // operandos = array, índice; imediato = tamanho a verificar, ou -1
+                 // se o BoundsCheckEliminator provou que o índice está no array
+  STORE_ELEM,    // operandos = array, índice, valor; imediato como em LOAD_ELEM
+  // Acesso a variáveis locais antes da conversão para SSA (removidos por converterParaSSA)
+  LOAD_LOCAL,    // imediato = slot
+  STORE_LOCAL,   // imediato = slot; operando = valor
+  // Terminadores: os destinos ficam em BlocoIR::sucessores
+  JUMP,
+  BRANCH,        // operando = condição; sucessores[0] se verdadeira, [1] se falsa
+  RETURN,        // operando opcional = valor retornado
+  REMOVIDA       // instrução apagada (permanece na arena, fora de qualquer bloco)
+};
+
+struct InstrucaoIR
+{
+  OpIR op;
+  TipoDeDado tipo; // tipo do valor produzido (VOID se não produz valor)
+  int32_t bloco;
+  uint32_t primeiroOperando;
+  uint32_t numOperandos;
+  union
+  {
+    int64_t imediato;
+    double real;
+  };
+};
+
+struct BlocoIR
+{
+  vector<uint32_t> instrucoes; // PHIs primeiro; a última é o terminador
+  vector<int> predecessores;
+  vector<int> sucessores;
+  int idom = -1;               // dominador imediato (-1 na entrada)
+  vector<int> filhosDominancia;
+};
+
+class FuncaoIR
+{
+public:
+  string nome;
+  TipoDeDado tipoRetorno = TipoDeDado::VOID;
+  vector<TipoDeDado> tiposParametros;
+  // Tipo de cada slot local (os do quadro da função seguidos dos temporários da IR)
+  vector<TipoDeDado> tiposSlots;
+  vector<string> strings;
+
+  vector<InstrucaoIR> instrucoes;
+  vector<uint32_t> operandos;
+  vector<BlocoIR> blocos;
+  bool emSSA = false;
+
+  int criarBloco();
+  void ligar(int de, int para);
+  // Retira a aresta pred -> bloco da lista de predecessores de bloco e o
+  // operando correspondente dos seus PHIs
+  void removerPredecessor(int bloco, int pred);
+  // Cria uma instrução no fim do bloco
+  uint32_t adicionar(int bloco, OpIR op, TipoDeDado tipo, const uint32_t *ops = nullptr, uint32_t numOps = 0, int64_t imediato = 0);
+  uint32_t adicionar(int bloco, OpIR op, TipoDeDado tipo, uint32_t op1, int64_t imediato = 0);
+  uint32_t adicionarBinaria(int bloco, OpIR op, TipoDeDado tipo, uint32_t op1, uint32_t op2);
+  uint32_t constanteInteira(int bloco, int64_t valor);
+  uint32_t constanteReal(int bloco, double valor);
+  // Cria uma instrução sem inseri-la em nenhum bloco
+  uint32_t criarInstrucao(OpIR op, TipoDeDado tipo, int bloco, const uint32_t *ops, uint32_t numOps, int64_t imediato = 0);
+
+  uint32_t operando(uint32_t instrucao, uint32_t i) const { return operandos[instrucoes[instrucao].primeiroOperando + i]; }
+  void setOperando(uint32_t instrucao, uint32_t i, uint32_t valor) { operandos[instrucoes[instrucao].primeiroOperando + i] = valor; }
+  bool isTerminado(int bloco) const;
+  uint32_t terminador(int bloco) const { return blocos[bloco].instrucoes.back(); }
+
+  // Remove blocos inalcançáveis a partir da entrada, renumerando os demais
+  void removerBlocosInalcancaveis();
+  // Insere um bloco vazio em toda aresta de um bloco com vários sucessores
+  // para um bloco com vários predecessores
+  void dividirArestasCriticas();
+  // Blocos em pós-ordem reversa a partir da entrada
+  vector<int> ordemReversaPosOrdem() const;
+
+  int numInstrucoesVivas() const;
+  string toString() const;
+};
+
+class ProgramaIR
+{
+public:
+  ~ProgramaIR();
+  vector<FuncaoIR *> funcoes; // mesma ordem de ProgramNode::getFunctions()
+  vector<TipoDeDado> tiposGlobais;
+  string toString() const;
+};
+
+string opIRParaString(OpIR op);
+bool isTerminadorIR(OpIR op);
+// Instruções sem efeitos colaterais, cujo resultado depende só dos operandos
+bool isPuraIR(OpIR op);
+// Instruções puras que ainda assim podem lançar um erro de execução (uma
+// divisão inteira cujo divisor não é uma constante não nula): não podem
+// ser removidas mesmo sem uso
+bool podeFalharIR(const FuncaoIR &funcao, uint32_t id);
+
+#endif // IR_H
@@ -0,0 +1,61 @@
+#ifndef IRBUILDER_H
+#define IRBUILDER_H
+
+#include <string>
+#include "AST.h"
+#include "IR.h"
+
+using namespace std;
+
+// Traduz a AST tipada (após Resolver e TypeChecker) para a IR.
+//
+// As variáveis locais são primeiro traduzidas como LOAD_LOCAL/STORE_LOCAL
+// sobre os slots do quadro; converterParaSSA (SSA.h) as promove a valores
+// SSA com PHIs. Variáveis globais continuam sendo acessadas pela memória.
+// Um array é um valor com o endereço dos seus elementos, criado por
+// NEW_ARRAY na declaração; os acessos levam o tamanho declarado quando o
+// índice precisa ser verificado.
+class IRBuilder
+{
+public:
+  IRBuilder();
+  // Gera a IR de todas as funções do programa
+  ProgramaIR *construir(ProgramNode *program, bool ssa = true);
+  FuncaoIR *construirFuncao(ProgramNode *program, FunctionNode *function, bool ssa = true);
+  // Versão da função que começa no cabeçalho do laço "laco" (for ou while
+  // do corpo da função), usada para trocar de camada no meio de um laço: os
+  // parâmetros são todos os slots do quadro, com os valores do momento
+  FuncaoIR *construirEntradaDeLaco(ProgramNode *program, FunctionNode *function, StatementNode *laco, bool ssa = true);
+
+private:
+  ProgramNode *programa;
+  FuncaoIR *funcao;
+  int blocoAtual;
+  StatementNode *lacoDeEntrada;
+  int cabecalhoDeEntrada;
+  // Tamanho declarado dos arrays, por slot (-1 nos demais)
+  vector<int64_t> tamanhosGlobais;
+  vector<int64_t> tamanhosLocais;
+
+  FuncaoIR *gerarFuncao(ProgramNode *program, FunctionNode *function, StatementNode *laco, bool ssa);
+  void gerarBloco(BlockNode *block);
+  void gerarStatement(StatementNode *stmt);
+  uint32_t gerarExpressao(ExpressionNode *expr);
+  uint32_t gerarBinaria(BinaryOpNode *binary);
+  uint32_t gerarLogica(BinaryOpNode *binary);
+  uint32_t gerarIncremento(UnaryOpNode *unary);
+
+  uint32_t carregar(Binding binding, TipoDeDado tipo);
+  void armazenar(Binding binding, uint32_t valor);
+  TipoDeDado tipoDaVariavel(Binding binding) const;
+  uint32_t carregarElemento(ArrayAccessNode *access);
+  void armazenarElemento(Binding binding, ExpressionNode *index, bool verificar, uint32_t valor);
+  int64_t tamanhoDoArray(Binding binding);
+  uint32_t valorPadrao(TipoDeDado tipo);
+  int novoTemporario(TipoDeDado tipo);
+  void saltarPara(int destino);
+
+  void erro(const string &msg);
+};
+
+#endif // IRBUILDER_H
@@ -0,0 +1,60 @@
+#ifndef INLINER_H
+#define INLINER_H
+
+#include <vector>
+#include "AST.h"
+#include "CallGraph.h"
+
+using namespace std;
+
+// Expansão de funções (inlining) sobre a AST tipada: substitui chamadas a
+// funções pequenas e não recursivas pelo corpo da função chamada.
+//
+// Na chamada "f(a, b)" dentro de um statement S, são inseridos antes de S:
+// uma declaração por parâmetro, inicializada com o argumento; uma cópia do
+// corpo de f com os slots deslocados para depois dos slots do chamador; e,
+// no lugar do return final, a declaração de um temporário com o valor
+// retornado, que substitui a chamada em S. Assim nenhum nome colide e o
+// quadro do chamador cresce com o quadro de f.
+//
+// Só são expandidas funções cujo único return é o último statement do
+// corpo, e chamadas cuja antecipação não muda a ordem de efeitos visíveis:
+// o restante de S não pode chamar funções nem ler variáveis globais, e a
+// chamada não pode estar no lado direito de && / || nem em condições de
+// laços. As funções são processadas dos chamados para os chamadores.
+class Inliner
+{
+public:
+  // limiteDeTamanho: número máximo de nós da AST no corpo da função
+  // chamada; dentro de laços o limite é dobrado. 0 desativa a expansão.
+  Inliner(int limiteDeTamanho = 40);
+  void otimizar(ProgramNode *program);
+  int getExpansoes() const { return expansoes; }
+
+private:
+  int limiteDeTamanho;
+  int expansoes;
+  ProgramNode *programa;
+  CallGraph grafo;
+  FunctionNode *chamador;
+
+  void expandirBloco(BlockNode *block, int profundidade, bool emLaco);
+  bool expandirStatement(StatementNode *stmt, int profundidade, bool emLaco, vector<StatementNode *> &antes, StatementNode *&resultado);
+  bool isExpansivel(int indice, bool emLaco);
+
+  // Cópia profunda com slots locais deslocados
+  struct Deslocamento
+  {
+    int slot;
+    int profundidade;
+  };
+  ExpressionNode *clonar(ExpressionNode *expr, Deslocamento d);
+  StatementNode *clonar(StatementNode *stmt, Deslocamento d);
+  BlockNode *clonar(BlockNode *block, Deslocamento d);
+  Binding deslocar(Binding binding, Deslocamento d);
+};
+
+// Número de nós da AST (statements e expressões) sob o nó
+int tamanhoDaAst(ASTNode *node);
+
+#endif // INLINER_H
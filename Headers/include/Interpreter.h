@@ -0,0 +1,98 @@
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "AST.h"
+#include "Jit.h"
+#include "Valor.h"
+
+using namespace std;
+
+// Execução em camadas da AST analisada (Resolver e TypeChecker).
+//
+// Toda função começa interpretada, percorrendo a árvore, que não tem custo
+// de preparação. Contadores por função (chamadas) e por laço (iterações do
+// corpo de for e while) medem o que está quente: uma função chamada
+// limiteDeChamadas vezes é compilada pelo Jit, e as chamadas seguintes vão
+// direto para o código nativo. Um laço que passa de limiteDeIteracoes
+// iterações numa mesma execução troca de camada no meio: o quadro atual é
+// passado para uma versão compilada da função que começa no cabeçalho do
+// laço (Jit::compilarEntradaDeLaco) e que termina a função.
+//
+// Funções que o Jit não aceita (strings, globais, código de nível de
+// programa) continuam interpretadas; a tentativa é feita uma só vez.
+class Interpreter
+{
+public:
+  Interpreter(ProgramNode *program, bool usarJit = true);
+
+  // Executa o código de nível de programa e depois a função main (se
+  // existir, sem parâmetros), retornando o valor de main
+  Valor executar();
+  Valor chamar(int indice, const vector<Valor> &argumentos);
+
+  void setLimites(int chamadas, int iteracoes);
+
+  int getChamadasInterpretadas() const { return chamadasInterpretadas; }
+  int getChamadasNativas() const { return chamadasNativas; }
+  int getPromocoes() const { return promocoes; }
+  int getEntradasDeLaco() const { return entradasDeLaco; }
+  long long getIteracoesInterpretadas() const { return iteracoesInterpretadas; }
+  const Jit &getJit() const { return jit; }
+
+private:
+  enum class Fluxo
+  {
+    NORMAL,
+    RETORNO
+  };
+
+  struct PerfilDeFuncao
+  {
+    int chamadas = 0;
+    bool tentouCompilar = false;
+  };
+
+  struct PerfilDeLaco
+  {
+    int iteracoes = 0; // na execução atual do laço
+    int entrada = -1;  // entrada compilada do Jit
+    bool falhou = false;
+  };
+
+  ProgramNode *programa;
+  Jit jit;
+  bool usarJit;
+  int limiteDeChamadas;
+  int limiteDeIteracoes;
+
+  vector<Valor> globais;
+  vector<Valor> *quadro; // slots da função em execução
+  int funcaoAtual;
+  Valor retorno;
+  vector<PerfilDeFuncao> perfis;
+  unordered_map<StatementNode *, PerfilDeLaco> lacos;
+  TabelaDeLiterais literais;
+
+  int chamadasInterpretadas;
+  int chamadasNativas;
+  int promocoes;
+  int entradasDeLaco;
+  long long iteracoesInterpretadas;
+
+  Valor interpretar(int indice, const vector<Valor> &argumentos);
+  Valor chamarNativa(int indice, const vector<Valor> &argumentos);
+  bool trocarDeCamada(StatementNode *laco, PerfilDeLaco &perfil);
+
+  Fluxo executarBloco(BlockNode *block);
+  Fluxo executarStatement(StatementNode *stmt);
+  Valor avaliar(ExpressionNode *expr);
+  Valor avaliarBinaria(BinaryOpNode *binary);
+  Valor &variavel(Binding binding);
+  // "array[index] = valor", com verificação do índice se "verificar"
+  void atribuirElemento(Binding binding, ExpressionNode *index, bool verificar, const Valor &valor);
+};
+
+#endif // INTERPRETER_H
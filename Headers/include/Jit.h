@@ -0,0 +1,84 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AST.h"
+#include "CallGraph.h"
+
+using namespace std;
+
+// Função compilada: recebe os argumentos num vetor de 64 bits (inteiros, ou
+// os bits de um double) e retorna o resultado da mesma forma
+typedef uint64_t (*FuncaoNativa)(const uint64_t *argumentos);
+
+uint64_t bitsDeReal(double valor);
+double realDeBits(uint64_t bits);
+
+// Compilador just-in-time para x86-64: traduz funções da AST analisada
+// (Resolver e TypeChecker) para código de máquina em páginas mapeadas com
+// mmap, sem montador externo, para serem chamadas por ponteiro de função.
+//
+// Cada função passa pelo mesmo caminho da compilação antecipada: IRBuilder,
+// GVN, LoopOptimizer, eliminação de código morto e o RegisterAllocator. As
+// arestas críticas são divididas, de modo que as cópias dos PHIs ficam no
+// fim do predecessor (ou no início do sucessor, se ele tem um só
+// predecessor), resolvidas como cópias paralelas.
+//
+// São compiláveis funções que só usam int, double e arrays locais deles
+// (com os elementos no quadro da função), sem variáveis globais, e que só
+// chamam funções também compiláveis; as chamadas entre funções
+// compiladas passam por uma tabela, o que permite compilar sob demanda e em
+// qualquer ordem. Funções embutidas são chamadas diretamente pela sua
+// versão em bits (Builtin::emBits). O código é escrito com as páginas graváveis e só depois
+// elas passam a executáveis (nunca as duas coisas ao mesmo tempo).
+//
+// Erros de execução no código nativo (divisão inteira por zero, índice fora
+// do array) voltam por longjmp até chamar(), que lança runtime_error.
+class Jit
+{
+public:
+  Jit(ProgramNode *program);
+  ~Jit();
+  Jit(const Jit &) = delete;
+  Jit &operator=(const Jit &) = delete;
+
+  // Compila a função (e as que ela chama, ainda não compiladas); retorna
+  // false se ela não é compilável, com o motivo em getMotivo()
+  bool compilar(int indice);
+  bool isCompilada(int indice) const { return tabela[indice] != nullptr; }
+  const string &getMotivo(int indice) const { return motivos[indice]; }
+  FuncaoNativa getFuncao(int indice) const { return tabela[indice]; }
+  uint64_t chamar(int indice, const uint64_t *argumentos);
+
+  // Compila uma versão da função que começa no cabeçalho do laço (for ou
+  // while do seu corpo) e recebe todos os slots do quadro como argumentos,
+  // para continuar em código nativo uma execução que está no meio do laço;
+  // retorna o identificador da entrada, ou -1 com o motivo em "motivo"
+  int compilarEntradaDeLaco(int indice, StatementNode *laco, string &motivo);
+  // Executa até o fim da função e retorna o seu valor
+  uint64_t chamarEntradaDeLaco(int entrada, const uint64_t *slots);
+
+  int getCompiladas() const { return compiladas; }
+  size_t getBytesDeCodigo() const { return bytesDeCodigo; }
+
+private:
+  ProgramNode *programa;
+  CallGraph grafo;
+  // Endereço de cada função compilada; o código gerado lê daqui nas
+  // chamadas, por isso o vetor nunca muda de tamanho
+  vector<FuncaoNativa> tabela;
+  vector<string> motivos;
+  vector<FuncaoNativa> entradas; // entradas de laço
+  vector<pair<void *, size_t>> regioes; // páginas mapeadas
+  int compiladas;
+  size_t bytesDeCodigo;
+
+  // Copia o código para páginas novas e as torna executáveis
+  uint8_t *instalar(const vector<uint8_t> &codigo);
+  uint64_t executarNativo(FuncaoNativa funcao, const uint64_t *argumentos);
+};
+
+#endif // JIT_H
@@ -1,7 +1,8 @@
 #ifndef LEXER_H
 #define LEXER_H
 
-#include "Token.h"
+#include "AnelDeTokens.h"
+#include "FluxoDeTokens.h"
 #include <string>
 #include <vector>
 
@@ -10,15 +11,48 @@ using namespace std;
 class Lexer
 {
 public:
+    Lexer();
     Lexer(const string& codigo);
-    vector<Token> Analisar();
+    Lexer(const Lexer&) = delete; // o fluxo aponta para o próprio código
+    Lexer& operator=(const Lexer&) = delete;
+    // Troca o código-fonte para reaproveitar o Lexer em outro programa; o
+    // fluxo de tokens e os buffers do código e do lexema mantêm a
+    // capacidade já alocada
+    void reset(const string& codigo);
+    // Os tokens (e os lexemas, que apontam para o código) ficam no Lexer
+    // até o próximo reset
+    const FluxoDeTokens& Analisar();
+    // Mesmo resultado de Analisar(), dividindo um código grande em trechos
+    // analisados em paralelo por até numThreads threads (0: uma por núcleo).
+    // Cada trecho começa logo depois de um espaço e é analisado supondo que
+    // não começa dentro de uma string; os trechos são conferidos em ordem e
+    // os que começavam dentro de uma string são analisados de novo a partir
+    // da aspa que a abriu
+    const FluxoDeTokens& AnalisarEmParalelo(int numThreads = 0);
+    // Trechos analisados de novo na última AnalisarEmParalelo()
+    int getTrechosRefeitos() const { return trechosRefeitos; }
+    // Produtor da análise em pipeline (Parser::analisarEmPipeline): envia
+    // os tokens ao anel em lotes enquanto analisa e fecha o anel no fim, com
+    // a mensagem do erro se houver. O fluxo do Lexer fica só com o último lote
+    void AnalisarParaAnel(AnelDeTokens& anel);
+    const string& getCodigo() const { return fonte; }
 
 private:
-    vector<Token> tokens;
+    FluxoDeTokens tokens;
     int i, estado_atual;
-    string lexema, codigo;
+    string lexema, fonte;
+    const char *codigo; // o código analisado (de outro Lexer, num trecho)
+    int fim;            // fim do trecho analisado
+    bool emTrecho;      // há código depois de "fim"
+    int stringAberta;   // aspa de uma string que passa de "fim", ou -1
+    int trechosRefeitos;
+    AnelDeTokens *anel; // destino dos lotes, na análise em pipeline
 
     void inicializar();
+    void percorrer();
+    void analisarTrecho(const string& fonte, int inicio, int fim, bool emTrecho);
+    void adicionar(TipoDeToken tipo);
+    void adicionar(TipoDeToken tipo, size_t inicio, size_t tamanho);
     void q0();
     void q1();
     void q2();
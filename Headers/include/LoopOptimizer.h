@@ -0,0 +1,51 @@
+#ifndef LOOPOPTIMIZER_H
+#define LOOPOPTIMIZER_H
+
+#include <vector>
+#include "IR.h"
+
+using namespace std;
+
+// Otimizações de laços sobre a IR em SSA (executar depois do GVN):
+// - movimentação de código invariante (LICM): computações puras cujos
+//   operandos são definidos fora do laço vão para o pré-cabeçalho
+// - redução de força: "i * k", com i variável de indução (i = i + c) e k
+//   invariante, vira uma nova variável de indução incrementada de c * k
+//
+// Os laços são os laços naturais das arestas de retorno (b -> h, com h
+// dominando b), processados dos mais internos para os mais externos.
+// Só são otimizados laços cujo cabeçalho tem um único predecessor de fora
+// do laço, terminado por um salto incondicional (o pré-cabeçalho), como os
+// gerados pelo IRBuilder para while e for.
+class LoopOptimizer
+{
+public:
+  LoopOptimizer();
+  void otimizar(ProgramaIR *programa);
+  void otimizarFuncao(FuncaoIR &funcao);
+  int getInvariantesMovidas() const { return invariantesMovidas; }
+  int getReducoesDeForca() const { return reducoesDeForca; }
+
+private:
+  struct Laco
+  {
+    int cabecalho;
+    int preCabecalho;
+    vector<int> blocos;
+    vector<bool> contem; // por bloco
+  };
+
+  int invariantesMovidas;
+  int reducoesDeForca;
+  FuncaoIR *funcao;
+  vector<uint32_t> substituto;
+
+  vector<Laco> encontrarLacos();
+  void moverInvariantes(Laco &laco);
+  void reduzirForca(Laco &laco);
+  bool isInvariante(const Laco &laco, uint32_t valor) const;
+  uint32_t inserirNoFim(int bloco, OpIR op, TipoDeDado tipo, uint32_t a, uint32_t b);
+  uint32_t valor(uint32_t id) const;
+};
+
+#endif // LOOPOPTIMIZER_H
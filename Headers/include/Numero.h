@@ -0,0 +1,26 @@
+#ifndef NUMERO_H
+#define NUMERO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Conversão de lexemas numéricos para valores nativos, feita uma única vez
+// pelo parser. As funções não alocam memória: trabalham diretamente sobre
+// os caracteres do lexema.
+
+// Converte uma sequência de dígitos decimais. Retorna false em caso de
+// estouro do intervalo de int64_t.
+bool converterInteiro(const char *texto, size_t tamanho, int64_t &resultado);
+
+// Converte um lexema "digitos.digitos". Retorna false se o valor não é
+// representável como double finito.
+bool converterReal(const char *texto, size_t tamanho, double &resultado);
+
+// Menor representação decimal que reproduz exatamente o valor, sempre com
+// ponto decimal (ex: "9.75", "2.0")
+string formatarReal(double valor);
+
+#endif
@@ -2,7 +2,8 @@
 #define PARSER_H
 
 #include <vector>
-#include "Token.h"
+#include "AnelDeTokens.h"
+#include "FluxoDeTokens.h"
 #include "AST.h"
 
 using namespace std;
@@ -15,19 +16,34 @@ class ProgramNode;
 class FunctionNode;
 class VariableDeclarationNode;
 class ParameterNode;
+class Lexer;
 
 class Parser
 {
 public:
-  Parser(vector<Token> tokens);
+  Parser();
+  // Os tokens não são copiados: o fluxo (e o Lexer que o produziu) deve
+  // existir enquanto o Parser analisa
+  Parser(const FluxoDeTokens &tokens);
+  // Troca os tokens para reaproveitar o Parser em outro programa
+  void reset(const FluxoDeTokens &tokens);
   ProgramNode *analisar();
+  // Análise em pipeline: o Lexer roda em outra thread e entrega os tokens
+  // em lotes por um AnelDeTokens, consumidos pelo Parser enquanto o Lexer
+  // continua. O resultado e os erros são os de lexer.Analisar() seguido de
+  // analisar(): um erro léxico tem precedência sobre um erro sintático
+  ProgramNode *analisarEmPipeline(Lexer &lexer);
 
 private:
-  vector<Token> tokens;
+  const FluxoDeTokens *tokens;
+  AnelDeTokens *anel;   // só na análise em pipeline
+  FluxoDeTokens janela; // tokens recebidos do anel que ainda podem ser lidos
+  int base;             // posição do primeiro token de "janela"
   int posicao_atual;
   Token token_atual;
 
   void avancar();
+  void descartarLidos();
   void erro(string msg);
 
   // Parsing de expressões (retornam AST)
@@ -57,7 +73,8 @@ private:
 
   // Verificadores de tokens
   bool isTipo(const Token &token);
-  bool isPalavraReservada(const string &palavra);
+  bool isInicioDeFuncao();
+  bool isPalavraReservada(const char *palavra);
 };
 
 #endif // PARSER_H
@@ -0,0 +1,48 @@
+#ifndef PEEPHOLEOPTIMIZER_H
+#define PEEPHOLEOPTIMIZER_H
+
+#include <vector>
+#include "Bytecode.h"
+
+using namespace std;
+
+// Otimização peephole do bytecode: sequências curtas e frequentes viram uma
+// única superinstrução, reduzindo o número de despachos da VM.
+//
+// Candidatas:
+// - load @a; load @b; add_int           -> add_int_ll @a, @b
+// - load @s; const k; add/sub_int; store @s -> inc_local @s, ±k ("i++", "i = i + 1")
+// - <comparação inteira>; jmp_if_false  -> jmp_if_not_cmp
+// - load @a; load @b                     -> load2 @a, @b
+// - load @a; const k                     -> load_const @a, k
+// - load @i; load_elem[_nc] @a (local)   -> load_elem_l[_nc] @a[@i]
+//
+// Com um perfil da VM, só são usadas as superinstruções cujos pares de
+// operações somam pelo menos "limiar" dos despachos perfilados; sem perfil,
+// todas. Uma sequência nunca é fundida se uma instrução do meio é destino
+// de salto.
+class PeepholeOptimizer
+{
+public:
+  PeepholeOptimizer(const PerfilBC *perfil = nullptr, double limiar = 0.01);
+  void otimizar(ProgramaBC *programa);
+  void otimizarFuncao(FuncaoBC &funcao);
+
+  // Superinstruções habilitadas, da mais para a menos frequente no perfil
+  const vector<OpBC> &getSuperinstrucoes() const { return habilitadas; }
+  // Sequências fundidas e instruções eliminadas na última execução
+  int getFusoes() const { return fusoes; }
+  int getRemovidas() const { return removidas; }
+
+private:
+  vector<OpBC> habilitadas;
+  int fusoes;
+  int removidas;
+
+  bool isHabilitada(OpBC super) const;
+  // Tenta fundir a sequência que começa em codigo[i]; retorna o número de
+  // instruções consumidas (0 se nenhuma superinstrução se aplica)
+  int fundir(FuncaoBC &funcao, size_t i, const vector<bool> &destinos, vector<InstrucaoBC> &saida);
+};
+
+#endif // PEEPHOLEOPTIMIZER_H
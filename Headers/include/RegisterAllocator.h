@@ -0,0 +1,102 @@
+#ifndef REGISTERALLOCATOR_H
+#define REGISTERALLOCATOR_H
+
+#include <string>
+#include <vector>
+#include "IR.h"
+
+using namespace std;
+
+// Alocação de registradores por varredura linear (linear scan, Poletto e
+// Sarkar) sobre a IR em SSA, para a geração de código x86-64.
+//
+// Os blocos são dispostos em pós-ordem reversa e as instruções numeradas
+// nessa ordem; cada valor recebe um intervalo [definição, último ponto em
+// que está vivo], calculado pela análise de vivacidade (Dataflow.h). Os
+// intervalos são percorridos em ordem de início: quando não há registrador
+// livre, vai para a pilha o intervalo de menor custo de spill por unidade de
+// comprimento, onde o custo soma os usos e a definição pesados por 10 elevado
+// à profundidade de laço (constantes custam menos: são rematerializáveis).
+//
+// Em funções com muitos valores e blocos, a vivacidade por bits ficaria cara
+// (valores x blocos); acima do limite usa-se o modo rápido: o intervalo vai
+// da definição ao último uso, estendido até o fim de cada laço em cujo
+// cabeçalho o valor está vivo, e o spill escolhe o intervalo que termina mais
+// tarde.
+//
+// Os operandos de um PHI são usados no fim do predecessor correspondente; as
+// cópias paralelas nas arestas ficam a cargo do gerador de código.
+enum class ClasseRegistrador
+{
+  INTEIRO, // int e string (ponteiro)
+  REAL     // double, em registradores SSE
+};
+
+ClasseRegistrador classeDoTipo(TipoDeDado tipo);
+
+// Registradores alocáveis. rax, rcx, rdx e rdi ficam com o gerador de código
+// (temporários, divisão e ponteiro dos argumentos), assim como xmm14 e xmm15.
+// Os inteiros de índice >= PRIMEIRO_PRESERVADO são preservados entre
+// chamadas (callee-saved); os demais e todos os SSE não são.
+const int NUM_REGISTRADORES_INTEIROS = 10;
+const int NUM_REGISTRADORES_REAIS = 14;
+const int PRIMEIRO_PRESERVADO = 5;
+
+string nomeDoRegistrador(ClasseRegistrador classe, int registrador);
+// Número do registrador na codificação das instruções x86-64
+int codigoDoRegistrador(ClasseRegistrador classe, int registrador);
+
+struct Alocacao
+{
+  // Por instrução: registrador do valor (índice na sua classe) ou -1, e o
+  // slot de 8 bytes na pilha dos valores que não couberam (-1 se nenhum)
+  vector<int> registrador;
+  vector<int> slotDePilha;
+  vector<int> ordemDosBlocos;
+  int numSlotsDePilha = 0;
+  int emRegistrador = 0;
+  int naPilha = 0;
+  bool modoRapido = false;
+};
+
+class RegisterAllocator
+{
+public:
+  // limiteDeBits: acima de valores x blocos, usa o modo rápido
+  RegisterAllocator(size_t limiteDeBits = size_t(1) << 24);
+  vector<Alocacao> alocar(ProgramaIR *programa);
+  Alocacao alocarFuncao(FuncaoIR &funcao);
+  int getEmRegistrador() const { return emRegistrador; }
+  int getNaPilha() const { return naPilha; }
+  int getFuncoesNoModoRapido() const { return funcoesNoModoRapido; }
+
+private:
+  struct Intervalo
+  {
+    uint32_t valor;
+    int inicio;
+    int fim;
+    ClasseRegistrador classe;
+    double custo;
+    bool cruzaChamada;
+  };
+
+  size_t limiteDeBits;
+  int emRegistrador;
+  int naPilha;
+  int funcoesNoModoRapido;
+
+  void calcularPosicoes(const FuncaoIR &funcao, const vector<int> &ordem, vector<int> &posicao, vector<int> &inicioDoBloco, vector<int> &fimDoBloco);
+  vector<int> calcularProfundidades(FuncaoIR &funcao, vector<int> &fimDoLaco, const vector<int> &fimDoBloco);
+  void varrer(vector<Intervalo> &intervalos, bool modoRapido, Alocacao &alocacao);
+};
+
+// Número de pares de valores simultaneamente vivos (segundo a análise de
+// vivacidade) que receberam o mesmo registrador ou o mesmo slot na pilha; 0
+// numa alocação correta
+int contarConflitos(const FuncaoIR &funcao, const Alocacao &alocacao);
+
+// Lista "%id: registrador" ou "%id: [pilha n]" por valor, em ordem de bloco
+string formatarAlocacao(const FuncaoIR &funcao, const Alocacao &alocacao);
+
+#endif // REGISTERALLOCATOR_H
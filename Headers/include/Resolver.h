@@ -0,0 +1,57 @@
+#ifndef RESOLVER_H
+#define RESOLVER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "AST.h"
+
+using namespace std;
+
+// Análise semântica de nomes: liga cada uso de variável a um par
+// (profundidade, slot) e cada chamada ao índice da função chamada (ou da
+// função embutida, se o programa não declara uma com o mesmo nome),
+// anotando a AST para que os backends não precisem buscar nomes em tempo
+// de execução.
+//
+// Profundidade 0 é o escopo global (declarações das funções "__global__");
+// 1 é o escopo dos parâmetros e do bloco principal de cada função; blocos
+// aninhados incrementam a profundidade. Slots locais são únicos dentro da
+// função (não são reaproveitados entre blocos irmãos).
+class Resolver
+{
+public:
+  Resolver();
+  void analisar(ProgramNode *program);
+
+private:
+  struct Simbolo
+  {
+    int depth;
+    int slot;
+  };
+
+  // Pilha de escopos com hash: cada nome aponta para a pilha das suas
+  // declarações visíveis (a do topo é a mais interna)
+  unordered_map<string, vector<Simbolo>> simbolos;
+  // Nomes declarados em cada escopo aberto, para desempilhar ao fechar
+  vector<vector<string>> escopos;
+  unordered_map<string, int> funcoes;
+  int proximoSlot;
+  int numGlobais;
+
+  void abrirEscopo();
+  void fecharEscopo();
+  Binding declarar(const string &name);
+  Binding buscar(const string &name);
+
+  void resolverFuncao(FunctionNode *function);
+  void resolverBloco(BlockNode *block);
+  void resolverStatements(BlockNode *block);
+  void resolverStatement(StatementNode *stmt);
+  void resolverExpressao(ExpressionNode *expr);
+
+  void erro(const string &msg);
+};
+
+#endif // RESOLVER_H
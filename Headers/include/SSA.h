@@ -0,0 +1,25 @@
+#ifndef SSA_H
+#define SSA_H
+
+#include <vector>
+#include "IR.h"
+
+using namespace std;
+
+// Calcula o dominador imediato de cada bloco e a árvore de dominância
+// (algoritmo iterativo de Cooper, Harvey e Kennedy)
+void calcularDominadores(FuncaoIR &funcao);
+
+// Verdadeiro se o bloco a domina o bloco b (requer calcularDominadores)
+bool domina(const FuncaoIR &funcao, int a, int b);
+
+// Fronteira de dominância de cada bloco (requer calcularDominadores)
+vector<vector<int>> calcularFronteirasDeDominancia(const FuncaoIR &funcao);
+
+// Promove os slots locais (LOAD_LOCAL/STORE_LOCAL) a valores SSA: insere
+// PHIs na fronteira de dominância iterada dos blocos que atribuem cada slot
+// (apenas para slots vivos entre blocos, forma SSA semi-podada) e renomeia
+// os usos percorrendo a árvore de dominância.
+void converterParaSSA(FuncaoIR &funcao);
+
+#endif // SSA_H
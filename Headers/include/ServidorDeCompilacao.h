@@ -0,0 +1,112 @@
+#ifndef SERVIDORDECOMPILACAO_H
+#define SERVIDORDECOMPILACAO_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Compilador.h"
+
+using namespace std;
+
+// Servidor de compilação de longa duração num socket Unix local, para
+// clientes que fazem muitas requisições pequenas e pagariam, a cada uma, a
+// criação de um processo e caches frios.
+//
+// Protocolo (várias requisições por conexão, em sequência):
+//   requisição: "<COMANDO> <tamanho>\n" seguido de <tamanho> bytes de código
+//   resposta:   "OK <tamanho>\n<corpo>" ou "ERRO <tamanho>\n<mensagem>"
+// Comandos:
+//   CHECK   só informa se o programa compila; corpo vazio (a unidade
+//           fica no cache para um RUN seguinte)
+//   COMPILE corpo com o bytecode gerado (com a VM)
+//   RUN     corpo com o valor de main numa linha e depois a saída dos prints
+//   STATS   contadores do servidor (sem código, tamanho 0)
+//
+// Uma thread aceita as conexões e as entrega a um conjunto fixo de threads
+// de trabalho; cada uma atende uma conexão até o cliente fechá-la ou ficar
+// mais que o tempo de espera sem enviar nada, para que clientes ociosos não
+// ocupem todas as threads. Cada
+// thread de trabalho tem o seu Compilador, com o cache de unidades (AST,
+// bytecode com os literais internados), que persiste entre conexões: os
+// Valores das unidades têm contagens de referência não atômicas e por isso
+// não são compartilhados entre threads.
+//
+// RUN executa código não confiável dentro do servidor: só é aceito com a
+// VM, que limita a profundidade das chamadas e o número de instruções
+// (OpcoesDoCompilador; sem valores dados, 2000 chamadas e 10^9 instruções).
+// Um programa que passa de um limite recebe ERRO, sem derrubar o servidor
+// nem prender a thread. Com o Interpreter, o código nativo do Jit não teria
+// como ser interrompido, e RUN responde ERRO.
+class ServidorDeCompilacao
+{
+public:
+  ServidorDeCompilacao(const string &caminho, int numThreads = 4, const OpcoesDoCompilador &opcoes = OpcoesDoCompilador());
+  ~ServidorDeCompilacao();
+  ServidorDeCompilacao(const ServidorDeCompilacao &) = delete;
+  ServidorDeCompilacao &operator=(const ServidorDeCompilacao &) = delete;
+
+  // Cria o socket (substituindo um arquivo antigo no caminho) e as threads;
+  // lança runtime_error se não conseguir
+  void iniciar();
+  // Fecha o socket e as conexões abertas e espera as threads terminarem
+  void parar();
+  // Tempo máximo de espera por dados de um cliente (e para enviá-los), em
+  // milissegundos; vale para as conexões aceitas depois da chamada
+  void setTempoDeEspera(int milissegundos) { tempoDeEspera = milissegundos; }
+
+  long long getRequisicoes() const { return requisicoes; }
+  long long getAcertosDoCache() const { return acertosDoCache; }
+  long long getConexoes() const { return conexoes; }
+
+private:
+  string caminho;
+  int numThreads;
+  OpcoesDoCompilador opcoes;
+  atomic<int> tempoDeEspera;
+  int descritor;
+  atomic<bool> ativo;
+  thread aceitacao;
+  vector<thread> trabalhadores;
+
+  mutex trava; // protege "pendentes" e "abertas"
+  condition_variable haConexoes;
+  deque<int> pendentes; // conexões aceitas esperando uma thread
+  set<int> abertas;     // conexões sendo atendidas
+
+  atomic<long long> requisicoes;
+  atomic<long long> acertosDoCache;
+  atomic<long long> conexoes;
+
+  void aceitar();
+  void trabalhar();
+  void atender(int cliente, Compilador &compilador);
+  // Executa um comando; retorna false (com a mensagem em "corpo") em caso de erro
+  bool responder(const string &comando, const string &codigo, Compilador &compilador, string &corpo);
+};
+
+// Cliente do protocolo acima, usado pelos testes e por ferramentas
+class ClienteDeCompilacao
+{
+public:
+  ClienteDeCompilacao();
+  ~ClienteDeCompilacao();
+  ClienteDeCompilacao(const ClienteDeCompilacao &) = delete;
+  ClienteDeCompilacao &operator=(const ClienteDeCompilacao &) = delete;
+
+  // Lança runtime_error se não conseguir conectar
+  void conectar(const string &caminho);
+  // Envia uma requisição e espera a resposta; "ok" diz se foi OK ou ERRO
+  string requisitar(const string &comando, const string &codigo, bool &ok);
+  void desconectar();
+
+private:
+  int descritor;
+  string buffer; // bytes recebidos e ainda não consumidos
+};
+
+#endif // SERVIDORDECOMPILACAO_H
@@ -0,0 +1,79 @@
+#ifndef TIPODEDADO_H
+#define TIPODEDADO_H
+
+#include <string>
+
+using namespace std;
+
+// Tipos da linguagem atribuídos pelo TypeChecker
+enum class TipoDeDado
+{
+    INDEFINIDO,
+    VOID,
+    INT,
+    DOUBLE,
+    STRING,
+    ARRAY_INT,   // int a[N]
+    ARRAY_DOUBLE // double a[N]
+};
+
+inline string tipoDeDadoParaString(TipoDeDado tipo)
+{
+    switch (tipo)
+    {
+        case TipoDeDado::VOID:
+            return "void";
+        case TipoDeDado::INT:
+            return "int";
+        case TipoDeDado::DOUBLE:
+            return "double";
+        case TipoDeDado::STRING:
+            return "string";
+        case TipoDeDado::ARRAY_INT:
+            return "int[]";
+        case TipoDeDado::ARRAY_DOUBLE:
+            return "double[]";
+        default:
+            return "indefinido";
+    }
+}
+
+inline TipoDeDado tipoDeDadoDeString(const string &nome)
+{
+    if (nome == "void")
+        return TipoDeDado::VOID;
+    if (nome == "int")
+        return TipoDeDado::INT;
+    if (nome == "double")
+        return TipoDeDado::DOUBLE;
+    if (nome == "string")
+        return TipoDeDado::STRING;
+    return TipoDeDado::INDEFINIDO;
+}
+
+inline bool isNumerico(TipoDeDado tipo)
+{
+    return tipo == TipoDeDado::INT || tipo == TipoDeDado::DOUBLE;
+}
+
+inline bool isArray(TipoDeDado tipo)
+{
+    return tipo == TipoDeDado::ARRAY_INT || tipo == TipoDeDado::ARRAY_DOUBLE;
+}
+
+// Tipo de um array de elementos "tipo", ou INDEFINIDO se não há arrays dele
+inline TipoDeDado tipoDeArray(TipoDeDado tipo)
+{
+    if (tipo == TipoDeDado::INT)
+        return TipoDeDado::ARRAY_INT;
+    if (tipo == TipoDeDado::DOUBLE)
+        return TipoDeDado::ARRAY_DOUBLE;
+    return TipoDeDado::INDEFINIDO;
+}
+
+inline TipoDeDado tipoDoElemento(TipoDeDado tipo)
+{
+    return tipo == TipoDeDado::ARRAY_DOUBLE ? TipoDeDado::DOUBLE : TipoDeDado::INT;
+}
+
+#endif
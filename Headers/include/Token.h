@@ -2,22 +2,39 @@
 #define TOKEN_H
 
 #include "TipoDeToken.h"
+#include <cstdint>
 #include <string>
 
 using namespace std;
 
+// Token lido de um FluxoDeTokens: o tipo e uma vista do lexema no
+// código-fonte (ponteiro e tamanho), que precisa continuar existindo. O
+// lexema só é copiado para uma string quando pedido
 class Token
 {
 public:
-    Token() : tipo(TipoDeToken::DESCONHECIDO), lexema("") {}
-    Token(TipoDeToken tipo, string lexema) : tipo(tipo), lexema(lexema) {}
+    Token() : tipo(TipoDeToken::DESCONHECIDO), texto(""), tamanho(0) {}
+    Token(TipoDeToken tipo, const char *texto, uint32_t tamanho) : tipo(tipo), texto(texto), tamanho(tamanho) {}
 
     TipoDeToken getTipo() const {
         return tipo;
     }
 
     string getLexema() const {
-        return lexema;
+        return string(texto, tamanho);
+    }
+
+    // Vista do lexema sem cópia
+    const char *getTexto() const {
+        return texto;
+    }
+
+    uint32_t getTamanho() const {
+        return tamanho;
+    }
+
+    bool isLexema(const char *palavra) const {
+        return string::traits_type::length(palavra) == tamanho && string::traits_type::compare(texto, palavra, tamanho) == 0;
     }
 
     static string tipoParaString(TipoDeToken tipo) {
@@ -73,7 +90,8 @@ public:
 
 private:
     TipoDeToken tipo;
-    string lexema;
+    const char *texto;
+    uint32_t tamanho;
 };
 
 #endif
@@ -0,0 +1,51 @@
+#ifndef TYPECHECKER_H
+#define TYPECHECKER_H
+
+#include <string>
+#include <vector>
+#include "AST.h"
+
+using namespace std;
+
+// Verificação e inferência de tipos. Deve ser executado depois do Resolver,
+// pois usa as ligações (profundidade, slot) para descobrir o tipo de cada
+// variável.
+//
+// Ao final, toda ExpressionNode tem um tipo concreto (int, double ou
+// string), conversões int -> double estão explícitas na árvore como
+// ConversionNode e toda condição (if, while, for, operandos de &&, || e !)
+// é do tipo int: condições double são reescritas como "expr != 0.0".
+class TypeChecker
+{
+public:
+  TypeChecker();
+  void analisar(ProgramNode *program);
+
+private:
+  ProgramNode *programa;
+  vector<TipoDeDado> tiposGlobais;
+  vector<TipoDeDado> tiposLocais;
+  TipoDeDado tipoRetorno;
+
+  void verificarFuncao(FunctionNode *function);
+  void verificarBloco(BlockNode *block);
+  void verificarStatement(StatementNode *stmt);
+  ExpressionNode *verificarExpressao(ExpressionNode *expr);
+  ExpressionNode *verificarCondicao(ExpressionNode *expr);
+  ExpressionNode *verificarBinaria(BinaryOpNode *binary);
+  // Escolhe a versão da função embutida pelos tipos dos argumentos
+  void verificarChamadaEmbutida(FunctionCallNode *call);
+  ExpressionNode *converter(ExpressionNode *expr, TipoDeDado destino);
+
+  void registrarVariavel(Binding binding, TipoDeDado tipo);
+  TipoDeDado tipoDaVariavel(Binding binding);
+  TipoDeDado tipoDeclarado(const string &nome);
+  // Tipo dos elementos do array "nome" (erro se a variável não é um array)
+  TipoDeDado tipoDoArray(const string &nome, Binding binding);
+  ExpressionNode *verificarIndice(ExpressionNode *index);
+  bool isLvalue(ExpressionNode *expr);
+
+  void erro(const string &msg);
+};
+
+#endif // TYPECHECKER_H
@@ -0,0 +1,61 @@
+#ifndef VM_H
+#define VM_H
+
+#include <cstdint>
+#include <vector>
+#include "Bytecode.h"
+#include "Valor.h"
+
+using namespace std;
+
+// Máquina virtual de pilha que executa o bytecode do BytecodeCompiler
+// (opcionalmente otimizado pelo PeepholeOptimizer).
+//
+// Locais e operandos dividem uma mesma pilha: numa chamada, os argumentos
+// já empilhados passam a ser os primeiros slots do quadro da função
+// chamada. Com o perfil ligado, cada despacho registra o par (operação
+// anterior, operação atual) da mesma função, que orienta a escolha das
+// superinstruções.
+//
+// As chamadas do bytecode usam a pilha nativa; para executar código que não
+// é confiável (o servidor de compilação), setLimites() limita a profundidade
+// das chamadas e o número de despachos de cada chamada externa, e um
+// programa que passa de um deles termina com runtime_error em vez de
+// estourar a pilha ou não terminar.
+class VM
+{
+public:
+  VM(const ProgramaBC *programa);
+  // Passa a executar outro programa, com as globais zeradas; a pilha
+  // mantém a capacidade já alocada
+  void carregar(const ProgramaBC *programa);
+
+  // Executa o código de nível de programa e depois a função main (se
+  // existir), retornando o valor de main
+  Valor executar();
+  Valor chamar(int indice, const vector<Valor> &argumentos);
+
+  void setPerfilar(bool ativo) { perfilar = ativo; }
+  // 0 desliga o limite (o padrão)
+  void setLimites(int profundidade, uint64_t despachos);
+  const PerfilBC &getPerfil() const { return perfil; }
+  uint64_t getDespachos() const { return despachos; }
+
+private:
+  const ProgramaBC *programa;
+  vector<Valor> globais;
+  vector<Valor> pilha;
+  bool perfilar;
+  PerfilBC perfil;
+  uint64_t despachos;
+  int profundidade; // quadros de executarFuncao ativos
+  int limiteDeProfundidade;
+  uint64_t limiteDeDespachos;
+  uint64_t fimDosDespachos; // valor de "despachos" em que a chamada externa para
+
+  // Executa a função cujo quadro começa em pilha[base], com os argumentos
+  // já nos primeiros slots; ao retornar, a pilha volta ao tamanho base
+  Valor executarFuncao(int indice, size_t base);
+};
+
+#endif // VM_H
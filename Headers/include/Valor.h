@@ -0,0 +1,193 @@
+#ifndef VALOR_H
+#define VALOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TipoDeDado.h"
+
+using namespace std;
+
+// Buffer de uma string longa, compartilhado pelos Valores que o referenciam
+// e liberado quando a última referência deixa de existir. Cada Valor guarda
+// o seu próprio comprimento e enxerga apenas esse prefixo do buffer, o que
+// permite acrescentar ao fim sem afetar os outros (ver Valor::concatenar).
+struct TextoCompartilhado
+{
+  int referencias;
+  string conteudo;
+};
+
+// Elemento de um array: o int ou o double, sem etiqueta
+union Elemento
+{
+  int64_t inteiro;
+  double real;
+};
+
+// Elementos de um array ("int a[N]", "double a[N]"), contíguos em memória
+struct ArranjoCompartilhado
+{
+  int referencias;
+  vector<Elemento> elementos;
+};
+
+// Valor da linguagem durante a execução, usado nos quadros, na pilha da VM
+// e nos argumentos das chamadas: uma palavra de 64 bits com o int, os bits
+// do double ou o texto, e uma etiqueta com o tipo, 16 bytes ao todo.
+//
+// int e double não alocam memória: copiar e operar sobre eles é copiar a
+// palavra. Strings de até CAPACIDADE_CURTA bytes ficam na própria palavra;
+// as maiores apontam para um TextoCompartilhado com contagem de referências,
+// e a cópia só incrementa o contador. Arrays são da mesma forma um ponteiro
+// para os elementos, com o número deles em "comprimento".
+class Valor
+{
+public:
+  static const uint32_t CAPACIDADE_CURTA = 8;
+
+  TipoDeDado tipo;
+  uint32_t comprimento; // de strings e arrays
+  union
+  {
+    int64_t inteiro;
+    double real;
+    TextoCompartilhado *compartilhado;
+    ArranjoCompartilhado *arranjo;
+    char curto[CAPACIDADE_CURTA];
+    uint64_t bits;
+  };
+
+  Valor() : tipo(TipoDeDado::VOID), comprimento(0), bits(0) {}
+  Valor(const Valor &outro) : tipo(outro.tipo), comprimento(outro.comprimento), bits(outro.bits)
+  {
+    reter();
+  }
+  Valor(Valor &&outro) noexcept : tipo(outro.tipo), comprimento(outro.comprimento), bits(outro.bits)
+  {
+    outro.tipo = TipoDeDado::VOID;
+  }
+  Valor &operator=(const Valor &outro)
+  {
+    outro.reter();
+    liberar();
+    tipo = outro.tipo;
+    comprimento = outro.comprimento;
+    bits = outro.bits;
+    return *this;
+  }
+  Valor &operator=(Valor &&outro) noexcept
+  {
+    if (this != &outro)
+    {
+      liberar();
+      tipo = outro.tipo;
+      comprimento = outro.comprimento;
+      bits = outro.bits;
+      outro.tipo = TipoDeDado::VOID;
+    }
+    return *this;
+  }
+  ~Valor() { liberar(); }
+
+  static Valor deInteiro(int64_t v)
+  {
+    Valor valor;
+    valor.tipo = TipoDeDado::INT;
+    valor.inteiro = v;
+    return valor;
+  }
+  static Valor deReal(double v)
+  {
+    Valor valor;
+    valor.tipo = TipoDeDado::DOUBLE;
+    valor.real = v;
+    return valor;
+  }
+  static Valor deTexto(const string &v);
+  // Valor inicial de uma variável declarada sem inicializador
+  static Valor padrao(TipoDeDado tipo);
+  // Array de "tamanho" elementos zerados; "tipo" é ARRAY_INT ou ARRAY_DOUBLE
+  static Valor novoArray(TipoDeDado tipo, uint32_t tamanho);
+
+  bool isTextoLongo() const { return tipo == TipoDeDado::STRING && comprimento > CAPACIDADE_CURTA; }
+  // Caracteres da string (sem terminador), válidos enquanto o Valor existir
+  const char *dados() const { return isTextoLongo() ? compartilhado->conteudo.data() : curto; }
+  string texto() const { return string(dados(), comprimento); }
+  // Comparação lexicográfica de strings, como strcmp (sem alocar)
+  int compararTexto(const Valor &outro) const;
+
+  Elemento *elementos() const { return arranjo->elementos.data(); }
+  // Elemento "indice" de um array como Valor do tipo dos elementos
+  Valor elemento(int64_t indice) const
+  {
+    Valor valor;
+    valor.tipo = tipoDoElemento(tipo);
+    valor.inteiro = elementos()[indice].inteiro;
+    return valor;
+  }
+  void atribuirElemento(int64_t indice, const Valor &valor) { elementos()[indice].inteiro = valor.inteiro; }
+  // Erro de execução se "indice" está fora do array
+  void verificarIndice(int64_t indice) const
+  {
+    if (uint64_t(indice) >= comprimento)
+      indiceForaDosLimites(indice);
+  }
+
+  // Acrescenta o texto de "outro" (ambos strings). Se este Valor enxerga o
+  // buffer inteiro, os caracteres são acrescentados ao próprio buffer, mesmo
+  // que compartilhado: quem o compartilha continua vendo só o seu prefixo.
+  // Assim "s = s + x" repetido num laço custa tempo linear amortizado.
+  void concatenar(const Valor &outro);
+
+  string toString() const;
+
+  // Buffers de texto criados desde o início e ainda não liberados
+  static long long getTextosCriados() { return textosCriados; }
+  static long long getTextosVivos() { return textosVivos; }
+
+private:
+  static atomic<long long> textosCriados;
+  static atomic<long long> textosVivos;
+
+  static TextoCompartilhado *novoTexto(size_t capacidade);
+  [[noreturn]] void indiceForaDosLimites(int64_t indice) const;
+  void reter() const
+  {
+    if (isTextoLongo())
+      compartilhado->referencias++;
+    else if (isArray(tipo))
+      arranjo->referencias++;
+  }
+  void liberar()
+  {
+    if (isTextoLongo())
+    {
+      if (--compartilhado->referencias == 0)
+      {
+        delete compartilhado;
+        textosVivos--;
+      }
+    }
+    else if (isArray(tipo) && --arranjo->referencias == 0)
+    {
+      delete arranjo;
+    }
+  }
+};
+
+// Literais de string deduplicados: cada conteúdo distinto tem um único
+// buffer, compartilhado por todas as ocorrências do literal no programa
+class TabelaDeLiterais
+{
+public:
+  const Valor &internar(const string &texto);
+  size_t getTamanho() const { return literais.size(); }
+
+private:
+  unordered_map<string, Valor> literais;
+};
+
+#endif // VALOR_H
@@ -1,7 +1,35 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <thread>
+#include <unistd.h>
 #include "Lexer.h"
 #include "Parser.h"
 #include "AST.h"
+#include "Resolver.h"
+#include "TypeChecker.h"
+#include "ConstantFolder.h"
+#include "CallGraph.h"
+#include "Inliner.h"
+#include "IRBuilder.h"
+#include "GVN.h"
+#include "LoopOptimizer.h"
+#include "DeadCodeEliminator.h"
+#include "Dataflow.h"
+#include "RegisterAllocator.h"
+#include "CBackend.h"
+#include "Jit.h"
+#include "Interpreter.h"
+#include "BytecodeCompiler.h"
+#include "VM.h"
+#include "PeepholeOptimizer.h"
+#include "BoundsCheckEliminator.h"
+#include "Compilador.h"
+#include "CompiladorC.h"
+#include "ServidorDeCompilacao.h"
 
 using namespace std;
 
@@ -10,11 +38,11 @@ void mostrarAst(string codigo)
   try
   {
     Lexer lexer(codigo);
-    vector<Token> tokens = lexer.Analisar();
+    const FluxoDeTokens &tokens = lexer.Analisar();
     cout << "Tokens: ";
-    for (auto token : tokens)
+    for (size_t t = 0; t < tokens.size(); t++)
     {
-      cout << token.getLexema() << " ";
+      cout << tokens.getLexema(t) << " ";
     }
     cout << endl
          << endl;
@@ -34,6 +62,857 @@ void mostrarAst(string codigo)
   }
 }
 
+// Como mostrarAst, mas executa também a análise semântica sobre a AST e,
+// opcionalmente, as otimizações
+void mostrarAstAnalisada(string codigo, bool otimizar = false)
+{
+  try
+  {
+    Lexer lexer(codigo);
+    Parser parser(lexer.Analisar());
+    ProgramNode *ast = parser.analisar();
+
+    try
+    {
+      Resolver resolver;
+      resolver.analisar(ast);
+      TypeChecker typeChecker;
+      typeChecker.analisar(ast);
+      if (otimizar)
+      {
+        Inliner inliner;
+        inliner.otimizar(ast);
+        cout << "Chamadas expandidas: " << inliner.getExpansoes() << endl;
+        ConstantFolder folder;
+        folder.otimizar(ast);
+        cout << "Simplificacoes: " << folder.getSimplificacoes() << endl;
+        DeadCodeEliminator eliminador;
+        eliminador.otimizar(ast);
+        cout << "Codigo morto removido: " << eliminador.getRemovidos() << endl;
+      }
+    }
+    catch (exception &)
+    {
+      delete ast;
+      throw;
+    }
+
+    cout << "AST Analisada:" << endl;
+    cout << ast->toString() << endl
+         << endl;
+
+    delete ast;
+  }
+  catch (exception &e)
+  {
+    cout << "Erro: " << e.what() << endl;
+  }
+}
+
+// Analisa o programa e mostra a sua IR em forma SSA, opcionalmente depois
+// das otimizações sobre a IR
+void mostrarIR(string codigo, bool otimizar = false)
+{
+  try
+  {
+    Lexer lexer(codigo);
+    Parser parser(lexer.Analisar());
+    ProgramNode *ast = parser.analisar();
+    ProgramaIR *ir = nullptr;
+
+    try
+    {
+      Resolver resolver;
+      resolver.analisar(ast);
+      TypeChecker typeChecker;
+      typeChecker.analisar(ast);
+      IRBuilder builder;
+      ir = builder.construir(ast);
+      if (otimizar)
+      {
+        GVN gvn;
+        gvn.otimizar(ir);
+        cout << "Valores reutilizados (GVN): " << gvn.getEliminadas() << endl;
+        LoopOptimizer lacos;
+        lacos.otimizar(ir);
+        cout << "Invariantes movidas: " << lacos.getInvariantesMovidas()
+             << ", reducoes de forca: " << lacos.getReducoesDeForca() << endl;
+        DeadCodeEliminator eliminador;
+        eliminador.otimizar(ir);
+        cout << "Instrucoes mortas removidas: " << eliminador.getRemovidos() << endl;
+      }
+    }
+    catch (exception &)
+    {
+      delete ast;
+      throw;
+    }
+
+    cout << "IR (SSA):" << endl;
+    cout << ir->toString();
+
+    delete ir;
+    delete ast;
+  }
+  catch (exception &e)
+  {
+    cout << "Erro: " << e.what() << endl;
+  }
+}
+
+// Mostra, por bloco, as variáveis vivas da IR em SSA e as definições que
+// alcançam cada bloco na IR sem SSA; sem detalhar, mostra só o custo de
+// cada análise
+void mostrarDataflow(string codigo, bool detalhar = true)
+{
+  try
+  {
+    Lexer lexer(codigo);
+    Parser parser(lexer.Analisar());
+    ProgramNode *ast = parser.analisar();
+    ProgramaIR *ssa = nullptr;
+    ProgramaIR *semSsa = nullptr;
+
+    try
+    {
+      Resolver resolver;
+      resolver.analisar(ast);
+      TypeChecker typeChecker;
+      typeChecker.analisar(ast);
+      IRBuilder builder;
+      ssa = builder.construir(ast);
+      semSsa = builder.construir(ast, false);
+    }
+    catch (exception &)
+    {
+      delete ssa;
+      delete ast;
+      throw;
+    }
+
+    for (size_t f = 0; f < ssa->funcoes.size(); f++)
+    {
+      const FuncaoIR &funcao = *ssa->funcoes[f];
+      AnaliseDeVivacidade vivacidade(funcao);
+      vivacidade.executar();
+      const ResultadoDataflow &vivas = vivacidade.getResultado();
+      cout << "Funcao " << funcao.nome << ": " << funcao.blocos.size() << " blocos, "
+           << funcao.instrucoes.size() << " valores" << endl;
+      cout << "  Vivacidade: " << vivas.visitas << " visitas";
+      if (!detalhar)
+      {
+        cout << " (" << vivas.microssegundos << " us)";
+      }
+      cout << endl;
+      if (detalhar)
+      {
+        for (size_t b = 0; b < funcao.blocos.size(); b++)
+        {
+          cout << "    bb" << b << ": entrada " << formatarConjunto(vivacidade.getVivasNaEntrada(b))
+               << ", saida " << formatarConjunto(vivacidade.getVivasNaSaida(b)) << endl;
+        }
+      }
+
+      const FuncaoIR &semSsaFuncao = *semSsa->funcoes[f];
+      DefinicoesAlcancaveis definicoes(semSsaFuncao);
+      definicoes.executar();
+      const ResultadoDataflow &alcancam = definicoes.getResultado();
+      cout << "  Definicoes alcancaveis: " << alcancam.visitas << " visitas";
+      if (!detalhar)
+      {
+        cout << " (" << alcancam.microssegundos << " us)";
+      }
+      cout << endl;
+      if (detalhar)
+      {
+        for (size_t b = 0; b < semSsaFuncao.blocos.size(); b++)
+        {
+          cout << "    bb" << b << ": entrada "
+               << formatarConjunto(alcancam.entrada[b], &definicoes.getDefinicoes()) << endl;
+        }
+        cout << "  Leituras possivelmente nao inicializadas: {";
+        vector<uint32_t> leituras = definicoes.leiturasSemDefinicao();
+        for (size_t i = 0; i < leituras.size(); i++)
+        {
+          cout << (i ? ", " : "") << "%" << leituras[i] << " (slot "
+               << semSsaFuncao.instrucoes[leituras[i]].imediato << ")";
+        }
+        cout << "}" << endl;
+      }
+    }
+    if (detalhar)
+    {
+      cout << "IR sem SSA:" << endl
+           << semSsa->toString();
+    }
+
+    delete semSsa;
+    delete ssa;
+    delete ast;
+  }
+  catch (exception &e)
+  {
+    cout << "Erro: " << e.what() << endl;
+  }
+}
+
+// Otimiza a IR do programa e mostra a alocação de registradores de cada
+// função, conferindo-a contra a análise de vivacidade
+void mostrarAlocacao(string codigo, size_t limiteDeBits = size_t(1) << 24)
+{
+  try
+  {
+    Lexer lexer(codigo);
+    Parser parser(lexer.Analisar());
+    ProgramNode *ast = parser.analisar();
+    ProgramaIR *ir = nullptr;
+
+    try
+    {
+      Resolver resolver;
+      resolver.analisar(ast);
+      TypeChecker typeChecker;
+      typeChecker.analisar(ast);
+      IRBuilder builder;
+      ir = builder.construir(ast);
+      GVN gvn;
+      gvn.otimizar(ir);
+      LoopOptimizer lacos;
+      lacos.otimizar(ir);
+      DeadCodeEliminator eliminador;
+      eliminador.otimizar(ir);
+    }
+    catch (exception &)
+    {
+      delete ir;
+      delete ast;
+      throw;
+    }
+
+    RegisterAllocator alocador(limiteDeBits);
+    vector<Alocacao> alocacoes = alocador.alocar(ir);
+    for (size_t f = 0; f < ir->funcoes.size(); f++)
+    {
+      const FuncaoIR &funcao = *ir->funcoes[f];
+      const Alocacao &alocacao = alocacoes[f];
+      cout << "Funcao " << funcao.nome << (alocacao.modoRapido ? " (modo rapido)" : "") << ": "
+           << alocacao.emRegistrador << " valores em registradores, " << alocacao.naPilha
+           << " na pilha (" << alocacao.numSlotsDePilha << " slots), conflitos: "
+           << contarConflitos(funcao, alocacao) << endl;
+      cout << formatarAlocacao(funcao, alocacao);
+    }
+
+    delete ir;
+    delete ast;
+  }
+  catch (exception &e)
+  {
+    cout << "Erro: " << e.what() << endl;
+  }
+}
+
+// Traduz o programa analisado e otimizado para C, mostra o código gerado
+// e, se executar for verdadeiro, compila-o com o compilador C do sistema e
+// mostra a saída do programa
+void mostrarC(string codigo, bool executar = true)
+{
+  try
+  {
+    Lexer lexer(codigo);
+    Parser parser(lexer.Analisar());
+    ProgramNode *ast = parser.analisar();
+    string fonte;
+    CBackend backend;
+
+    try
+    {
+      Resolver resolver;
+      resolver.analisar(ast);
+      TypeChecker typeChecker;
+      typeChecker.analisar(ast);
+      Inliner inliner;
+      inliner.otimizar(ast);
+      ConstantFolder folder;
+      folder.otimizar(ast);
+      DeadCodeEliminator eliminador;
+      eliminador.otimizar(ast);
+      BoundsCheckEliminator limites;
+      limites.otimizar(ast);
+      fonte = backend.gerar(ast);
+    }
+    catch (exception &)
+    {
+      delete ast;
+      throw;
+    }
+    delete ast;
+
+    cout << "Codigo C (" << backend.getTemporarios() << " temporarios de ordem de avaliacao):" << endl
+         << fonte;
+    if (executar)
+    {
+      string executavel = "/tmp/compilador_cbackend_" + to_string(getpid());
+      backend.compilar(fonte, executavel);
+      cout << "Saida do programa compilado: " << backend.executar(executavel);
+      remove(executavel.c_str());
+      remove((executavel + ".c").c_str());
+    }
+  }
+  catch (exception &e)
+  {
+    cout << "Erro: " << e.what() << endl;
+  }
+}
+
+void mostrarJit(string codigo, const vector<pair<string, vector<double>>> &chamadas)
+{
+  try
+  {
+    Lexer lexer(codigo);
+    Parser parser(lexer.Analisar());
+    ProgramNode *ast = parser.analisar();
+
+    try
+    {
+      Resolver resolver;
+      resolver.analisar(ast);
+      TypeChecker typeChecker;
+      typeChecker.analisar(ast);
+      BoundsCheckEliminator limites;
+      limites.otimizar(ast);
+      Jit jit(ast);
+      const vector<FunctionNode *> &functions = ast->getFunctions();
+      for (auto &chamada : chamadas)
+      {
+        int indice = 0;
+        while (functions[indice]->getName() != chamada.first)
+          indice++;
+        FunctionNode *function = functions[indice];
+        cout << chamada.first << "(";
+        vector<uint64_t> argumentos;
+        for (size_t i = 0; i < chamada.second.size(); i++)
+        {
+          bool real = function->getParams()[i]->getType() == "double";
+          argumentos.push_back(real ? bitsDeReal(chamada.second[i]) : uint64_t(int64_t(chamada.second[i])));
+          cout << (i ? ", " : "") << chamada.second[i];
+        }
+        cout << ") = ";
+        if (!jit.compilar(indice))
+        {
+          cout << "nao compilada: " << jit.getMotivo(indice) << endl;
+          continue;
+        }
+        try
+        {
+          uint64_t resultado = jit.chamar(indice, argumentos.data());
+          if (function->getReturnType() == "double")
+            cout << realDeBits(resultado) << endl;
+          else
+            cout << int64_t(resultado) << endl;
+        }
+        catch (runtime_error &e)
+        {
+          cout << e.what() << endl;
+        }
+      }
+      cout << jit.getCompiladas() << " funcoes compiladas, " << jit.getBytesDeCodigo() << " bytes de codigo x86-64" << endl;
+    }
+    catch (exception &)
+    {
+      delete ast;
+      throw;
+    }
+    delete ast;
+  }
+  catch (exception &e)
+  {
+    cout << "Erro: " << e.what() << endl;
+  }
+}
+
+void mostrarExecucao(string codigo, int limiteDeChamadas, int limiteDeIteracoes)
+{
+  try
+  {
+    Lexer lexer(codigo);
+    Parser parser(lexer.Analisar());
+    ProgramNode *ast = parser.analisar();
+
+    try
+    {
+      Resolver resolver;
+      resolver.analisar(ast);
+      TypeChecker typeChecker;
+      typeChecker.analisar(ast);
+      for (bool usarJit : {false, true})
+      {
+        Interpreter interpreter(ast, usarJit);
+        interpreter.setLimites(limiteDeChamadas, limiteDeIteracoes);
+        auto inicio = chrono::steady_clock::now();
+        Valor resultado = interpreter.executar();
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+        cout << (usarJit ? "Em camadas:   " : "Interpretado: ") << "main() = " << resultado.toString()
+             << " (" << ms << " ms)" << endl;
+        cout << "  chamadas interpretadas: " << interpreter.getChamadasInterpretadas()
+             << ", nativas: " << interpreter.getChamadasNativas()
+             << ", iteracoes interpretadas: " << interpreter.getIteracoesInterpretadas() << endl;
+        if (usarJit)
+        {
+          const Jit &jit = interpreter.getJit();
+          cout << "  funcoes promovidas: " << interpreter.getPromocoes()
+               << ", trocas de camada no meio de um laco: " << interpreter.getEntradasDeLaco() << endl;
+          for (size_t i = 0; i < ast->getFunctions().size(); i++)
+          {
+            FunctionNode *function = ast->getFunctions()[i];
+            if (!function->isGlobalWrapper())
+            {
+              cout << "  " << function->getName() << ": "
+                   << (jit.isCompilada(i) ? "nativa" : jit.getMotivo(i).empty() ? "interpretada" : "interpretada (" + jit.getMotivo(i) + ")")
+                   << endl;
+            }
+          }
+        }
+      }
+    }
+    catch (exception &)
+    {
+      delete ast;
+      throw;
+    }
+    delete ast;
+  }
+  catch (exception &e)
+  {
+    cout << "Erro: " << e.what() << endl;
+  }
+}
+
+void mostrarBytecode(string codigo, const string &nomeDaFuncao)
+{
+  try
+  {
+    Lexer lexer(codigo);
+    Parser parser(lexer.Analisar());
+    ProgramNode *ast = parser.analisar();
+    ProgramaBC *programa = nullptr;
+
+    try
+    {
+      Resolver resolver;
+      resolver.analisar(ast);
+      TypeChecker typeChecker;
+      typeChecker.analisar(ast);
+      BytecodeCompiler compilador;
+      programa = compilador.gerar(ast);
+    }
+    catch (exception &)
+    {
+      delete ast;
+      throw;
+    }
+    delete ast;
+
+    try
+    {
+      const FuncaoBC *funcao = nullptr;
+      for (const FuncaoBC &f : programa->funcoes)
+      {
+        if (f.nome == nomeDaFuncao)
+          funcao = &f;
+      }
+      cout << "Bytecode:" << endl
+           << funcao->toString();
+
+      VM perfilada(programa);
+      perfilada.setPerfilar(true);
+      auto inicio = chrono::steady_clock::now();
+      Valor resultado = perfilada.executar();
+      double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+      cout << "main() = " << resultado.toString() << ", " << perfilada.getDespachos() << " despachos ("
+           << ms << " ms, com perfil)" << endl;
+      cout << "Pares de operacoes mais frequentes:" << endl
+           << perfilada.getPerfil().relatorio(8);
+
+      PeepholeOptimizer peephole(&perfilada.getPerfil(), 0.02);
+      peephole.otimizar(programa);
+      cout << "Superinstrucoes escolhidas pelo perfil:";
+      for (OpBC op : peephole.getSuperinstrucoes())
+      {
+        cout << " " << opBCParaString(op);
+      }
+      cout << endl
+           << peephole.getFusoes() << " sequencias fundidas, " << peephole.getRemovidas() << " instrucoes a menos" << endl;
+      cout << "Bytecode otimizado:" << endl
+           << funcao->toString();
+
+      VM otimizada(programa);
+      inicio = chrono::steady_clock::now();
+      resultado = otimizada.executar();
+      ms = chrono::duration<double, milli>(chrono::steady_clock::now() - inicio).count();
+      cout << "main() = " << resultado.toString() << ", " << otimizada.getDespachos() << " despachos ("
+           << ms << " ms)" << endl;
+    }
+    catch (exception &)
+    {
+      delete programa;
+      throw;
+    }
+    delete programa;
+  }
+  catch (exception &e)
+  {
+    cout << "Erro: " << e.what() << endl;
+  }
+}
+
+void mostrarValores(string codigo)
+{
+  try
+  {
+    Lexer lexer(codigo);
+    Parser parser(lexer.Analisar());
+    ProgramNode *ast = parser.analisar();
+    ProgramaBC *programa = nullptr;
+
+    try
+    {
+      Resolver resolver;
+      resolver.analisar(ast);
+      TypeChecker typeChecker;
+      typeChecker.analisar(ast);
+      BytecodeCompiler compilador;
+      programa = compilador.gerar(ast);
+
+      cout << "sizeof(Valor) = " << sizeof(Valor) << " bytes" << endl;
+      for (int motor = 0; motor < 2; motor++)
+      {
+        long long criados = Valor::getTextosCriados();
+        long long vivos = Valor::getTextosVivos();
+        string resultado;
+        if (motor == 0)
+        {
+          Interpreter interpreter(ast, false);
+          resultado = interpreter.executar().toString();
+        }
+        else
+        {
+          VM vm(programa);
+          resultado = vm.executar().toString();
+        }
+        cout << (motor == 0 ? "Interpreter: " : "VM:          ") << "main() = " << resultado
+             << ", textos alocados: " << Valor::getTextosCriados() - criados
+             << ", ainda vivos: " << Valor::getTextosVivos() - vivos << endl;
+      }
+    }
+    catch (exception &)
+    {
+      delete programa;
+      delete ast;
+      throw;
+    }
+    delete programa;
+    delete ast;
+  }
+  catch (exception &e)
+  {
+    cout << "Erro: " << e.what() << endl;
+  }
+}
+
+void mostrarTextos(string codigo)
+{
+  try
+  {
+    Lexer lexer(codigo);
+    Parser parser(lexer.Analisar());
+    ProgramNode *ast = parser.analisar();
+    ProgramaBC *programa = nullptr;
+
+    try
+    {
+      Resolver resolver;
+      resolver.analisar(ast);
+      TypeChecker typeChecker;
+      typeChecker.analisar(ast);
+      BytecodeCompiler compilador;
+      programa = compilador.gerar(ast);
+      cout << "Literais distintos no bytecode: " << programa->literais.getTamanho() << endl;
+
+      for (int motor = 0; motor < 2; motor++)
+      {
+        long long criados = Valor::getTextosCriados();
+        auto inicio = chrono::steady_clock::now();
+        Valor resultado;
+        if (motor == 0)
+        {
+          Interpreter interpreter(ast, false);
+          resultado = interpreter.executar();
+        }
+        else
+        {
+          VM vm(programa);
+          resultado = vm.executar();
+        }
+        auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - inicio).count();
+        cout << (motor == 0 ? "Interpreter: " : "VM:          ") << "main() = string de " << resultado.comprimento
+             << " caracteres, textos alocados: " << Valor::getTextosCriados() - criados
+             << ", tempo: " << ms << " ms" << endl;
+      }
+    }
+    catch (exception &)
+    {
+      delete programa;
+      delete ast;
+      throw;
+    }
+    delete programa;
+    delete ast;
+  }
+  catch (exception &e)
+  {
+    cout << "Erro: " << e.what() << endl;
+  }
+}
+
+void mostrarArrays(string codigo, const string &nomeDaFuncao)
+{
+  // Primeiro com todas as verificações de limites, depois com o BoundsCheckEliminator
+  for (int eliminar = 0; eliminar < 2; eliminar++)
+  {
+    try
+    {
+      Lexer lexer(codigo);
+      Parser parser(lexer.Analisar());
+      ProgramNode *ast = parser.analisar();
+      ProgramaBC *programa = nullptr;
+
+      try
+      {
+        Resolver resolver;
+        resolver.analisar(ast);
+        TypeChecker typeChecker;
+        typeChecker.analisar(ast);
+        if (eliminar)
+        {
+          BoundsCheckEliminator eliminador;
+          eliminador.otimizar(ast);
+          cout << "Verificacoes de limites eliminadas: " << eliminador.getEliminadas()
+               << ", mantidas: " << eliminador.getMantidas() << endl;
+        }
+        BytecodeCompiler compilador;
+        programa = compilador.gerar(ast);
+        for (const FuncaoBC &funcao : programa->funcoes)
+        {
+          if (eliminar && funcao.nome == nomeDaFuncao)
+            cout << "Bytecode:" << endl
+                 << funcao.toString();
+        }
+
+        for (int motor = 0; motor < 2; motor++)
+        {
+          cout << (motor == 0 ? "Interpreter" : "VM         ") << (eliminar ? " (sem verificacoes provadas): " : " (com verificacoes):         ");
+          try
+          {
+            auto inicio = chrono::steady_clock::now();
+            Valor resultado;
+            if (motor == 0)
+            {
+              Interpreter interpreter(ast);
+              resultado = interpreter.executar();
+            }
+            else
+            {
+              VM vm(programa);
+              resultado = vm.executar();
+            }
+            auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - inicio).count();
+            cout << "main() = " << resultado.toString() << " (" << ms << " ms)" << endl;
+          }
+          catch (exception &e)
+          {
+            cout << "Erro: " << e.what() << endl;
+          }
+        }
+      }
+      catch (exception &)
+      {
+        delete programa;
+        delete ast;
+        throw;
+      }
+      delete programa;
+      delete ast;
+    }
+    catch (exception &e)
+    {
+      cout << "Erro: " << e.what() << endl;
+    }
+  }
+}
+
+// Executa um programa que chama funções embutidas no Interpreter (sem e
+// com o Jit), na VM e no código do CBackend, mostrando o bytecode da
+// função "nomeDaFuncao"; os prints do programa aparecem entre as linhas
+void mostrarBuiltins(string codigo, const string &nomeDaFuncao)
+{
+  try
+  {
+    Lexer lexer(codigo);
+    Parser parser(lexer.Analisar());
+    ProgramNode *ast = parser.analisar();
+    ProgramaBC *programa = nullptr;
+
+    try
+    {
+      Resolver resolver;
+      resolver.analisar(ast);
+      TypeChecker typeChecker;
+      typeChecker.analisar(ast);
+      BytecodeCompiler compilador;
+      programa = compilador.gerar(ast);
+      for (const FuncaoBC &funcao : programa->funcoes)
+      {
+        if (funcao.nome == nomeDaFuncao)
+          cout << "Bytecode:" << endl
+               << funcao.toString();
+      }
+
+      for (int motor = 0; motor < 3; motor++)
+      {
+        cout << (motor == 0 ? "Interpreter sem Jit:" : motor == 1 ? "Interpreter com Jit:" : "VM:") << endl;
+        try
+        {
+          auto inicio = chrono::steady_clock::now();
+          Valor resultado;
+          string camadas;
+          if (motor < 2)
+          {
+            Interpreter interpreter(ast, motor == 1);
+            resultado = interpreter.executar();
+            if (motor == 1)
+              camadas = ", " + to_string(interpreter.getPromocoes()) + " promocao(oes), " +
+                        to_string(interpreter.getEntradasDeLaco()) + " entrada(s) de laco no Jit";
+          }
+          else
+          {
+            VM vm(programa);
+            resultado = vm.executar();
+          }
+          auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - inicio).count();
+          cout << "main() = " << resultado.toString() << " (" << ms << " ms" << camadas << ")" << endl;
+        }
+        catch (exception &e)
+        {
+          cout << "Erro: " << e.what() << endl;
+        }
+      }
+    }
+    catch (exception &)
+    {
+      delete programa;
+      delete ast;
+      throw;
+    }
+    delete programa;
+
+    try
+    {
+      CBackend backend;
+      string fonte = backend.gerar(ast);
+      string executavel = "/tmp/compilador_builtins_" + to_string(getpid());
+      backend.compilar(fonte, executavel);
+      cout << "Programa compilado pelo CBackend:" << endl
+           << backend.executar(executavel);
+      remove(executavel.c_str());
+      remove((executavel + ".c").c_str());
+    }
+    catch (exception &e)
+    {
+      cout << "Erro: " << e.what() << endl;
+    }
+    delete ast;
+  }
+  catch (exception &e)
+  {
+    cout << "Erro: " << e.what() << endl;
+  }
+}
+
+// Compila e executa cada programa num mesmo contexto (reaproveitado),
+// mostrando o valor de main, a saída dos prints e o tempo de compilação e
+// de execução
+void mostrarCompilador(Compilador &compilador, const vector<string> &programas, int execucoes = 1)
+{
+  for (const string &codigo : programas)
+  {
+    try
+    {
+      auto inicio = chrono::steady_clock::now();
+      compilador.compilar(codigo);
+      auto compilado = chrono::steady_clock::now();
+      cout << "Compilado em " << chrono::duration_cast<chrono::microseconds>(compilado - inicio).count() << " us" << endl;
+      for (int e = 0; e < execucoes; e++)
+      {
+        auto antes = chrono::steady_clock::now();
+        Valor resultado = compilador.executar();
+        auto us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - antes).count();
+        cout << "  execucao " << e + 1 << ": main() = " << resultado.toString() << " (" << us << " us)";
+        if (!compilador.getSaida().empty())
+        {
+          string saida = compilador.getSaida();
+          saida.pop_back();
+          for (char &c : saida)
+          {
+            if (c == '\n')
+              c = ' ';
+          }
+          cout << ", saida: " << saida;
+        }
+        cout << endl;
+      }
+    }
+    catch (exception &e)
+    {
+      cout << "Erro: " << e.what() << endl;
+    }
+  }
+}
+
+// Executa o programa na VM sem e com as otimizações, que não podem mudar o
+// resultado nem esconder um erro de execução
+void mostrarComESemOtimizacao(const string &codigo)
+{
+  for (bool otimizar : {false, true})
+  {
+    OpcoesDoCompilador opcoes;
+    opcoes.otimizar = otimizar;
+    Compilador compilador(opcoes);
+    cout << (otimizar ? "Otimizado:    " : "Sem otimizar: ");
+    try
+    {
+      compilador.compilar(codigo);
+      Valor resultado = compilador.executar();
+      cout << "main() = " << resultado.toString() << endl;
+    }
+    catch (exception &e)
+    {
+      cout << e.what() << endl;
+    }
+  }
+}
+
+bool mesmosTokens(const FluxoDeTokens &a, const FluxoDeTokens &b)
+{
+  if (a.size() != b.size())
+    return false;
+  for (size_t t = 0; t < a.size(); t++)
+  {
+    if (a.getTipo(t) != b.getTipo(t) || a.getInicio(t) != b.getInicio(t) || a.getTamanho(t) != b.getTamanho(t))
+      return false;
+  }
+  return true;
+}
+
 void testarExpressaoAritmetica()
 {
   cout << "\n=== 1. Teste: Expressao Aritmetica ===" << endl;
@@ -87,8 +966,747 @@ void testarFor()
   mostrarAst(codigo);
 }
 
-int main()
+void testarResolucaoDeNomes()
+{
+  cout << "\n=== 8. Teste: Resolucao de Nomes ===" << endl;
+  string codigo = "int g = 5; int dobro(int n) { return n * 2; } int main() { int x = g; if (x > 0) { int x = 1; x = dobro(x); } for (int i = 0; i < 3; i++) { x = x + i; } return x; } ";
+  mostrarAstAnalisada(codigo);
+
+  cout << "Nome nao declarado:" << endl;
+  mostrarAstAnalisada("int main() { int x = 1; return y; } ");
+
+  cout << "Nome duplicado:" << endl;
+  mostrarAstAnalisada("int main() { int x = 1; int x = 2; return x; } ");
+}
+
+void testarTipos()
+{
+  cout << "\n=== 9. Teste: Verificacao de Tipos ===" << endl;
+  string codigo = "double media(int a, double b) { return (a + b) / 2; } int main() { double d = 1; string s = \"ab\" + \"cd\"; while (d) { d = media(3, d) - 1; } return s == \"abcd\"; } ";
+  mostrarAstAnalisada(codigo);
+
+  cout << "Operacao mal tipada:" << endl;
+  mostrarAstAnalisada("int main() { string s = \"a\"; return s * 2; } ");
+
+  cout << "Conversao proibida:" << endl;
+  mostrarAstAnalisada("int main() { int x = 2.5; return x; } ");
+}
+
+void testarLiterais()
+{
+  cout << "\n=== 10. Teste: Literais Numericos ===" << endl;
+  string codigo = "int main() { int grande = 9223372036854775807; double d = 0.1 + 123.456 + 000.050; string s = \"42\"; return 007; } ";
+  mostrarAstAnalisada(codigo);
+
+  cout << "Inteiro fora do intervalo:" << endl;
+  mostrarAstAnalisada("int main() { return 9223372036854775808; } ");
+}
+
+void testarDobraDeConstantes()
+{
+  cout << "\n=== 11. Teste: Dobra de Constantes ===" << endl;
+  string codigo = "int main() { int x = 4; double r = (123.456 - 5) / 2; int y = x * 1 + 0 * x + (2 * 3 - 6); if (10 > 2 * 5 || !0) { y = y + 1; } else { y = 0; } while (0) { x = x + 1; } string s = \"a\" + \"b\"; return y * (4 / 0); } ";
+  mostrarAstAnalisada(codigo, true);
+
+  // x * 0 só vira 0 se avaliar x não pode falhar
+  mostrarComESemOtimizacao("int main() { int a = 0; return (10 / a) * 0; } ");
+  mostrarComESemOtimizacao("int main() { int a = 2; return (10 / a) * 0 + (7 / 2) * 0; } ");
+}
+
+void testarIR()
+{
+  cout << "\n=== 12. Teste: IR em Forma SSA ===" << endl;
+  string codigo = "int soma(int n) { int total = 0; for (int i = 0; i < n; i++) { if ((i > 2) && (i != 5)) { total = total + i; } else { total = total - 1; } } return total; } ";
+  mostrarIR(codigo);
+}
+
+void testarGVN()
+{
+  cout << "\n=== 13. Teste: Numeracao Global de Valores ===" << endl;
+  string codigo = "int indice(int i, int j, int n) { int a = i * n + j; int b = (n * i + j) * 2; if (a > b) { a = a + i * n; } else { b = b - (i * n + j); } return (b < a) + (a > b); } ";
+  mostrarIR(codigo, true);
+}
+
+void testarOtimizacaoDeLacos()
+{
+  cout << "\n=== 14. Teste: Otimizacao de Lacos ===" << endl;
+  string codigo = "int kernel(int n, int stride, int base) { int total = 0; for (int i = 0; i < n; i++) { int offset = base * stride + 4; total = total + i * stride + offset / 2; } int j = n; while (j > 0) { total = total + j * 3 + base / stride; j = j - 2; } return total; } ";
+  mostrarIR(codigo, true);
+}
+
+void testarCodigoMorto()
+{
+  cout << "\n=== 15. Teste: Eliminacao de Codigo Morto ===" << endl;
+  string codigo = "int g(int a) { return a; } int f(int n) { int lixo = n * 2; int x = 0; int nunca; int r; x = n + 1; x = x * 2; r = g(n); if (0) { x = 99; } while (n > 0) { int tmp = n * 3; n = n - 1; } if (x > 10) { return x; } else { return 0; } x = 3; g(x); } ";
+  mostrarAstAnalisada(codigo, true);
+  mostrarIR(codigo, true);
+
+  // Valores nunca lidos cuja avaliação falha continuam sendo avaliados
+  mostrarComESemOtimizacao("int main() { int a = 0; int y = 10 / a; return 1; } ");
+  mostrarComESemOtimizacao("int main() { int a[3]; int y = a[5]; return 1; } ");
+  mostrarIR("int f(int a) { int y = 10 / a; int z = a / 2; return 1; } ", true);
+}
+
+void testarInlining()
+{
+  cout << "\n=== 16. Teste: Expansao de Funcoes (Inlining) ===" << endl;
+  string codigo = "int quadrado(int x) { return x * x; } double media(int a, double b) { double s = a + b; return s / 2; } int fat(int n) { if (n < 2) { return 1; } return n * fat(n - 1); } int main() { int total = 0; for (int i = 0; i < 10; i++) { total = total + quadrado(i) + quadrado(quadrado(2)); } double m = media(total, 1.5); return total + fat(5); } ";
+
+  try
+  {
+    Lexer lexer(codigo);
+    Parser parser(lexer.Analisar());
+    ProgramNode *ast = parser.analisar();
+    Resolver resolver;
+    resolver.analisar(ast);
+    CallGraph grafo;
+    grafo.construir(ast);
+    cout << "Grafo de chamadas:" << endl
+         << grafo.toString();
+    delete ast;
+  }
+  catch (exception &e)
+  {
+    cout << "Erro: " << e.what() << endl;
+  }
+  mostrarAstAnalisada(codigo, true);
+}
+
+void testarDataflow()
+{
+  cout << "\n=== 17. Teste: Analise de Fluxo de Dados ===" << endl;
+  string codigo = "int f(int n) { int x; int y = 1; int i = 0; while (i < n) { x = y + i; if (x > 5) { y = x; } i = i + 1; } return y + x; } ";
+  mostrarIR(codigo);
+  mostrarDataflow(codigo);
+
+  // Função grande gerada, para medir o custo das análises
+  string grande = "int g(int n) { int a = 0; int b = 1; int i = 0; while (i < n) { ";
+  for (int k = 0; k < 200; k++)
+  {
+    grande += "if ((a + " + to_string(k) + ") > b) { a = a + b; } else { b = b + " + to_string(k) + "; } ";
+  }
+  grande += "i = i + 1; } return a + b; } ";
+  mostrarDataflow(grande, false);
+}
+
+void testarAlocacaoDeRegistradores()
+{
+  cout << "\n=== 18. Teste: Alocacao de Registradores ===" << endl;
+  string codigo = "double horner(double x, int n) { double r = 0; for (int i = 0; i < n; i++) { r = r * x + i; } return r; } int soma(int a, int b) { return a + b; } int kernel(int n, int k) { int acc = 0; for (int i = 0; i < n; i++) { int t = soma(i, k); acc = acc + t * k + (i - k) * (i + k); } return acc + n; } ";
+  mostrarIR(codigo, true);
+  mostrarAlocacao(codigo);
+
+  // Mais valores vivos ao mesmo tempo do que registradores: alguns vão para a pilha
+  string pressao = "int pressao(int a) { ";
+  for (int k = 0; k < 14; k++)
+  {
+    pressao += "int v" + to_string(k) + " = a * " + to_string(k + 2) + "; ";
+  }
+  pressao += "int s = 0; for (int i = 0; i < a; i++) { s = s + i; } return s";
+  for (int k = 0; k < 14; k++)
+  {
+    pressao += " + v" + to_string(k);
+  }
+  pressao += "; } ";
+  mostrarAlocacao(pressao);
+  // Mesmo programa no modo rápido, sem a análise de vivacidade
+  mostrarAlocacao(pressao, 0);
+}
+
+void testarBackendC()
+{
+  cout << "\n=== 19. Teste: Backend C ===" << endl;
+  string codigo = "int contador = 0; string prefixo = \"ola, \"; int proximo() { contador = contador + 1; return contador; } int fib(int n) { if (n < 2) { return n; } return fib(n - 1) + fib(n - 2); } double media(int a, double b) { return (a + b) / 2; } string saudar(string nome) { return prefixo + nome; } int main() { int total = 0; for (int i = 0; i < 20; i++) { total = total + fib(i); } int ordem = proximo() * 10 + proximo(); string s = saudar(\"mundo\"); if ((s == \"ola, mundo\") && (media(3, 4.5) > 3)) { total = total + ordem; } int x = 5; x = x++ + x; return total * 100 + x + total / (x - 7); } ";
+  mostrarC(codigo);
+
+  // Nomes do programa que coincidiriam com os gerados (temporários,
+  // funções e inicializadores) se a codificação não os separasse
+  // (main() = 30)
+  string nomes = "int f = 1; int g0() { f = f + 1; return f; } int um() { int global = 1; return global; } "
+                 "int main() { int t = 2; t = t * 10 + g0(); return t + um() + 2 + f + g0(); } ";
+  mostrarC(nomes);
+}
+
+void testarJit()
+{
+  cout << "\n=== 20. Teste: Compilacao Just-in-Time ===" << endl;
+  string codigo = "int contador = 0; int fib(int n) { if (n < 2) { return n; } return fib(n - 1) + fib(n - 2); } int soma(int n) { int total = 0; for (int i = 0; i < n; i++) { total = total + i; } return total; } double horner(double x) { return ((2.0 * x - 3) * x + 0.5) * x - 1; } double media(int a, double b) { return (a + b) / 2; } int troca(int n) { int a = 1; int b = 2; double x = 0.5; double y = 1.5; for (int i = 0; i < n; i++) { int t = a; a = b; b = t + b; double u = x; x = y; y = u; } if (x < y) { a = a + 1; } return a * 1000 + b; } int pressao(int a) { int b = a + 1; int c = a * 2; int d = a - 3; int e = a * a; int f = b + c; int g = d * e; int h = f - g; int i = a + 7; int j = b * 3; int k = c + 11; int l = d * 5; int m = e - 13; int r = fib(10); return a + b + c + d + e + f + g + h + i + j + k + l + m + r; } int divide(int a, int b) { return a / b; } int proximo() { contador = contador + 1; return contador; } int dobro() { return proximo() * 2; } string exclamar(string s) { return s + \"!\"; } int verifica() { if (exclamar(\"a\") == \"a!\") { return 1; } return 0; } ";
+  mostrarJit(codigo, {{"fib", {25}}, {"soma", {100000}}, {"horner", {2.5}}, {"media", {3, 4.5}}, {"troca", {7}}, {"troca", {8}}, {"pressao", {4}}, {"divide", {-9, 2}}, {"divide", {5, -1}}, {"divide", {7, 0}}, {"proximo", {}}, {"dobro", {}}, {"verifica", {}}});
+
+  // Regressão: um valor tirado de um registrador já estava vivo antes dos
+  // slots liberados no início do intervalo atual e não pode reaproveitá-los
+  // (f(5) = 570, main() = 171000)
+  string spill = "int f(int n) { int s = 0; int i; for (i = 0; i < n; i++) { int a = i; int b = 1; int c = 2; int d = 3; int e = 4; int g = 5; int h = 6; s = s + (a + b * 2 + c * 3 + d * 4 + e * 5 + g * 6 + h * 7); } return s; } "
+                 "int main() { int t = 0; int k; for (k = 0; k < 300; k++) { t = t + f(5); } return t; } ";
+  mostrarJit(spill, {{"f", {5}}, {"main", {}}});
+  mostrarAlocacao(spill);
+
+  // Regressão: PHIs int e double trocam de lugar por slots da pilha
+  // compartilhados, formando um ciclo de cópias de classes mistas que
+  // passa por RAX bit a bit (f(5) = f(7) = 3)
+  string mista = "int f(int n) { int i0 = 6; int i1 = 1; int i2 = 5; int i3 = 4; int i4 = 0; int i6 = 8; int i7 = 7; int i8 = 9; "
+                "int i10 = 4; int i11 = 8; int i12 = 0; int i13 = 4; int i14 = 7; int i15 = 2; int i16 = 2; int i17 = 4; int i18 = 3; "
+                "double d2 = 9.5; double d3 = 3.5; double d4 = 9.5; double d6 = 3.5; double d7 = 2.5; double d8 = 2.5; double d9 = 1.5; "
+                "double d10 = 7.5; double d11 = 8.5; double d12 = 8.5; double d13 = 1.5; double d14 = 3.5; double d15 = 9.5; "
+                "double d17 = 8.5; double d18 = 8.5; for (int r = 0; r < n; r++) { i12 = (d11 > d10); d11 = (i2 * 0.5); "
+                "d10 = (i7 * 0.5); d15 = (i16 * 0.5); i13 = i0; d17 = (i8 * 0.5); d7 = (i14 * 0.5); i14 = (d10 > d7); d2 = (i11 * 0.5); "
+                "i17 = (i10 + i13); d14 = (i18 * 0.5); i0 = (d4 > d11); i2 = (d12 > d11); i11 = i10; i4 = (d15 > d4); d13 = (d10 - d3); "
+                "i7 = (d17 > d13); i10 = (i3 + i1); i18 = i14; i16 = (d18 > d12); d18 = (i15 * 0.5); i8 = (d9 > d12); d6 = (i14 * 0.5); "
+                "i15 = (i6 + i14); d4 = (i4 * 0.5); d9 = (d12 - d15); d12 = (i11 * 0.5); d8 = (i0 * 0.5); i3 = (d14 > d14); "
+                "} return i0 + i1 + i4 + i12 + i17 + (d2 + d6 + d7 + d8 + d13 + d15 + d17 > 10.0); } ";
+  mostrarJit(mista, {{"f", {5}}, {"f", {7}}});
+}
+
+void testarExecucaoEmCamadas()
+{
+  cout << "\n=== 21. Teste: Execucao em Camadas ===" << endl;
+  string codigo = "int visitas = 0; int fib(int n) { if (n < 2) { return n; } return fib(n - 1) + fib(n - 2); } int soma(int n) { int acc = 0; int k = 0; while (k < n) { acc = acc + k * 3 - k / 7; k++; } return acc; } string rotulo(int n) { visitas = visitas + 1; if (n > 10) { return \"grande\"; } return \"pequeno\"; } int main() { int total = 0; for (int i = 0; i < 300; i++) { total = total + fib(i / 20); if (rotulo(i) == \"grande\") { total = total + 1; } } return total + soma(300000) + visitas; } ";
+  mostrarExecucao(codigo, 50, 500);
+}
+
+void testarBytecode()
+{
+  cout << "\n=== 22. Teste: Bytecode, Peephole e Superinstrucoes ===" << endl;
+  string codigo = "int soma(int n) { int acc = 0; for (int i = 0; i < n; i++) { acc = acc + i; } return acc; } double media(int n) { double s = 0; int i = 1; while (i <= n) { s = s + 1.0 / i; i = i + 1; } return s / n; } string repete(string s, int n) { string r = \"\"; for (int i = 0; i < n; i++) { r = r + s; } return r; } int main() { int total = 0; for (int k = 0; k < 20; k++) { total = total + soma(10000); } if (repete(\"ab\", 3) == \"ababab\") { total = total + 1; } if (media(100) > 0.05) { total = total + 2; } return total; } ";
+  mostrarBytecode(codigo, "soma");
+}
+
+void testarValores()
+{
+  cout << "\n=== 23. Teste: Representacao de Valores ===" << endl;
+  string numerico = "int main() { int a = 0; double x = 1.5; for (int i = 0; i < 100000; i++) { a = a + i * 3 - i / 2; x = x * 1.0001 + a; } if (x > 0) { a = a + 1; } return a; } ";
+  mostrarValores(numerico);
+  string textos = "string sufixo = \"!\"; string junta(string a, string b) { return a + b; } int main() { string s = \"\"; string t = s; for (int i = 0; i < 100; i++) { s = junta(s, \"ab\"); } t = s + sufixo; if ((t > s) && (s != \"\")) { return 1; } return 0; } ";
+  mostrarValores(textos);
+}
+
+void testarTextos()
+{
+  cout << "\n=== 24. Teste: Strings em Tempo de Execucao ===" << endl;
+  // Dobrar o número de iterações deve dobrar o tempo, não quadruplicar
+  for (int n = 20000; n <= 80000; n *= 2)
+  {
+    string codigo = "string main() { string s = \"\"; for (int i = 0; i < " + to_string(n) +
+                    "; i++) { if ((i / 2) * 2 == i) { s = s + \"ab\"; } else { s = s + \"ab\" + \"c\"; } } return s; } ";
+    mostrarTextos(codigo);
+  }
+  // Strings curtas ficam dentro do Valor e não alocam
+  string curtas = "string main() { string s = \"\"; for (int i = 0; i < 1000; i++) { s = \"abc\"; s = s + \"defg\"; } return s; } ";
+  mostrarTextos(curtas);
+}
+
+void testarArrays()
+{
+  cout << "\n=== 25. Teste: Arrays e Eliminacao de Verificacoes de Limites ===" << endl;
+  string kernel = "int a[1000]; "
+                  "int vizinhos(int rodadas) { int s = 0; for (int r = 0; r < rodadas; r++) { for (int i = 1; i < 999; i++) { s = s + a[i - 1] + a[i + 1] - a[i]; } } return s; } "
+                  "int main() { double b[1000]; for (int i = 0; i < 1000; i++) { a[i] = i * 3; b[i] = i; } "
+                  "double t = 0.0; for (int i = 0; i < 1000; i++) { for (int j = 0; j <= i; j++) { t = t + b[j] * 0.5; } } "
+                  "int k = 0; while (k < 10) { a[k] = 0; k++; } "
+                  "return vizinhos(100) + a[5]; } ";
+  mostrarArrays(kernel, "vizinhos");
+  // O índice depende de uma variável global: a verificação fica e o erro aparece
+  string foraDosLimites = "int n = 3; int main() { int a[3]; for (int i = 0; i <= n; i++) { a[i] = i; } return a[0]; } ";
+  mostrarArrays(foraDosLimites, "");
+
+  // Os mesmos programas no backend C: índices provados acessam o array
+  // direto, os outros passam por rt_indice
+  mostrarC(kernel);
+  mostrarC(foraDosLimites);
+
+  // No Jit os arrays locais ficam no quadro da função, um por chamada
+  string locais = "int vizinhos(int n) { int a[64]; double b[64]; for (int i = 0; i < 64; i++) { a[i] = i * n; b[i] = i * 0.5; } "
+                  "int s = 0; double t = 0.0; for (int r = 0; r < 1000; r++) { for (int i = 1; i < 63; i++) { s = s + a[i - 1] + a[i + 1] - a[i]; t = t + b[i]; } } "
+                  "if (t > 1000.0) { s = s + 1; } return s; } "
+                  "int pega(int k) { int a[4]; for (int i = 0; i < 4; i++) { a[i] = (i + 1) * 10; } a[k] = a[k] + 1; return a[k] * 2 + a[3]; } "
+                  "int recursiva(int n) { int a[3]; a[0] = n; if (n > 0) { a[1] = recursiva(n - 1); } return a[0] + a[1]; } "
+                  "double grande(int n) { double a[100000]; return a[n]; } "
+                  "int main() { return 0; } ";
+  mostrarJit(locais, {{"vizinhos", {3}}, {"pega", {2}}, {"pega", {7}}, {"pega", {-1}}, {"recursiva", {4}}, {"grande", {5}}});
+
+  // A troca de camada no meio de um laço passa os arrays já declarados
+  string quente = "int main() { int a[1000]; double b[1000]; for (int i = 0; i < 1000; i++) { a[i] = i; b[i] = i * 0.5; } "
+                  "int s = 0; for (int r = 0; r < 200; r++) { for (int i = 1; i < 999; i++) { s = s + a[i - 1] + a[i + 1] - a[i]; } } "
+                  "double t = 0.0; for (int i = 0; i < 1000; i++) { t = t + b[i]; } if (t > 0.0) { s = s + 1; } return s; } ";
+  mostrarExecucao(quente, 100, 500);
+
+  // Um array local indexado por uma variável vira uma só superinstrução
+  string soma = "int soma(int n) { int a[100]; for (int i = 0; i < 100; i++) { a[i] = i; } int s = 0; "
+                "for (int r = 0; r < n; r++) { for (int i = 0; i < 100; i++) { s = s + a[i]; } } return s; } "
+                "int main() { return soma(2000); } ";
+  mostrarBytecode(soma, "soma");
+}
+
+void testarBuiltins()
+{
+  cout << "\n=== 26. Teste: Funcoes Embutidas ===" << endl;
+  string programa = "double onda(int n) { double s = 0.0; for (int i = 1; i <= n; i++) { s = s + sqrt(i) + fabs(sin(i)) - floor(sqrt(i)); } return s; } "
+                    "int main() { print(\"embutidas\"); print(len(\"compilador\")); print(substr(\"compilador\", 0, 7)); "
+                    "print(max(3, abs(0 - 9))); print(pow(2, 10)); double r = onda(300000); print(r > 100000.0); print(floor(r)); "
+                    "return min(7, 4); } ";
+  mostrarBuiltins(programa, "onda");
+  // Uma função do programa tem precedência sobre a embutida de mesmo nome
+  string sombreada = "int max(int a, int b) { return a - b; } int main() { print(max(10, 3)); return max(1, 2); } ";
+  mostrarBuiltins(sombreada, "");
+  // Número e tipos dos argumentos são verificados na análise, não na execução
+  mostrarBuiltins("int main() { return len(5); } ", "");
+  mostrarBuiltins("int main() { print(1, 2); return 0; } ", "");
+  mostrarBuiltins("int main() { print(substr(\"abc\", 4, 1)); return 0; } ", "");
+}
+
+void testarBiblioteca()
+{
+  cout << "\n=== 27. Teste: Biblioteca e Contextos Reutilizaveis ===" << endl;
+  vector<string> programas = {
+      "int quadrado(int x) { return x * x; } int main() { int s = 0; for (int i = 0; i < 1000; i++) { s = s + quadrado(i); } print(s); return s; } ",
+      "string saudacao = \"ola\"; int main() { print(saudacao + \", mundo\"); print(sqrt(2.0)); return len(saudacao); } ",
+      "int main() { return x; } ",
+      "double media(int n) { double s = 0.0; for (int i = 1; i <= n; i++) { s = s + i; } return s / n; } int main() { print(media(10)); return 0; } "};
+
+  // Um mesmo contexto compila e executa programas em sequência
+  Compilador vm;
+  cout << "Contexto com a VM:" << endl;
+  mostrarCompilador(vm, programas);
+  cout << "Compilacoes: " << vm.getCompilacoes() << ", execucoes: " << vm.getExecucoes() << endl;
+  vm.reiniciar();
+  try
+  {
+    vm.executar();
+  }
+  catch (exception &e)
+  {
+    cout << "Depois de reiniciar: " << e.what() << endl;
+  }
+
+  // No Interpreter, os contadores e o código do Jit sobrevivem entre execuções
+  // do mesmo programa: soma é chamada 60 vezes por execução e passa a
+  // nativa na 100ª chamada, durante a segunda (sem o Inliner, que a
+  // expandiria em main)
+  OpcoesDoCompilador opcoes;
+  opcoes.motor = Motor::INTERPRETER;
+  opcoes.otimizar = false;
+  Compilador interpreter(opcoes);
+  cout << "Contexto com o Interpreter, tres execucoes do mesmo programa:" << endl;
+  mostrarCompilador(interpreter, {"int soma(int n) { int s = 0; for (int i = 0; i < n; i++) { s = s + i * 3 - i / 2; } return s; } "
+                                  "int main() { int t = 0; for (int k = 0; k < 60; k++) { t = t + soma(900); } return t; } "},
+                    3);
+
+  // Contextos independentes em threads diferentes, cada um com a sua saída
+  vector<string> saidas(4);
+  vector<thread> threads;
+  for (int t = 0; t < 4; t++)
+  {
+    threads.push_back(thread([t, &saidas]()
+                             {
+      Compilador contexto;
+      for (int n = 1; n <= 50; n++)
+      {
+        contexto.compilar("int main() { int s = 0; for (int i = 0; i <= " + to_string(n * (t + 1)) + "; i++) { s = s + i; } print(s); return s; } ");
+        contexto.executar();
+      }
+      saidas[t] = contexto.getSaida(); }));
+  }
+  for (thread &t : threads)
+  {
+    t.join();
+  }
+  for (int t = 0; t < 4; t++)
+  {
+    cout << "Thread " << t << ", ultimo programa: " << saidas[t];
+  }
+
+  // Interface C
+  compilador *contexto = compilador_criar(COMPILADOR_VM);
+  const char *fontes[] = {"int main() { print(\"via C\"); return 6 * 7; } ", "int main() { return \"a\" + 1; } "};
+  for (const char *fonte : fontes)
+  {
+    if (compilador_compilar(contexto, fonte) == 0 && compilador_executar(contexto) == 0)
+      cout << "API C: main() = " << compilador_resultado(contexto) << ", saida: " << compilador_saida(contexto);
+    else
+      cout << "API C: " << compilador_erro(contexto) << endl;
+  }
+  compilador_destruir(contexto);
+}
+
+void testarServidor()
+{
+  cout << "\n=== 28. Teste: Servidor de Compilacao ===" << endl;
+  string caminho = "/tmp/compilador_" + to_string(getpid()) + ".sock";
+  ServidorDeCompilacao servidor(caminho, 4);
+  servidor.iniciar();
+
+  vector<string> programas = {
+      "int fib(int n) { if (n < 2) { return n; } return fib(n - 1) + fib(n - 2); } int main() { return fib(15); } ",
+      "string nome = \"servidor\"; int main() { print(\"ola, \" + nome); return len(nome); } ",
+      "int main() { int s = 0; for (int i = 0; i < 100; i++) { s = s + i; } return s; } "};
+
+  // Uma conexão mostra os comandos e um erro de compilação
+  ClienteDeCompilacao cliente;
+  cliente.conectar(caminho);
+  bool ok;
+  string resposta = cliente.requisitar("CHECK", programas[0], ok);
+  cout << "CHECK: " << (ok ? "OK" : "ERRO") << endl;
+  resposta = cliente.requisitar("CHECK", "int main() { return y; } ", ok);
+  cout << "CHECK com erro: " << (ok ? "OK" : "ERRO") << " - " << resposta << endl;
+  resposta = cliente.requisitar("COMPILE", programas[2], ok);
+  cout << "COMPILE: " << (ok ? "OK" : "ERRO") << ", " << count(resposta.begin(), resposta.end(), '\n') << " linhas de bytecode" << endl;
+  resposta = cliente.requisitar("RUN", programas[1], ok);
+  cout << "RUN: " << (ok ? "OK" : "ERRO") << endl
+       << resposta;
+  resposta = cliente.requisitar("LINK", "", ok);
+  cout << "LINK: " << (ok ? "OK" : "ERRO") << " - " << resposta << endl;
+  // O comando leva o seu próprio cabeçalho, com um tamanho que não cabe em
+  // 64 bits; o servidor responde ERRO e fecha só esta conexão
+  resposta = cliente.requisitar("CHECK 99999999999999999999999\n", "", ok);
+  cout << "Tamanho com 23 digitos: " << (ok ? "OK" : "ERRO") << " - " << resposta << endl;
+  cliente.conectar(caminho);
+  cliente.requisitar("CHECK", programas[0], ok);
+  cout << "CHECK numa nova conexao: " << (ok ? "OK" : "ERRO") << endl;
+  // Recursão sem fim para no limite de chamadas, sem derrubar o servidor
+  resposta = cliente.requisitar("RUN", "int f(int n) { return f(n + 1) + 1; } int main() { return f(0); } ", ok);
+  cout << "RUN com recursao sem fim: " << (ok ? "OK" : "ERRO") << " - " << resposta << endl;
+  resposta = cliente.requisitar("RUN", programas[0], ok);
+  cout << "RUN em seguida: " << (ok ? "OK" : "ERRO") << " - " << resposta;
+  cliente.desconectar();
+
+  // Vários clientes ao mesmo tempo repetindo os mesmos programas: depois da
+  // primeira vez em cada thread do servidor, compilar é só achar a unidade
+  const int NUM_CLIENTES = 4;
+  const int REPETICOES = 50;
+  vector<long long> microssegundos(NUM_CLIENTES);
+  vector<int> falhas(NUM_CLIENTES);
+  vector<thread> threads;
+  for (int c = 0; c < NUM_CLIENTES; c++)
+  {
+    threads.push_back(thread([c, &caminho, &programas, &microssegundos, &falhas]()
+                             {
+      ClienteDeCompilacao cliente;
+      cliente.conectar(caminho);
+      auto inicio = chrono::steady_clock::now();
+      for (int r = 0; r < REPETICOES; r++)
+      {
+        bool ok;
+        string resposta = cliente.requisitar("RUN", programas[(c + r) % 3], ok);
+        string esperado = (c + r) % 3 == 0 ? "610\n" : (c + r) % 3 == 1 ? "8\nola, servidor\n" : "4950\n";
+        if (!ok || resposta != esperado)
+          falhas[c]++;
+      }
+      microssegundos[c] = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - inicio).count(); }));
+  }
+  for (thread &t : threads)
+  {
+    t.join();
+  }
+  long long total = 0;
+  int totalDeFalhas = 0;
+  for (int c = 0; c < NUM_CLIENTES; c++)
+  {
+    total += microssegundos[c];
+    totalDeFalhas += falhas[c];
+  }
+  cout << NUM_CLIENTES << " clientes x " << REPETICOES << " RUN: " << totalDeFalhas << " respostas erradas, "
+       << total / (NUM_CLIENTES * REPETICOES) << " us por requisicao em media" << endl;
+
+  cliente.conectar(caminho);
+  cout << "STATS:" << endl
+       << cliente.requisitar("STATS", "", ok);
+  cliente.desconectar();
+  servidor.parar();
+  cout << "Servidor parado, socket removido: " << (access(caminho.c_str(), F_OK) != 0 ? "sim" : "nao") << endl;
+
+  // Uma só thread: um laço sem fim para no limite de instruções, e um
+  // cliente ocioso não impede que outro seja atendido
+  OpcoesDoCompilador opcoes;
+  opcoes.limiteDeDespachos = 1000000;
+  ServidorDeCompilacao restrito(caminho, 1, opcoes);
+  restrito.setTempoDeEspera(200);
+  restrito.iniciar();
+  cliente.conectar(caminho);
+  resposta = cliente.requisitar("RUN", "int main() { int i = 0; while (1) { i = i + 1; } return i; } ", ok);
+  cout << "RUN com laco sem fim: " << (ok ? "OK" : "ERRO") << " - " << resposta << endl;
+  ClienteDeCompilacao outro;
+  outro.conectar(caminho);
+  auto inicio = chrono::steady_clock::now();
+  resposta = outro.requisitar("RUN", programas[2], ok);
+  long long ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - inicio).count();
+  cout << "Outro cliente com a thread ocupada por um ocioso, atendido depois do tempo de espera: " << (ms >= 150 ? "sim" : "nao")
+       << ", " << (ok ? "OK" : "ERRO") << " - " << resposta;
+  try
+  {
+    cliente.requisitar("CHECK", programas[0], ok);
+    cout << "Cliente ocioso: ainda conectado" << endl;
+  }
+  catch (exception &e)
+  {
+    cout << "Cliente ocioso: " << e.what() << endl;
+  }
+  outro.desconectar();
+  cliente.desconectar();
+  restrito.parar();
+
+  // No Interpreter o código nativo não tem limites: RUN é recusado
+  opcoes = OpcoesDoCompilador();
+  opcoes.motor = Motor::INTERPRETER;
+  ServidorDeCompilacao interpretado(caminho, 1, opcoes);
+  interpretado.iniciar();
+  cliente.conectar(caminho);
+  resposta = cliente.requisitar("RUN", programas[2], ok);
+  cout << "RUN com o Interpreter: " << (ok ? "OK" : "ERRO") << " - " << resposta << endl;
+  cliente.desconectar();
+  interpretado.parar();
+}
+
+void testarReusoDoLexerEParser()
+{
+  cout << "\n=== 29. Teste: Lexer e Parser Reutilizaveis ===" << endl;
+  // Muitos trechos pequenos, como numa verificação em lote
+  vector<string> trechos;
+  for (int n = 0; n < 3000; n++)
+  {
+    trechos.push_back("int f" + to_string(n) + "(int x) { if (x > " + to_string(n) + ") { return x * 2; } return x + " +
+                      to_string(n) + "; } int main() { string s = \"trecho\"; return f" + to_string(n) + "(" + to_string(n / 2) + "); } ");
+  }
+  trechos.push_back("int main() { return (1 + ; } ");
+
+  // Um Lexer e um Parser novos por trecho
+  vector<string> novos;
+  auto inicio = chrono::steady_clock::now();
+  for (const string &trecho : trechos)
+  {
+    try
+    {
+      Lexer lexer(trecho);
+      Parser parser(lexer.Analisar());
+      ProgramNode *ast = parser.analisar();
+      novos.push_back(ast->toString());
+      delete ast;
+    }
+    catch (exception &e)
+    {
+      novos.push_back(e.what());
+    }
+  }
+  auto usNovos = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - inicio).count();
+
+  // Os mesmos objetos, com reset entre os trechos
+  vector<string> reaproveitados;
+  Lexer lexer;
+  Parser parser;
+  inicio = chrono::steady_clock::now();
+  for (const string &trecho : trechos)
+  {
+    try
+    {
+      lexer.reset(trecho);
+      parser.reset(lexer.Analisar());
+      ProgramNode *ast = parser.analisar();
+      reaproveitados.push_back(ast->toString());
+      delete ast;
+    }
+    catch (exception &e)
+    {
+      reaproveitados.push_back(e.what());
+    }
+  }
+  auto usReaproveitados = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - inicio).count();
+
+  cout << trechos.size() << " trechos, mesmas ASTs: " << (novos == reaproveitados ? "sim" : "nao") << endl;
+  cout << "Ultimo trecho: " << reaproveitados.back() << endl;
+  cout << "Objetos novos: " << usNovos << " us, reaproveitados: " << usReaproveitados << " us" << endl;
+}
+
+void testarFluxoDeTokens()
+{
+  cout << "\n=== 30. Teste: Fluxo de Tokens Compacto ===" << endl;
+  Lexer lexer("string s = \"dois  espacos\"; double d = 3.25; if (d >= 1.0 && s != \"\") { d++; } ");
+  const FluxoDeTokens &tokens = lexer.Analisar();
+  for (size_t t = 0; t < tokens.size(); t++)
+  {
+    cout << Token::tipoParaString(tokens.getTipo(t)) << " [" << tokens.getInicio(t) << ", " << tokens.getTamanho(t)
+         << "] '" << tokens.getLexema(t) << "'" << endl;
+  }
+
+  // Um programa grande: memória dos tokens e tempo de análise
+  string codigo;
+  for (int n = 0; n < 20000; n++)
+  {
+    codigo += "int funcao" + to_string(n) + "(int a, int b) { if (a > b) { return a - b; } return a * b + " + to_string(n) + "; } ";
+  }
+  auto inicio = chrono::steady_clock::now();
+  lexer.reset(codigo);
+  const FluxoDeTokens &grande = lexer.Analisar();
+  auto lexado = chrono::steady_clock::now();
+  Parser parser(grande);
+  ProgramNode *ast = parser.analisar();
+  auto analisado = chrono::steady_clock::now();
+  cout << grande.size() << " tokens, " << grande.getBytes() << " bytes no fluxo ("
+       << grande.getBytes() / grande.size() << " por token; com uma string por token seriam "
+       << grande.size() * sizeof(pair<TipoDeToken, string>) << ")" << endl;
+  cout << ast->getFunctions().size() << " funcoes; lexer: " << chrono::duration_cast<chrono::milliseconds>(lexado - inicio).count()
+       << " ms, parser: " << chrono::duration_cast<chrono::milliseconds>(analisado - lexado).count() << " ms" << endl;
+  delete ast;
+}
+
+void testarLexerParalelo()
+{
+  cout << "\n=== 31. Teste: Lexer Paralelo Especulativo ===" << endl;
+  // Código grande em várias linhas, com strings cheias de espaços
+  string frase;
+  for (int p = 0; p < 50; p++)
+  {
+    frase += "palavra ";
+  }
+  string codigo;
+  for (int n = 0; codigo.size() < 16 * 1024 * 1024; n++)
+  {
+    codigo += "string texto" + to_string(n) + "() { return \"" + frase + "\"; }\nint valor" + to_string(n) +
+              "(int a) {\n  if (a >= 10 && a != 20) { a++; }\n  return a * 2 + 3.5;\n}\n";
+  }
+
+  Lexer sequencial(codigo);
+  auto inicio = chrono::steady_clock::now();
+  const FluxoDeTokens &esperado = sequencial.Analisar();
+  auto msSequencial = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - inicio).count();
+  cout << codigo.size() / (1024 * 1024) << " MB, " << esperado.size() << " tokens" << endl;
+  cout << "Sequencial: " << msSequencial << " ms" << endl;
+
+  Lexer paralelo(codigo);
+  for (int threads : {2, 4, 8})
+  {
+    inicio = chrono::steady_clock::now();
+    const FluxoDeTokens &tokens = paralelo.AnalisarEmParalelo(threads);
+    auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - inicio).count();
+    cout << threads << " threads: " << ms << " ms, mesmos tokens: " << (mesmosTokens(esperado, tokens) ? "sim" : "nao")
+         << ", trechos refeitos: " << paralelo.getTrechosRefeitos() << endl;
+  }
+
+  // Uma string com quebras de linha que atravessa todos os cortes: os
+  // trechos depois do primeiro começam dentro dela e são refeitos
+  string longa = "string s = \"";
+  for (int n = 0; longa.size() < 2 * 1024 * 1024; n++)
+  {
+    longa += "linha " + to_string(n) + "; int x = 1;\n";
+  }
+  longa += "\"; int fim = 1; ";
+  Lexer umaString(longa);
+  FluxoDeTokens copia = umaString.Analisar();
+  const FluxoDeTokens &tokens = umaString.AnalisarEmParalelo(4);
+  cout << "String de " << longa.size() / 1024 << " KB: " << tokens.size() << " tokens, mesmos tokens: " << (mesmosTokens(copia, tokens) ? "sim" : "nao")
+       << ", trechos refeitos: " << umaString.getTrechosRefeitos() << endl;
+
+  // Os erros são os mesmos da análise sequencial: uma string que nunca
+  // fecha e um caractere inválido fora de uma string (dentro dela, é texto)
+  for (const string &final : {string("string s = \"sem fim; "), string("int x = 1 # 2; "), string("string t = \"# ok\"; ")})
+  {
+    string comErro = codigo + final;
+    string mensagens[2];
+    Lexer lexer(comErro);
+    try
+    {
+      lexer.Analisar();
+      mensagens[0] = "ok";
+    }
+    catch (exception &e)
+    {
+      mensagens[0] = e.what();
+    }
+    try
+    {
+      lexer.AnalisarEmParalelo(4);
+      mensagens[1] = "ok";
+    }
+    catch (exception &e)
+    {
+      mensagens[1] = e.what();
+    }
+    cout << "Final '" << final << "': sequencial: " << mensagens[0] << ", paralelo: " << mensagens[1] << endl;
+  }
+}
+
+void testarPipeline()
+{
+  cout << "\n=== 32. Teste: Lexer e Parser em Pipeline ===" << endl;
+  // Funções com atribuições a array e for, em que o Parser volta atrás
+  string codigo;
+  for (int n = 0; n < 20000; n++)
+  {
+    codigo += "int f" + to_string(n) + "(int a) { int v[4]; for (i = 0; i < 4; i++) { v[i] = a * i + " + to_string(n) +
+              "; } v[v[0] - v[0]] = 1; return v[3]; }\n";
+  }
+
+  Lexer lexer(codigo);
+  Parser parser;
+  auto inicio = chrono::steady_clock::now();
+  parser.reset(lexer.Analisar());
+  ProgramNode *sequencial = parser.analisar();
+  auto msSequencial = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - inicio).count();
+
+  inicio = chrono::steady_clock::now();
+  ProgramNode *emPipeline = parser.analisarEmPipeline(lexer);
+  auto msPipeline = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - inicio).count();
+  cout << emPipeline->getFunctions().size() << " funcoes, mesma AST: " << (sequencial->toString() == emPipeline->toString() ? "sim" : "nao") << endl;
+  cout << "Sequencial: " << msSequencial << " ms, em pipeline: " << msPipeline << " ms" << endl;
+  delete sequencial;
+  delete emPipeline;
+
+  // Os erros são os da análise sequencial: um erro léxico no fim do código
+  // tem precedência sobre um erro sintático no começo
+  for (const string &trecho : {string("int main() { return (1 + ; } ") + codigo, codigo + "int main() { return 1 # 2; } ",
+                               string("int main() { return (1 + ; } ") + codigo + "string s = \"sem fim; "})
+  {
+    string mensagens[2];
+    Lexer comErro(trecho);
+    try
+    {
+      Parser(comErro.Analisar()).analisar();
+    }
+    catch (exception &e)
+    {
+      mensagens[0] = e.what();
+    }
+    try
+    {
+      Parser().analisarEmPipeline(comErro);
+    }
+    catch (exception &e)
+    {
+      mensagens[1] = e.what();
+    }
+    cout << "Sequencial: " << mensagens[0] << " | em pipeline: " << mensagens[1] << endl;
+  }
+}
+
+int main(int argc, char **argv)
 {
+  // Modo servidor: lexer_program --servidor <caminho> [threads]
+  if (argc >= 3 && strcmp(argv[1], "--servidor") == 0)
+  {
+    // SIGINT e SIGTERM ficam bloqueados em todas as threads e são
+    // esperados aqui, para parar o servidor de forma ordenada
+    sigset_t sinais;
+    sigemptyset(&sinais);
+    sigaddset(&sinais, SIGINT);
+    sigaddset(&sinais, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &sinais, nullptr);
+
+    ServidorDeCompilacao servidor(argv[2], argc >= 4 ? atoi(argv[3]) : 4);
+    try
+    {
+      servidor.iniciar();
+    }
+    catch (exception &e)
+    {
+      cerr << e.what() << endl;
+      return 1;
+    }
+    cout << "Servidor de compilacao em " << argv[2] << endl;
+    int sinal;
+    sigwait(&sinais, &sinal);
+    servidor.parar();
+    cout << "Requisicoes: " << servidor.getRequisicoes() << ", acertos do cache: " << servidor.getAcertosDoCache() << endl;
+    return 0;
+  }
+
   cout << "Iniciando Testes do Compilador" << endl
        << "===============================" << endl;
 
@@ -99,6 +1717,31 @@ int main()
   testarProgramaCompleto2();
   testarEstruturasControle();
   testarFor();
+  testarResolucaoDeNomes();
+  testarTipos();
+  testarLiterais();
+  testarDobraDeConstantes();
+  testarIR();
+  testarGVN();
+  testarOtimizacaoDeLacos();
+  testarCodigoMorto();
+  testarInlining();
+  testarDataflow();
+  testarAlocacaoDeRegistradores();
+  testarBackendC();
+  testarJit();
+  testarExecucaoEmCamadas();
+  testarBytecode();
+  testarValores();
+  testarTextos();
+  testarArrays();
+  testarBuiltins();
+  testarBiblioteca();
+  testarServidor();
+  testarReusoDoLexerEParser();
+  testarFluxoDeTokens();
+  testarLexerParalelo();
+  testarPipeline();
 
   cout << "Todos os testes concluidos com sucesso!" << endl;
 
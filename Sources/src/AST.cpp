@@ -1,16 +1,37 @@
 #include "AST.h"
+#include "Numero.h"
 #include <sstream>
 
 using namespace std;
 
-string LiteralNode::toString(int indent) const
+// Sufixo "@profundidade:slot" exibido apenas para nomes já resolvidos
+static string bindingToString(const Binding &binding)
+{
+  if (!binding.isResolved())
+  {
+    return "";
+  }
+  return "@" + to_string(binding.depth) + ":" + to_string(binding.slot);
+}
+
+string IntLiteralNode::toString(int indent) const
+{
+  return string(indent, ' ') + "Literal(" + to_string(value) + ")";
+}
+
+string RealLiteralNode::toString(int indent) const
+{
+  return string(indent, ' ') + "Literal(" + formatarReal(value) + ")";
+}
+
+string StringLiteralNode::toString(int indent) const
 {
   return string(indent, ' ') + "Literal(" + value + ")";
 }
 
 string IdentifierNode::toString(int indent) const
 {
-  return string(indent, ' ') + "Identifier(" + name + ")";
+  return string(indent, ' ') + "Identifier(" + name + bindingToString(binding) + ")";
 }
 
 ArrayAccessNode::~ArrayAccessNode()
@@ -21,9 +42,9 @@ ArrayAccessNode::~ArrayAccessNode()
 string ArrayAccessNode::toString(int indent) const
 {
   stringstream ss;
-  ss << string(indent, ' ') << "ArrayAccess(" << name << "[" << endl;
+  ss << string(indent, ' ') << "ArrayAccess(" << name << bindingToString(binding) << "[" << endl;
   ss << index->toString(indent + 2) << endl;
-  ss << string(indent, ' ') << "])";
+  ss << string(indent, ' ') << "]" << (boundsCheck ? "" : ", sem verificacao") << ")";
   return ss.str();
 }
 
@@ -55,6 +76,19 @@ string BinaryOpNode::toString(int indent) const
   return ss.str();
 }
 
+ConversionNode::~ConversionNode()
+{
+  delete operand;
+}
+
+string ConversionNode::toString(int indent) const
+{
+  stringstream ss;
+  ss << string(indent, ' ') << "Conversion(" << tipoDeDadoParaString(getTipo()) << ")" << endl;
+  ss << operand->toString(indent + 2);
+  return ss.str();
+}
+
 FunctionCallNode::~FunctionCallNode()
 {
   for (auto arg : args)
@@ -66,7 +100,16 @@ FunctionCallNode::~FunctionCallNode()
 string FunctionCallNode::toString(int indent) const
 {
   stringstream ss;
-  ss << string(indent, ' ') << "FunctionCall(" << name << ")" << endl;
+  ss << string(indent, ' ') << "FunctionCall(" << name;
+  if (functionIndex >= 0)
+  {
+    ss << "#" << functionIndex;
+  }
+  else if (builtinIndex >= 0)
+  {
+    ss << ", embutida #" << builtinIndex;
+  }
+  ss << ")" << endl;
   for (auto arg : args)
   {
     ss << arg->toString(indent + 2) << endl;
@@ -105,7 +148,11 @@ VariableDeclarationNode::~VariableDeclarationNode()
 string VariableDeclarationNode::toString(int indent) const
 {
   stringstream ss;
-  ss << string(indent, ' ') << "VarDecl(" << type << " " << name;
+  ss << string(indent, ' ') << "VarDecl(" << type << " " << name << bindingToString(binding);
+  if (isArray())
+  {
+    ss << "[" << arraySize << "]";
+  }
   if (initialValue)
   {
     ss << " = " << initialValue->toString(0);
@@ -117,12 +164,23 @@ string VariableDeclarationNode::toString(int indent) const
 AssignmentNode::~AssignmentNode()
 {
   delete value;
+  if (index)
+  {
+    delete index;
+  }
 }
 
 string AssignmentNode::toString(int indent) const
 {
   stringstream ss;
-  ss << string(indent, ' ') << "Assign(" << name << " = " << endl;
+  ss << string(indent, ' ') << "Assign(" << name << bindingToString(binding);
+  if (index)
+  {
+    ss << "[" << endl;
+    ss << index->toString(indent + 2) << endl;
+    ss << string(indent, ' ') << "]" << (boundsCheck ? "" : ", sem verificacao");
+  }
+  ss << " = " << endl;
   ss << value->toString(indent + 2) << ")";
   return ss.str();
 }
@@ -256,7 +314,7 @@ string FunctionNode::toString(int indent) const
   ss << string(indent, ' ') << "Function(" << returnType << " " << name << "(";
   for (size_t i = 0; i < params.size(); i++)
   {
-    ss << params[i]->getType() << " " << params[i]->getName();
+    ss << params[i]->getType() << " " << params[i]->getName() << bindingToString(params[i]->getBinding());
     if (i < params.size() - 1)
     {
       ss << ", ";
@@ -0,0 +1,343 @@
+#include "BoundsCheckEliminator.h"
+#include <iterator>
+
+using namespace std;
+
+namespace
+{
+  // Maior valor absoluto considerado nos intervalos: somas e diferenças de
+  // poucos termos ficam longe do estouro de int64_t
+  const int64_t LIMITE = int64_t(1) << 40;
+
+  bool dentroDoLimite(int64_t valor)
+  {
+    return valor >= -LIMITE && valor <= LIMITE;
+  }
+
+  bool isVariavel(ExpressionNode *expr, Binding variavel)
+  {
+    auto ident = dynamic_cast<IdentifierNode *>(expr);
+    return ident && ident->getBinding().depth == variavel.depth && ident->getBinding().slot == variavel.slot;
+  }
+
+  // Verdadeiro se algum statement ou expressão dentro de "node" atribui à variável
+  bool atribuiA(ASTNode *node, Binding variavel)
+  {
+    if (!node)
+      return false;
+    if (auto assign = dynamic_cast<AssignmentNode *>(node))
+    {
+      bool mesma = !assign->getIndex() && assign->getBinding().depth == variavel.depth &&
+                   assign->getBinding().slot == variavel.slot;
+      return mesma || atribuiA(assign->getIndex(), variavel) || atribuiA(assign->getValue(), variavel);
+    }
+    if (auto unary = dynamic_cast<UnaryOpNode *>(node))
+      return (unary->getOp() != "!" && isVariavel(unary->getOperand(), variavel)) || atribuiA(unary->getOperand(), variavel);
+    if (auto binary = dynamic_cast<BinaryOpNode *>(node))
+      return (binary->getOp() == "=" && isVariavel(binary->getLeft(), variavel)) || atribuiA(binary->getLeft(), variavel) ||
+             atribuiA(binary->getRight(), variavel);
+    if (auto conversion = dynamic_cast<ConversionNode *>(node))
+      return atribuiA(conversion->getOperand(), variavel);
+    if (auto access = dynamic_cast<ArrayAccessNode *>(node))
+      return atribuiA(access->getIndex(), variavel);
+    if (auto call = dynamic_cast<FunctionCallNode *>(node))
+    {
+      for (auto arg : call->getArgs())
+      {
+        if (atribuiA(arg, variavel))
+          return true;
+      }
+      return false;
+    }
+    if (auto block = dynamic_cast<BlockNode *>(node))
+    {
+      for (auto stmt : block->getStatements())
+      {
+        if (atribuiA(stmt, variavel))
+          return true;
+      }
+      return false;
+    }
+    if (auto decl = dynamic_cast<VariableDeclarationNode *>(node))
+      return atribuiA(decl->getInitialValue(), variavel);
+    if (auto ifStmt = dynamic_cast<IfStatementNode *>(node))
+      return atribuiA(ifStmt->getCondition(), variavel) || atribuiA(ifStmt->getThenBlock(), variavel) ||
+             atribuiA(ifStmt->getElseBlock(), variavel);
+    if (auto whileStmt = dynamic_cast<WhileStatementNode *>(node))
+      return atribuiA(whileStmt->getCondition(), variavel) || atribuiA(whileStmt->getBody(), variavel);
+    if (auto forStmt = dynamic_cast<ForStatementNode *>(node))
+      return atribuiA(forStmt->getInit(), variavel) || atribuiA(forStmt->getCondition(), variavel) ||
+             atribuiA(forStmt->getUpdate(), variavel) || atribuiA(forStmt->getBody(), variavel);
+    if (auto ret = dynamic_cast<ReturnStatementNode *>(node))
+      return atribuiA(ret->getValue(), variavel);
+    if (auto exprStmt = dynamic_cast<ExpressionStatementNode *>(node))
+      return atribuiA(exprStmt->getExpression(), variavel);
+    return false;
+  }
+
+  // "i++", "++i" ou "i = i + k" / "i = k + i" com k > 0
+  bool isAvanco(ExpressionNode *update, Binding variavel)
+  {
+    if (auto unary = dynamic_cast<UnaryOpNode *>(update))
+    {
+      return unary->getOp() == "++" && isVariavel(unary->getOperand(), variavel);
+    }
+    auto binary = dynamic_cast<BinaryOpNode *>(update);
+    if (!binary || binary->getOp() != "=" || !isVariavel(binary->getLeft(), variavel))
+    {
+      return false;
+    }
+    auto soma = dynamic_cast<BinaryOpNode *>(binary->getRight());
+    if (!soma || soma->getOp() != "+")
+    {
+      return false;
+    }
+    ExpressionNode *outro = isVariavel(soma->getLeft(), variavel)    ? soma->getRight()
+                            : isVariavel(soma->getRight(), variavel) ? soma->getLeft()
+                                                                     : nullptr;
+    auto passo = dynamic_cast<IntLiteralNode *>(outro);
+    return passo && passo->getValue() > 0 && dentroDoLimite(passo->getValue());
+  }
+}
+
+BoundsCheckEliminator::BoundsCheckEliminator() : eliminadas(0), mantidas(0)
+{
+}
+
+int BoundsCheckEliminator::chave(Binding binding)
+{
+  return binding.isGlobal() ? -(binding.slot + 1) : binding.slot;
+}
+
+void BoundsCheckEliminator::otimizar(ProgramNode *program)
+{
+  eliminadas = 0;
+  mantidas = 0;
+  tamanhos.clear();
+  // Arrays globais, que as funções podem acessar antes da declaração no texto
+  for (auto function : program->getFunctions())
+  {
+    if (!function->isGlobalWrapper())
+      continue;
+    for (auto stmt : function->getBody()->getStatements())
+    {
+      auto decl = dynamic_cast<VariableDeclarationNode *>(stmt);
+      if (decl && decl->isArray())
+      {
+        tamanhos[chave(decl->getBinding())] = decl->getArraySize();
+      }
+    }
+  }
+
+  for (auto function : program->getFunctions())
+  {
+    for (auto it = tamanhos.begin(); it != tamanhos.end();)
+    {
+      it = it->first >= 0 ? tamanhos.erase(it) : next(it);
+    }
+    intervalos.clear();
+    analisarBloco(function->getBody());
+  }
+}
+
+void BoundsCheckEliminator::analisarBloco(BlockNode *block)
+{
+  for (auto stmt : block->getStatements())
+  {
+    analisarStatement(stmt);
+  }
+}
+
+void BoundsCheckEliminator::analisarStatement(StatementNode *stmt)
+{
+  if (auto decl = dynamic_cast<VariableDeclarationNode *>(stmt))
+  {
+    if (decl->isArray())
+    {
+      tamanhos[chave(decl->getBinding())] = decl->getArraySize();
+    }
+    analisarExpressao(decl->getInitialValue());
+  }
+  else if (auto assign = dynamic_cast<AssignmentNode *>(stmt))
+  {
+    analisarExpressao(assign->getValue());
+    if (assign->getIndex())
+    {
+      analisarExpressao(assign->getIndex());
+      assign->setNeedsBoundsCheck(precisaVerificar(assign->getBinding(), assign->getIndex()));
+    }
+  }
+  else if (auto block = dynamic_cast<BlockNode *>(stmt))
+  {
+    analisarBloco(block);
+  }
+  else if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+  {
+    analisarExpressao(ifStmt->getCondition());
+    analisarBloco(ifStmt->getThenBlock());
+    if (ifStmt->getElseBlock())
+    {
+      analisarBloco(ifStmt->getElseBlock());
+    }
+  }
+  else if (auto whileStmt = dynamic_cast<WhileStatementNode *>(stmt))
+  {
+    analisarExpressao(whileStmt->getCondition());
+    analisarBloco(whileStmt->getBody());
+  }
+  else if (auto forStmt = dynamic_cast<ForStatementNode *>(stmt))
+  {
+    analisarFor(forStmt);
+  }
+  else if (auto ret = dynamic_cast<ReturnStatementNode *>(stmt))
+  {
+    analisarExpressao(ret->getValue());
+  }
+  else if (auto exprStmt = dynamic_cast<ExpressionStatementNode *>(stmt))
+  {
+    analisarExpressao(exprStmt->getExpression());
+  }
+}
+
+void BoundsCheckEliminator::analisarFor(ForStatementNode *forStmt)
+{
+  // A condição e a atualização também executam com a variável fora do
+  // intervalo (na última iteração): são analisadas sem ele
+  if (forStmt->getInit())
+  {
+    analisarStatement(forStmt->getInit());
+  }
+  analisarExpressao(forStmt->getCondition());
+  analisarExpressao(forStmt->getUpdate());
+
+  Binding variavel;
+  Intervalo intervalo;
+  if (!variavelDeLaco(forStmt, variavel, intervalo))
+  {
+    analisarBloco(forStmt->getBody());
+    return;
+  }
+  intervalos[chave(variavel)] = intervalo;
+  analisarBloco(forStmt->getBody());
+  intervalos.erase(chave(variavel));
+}
+
+void BoundsCheckEliminator::analisarExpressao(ExpressionNode *expr)
+{
+  if (!expr)
+  {
+    return;
+  }
+  if (auto access = dynamic_cast<ArrayAccessNode *>(expr))
+  {
+    analisarExpressao(access->getIndex());
+    access->setNeedsBoundsCheck(precisaVerificar(access->getBinding(), access->getIndex()));
+  }
+  else if (auto unary = dynamic_cast<UnaryOpNode *>(expr))
+  {
+    analisarExpressao(unary->getOperand());
+  }
+  else if (auto binary = dynamic_cast<BinaryOpNode *>(expr))
+  {
+    analisarExpressao(binary->getLeft());
+    analisarExpressao(binary->getRight());
+  }
+  else if (auto conversion = dynamic_cast<ConversionNode *>(expr))
+  {
+    analisarExpressao(conversion->getOperand());
+  }
+  else if (auto call = dynamic_cast<FunctionCallNode *>(expr))
+  {
+    for (auto arg : call->getArgs())
+    {
+      analisarExpressao(arg);
+    }
+  }
+}
+
+bool BoundsCheckEliminator::precisaVerificar(Binding binding, ExpressionNode *index)
+{
+  auto tamanho = tamanhos.find(chave(binding));
+  Intervalo intervalo;
+  if (tamanho != tamanhos.end() && intervaloDe(index, intervalo) && intervalo.minimo >= 0 &&
+      intervalo.maximo < tamanho->second)
+  {
+    eliminadas++;
+    return false;
+  }
+  mantidas++;
+  return true;
+}
+
+bool BoundsCheckEliminator::intervaloDe(ExpressionNode *expr, Intervalo &intervalo)
+{
+  if (auto literal = dynamic_cast<IntLiteralNode *>(expr))
+  {
+    intervalo.minimo = intervalo.maximo = literal->getValue();
+    return dentroDoLimite(literal->getValue());
+  }
+  if (auto ident = dynamic_cast<IdentifierNode *>(expr))
+  {
+    auto it = ident->getBinding().isGlobal() ? intervalos.end() : intervalos.find(chave(ident->getBinding()));
+    if (it == intervalos.end())
+      return false;
+    intervalo = it->second;
+    return true;
+  }
+  auto binary = dynamic_cast<BinaryOpNode *>(expr);
+  Intervalo a, b;
+  if (!binary || (binary->getOp() != "+" && binary->getOp() != "-") || !intervaloDe(binary->getLeft(), a) ||
+      !intervaloDe(binary->getRight(), b))
+  {
+    return false;
+  }
+  if (binary->getOp() == "+")
+  {
+    intervalo.minimo = a.minimo + b.minimo;
+    intervalo.maximo = a.maximo + b.maximo;
+  }
+  else
+  {
+    intervalo.minimo = a.minimo - b.maximo;
+    intervalo.maximo = a.maximo - b.minimo;
+  }
+  return dentroDoLimite(intervalo.minimo) && dentroDoLimite(intervalo.maximo);
+}
+
+bool BoundsCheckEliminator::variavelDeLaco(ForStatementNode *forStmt, Binding &variavel, Intervalo &intervalo)
+{
+  // Inicialização: "int i = inicio" ou "i = inicio"
+  ExpressionNode *inicio = nullptr;
+  if (auto decl = dynamic_cast<VariableDeclarationNode *>(forStmt->getInit()))
+  {
+    variavel = decl->getBinding();
+    inicio = decl->isArray() ? nullptr : decl->getInitialValue();
+  }
+  else if (auto assign = dynamic_cast<AssignmentNode *>(forStmt->getInit()))
+  {
+    variavel = assign->getBinding();
+    inicio = assign->getIndex() ? nullptr : assign->getValue();
+  }
+  Intervalo inicial, limite;
+  if (!inicio || variavel.isGlobal() || !intervaloDe(inicio, inicial))
+  {
+    return false;
+  }
+
+  // Condição: "i < limite" ou "i <= limite"
+  auto condicao = dynamic_cast<BinaryOpNode *>(forStmt->getCondition());
+  if (!condicao || (condicao->getOp() != "<" && condicao->getOp() != "<=") || !isVariavel(condicao->getLeft(), variavel) ||
+      condicao->getLeft()->getTipo() != TipoDeDado::INT || !intervaloDe(condicao->getRight(), limite))
+  {
+    return false;
+  }
+
+  // Atualização crescente, e nenhuma outra atribuição a i no corpo
+  if (!isAvanco(forStmt->getUpdate(), variavel) || atribuiA(forStmt->getBody(), variavel))
+  {
+    return false;
+  }
+  intervalo.minimo = inicial.minimo;
+  intervalo.maximo = condicao->getOp() == "<" ? limite.maximo - 1 : limite.maximo;
+  return true;
+}
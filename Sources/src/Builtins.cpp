@@ -0,0 +1,183 @@
+#include "Builtins.h"
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace std;
+
+namespace
+{
+  thread_local ostream *saidaDaThread = nullptr;
+
+  ostream &saida()
+  {
+    return saidaDaThread ? *saidaDaThread : cout;
+  }
+
+  double real(uint64_t bits)
+  {
+    double valor;
+    memcpy(&valor, &bits, sizeof(valor));
+    return valor;
+  }
+
+  uint64_t bits(double valor)
+  {
+    uint64_t resultado;
+    memcpy(&resultado, &valor, sizeof(resultado));
+    return resultado;
+  }
+
+  // print: o valor seguido de quebra de linha, no formato de Valor::toString
+  Valor imprimir(const Valor *argumentos)
+  {
+    saida() << argumentos[0].toString() << '\n';
+    return Valor();
+  }
+
+  uint64_t imprimirInteiroEmBits(const uint64_t *argumentos)
+  {
+    saida() << int64_t(argumentos[0]) << '\n';
+    return 0;
+  }
+
+  uint64_t imprimirRealEmBits(const uint64_t *argumentos)
+  {
+    saida() << Valor::deReal(real(argumentos[0])).toString() << '\n';
+    return 0;
+  }
+
+  // double -> double da biblioteca C (sqrt, sin, ...)
+  template <double (*F)(double)>
+  Valor real1(const Valor *argumentos)
+  {
+    return Valor::deReal(F(argumentos[0].real));
+  }
+
+  template <double (*F)(double)>
+  uint64_t real1EmBits(const uint64_t *argumentos)
+  {
+    return bits(F(real(argumentos[0])));
+  }
+
+  Valor potencia(const Valor *argumentos)
+  {
+    return Valor::deReal(pow(argumentos[0].real, argumentos[1].real));
+  }
+
+  uint64_t potenciaEmBits(const uint64_t *argumentos)
+  {
+    return bits(pow(real(argumentos[0]), real(argumentos[1])));
+  }
+
+  // Como na aritmética da linguagem, abs(INT64_MIN) dá a volta
+  int64_t absoluto(int64_t v)
+  {
+    return v < 0 ? int64_t(0 - uint64_t(v)) : v;
+  }
+
+  Valor absolutoInteiro(const Valor *argumentos)
+  {
+    return Valor::deInteiro(absoluto(argumentos[0].inteiro));
+  }
+
+  uint64_t absolutoInteiroEmBits(const uint64_t *argumentos)
+  {
+    return absoluto(int64_t(argumentos[0]));
+  }
+
+  Valor minimo(const Valor *argumentos)
+  {
+    return Valor::deInteiro(min(argumentos[0].inteiro, argumentos[1].inteiro));
+  }
+
+  uint64_t minimoEmBits(const uint64_t *argumentos)
+  {
+    return min(int64_t(argumentos[0]), int64_t(argumentos[1]));
+  }
+
+  Valor maximo(const Valor *argumentos)
+  {
+    return Valor::deInteiro(max(argumentos[0].inteiro, argumentos[1].inteiro));
+  }
+
+  uint64_t maximoEmBits(const uint64_t *argumentos)
+  {
+    return max(int64_t(argumentos[0]), int64_t(argumentos[1]));
+  }
+
+  Valor comprimento(const Valor *argumentos)
+  {
+    return Valor::deInteiro(argumentos[0].comprimento);
+  }
+
+  // substr(s, inicio, n): até n caracteres a partir de inicio
+  Valor subtexto(const Valor *argumentos)
+  {
+    const Valor &texto = argumentos[0];
+    int64_t inicio = argumentos[1].inteiro;
+    int64_t n = argumentos[2].inteiro;
+    if (inicio < 0 || n < 0 || inicio > int64_t(texto.comprimento))
+    {
+      throw runtime_error("Erro de execucao: substr(" + to_string(inicio) + ", " + to_string(n) +
+                          ") fora dos limites da string de tamanho " + to_string(texto.comprimento));
+    }
+    n = min(n, int64_t(texto.comprimento) - inicio);
+    return Valor::deTexto(string(texto.dados() + inicio, n));
+  }
+
+  const TipoDeDado INT = TipoDeDado::INT;
+  const TipoDeDado DOUBLE = TipoDeDado::DOUBLE;
+  const TipoDeDado STRING = TipoDeDado::STRING;
+  const TipoDeDado VOID = TipoDeDado::VOID;
+}
+
+const Builtin BUILTINS[] = {
+    {"print", VOID, 1, {INT}, imprimir, imprimirInteiroEmBits, "rt_print_int"},
+    {"print", VOID, 1, {DOUBLE}, imprimir, imprimirRealEmBits, "rt_print_real"},
+    {"print", VOID, 1, {STRING}, imprimir, nullptr, "rt_print_str"},
+    {"sqrt", DOUBLE, 1, {DOUBLE}, real1<sqrt>, real1EmBits<sqrt>, "sqrt"},
+    {"sin", DOUBLE, 1, {DOUBLE}, real1<sin>, real1EmBits<sin>, "sin"},
+    {"cos", DOUBLE, 1, {DOUBLE}, real1<cos>, real1EmBits<cos>, "cos"},
+    {"exp", DOUBLE, 1, {DOUBLE}, real1<exp>, real1EmBits<exp>, "exp"},
+    {"log", DOUBLE, 1, {DOUBLE}, real1<log>, real1EmBits<log>, "log"},
+    {"floor", DOUBLE, 1, {DOUBLE}, real1<floor>, real1EmBits<floor>, "floor"},
+    {"fabs", DOUBLE, 1, {DOUBLE}, real1<fabs>, real1EmBits<fabs>, "fabs"},
+    {"pow", DOUBLE, 2, {DOUBLE, DOUBLE}, potencia, potenciaEmBits, "pow"},
+    {"abs", INT, 1, {INT}, absolutoInteiro, absolutoInteiroEmBits, "rt_abs"},
+    {"min", INT, 2, {INT, INT}, minimo, minimoEmBits, "rt_min"},
+    {"max", INT, 2, {INT, INT}, maximo, maximoEmBits, "rt_max"},
+    {"len", INT, 1, {STRING}, comprimento, nullptr, "rt_len"},
+    {"substr", STRING, 3, {STRING, INT, INT}, subtexto, nullptr, "rt_substr"},
+};
+
+const int NUM_BUILTINS = sizeof(BUILTINS) / sizeof(BUILTINS[0]);
+
+static unordered_map<string, int> indicesDosBuiltins()
+{
+  unordered_map<string, int> indices;
+  for (int i = NUM_BUILTINS - 1; i >= 0; i--)
+  {
+    indices[BUILTINS[i].nome] = i;
+  }
+  return indices;
+}
+
+void setSaidaDosBuiltins(ostream *saida)
+{
+  saidaDaThread = saida;
+}
+
+ostream *getSaidaDosBuiltins()
+{
+  return saidaDaThread;
+}
+
+int buscarBuiltin(const string &nome)
+{
+  static const unordered_map<string, int> indices = indicesDosBuiltins();
+  auto it = indices.find(nome);
+  return it == indices.end() ? -1 : it->second;
+}
@@ -0,0 +1,166 @@
+#include "Bytecode.h"
+#include "Builtins.h"
+#include "Numero.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+string opBCParaString(OpBC op)
+{
+  static const char *nomes[] = {
+      "const", "load", "store", "loadg", "storeg", "pop", "dup",
+      "add_int", "sub_int", "mul_int", "div_int",
+      "add_real", "sub_real", "mul_real", "div_real", "concat",
+      "lt_int", "gt_int", "le_int", "ge_int", "eq_int", "ne_int",
+      "lt_real", "gt_real", "le_real", "ge_real", "eq_real", "ne_real",
+      "lt_str", "gt_str", "le_str", "ge_str", "eq_str", "ne_str",
+      "not", "itod", "jmp", "jmp_if_false", "jmp_if_true", "call", "call_builtin", "ret", "ret_void",
+      "new_array", "load_elem", "store_elem", "load_elem_nc", "store_elem_nc",
+      "load2", "load_const", "add_int_ll", "inc_local", "jmp_if_not_cmp", "load_elem_l", "load_elem_l_nc"};
+  static_assert(sizeof(nomes) / sizeof(nomes[0]) == size_t(OpBC::NUM_OPS), "nomes das operacoes do bytecode");
+  return int(op) < NUM_OPS_BC ? nomes[int(op)] : "?";
+}
+
+bool isSaltoBC(OpBC op)
+{
+  return op == OpBC::JUMP || op == OpBC::JUMP_IF_FALSE || op == OpBC::JUMP_IF_TRUE || op == OpBC::JUMP_IF_NOT_CMP;
+}
+
+int FuncaoBC::adicionarConstante(const Valor &valor)
+{
+  constantes.push_back(valor);
+  return constantes.size() - 1;
+}
+
+static string formatarConstante(const Valor &valor)
+{
+  if (valor.tipo == TipoDeDado::DOUBLE)
+  {
+    return formatarReal(valor.real);
+  }
+  if (valor.tipo == TipoDeDado::STRING)
+  {
+    return "\"" + valor.texto() + "\"";
+  }
+  return valor.toString();
+}
+
+string FuncaoBC::toString() const
+{
+  stringstream ss;
+  ss << "funcao " << tipoDeDadoParaString(tipoRetorno) << " " << nome << "(" << numParametros
+     << " parametros, " << tiposSlots.size() << " slots)" << endl;
+  for (size_t pc = 0; pc < codigo.size(); pc++)
+  {
+    const InstrucaoBC &ins = codigo[pc];
+    ss << "  " << setw(3) << pc << "  " << opBCParaString(ins.op);
+    switch (ins.op)
+    {
+    case OpBC::CONST:
+      ss << " " << formatarConstante(constantes[ins.a]);
+      break;
+    case OpBC::LOAD_LOCAL:
+    case OpBC::STORE_LOCAL:
+    case OpBC::LOAD_GLOBAL:
+    case OpBC::STORE_GLOBAL:
+      ss << " @" << ins.a;
+      break;
+    case OpBC::JUMP:
+    case OpBC::JUMP_IF_FALSE:
+    case OpBC::JUMP_IF_TRUE:
+      ss << " " << ins.a;
+      break;
+    case OpBC::CALL:
+      ss << " f" << ins.a << " (" << ins.b << ")";
+      break;
+    case OpBC::CALL_BUILTIN:
+      ss << " " << BUILTINS[ins.a].nome << " (" << ins.b << ")";
+      break;
+    case OpBC::NEW_ARRAY:
+      ss << " " << tipoDeDadoParaString(tipoDoElemento(TipoDeDado(ins.b))) << "[" << uint32_t(ins.a) << "]";
+      break;
+    case OpBC::LOAD_ELEM:
+    case OpBC::STORE_ELEM:
+    case OpBC::LOAD_ELEM_NC:
+    case OpBC::STORE_ELEM_NC:
+      ss << " @" << ins.a << (ins.b ? " (global)" : "");
+      break;
+    case OpBC::LOAD_LOCAL_2:
+    case OpBC::ADD_INT_LL:
+      ss << " @" << ins.a << ", @" << ins.b;
+      break;
+    case OpBC::LOAD_ELEM_L:
+    case OpBC::LOAD_ELEM_L_NC:
+      ss << " @" << ins.a << "[@" << ins.b << "]";
+      break;
+    case OpBC::LOAD_LOCAL_CONST:
+      ss << " @" << ins.a << ", " << formatarConstante(constantes[ins.b]);
+      break;
+    case OpBC::INC_LOCAL:
+      ss << " @" << ins.a << ", " << ins.b;
+      break;
+    case OpBC::JUMP_IF_NOT_CMP:
+      ss << " " << opBCParaString(OpBC(ins.b)) << ", " << ins.a;
+      break;
+    default:
+      break;
+    }
+    ss << endl;
+  }
+  return ss.str();
+}
+
+string ProgramaBC::toString() const
+{
+  stringstream ss;
+  for (size_t i = 0; i < funcoes.size(); i++)
+  {
+    ss << "f" << i << ": " << funcoes[i].toString();
+  }
+  return ss.str();
+}
+
+PerfilBC::PerfilBC() : pares(NUM_OPS_BC * NUM_OPS_BC, 0)
+{
+}
+
+uint64_t PerfilBC::getTotal() const
+{
+  uint64_t total = 0;
+  for (uint64_t contagem : pares)
+  {
+    total += contagem;
+  }
+  return total;
+}
+
+void PerfilBC::limpar()
+{
+  fill(pares.begin(), pares.end(), 0);
+}
+
+string PerfilBC::relatorio(size_t n) const
+{
+  vector<pair<uint64_t, int>> ordenados;
+  for (size_t i = 0; i < pares.size(); i++)
+  {
+    if (pares[i])
+    {
+      ordenados.push_back(make_pair(pares[i], int(i)));
+    }
+  }
+  sort(ordenados.begin(), ordenados.end(), [](const pair<uint64_t, int> &x, const pair<uint64_t, int> &y)
+       { return x.first != y.first ? x.first > y.first : x.second < y.second; });
+  uint64_t total = getTotal();
+  stringstream ss;
+  for (size_t i = 0; i < ordenados.size() && i < n; i++)
+  {
+    int par = ordenados[i].second;
+    string nome = opBCParaString(OpBC(par / NUM_OPS_BC)) + " -> " + opBCParaString(OpBC(par % NUM_OPS_BC));
+    ss << "  " << left << setw(28) << nome << right << setw(10) << ordenados[i].first
+       << "  (" << fixed << setprecision(1) << 100.0 * ordenados[i].first / total << "%)" << endl;
+  }
+  return ss.str();
+}
@@ -0,0 +1,369 @@
+#include "BytecodeCompiler.h"
+#include <stdexcept>
+
+using namespace std;
+
+BytecodeCompiler::BytecodeCompiler() : programa(nullptr), funcao(nullptr)
+{
+}
+
+void BytecodeCompiler::erro(const string &msg)
+{
+  throw runtime_error("Erro na geracao de bytecode: " + msg);
+}
+
+ProgramaBC *BytecodeCompiler::gerar(ProgramNode *program)
+{
+  ProgramaBC *resultado = new ProgramaBC();
+  programa = resultado;
+  resultado->tiposGlobais = program->getGlobalTypes();
+  resultado->tiposGlobais.resize(program->getGlobalCount(), TipoDeDado::INT);
+  const vector<FunctionNode *> &functions = program->getFunctions();
+  resultado->funcoes.resize(functions.size());
+  try
+  {
+    for (size_t i = 0; i < functions.size(); i++)
+    {
+      gerarFuncao(functions[i], resultado->funcoes[i]);
+      if (functions[i]->getName() == "main" && functions[i]->getParams().empty())
+      {
+        resultado->principal = i;
+      }
+    }
+  }
+  catch (exception &)
+  {
+    delete resultado;
+    throw;
+  }
+  return resultado;
+}
+
+void BytecodeCompiler::gerarFuncao(FunctionNode *function, FuncaoBC &destino)
+{
+  funcao = &destino;
+  funcao->nome = function->getName();
+  funcao->tipoRetorno = tipoDeDadoDeString(function->getReturnType());
+  funcao->tiposSlots = function->getSlotTypes();
+  funcao->tiposSlots.resize(function->getFrameSize(), TipoDeDado::INT);
+  funcao->numParametros = function->getParams().size();
+  funcao->isGlobalWrapper = function->isGlobalWrapper();
+
+  gerarBloco(function->getBody());
+
+  // Retorno implícito no fim da função
+  if (funcao->tipoRetorno == TipoDeDado::VOID)
+  {
+    emitir(OpBC::RETURN_VOID);
+  }
+  else
+  {
+    constante(Valor::padrao(funcao->tipoRetorno));
+    emitir(OpBC::RETURN);
+  }
+}
+
+int BytecodeCompiler::emitir(OpBC op, int32_t a, int32_t b)
+{
+  funcao->codigo.push_back(InstrucaoBC(op, a, b));
+  return funcao->codigo.size() - 1;
+}
+
+void BytecodeCompiler::constante(const Valor &valor)
+{
+  emitir(OpBC::CONST, funcao->adicionarConstante(valor));
+}
+
+void BytecodeCompiler::carregar(Binding binding)
+{
+  emitir(binding.isGlobal() ? OpBC::LOAD_GLOBAL : OpBC::LOAD_LOCAL, binding.slot);
+}
+
+void BytecodeCompiler::emitirElemento(OpBC op, Binding binding)
+{
+  emitir(op, binding.slot, binding.isGlobal() ? 1 : 0);
+}
+
+void BytecodeCompiler::armazenar(Binding binding)
+{
+  emitir(binding.isGlobal() ? OpBC::STORE_GLOBAL : OpBC::STORE_LOCAL, binding.slot);
+}
+
+void BytecodeCompiler::ajustarSalto(int salto)
+{
+  funcao->codigo[salto].a = funcao->codigo.size();
+}
+
+void BytecodeCompiler::gerarBloco(BlockNode *block)
+{
+  for (auto stmt : block->getStatements())
+  {
+    gerarStatement(stmt);
+  }
+}
+
+void BytecodeCompiler::gerarStatement(StatementNode *stmt)
+{
+  if (auto decl = dynamic_cast<VariableDeclarationNode *>(stmt))
+  {
+    if (decl->isArray())
+    {
+      emitir(OpBC::NEW_ARRAY, int32_t(decl->getArraySize()), int32_t(tipoDeArray(tipoDeDadoDeString(decl->getType()))));
+    }
+    else if (decl->getInitialValue())
+    {
+      gerarExpressao(decl->getInitialValue());
+    }
+    else
+    {
+      constante(Valor::padrao(tipoDeDadoDeString(decl->getType())));
+    }
+    armazenar(decl->getBinding());
+  }
+  else if (auto assign = dynamic_cast<AssignmentNode *>(stmt))
+  {
+    gerarExpressao(assign->getValue());
+    if (assign->getIndex())
+    {
+      gerarExpressao(assign->getIndex());
+      emitirElemento(assign->needsBoundsCheck() ? OpBC::STORE_ELEM : OpBC::STORE_ELEM_NC, assign->getBinding());
+    }
+    else
+    {
+      armazenar(assign->getBinding());
+    }
+  }
+  else if (auto block = dynamic_cast<BlockNode *>(stmt))
+  {
+    gerarBloco(block);
+  }
+  else if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+  {
+    gerarExpressao(ifStmt->getCondition());
+    int paraElse = emitir(OpBC::JUMP_IF_FALSE);
+    gerarBloco(ifStmt->getThenBlock());
+    if (ifStmt->getElseBlock())
+    {
+      int paraFim = emitir(OpBC::JUMP);
+      ajustarSalto(paraElse);
+      gerarBloco(ifStmt->getElseBlock());
+      ajustarSalto(paraFim);
+    }
+    else
+    {
+      ajustarSalto(paraElse);
+    }
+  }
+  else if (auto whileStmt = dynamic_cast<WhileStatementNode *>(stmt))
+  {
+    int inicio = funcao->codigo.size();
+    gerarExpressao(whileStmt->getCondition());
+    int paraSaida = emitir(OpBC::JUMP_IF_FALSE);
+    gerarBloco(whileStmt->getBody());
+    emitir(OpBC::JUMP, inicio);
+    ajustarSalto(paraSaida);
+  }
+  else if (auto forStmt = dynamic_cast<ForStatementNode *>(stmt))
+  {
+    if (forStmt->getInit())
+    {
+      gerarStatement(forStmt->getInit());
+    }
+    int inicio = funcao->codigo.size();
+    int paraSaida = -1;
+    if (forStmt->getCondition())
+    {
+      gerarExpressao(forStmt->getCondition());
+      paraSaida = emitir(OpBC::JUMP_IF_FALSE);
+    }
+    gerarBloco(forStmt->getBody());
+    if (forStmt->getUpdate())
+    {
+      gerarExpressao(forStmt->getUpdate(), true);
+    }
+    emitir(OpBC::JUMP, inicio);
+    if (paraSaida >= 0)
+    {
+      ajustarSalto(paraSaida);
+    }
+  }
+  else if (auto ret = dynamic_cast<ReturnStatementNode *>(stmt))
+  {
+    if (ret->getValue())
+    {
+      gerarExpressao(ret->getValue());
+      emitir(OpBC::RETURN);
+    }
+    else
+    {
+      emitir(OpBC::RETURN_VOID);
+    }
+  }
+  else if (auto exprStmt = dynamic_cast<ExpressionStatementNode *>(stmt))
+  {
+    gerarExpressao(exprStmt->getExpression(), true);
+  }
+}
+
+void BytecodeCompiler::gerarExpressao(ExpressionNode *expr, bool descartar)
+{
+  if (auto binary = dynamic_cast<BinaryOpNode *>(expr))
+  {
+    gerarBinaria(binary, descartar);
+    return;
+  }
+  if (auto unary = dynamic_cast<UnaryOpNode *>(expr))
+  {
+    if (unary->getOp() != "!")
+    {
+      gerarIncremento(unary, descartar);
+      return;
+    }
+    gerarExpressao(unary->getOperand());
+    emitir(OpBC::NOT);
+  }
+  else if (auto literal = dynamic_cast<IntLiteralNode *>(expr))
+  {
+    constante(Valor::deInteiro(literal->getValue()));
+  }
+  else if (auto literal = dynamic_cast<RealLiteralNode *>(expr))
+  {
+    constante(Valor::deReal(literal->getValue()));
+  }
+  else if (auto literal = dynamic_cast<StringLiteralNode *>(expr))
+  {
+    constante(programa->literais.internar(literal->getValue()));
+  }
+  else if (auto ident = dynamic_cast<IdentifierNode *>(expr))
+  {
+    carregar(ident->getBinding());
+  }
+  else if (auto conversion = dynamic_cast<ConversionNode *>(expr))
+  {
+    gerarExpressao(conversion->getOperand());
+    emitir(OpBC::INT_TO_DOUBLE);
+  }
+  else if (auto call = dynamic_cast<FunctionCallNode *>(expr))
+  {
+    for (auto arg : call->getArgs())
+    {
+      gerarExpressao(arg);
+    }
+    if (call->isBuiltin())
+      emitir(OpBC::CALL_BUILTIN, call->getBuiltinIndex(), call->getArgs().size());
+    else
+      emitir(OpBC::CALL, call->getFunctionIndex(), call->getArgs().size());
+  }
+  else if (auto access = dynamic_cast<ArrayAccessNode *>(expr))
+  {
+    gerarExpressao(access->getIndex());
+    emitirElemento(access->needsBoundsCheck() ? OpBC::LOAD_ELEM : OpBC::LOAD_ELEM_NC, access->getBinding());
+  }
+  else
+  {
+    erro("expressao desconhecida");
+  }
+  if (descartar)
+  {
+    emitir(OpBC::POP);
+  }
+}
+
+void BytecodeCompiler::gerarBinaria(BinaryOpNode *binary, bool descartar)
+{
+  const string &op = binary->getOp();
+  if (op == "=")
+  {
+    // O valor é avaliado antes do índice e fica sob ele na pilha
+    gerarExpressao(binary->getRight());
+    if (!descartar)
+    {
+      emitir(OpBC::DUP);
+    }
+    if (auto access = dynamic_cast<ArrayAccessNode *>(binary->getLeft()))
+    {
+      gerarExpressao(access->getIndex());
+      emitirElemento(access->needsBoundsCheck() ? OpBC::STORE_ELEM : OpBC::STORE_ELEM_NC, access->getBinding());
+    }
+    else
+    {
+      armazenar(static_cast<IdentifierNode *>(binary->getLeft())->getBinding());
+    }
+    return;
+  }
+
+  if (op == "&&" || op == "||")
+  {
+    gerarLogica(binary);
+  }
+  else
+  {
+    gerarExpressao(binary->getLeft());
+    gerarExpressao(binary->getRight());
+    // A operação é escolhida pelo tipo dos operandos (iguais após o TypeChecker)
+    TipoDeDado tipo = binary->getLeft()->getTipo();
+    static const string ops[] = {"+", "-", "*", "/", "<", ">", "<=", ">=", "==", "!="};
+    static const OpBC inteiras[] = {OpBC::ADD_INT, OpBC::SUB_INT, OpBC::MUL_INT, OpBC::DIV_INT, OpBC::LT_INT,
+                                    OpBC::GT_INT, OpBC::LE_INT, OpBC::GE_INT, OpBC::EQ_INT, OpBC::NE_INT};
+    static const OpBC reais[] = {OpBC::ADD_REAL, OpBC::SUB_REAL, OpBC::MUL_REAL, OpBC::DIV_REAL, OpBC::LT_REAL,
+                                 OpBC::GT_REAL, OpBC::LE_REAL, OpBC::GE_REAL, OpBC::EQ_REAL, OpBC::NE_REAL};
+    static const OpBC textos[] = {OpBC::CONCAT, OpBC::NUM_OPS, OpBC::NUM_OPS, OpBC::NUM_OPS, OpBC::LT_STR,
+                                  OpBC::GT_STR, OpBC::LE_STR, OpBC::GE_STR, OpBC::EQ_STR, OpBC::NE_STR};
+    int i = 0;
+    while (i < 10 && ops[i] != op)
+    {
+      i++;
+    }
+    OpBC opBC = i == 10                        ? OpBC::NUM_OPS
+                : tipo == TipoDeDado::DOUBLE ? reais[i]
+                : tipo == TipoDeDado::STRING ? textos[i]
+                                               : inteiras[i];
+    if (opBC == OpBC::NUM_OPS)
+    {
+      erro("operador '" + op + "' invalido para " + tipoDeDadoParaString(tipo));
+    }
+    emitir(opBC);
+  }
+  if (descartar)
+  {
+    emitir(OpBC::POP);
+  }
+}
+
+// "a && b" e "a || b" avaliam b apenas quando necessário e resultam em 0 ou 1
+void BytecodeCompiler::gerarLogica(BinaryOpNode *binary)
+{
+  bool isE = binary->getOp() == "&&";
+  gerarExpressao(binary->getLeft());
+  int paraCurto = emitir(isE ? OpBC::JUMP_IF_FALSE : OpBC::JUMP_IF_TRUE);
+  gerarExpressao(binary->getRight());
+  constante(Valor::deInteiro(0));
+  emitir(OpBC::NE_INT);
+  int paraFim = emitir(OpBC::JUMP);
+  ajustarSalto(paraCurto);
+  constante(Valor::deInteiro(isE ? 0 : 1));
+  ajustarSalto(paraFim);
+}
+
+void BytecodeCompiler::gerarIncremento(UnaryOpNode *unary, bool descartar)
+{
+  auto ident = dynamic_cast<IdentifierNode *>(unary->getOperand());
+  if (!ident)
+  {
+    erro("incremento de elemento de array nao suportado");
+  }
+  bool real = ident->getTipo() == TipoDeDado::DOUBLE;
+  carregar(ident->getBinding());
+  if (!descartar && unary->isPostfix())
+  {
+    emitir(OpBC::DUP); // o valor anterior fica na pilha
+  }
+  constante(real ? Valor::deReal(1.0) : Valor::deInteiro(1));
+  bool soma = unary->getOp() == "++";
+  emitir(real ? (soma ? OpBC::ADD_REAL : OpBC::SUB_REAL) : (soma ? OpBC::ADD_INT : OpBC::SUB_INT));
+  if (!descartar && !unary->isPostfix())
+  {
+    emitir(OpBC::DUP);
+  }
+  armazenar(ident->getBinding());
+}
@@ -0,0 +1,721 @@
+#include "CBackend.h"
+#include "Builtins.h"
+#include "ConstantFolder.h"
+#include "Numero.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+  // Funções de apoio incluídas em todo programa gerado
+  const char *const RUNTIME =
+      "static inline int64_t rt_div(int64_t a, int64_t b)\n"
+      "{\n"
+      "  if (b == 0)\n"
+      "  {\n"
+      "    fprintf(stderr, \"erro: divisao por zero\\n\");\n"
+      "    exit(1);\n"
+      "  }\n"
+      "  return b == -1 ? -a : a / b; /* INT64_MIN / -1 da a volta */\n"
+      "}\n"
+      "\n"
+      "static inline int64_t rt_indice(int64_t i, int64_t n)\n"
+      "{\n"
+      "  if ((uint64_t)i >= (uint64_t)n)\n"
+      "  {\n"
+      "    fprintf(stderr, \"erro: indice %\" PRId64 \" fora dos limites do array de tamanho %\" PRId64 \"\\n\", i, n);\n"
+      "    exit(1);\n"
+      "  }\n"
+      "  return i;\n"
+      "}\n"
+      "\n"
+      "static inline const char *rt_concat(const char *a, const char *b)\n"
+      "{\n"
+      "  size_t na = strlen(a), nb = strlen(b);\n"
+      "  char *r = malloc(na + nb + 1);\n"
+      "  if (!r)\n"
+      "  {\n"
+      "    fprintf(stderr, \"erro: memoria insuficiente\\n\");\n"
+      "    exit(1);\n"
+      "  }\n"
+      "  memcpy(r, a, na);\n"
+      "  memcpy(r + na, b, nb + 1);\n"
+      "  return r;\n"
+      "}\n"
+      "\n"
+      "/* Funcoes embutidas (Builtins.h) sem equivalente direto em math.h */\n"
+      "static inline void rt_print_int(int64_t v) { printf(\"%\" PRId64 \"\\n\", v); }\n"
+      "static inline void rt_print_real(double v) { printf(\"%g\\n\", v); }\n"
+      "static inline void rt_print_str(const char *v) { printf(\"%s\\n\", v); }\n"
+      "static inline int64_t rt_abs(int64_t v) { return v < 0 ? -v : v; }\n"
+      "static inline int64_t rt_min(int64_t a, int64_t b) { return a < b ? a : b; }\n"
+      "static inline int64_t rt_max(int64_t a, int64_t b) { return a > b ? a : b; }\n"
+      "static inline int64_t rt_len(const char *s) { return (int64_t)strlen(s); }\n"
+      "\n"
+      "static const char *rt_substr(const char *s, int64_t inicio, int64_t n)\n"
+      "{\n"
+      "  int64_t tamanho = (int64_t)strlen(s);\n"
+      "  if (inicio < 0 || n < 0 || inicio > tamanho)\n"
+      "  {\n"
+      "    fprintf(stderr, \"erro: substr fora dos limites\\n\");\n"
+      "    exit(1);\n"
+      "  }\n"
+      "  if (n > tamanho - inicio)\n"
+      "    n = tamanho - inicio;\n"
+      "  char *r = malloc(n + 1);\n"
+      "  if (!r)\n"
+      "  {\n"
+      "    fprintf(stderr, \"erro: memoria insuficiente\\n\");\n"
+      "    exit(1);\n"
+      "  }\n"
+      "  memcpy(r, s + inicio, n);\n"
+      "  r[n] = 0;\n"
+      "  return r;\n"
+      "}\n";
+
+  // Elementos de um array local, que fica na pilha do programa gerado
+  const int64_t LIMITE_DE_ELEMENTOS = 1 << 16;
+
+  string espacos(int indent)
+  {
+    return string(indent * 2, ' ');
+  }
+
+  string valorPadrao(TipoDeDado tipo)
+  {
+    switch (tipo)
+    {
+    case TipoDeDado::DOUBLE:
+      return "0.0";
+    case TipoDeDado::STRING:
+      return "\"\"";
+    default:
+      return "0";
+    }
+  }
+
+  string literalDeTexto(const string &texto)
+  {
+    string resultado = "\"";
+    for (unsigned char c : texto)
+    {
+      if (c == '"' || c == '\\' || c == '?') // '?' evita trígrafos
+      {
+        resultado += '\\';
+        resultado += c;
+      }
+      else if (c == '\n')
+      {
+        resultado += "\\n";
+      }
+      else if (c == '\t')
+      {
+        resultado += "\\t";
+      }
+      else if (c < 0x20 || c >= 0x7f)
+      {
+        // Sempre três dígitos octais, para não absorver um dígito seguinte
+        char octal[5];
+        snprintf(octal, sizeof(octal), "\\%03o", c);
+        resultado += octal;
+      }
+      else
+      {
+        resultado += c;
+      }
+    }
+    return resultado + "\"";
+  }
+
+  string literalInteiro(int64_t valor)
+  {
+    if (valor == INT64_MIN)
+    {
+      return "(-9223372036854775807LL - 1)";
+    }
+    // O sufixo garante aritmética de 64 bits mesmo entre dois literais
+    return to_string(valor) + "LL";
+  }
+
+  string literalReal(double valor)
+  {
+    if (std::isnan(valor))
+    {
+      return "NAN";
+    }
+    if (std::isinf(valor))
+    {
+      return valor > 0 ? "INFINITY" : "(-INFINITY)";
+    }
+    return formatarReal(valor);
+  }
+
+  // Retira um par de parênteses que envolva a expressão inteira, nos
+  // contextos em que ela pode aparecer sem eles
+  string semParenteses(const string &expr)
+  {
+    if (expr.size() < 2 || expr[0] != '(' || expr.back() != ')')
+    {
+      return expr;
+    }
+    int nivel = 0;
+    bool emTexto = false;
+    for (size_t i = 0; i < expr.size(); i++)
+    {
+      char c = expr[i];
+      if (emTexto)
+      {
+        if (c == '\\')
+          i++;
+        else if (c == '"')
+          emTexto = false;
+      }
+      else if (c == '"')
+        emTexto = true;
+      else if (c == '(')
+        nivel++;
+      else if (c == ')' && --nivel == 0 && i + 1 < expr.size())
+        return expr;
+    }
+    return expr.substr(1, expr.size() - 2);
+  }
+
+  // Verdadeiro se a expressão atribui a alguma variável ("=", "++", "--")
+  bool modificaVariaveis(ExpressionNode *expr)
+  {
+    if (auto unary = dynamic_cast<UnaryOpNode *>(expr))
+    {
+      return unary->getOp() != "!" || modificaVariaveis(unary->getOperand());
+    }
+    if (auto binary = dynamic_cast<BinaryOpNode *>(expr))
+    {
+      return binary->getOp() == "=" || modificaVariaveis(binary->getLeft()) || modificaVariaveis(binary->getRight());
+    }
+    if (auto conversion = dynamic_cast<ConversionNode *>(expr))
+    {
+      return modificaVariaveis(conversion->getOperand());
+    }
+    if (auto call = dynamic_cast<FunctionCallNode *>(expr))
+    {
+      for (auto arg : call->getArgs())
+      {
+        if (modificaVariaveis(arg))
+        {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+}
+
+string tipoEmC(TipoDeDado tipo)
+{
+  switch (tipo)
+  {
+  case TipoDeDado::INT:
+    return "int64_t";
+  case TipoDeDado::DOUBLE:
+    return "double";
+  case TipoDeDado::STRING:
+    return "const char *";
+  default:
+    return "void";
+  }
+}
+
+// "int64_t x", mas "const char *x"; arrays "int64_t a[N]"
+static string declaracao(TipoDeDado tipo, const string &nome, int64_t tamanho = -1)
+{
+  if (isArray(tipo))
+  {
+    return tipoEmC(tipoDoElemento(tipo)) + " " + nome + "[" + to_string(tamanho) + "]";
+  }
+  string c = tipoEmC(tipo);
+  return c + (c.back() == '*' ? "" : " ") + nome;
+}
+
+CBackend::CBackend() : programa(nullptr), funcao(nullptr), numTemporarios(0) {}
+
+string CBackend::nomeDaVariavel(const string &nome, Binding binding) const
+{
+  return nome + (binding.isGlobal() ? "_g" : "_") + to_string(binding.slot);
+}
+
+string CBackend::nomeDaFuncao(const string &nome) const
+{
+  return nome + "_f";
+}
+
+string CBackend::gerar(ProgramNode *program)
+{
+  programa = program;
+  numTemporarios = 0;
+  const vector<FunctionNode *> &functions = program->getFunctions();
+  stringstream saida;
+
+  saida << "/* Gerado pelo CBackend. Compilar com -fwrapv: a aritmetica inteira da a volta no estouro. */" << endl
+        << "#include <inttypes.h>" << endl
+        << "#include <math.h>" << endl
+        << "#include <stdint.h>" << endl
+        << "#include <stdio.h>" << endl
+        << "#include <stdlib.h>" << endl
+        << "#include <string.h>" << endl
+        << endl
+        << RUNTIME << endl;
+
+  // As globais são as declarações de nível superior das funções "__global__"
+  vector<string> globais(program->getGlobalCount());
+  tamanhosGlobais.assign(program->getGlobalCount(), -1);
+  for (auto function : functions)
+  {
+    if (!function->isGlobalWrapper())
+    {
+      continue;
+    }
+    for (auto stmt : function->getBody()->getStatements())
+    {
+      auto decl = dynamic_cast<VariableDeclarationNode *>(stmt);
+      if (decl && decl->getBinding().isGlobal())
+      {
+        globais[decl->getBinding().slot] = nomeDaVariavel(decl->getName(), decl->getBinding());
+        tamanhosGlobais[decl->getBinding().slot] = decl->getArraySize();
+      }
+    }
+  }
+  const vector<TipoDeDado> &tiposGlobais = program->getGlobalTypes();
+  for (size_t g = 0; g < globais.size(); g++)
+  {
+    // Arrays globais começam zerados, como toda variável estática do C
+    if (isArray(tiposGlobais[g]))
+      saida << "static " << declaracao(tiposGlobais[g], globais[g], tamanhosGlobais[g]) << ";" << endl;
+    else
+      saida << "static " << declaracao(tiposGlobais[g], globais[g]) << " = " << valorPadrao(tiposGlobais[g]) << ";" << endl;
+  }
+  if (!globais.empty())
+  {
+    saida << endl;
+  }
+
+  // Protótipos, permitindo chamadas em qualquer ordem
+  vector<string> nomes;
+  int mainDoPrograma = -1;
+  for (size_t i = 0; i < functions.size(); i++)
+  {
+    FunctionNode *function = functions[i];
+    nomes.push_back(function->isGlobalWrapper() ? "global" + to_string(i) : nomeDaFuncao(function->getName()));
+    saida << "static " << declaracao(tipoDeDadoDeString(function->getReturnType()), nomes[i]) << "(";
+    const vector<ParameterNode *> &params = function->getParams();
+    for (size_t p = 0; p < params.size(); p++)
+    {
+      saida << (p ? ", " : "") << declaracao(tipoDeDadoDeString(params[p]->getType()), nomeDaVariavel(params[p]->getName(), params[p]->getBinding()));
+    }
+    saida << (params.empty() ? "void" : "") << ");" << endl;
+    if (function->getName() == "main" && params.empty())
+    {
+      mainDoPrograma = i;
+    }
+  }
+  saida << endl;
+
+  for (size_t i = 0; i < functions.size(); i++)
+  {
+    gerarFuncao(functions[i], nomes[i], saida);
+  }
+
+  // Ponto de entrada: inicializadores na ordem do programa e depois o main
+  saida << "int main(void)" << endl
+        << "{" << endl;
+  for (size_t i = 0; i < functions.size(); i++)
+  {
+    if (functions[i]->isGlobalWrapper())
+    {
+      saida << "  " << nomes[i] << "();" << endl;
+    }
+  }
+  if (mainDoPrograma >= 0)
+  {
+    TipoDeDado tipo = tipoDeDadoDeString(functions[mainDoPrograma]->getReturnType());
+    string chamada = nomes[mainDoPrograma] + "()";
+    if (tipo == TipoDeDado::INT)
+      saida << "  printf(\"%\" PRId64 \"\\n\", " << chamada << ");" << endl;
+    else if (tipo == TipoDeDado::DOUBLE)
+      saida << "  printf(\"%.17g\\n\", " << chamada << ");" << endl;
+    else if (tipo == TipoDeDado::STRING)
+      saida << "  printf(\"%s\\n\", " << chamada << ");" << endl;
+    else
+      saida << "  " << chamada << ";" << endl;
+  }
+  saida << "  return 0;" << endl
+        << "}" << endl;
+
+  programa = nullptr;
+  return saida.str();
+}
+
+void CBackend::gerarFuncao(FunctionNode *function, const string &nome, stringstream &saida)
+{
+  funcao = function;
+  declaracoes.str("");
+  tamanhosLocais.assign(function->getFrameSize(), -1);
+  TipoDeDado tipoRetorno = tipoDeDadoDeString(function->getReturnType());
+
+  stringstream corpo;
+  for (auto stmt : function->getBody()->getStatements())
+  {
+    gerarStatement(stmt, 1, corpo);
+  }
+  // Retorno implícito do valor padrão, como no IRBuilder
+  const vector<StatementNode *> &stmts = function->getBody()->getStatements();
+  if (tipoRetorno != TipoDeDado::VOID && (stmts.empty() || !dynamic_cast<ReturnStatementNode *>(stmts.back())))
+  {
+    corpo << "  return " << valorPadrao(tipoRetorno) << ";" << endl;
+  }
+
+  saida << "static " << declaracao(tipoRetorno, nome) << "(";
+  const vector<ParameterNode *> &params = function->getParams();
+  for (size_t p = 0; p < params.size(); p++)
+  {
+    saida << (p ? ", " : "") << declaracao(tipoDeDadoDeString(params[p]->getType()), nomeDaVariavel(params[p]->getName(), params[p]->getBinding()));
+  }
+  saida << (params.empty() ? "void" : "") << ")" << endl
+        << "{" << endl
+        << declaracoes.str() << corpo.str() << "}" << endl
+        << endl;
+  funcao = nullptr;
+}
+
+void CBackend::gerarBloco(BlockNode *block, int indent, stringstream &saida)
+{
+  saida << espacos(indent) << "{" << endl;
+  for (auto stmt : block->getStatements())
+  {
+    gerarStatement(stmt, indent + 1, saida);
+  }
+  saida << espacos(indent) << "}" << endl;
+}
+
+void CBackend::gerarStatement(StatementNode *stmt, int indent, stringstream &saida)
+{
+  string tab = espacos(indent);
+  if (auto decl = dynamic_cast<VariableDeclarationNode *>(stmt))
+  {
+    string nome = nomeDaVariavel(decl->getName(), decl->getBinding());
+    ExpressionNode *valor = decl->getInitialValue();
+    if (decl->getBinding().isGlobal())
+    {
+      // Declarada no escopo do arquivo; aqui só a inicialização
+      if (valor)
+      {
+        saida << tab << nome << " = " << expressao(valor) << ";" << endl;
+      }
+      return;
+    }
+    TipoDeDado tipo = tipoDeDadoDeString(decl->getType());
+    if (decl->isArray())
+    {
+      if (decl->getArraySize() > LIMITE_DE_ELEMENTOS)
+      {
+        throw runtime_error("Erro no backend C: array local '" + decl->getName() + "' com mais de " +
+                            to_string(LIMITE_DE_ELEMENTOS) + " elementos");
+      }
+      // O inicializador zera o array a cada execução da declaração
+      tamanhosLocais[decl->getBinding().slot] = decl->getArraySize();
+      saida << tab << declaracao(tipoDeArray(tipo), nome, decl->getArraySize()) << " = {0};" << endl;
+      return;
+    }
+    saida << tab << declaracao(tipo, nome) << " = " << (valor ? expressao(valor) : valorPadrao(tipo)) << ";" << endl;
+  }
+  else if (auto assign = dynamic_cast<AssignmentNode *>(stmt))
+  {
+    if (assign->getIndex())
+    {
+      saida << tab << semParenteses(atribuirElemento(assign->getName(), assign->getBinding(), assign->getIndex(),
+                                                     assign->needsBoundsCheck(), assign->getValue()))
+            << ";" << endl;
+      return;
+    }
+    string nome = nomeDaVariavel(assign->getName(), assign->getBinding());
+    string valor = expressao(assign->getValue());
+    if (modificaVariaveis(assign->getValue()))
+    {
+      // "x = x++" não é sequenciado em C: o valor vai antes para um temporário
+      string t = temporario(assign->getValue()->getTipo());
+      valor = "(" + t + " = " + valor + ", " + t + ")";
+    }
+    saida << tab << nome << " = " << valor << ";" << endl;
+  }
+  else if (auto block = dynamic_cast<BlockNode *>(stmt))
+  {
+    gerarBloco(block, indent, saida);
+  }
+  else if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+  {
+    saida << tab << "if (" << semParenteses(expressao(ifStmt->getCondition())) << ")" << endl;
+    gerarBloco(ifStmt->getThenBlock(), indent, saida);
+    if (ifStmt->getElseBlock())
+    {
+      saida << tab << "else" << endl;
+      gerarBloco(ifStmt->getElseBlock(), indent, saida);
+    }
+  }
+  else if (auto whileStmt = dynamic_cast<WhileStatementNode *>(stmt))
+  {
+    saida << tab << "while (" << semParenteses(expressao(whileStmt->getCondition())) << ")" << endl;
+    gerarBloco(whileStmt->getBody(), indent, saida);
+  }
+  else if (auto forStmt = dynamic_cast<ForStatementNode *>(stmt))
+  {
+    // A inicialização é gerada como statement num bloco próprio, que também
+    // delimita o escopo da variável declarada nela
+    saida << tab << "{" << endl;
+    if (forStmt->getInit())
+    {
+      gerarStatement(forStmt->getInit(), indent + 1, saida);
+    }
+    saida << espacos(indent + 1) << "for (; "
+          << (forStmt->getCondition() ? semParenteses(expressao(forStmt->getCondition())) : "") << "; "
+          << (forStmt->getUpdate() ? semParenteses(expressao(forStmt->getUpdate())) : "") << ")" << endl;
+    gerarBloco(forStmt->getBody(), indent + 1, saida);
+    saida << tab << "}" << endl;
+  }
+  else if (auto ret = dynamic_cast<ReturnStatementNode *>(stmt))
+  {
+    if (ret->getValue())
+    {
+      saida << tab << "return " << semParenteses(expressao(ret->getValue())) << ";" << endl;
+    }
+    else
+    {
+      saida << tab << "return;" << endl;
+    }
+  }
+  else if (auto exprStmt = dynamic_cast<ExpressionStatementNode *>(stmt))
+  {
+    saida << tab << semParenteses(expressao(exprStmt->getExpression())) << ";" << endl;
+  }
+}
+
+string CBackend::temporario(TipoDeDado tipo)
+{
+  string nome = "t" + to_string(numTemporarios++);
+  declaracoes << "  " << declaracao(tipo, nome) << ";" << endl;
+  return nome;
+}
+
+vector<string> CBackend::operandos(const vector<ExpressionNode *> &exprs, string &prefixo)
+{
+  // A ordem só precisa ser fixada se algum operando tem efeitos colaterais
+  // e há outro que não é literal
+  int naoLiterais = 0, ultimo = -1;
+  bool impuro = false;
+  for (size_t i = 0; i < exprs.size(); i++)
+  {
+    if (!dynamic_cast<LiteralNode *>(exprs[i]))
+    {
+      naoLiterais++;
+      ultimo = i;
+    }
+    impuro = impuro || !isExpressaoPura(exprs[i]);
+  }
+  bool fixar = impuro && naoLiterais >= 2;
+
+  vector<string> textos;
+  for (size_t i = 0; i < exprs.size(); i++)
+  {
+    string texto = expressao(exprs[i]);
+    if (fixar && int(i) != ultimo && !dynamic_cast<LiteralNode *>(exprs[i]))
+    {
+      string t = temporario(exprs[i]->getTipo());
+      prefixo += t + " = " + texto + ", ";
+      texto = t;
+    }
+    textos.push_back(texto);
+  }
+  return textos;
+}
+
+string CBackend::expressao(ExpressionNode *expr)
+{
+  if (auto literal = dynamic_cast<IntLiteralNode *>(expr))
+  {
+    return literalInteiro(literal->getValue());
+  }
+  if (auto literal = dynamic_cast<RealLiteralNode *>(expr))
+  {
+    return literalReal(literal->getValue());
+  }
+  if (auto literal = dynamic_cast<StringLiteralNode *>(expr))
+  {
+    return literalDeTexto(literal->getValue());
+  }
+  if (auto ident = dynamic_cast<IdentifierNode *>(expr))
+  {
+    return nomeDaVariavel(ident->getName(), ident->getBinding());
+  }
+  if (auto access = dynamic_cast<ArrayAccessNode *>(expr))
+  {
+    return elemento(access->getName(), access->getBinding(), expressao(access->getIndex()), access->needsBoundsCheck());
+  }
+  if (auto unary = dynamic_cast<UnaryOpNode *>(expr))
+  {
+    string operando = expressao(unary->getOperand());
+    if (unary->isPostfix())
+    {
+      return "(" + operando + unary->getOp() + ")";
+    }
+    return "(" + unary->getOp() + operando + ")";
+  }
+  if (auto binary = dynamic_cast<BinaryOpNode *>(expr))
+  {
+    return binaria(binary);
+  }
+  if (auto conversion = dynamic_cast<ConversionNode *>(expr))
+  {
+    return "((double)" + expressao(conversion->getOperand()) + ")";
+  }
+  if (auto call = dynamic_cast<FunctionCallNode *>(expr))
+  {
+    string prefixo;
+    vector<string> args = operandos(call->getArgs(), prefixo);
+    string chamada = (call->isBuiltin() ? string(BUILTINS[call->getBuiltinIndex()].emC) : nomeDaFuncao(call->getName())) + "(";
+    for (size_t i = 0; i < args.size(); i++)
+    {
+      chamada += (i ? ", " : "") + args[i];
+    }
+    chamada += ")";
+    return prefixo.empty() ? chamada : "(" + prefixo + chamada + ")";
+  }
+  throw runtime_error("Erro no backend C: expressao nao suportada: " + expr->toString());
+}
+
+string CBackend::binaria(BinaryOpNode *binary)
+{
+  const string &op = binary->getOp();
+  if (op == "&&" || op == "||")
+  {
+    return "(" + expressao(binary->getLeft()) + " " + op + " " + expressao(binary->getRight()) + ")";
+  }
+  if (op == "=")
+  {
+    if (auto access = dynamic_cast<ArrayAccessNode *>(binary->getLeft()))
+    {
+      return atribuirElemento(access->getName(), access->getBinding(), access->getIndex(), access->needsBoundsCheck(),
+                              binary->getRight());
+    }
+    string valor = expressao(binary->getRight());
+    if (modificaVariaveis(binary->getRight()))
+    {
+      string t = temporario(binary->getRight()->getTipo());
+      valor = "(" + t + " = " + valor + ", " + t + ")";
+    }
+    return "(" + expressao(binary->getLeft()) + " = " + valor + ")";
+  }
+
+  string prefixo;
+  vector<string> ops = operandos({binary->getLeft(), binary->getRight()}, prefixo);
+  bool texto = binary->getLeft()->getTipo() == TipoDeDado::STRING;
+  string resultado;
+  if (texto && op == "+")
+  {
+    resultado = "rt_concat(" + ops[0] + ", " + ops[1] + ")";
+  }
+  else if (texto)
+  {
+    resultado = "(strcmp(" + ops[0] + ", " + ops[1] + ") " + op + " 0)";
+  }
+  else if (op == "/" && binary->getTipo() == TipoDeDado::INT)
+  {
+    resultado = "rt_div(" + ops[0] + ", " + ops[1] + ")";
+  }
+  else
+  {
+    resultado = "(" + ops[0] + " " + op + " " + ops[1] + ")";
+  }
+  return prefixo.empty() ? resultado : "(" + prefixo + resultado + ")";
+}
+
+// "a_3[i]", com o índice passado por rt_indice se precisa ser verificado
+string CBackend::elemento(const string &nome, Binding binding, const string &indice, bool verificar)
+{
+  string texto = nomeDaVariavel(nome, binding) + "[";
+  if (verificar)
+  {
+    int64_t tamanho = binding.isGlobal() ? tamanhosGlobais[binding.slot] : tamanhosLocais[binding.slot];
+    return texto + "rt_indice(" + semParenteses(indice) + ", " + literalInteiro(tamanho) + ")]";
+  }
+  return texto + semParenteses(indice) + "]";
+}
+
+// "a[i] = v" avalia v antes do índice; em C a ordem dos dois lados não é
+// especificada, e o valor vai antes para um temporário se ela importa
+string CBackend::atribuirElemento(const string &nome, Binding binding, ExpressionNode *index, bool verificar,
+                                  ExpressionNode *value)
+{
+  string valor = expressao(value);
+  string alvo = elemento(nome, binding, expressao(index), verificar);
+  // Um índice literal ainda pode falhar na verificação, que vem depois do valor
+  bool literal = dynamic_cast<LiteralNode *>(value) || (dynamic_cast<LiteralNode *>(index) && !verificar);
+  if (!literal && (!isExpressaoPura(value) || !isExpressaoPura(index)))
+  {
+    string t = temporario(value->getTipo());
+    return "(" + t + " = " + semParenteses(valor) + ", " + alvo + " = " + t + ")";
+  }
+  return "(" + alvo + " = " + semParenteses(valor) + ")";
+}
+
+void CBackend::compilar(const string &codigoC, const string &executavel)
+{
+  string fonte = executavel + ".c";
+  ofstream arquivo(fonte);
+  if (!arquivo)
+  {
+    throw runtime_error("Erro no backend C: nao foi possivel criar " + fonte);
+  }
+  arquivo << codigoC;
+  arquivo.close();
+
+  const char *cc = getenv("CC");
+  string comando = string(cc && *cc ? cc : "cc") + " -std=c99 -O2 -fwrapv -o '" + executavel + "' '" + fonte + "' -lm 2>&1";
+  FILE *processo = popen(comando.c_str(), "r");
+  if (!processo)
+  {
+    throw runtime_error("Erro no backend C: nao foi possivel executar o compilador C");
+  }
+  string mensagens;
+  char buffer[512];
+  while (fgets(buffer, sizeof(buffer), processo))
+  {
+    mensagens += buffer;
+  }
+  if (pclose(processo) != 0)
+  {
+    throw runtime_error("Erro no backend C: falha ao compilar " + fonte + "\n" + mensagens);
+  }
+}
+
+string CBackend::executar(const string &executavel)
+{
+  FILE *processo = popen(("'" + executavel + "'").c_str(), "r");
+  if (!processo)
+  {
+    throw runtime_error("Erro no backend C: nao foi possivel executar " + executavel);
+  }
+  string saida;
+  char buffer[512];
+  while (fgets(buffer, sizeof(buffer), processo))
+  {
+    saida += buffer;
+  }
+  int status = pclose(processo);
+  if (status != 0)
+  {
+    throw runtime_error("Erro no backend C: " + executavel + " terminou com status " + to_string(status) + "\n" + saida);
+  }
+  return saida;
+}
@@ -0,0 +1,207 @@
+#include "CallGraph.h"
+#include <algorithm>
+#include <sstream>
+
+using namespace std;
+
+CallGraph::CallGraph() : programa(nullptr) {}
+
+void CallGraph::construir(ProgramNode *program)
+{
+  programa = program;
+  size_t numFuncoes = program->getFunctions().size();
+  chamadas.assign(numFuncoes, vector<int>());
+  contagens.assign(numFuncoes, vector<int>());
+  recursiva.assign(numFuncoes, false);
+  for (size_t f = 0; f < numFuncoes; f++)
+  {
+    registrarChamadas(f, program->getFunctions()[f]->getBody());
+  }
+  calcularComponentes();
+}
+
+int CallGraph::getNumChamadas(int de, int para) const
+{
+  auto it = find(chamadas[de].begin(), chamadas[de].end(), para);
+  return it == chamadas[de].end() ? 0 : contagens[de][it - chamadas[de].begin()];
+}
+
+void CallGraph::registrarChamadas(int f, ASTNode *node)
+{
+  if (!node)
+  {
+    return;
+  }
+  if (auto call = dynamic_cast<FunctionCallNode *>(node))
+  {
+    int chamado = call->getFunctionIndex();
+    if (chamado >= 0)
+    {
+      auto it = find(chamadas[f].begin(), chamadas[f].end(), chamado);
+      if (it == chamadas[f].end())
+      {
+        chamadas[f].push_back(chamado);
+        contagens[f].push_back(1);
+      }
+      else
+      {
+        contagens[f][it - chamadas[f].begin()]++;
+      }
+    }
+    for (auto arg : call->getArgs())
+    {
+      registrarChamadas(f, arg);
+    }
+  }
+  else if (auto unary = dynamic_cast<UnaryOpNode *>(node))
+  {
+    registrarChamadas(f, unary->getOperand());
+  }
+  else if (auto binary = dynamic_cast<BinaryOpNode *>(node))
+  {
+    registrarChamadas(f, binary->getLeft());
+    registrarChamadas(f, binary->getRight());
+  }
+  else if (auto conversion = dynamic_cast<ConversionNode *>(node))
+  {
+    registrarChamadas(f, conversion->getOperand());
+  }
+  else if (auto access = dynamic_cast<ArrayAccessNode *>(node))
+  {
+    registrarChamadas(f, access->getIndex());
+  }
+  else if (auto block = dynamic_cast<BlockNode *>(node))
+  {
+    for (auto stmt : block->getStatements())
+    {
+      registrarChamadas(f, stmt);
+    }
+  }
+  else if (auto decl = dynamic_cast<VariableDeclarationNode *>(node))
+  {
+    registrarChamadas(f, decl->getInitialValue());
+  }
+  else if (auto assign = dynamic_cast<AssignmentNode *>(node))
+  {
+    registrarChamadas(f, assign->getValue());
+    registrarChamadas(f, assign->getIndex());
+  }
+  else if (auto ifStmt = dynamic_cast<IfStatementNode *>(node))
+  {
+    registrarChamadas(f, ifStmt->getCondition());
+    registrarChamadas(f, ifStmt->getThenBlock());
+    registrarChamadas(f, ifStmt->getElseBlock());
+  }
+  else if (auto whileStmt = dynamic_cast<WhileStatementNode *>(node))
+  {
+    registrarChamadas(f, whileStmt->getCondition());
+    registrarChamadas(f, whileStmt->getBody());
+  }
+  else if (auto forStmt = dynamic_cast<ForStatementNode *>(node))
+  {
+    registrarChamadas(f, forStmt->getInit());
+    registrarChamadas(f, forStmt->getCondition());
+    registrarChamadas(f, forStmt->getUpdate());
+    registrarChamadas(f, forStmt->getBody());
+  }
+  else if (auto ret = dynamic_cast<ReturnStatementNode *>(node))
+  {
+    registrarChamadas(f, ret->getValue());
+  }
+  else if (auto exprStmt = dynamic_cast<ExpressionStatementNode *>(node))
+  {
+    registrarChamadas(f, exprStmt->getExpression());
+  }
+}
+
+// Algoritmo de Tarjan com pilha explícita. Os componentes saem em ordem
+// topológica reversa: um componente só é fechado depois de todos os que
+// ele alcança.
+void CallGraph::calcularComponentes()
+{
+  size_t n = chamadas.size();
+  vector<int> indice(n, -1), menor(n, 0);
+  vector<bool> naPilha(n, false);
+  vector<int> pilha;
+  vector<pair<int, size_t>> busca; // (função, próxima aresta)
+  int proximoIndice = 0;
+  componentes.clear();
+
+  for (size_t raiz = 0; raiz < n; raiz++)
+  {
+    if (indice[raiz] >= 0)
+    {
+      continue;
+    }
+    busca.push_back(make_pair(raiz, 0));
+    while (!busca.empty())
+    {
+      int v = busca.back().first;
+      size_t &aresta = busca.back().second;
+      if (aresta == 0 && indice[v] < 0)
+      {
+        indice[v] = menor[v] = proximoIndice++;
+        pilha.push_back(v);
+        naPilha[v] = true;
+      }
+
+      if (aresta < chamadas[v].size())
+      {
+        int w = chamadas[v][aresta++];
+        if (indice[w] < 0)
+        {
+          busca.push_back(make_pair(w, 0));
+        }
+        else if (naPilha[w])
+        {
+          menor[v] = min(menor[v], indice[w]);
+        }
+        continue;
+      }
+
+      if (menor[v] == indice[v])
+      {
+        vector<int> componente;
+        int w;
+        do
+        {
+          w = pilha.back();
+          pilha.pop_back();
+          naPilha[w] = false;
+          componente.push_back(w);
+        } while (w != v);
+        for (int membro : componente)
+        {
+          recursiva[membro] = componente.size() > 1 || getNumChamadas(membro, membro) > 0;
+        }
+        componentes.push_back(componente);
+      }
+      busca.pop_back();
+      if (!busca.empty())
+      {
+        int pai = busca.back().first;
+        menor[pai] = min(menor[pai], menor[v]);
+      }
+    }
+  }
+}
+
+string CallGraph::toString() const
+{
+  stringstream ss;
+  const vector<FunctionNode *> &funcoes = programa->getFunctions();
+  for (size_t f = 0; f < chamadas.size(); f++)
+  {
+    ss << funcoes[f]->getName() << (recursiva[f] ? " (recursiva)" : "") << " ->";
+    for (size_t i = 0; i < chamadas[f].size(); i++)
+    {
+      ss << " " << funcoes[chamadas[f][i]]->getName();
+      if (contagens[f][i] > 1)
+      {
+        ss << " x" << contagens[f][i];
+      }
+    }
+    ss << endl;
+  }
+  return ss.str();
+}
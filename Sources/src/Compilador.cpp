@@ -0,0 +1,179 @@
+#include "Compilador.h"
+#include "BoundsCheckEliminator.h"
+#include "Builtins.h"
+#include "BytecodeCompiler.h"
+#include "ConstantFolder.h"
+#include "DeadCodeEliminator.h"
+#include "Inliner.h"
+#include "PeepholeOptimizer.h"
+#include "Resolver.h"
+#include "TypeChecker.h"
+#include <ostream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+  // streambuf que acrescenta ao fim de uma string, sem realocar enquanto
+  // couber na capacidade que ela já tem
+  class SaidaEmTexto : public streambuf
+  {
+  public:
+    SaidaEmTexto(string &destino) : destino(destino) {}
+
+  protected:
+    int_type overflow(int_type c) override
+    {
+      if (c != traits_type::eof())
+      {
+        destino.push_back(traits_type::to_char_type(c));
+      }
+      return traits_type::not_eof(c);
+    }
+    streamsize xsputn(const char *s, streamsize n) override
+    {
+      destino.append(s, n);
+      return n;
+    }
+
+  private:
+    string &destino;
+  };
+
+  // Desvia os prints da thread para "saida" enquanto existir
+  class DesvioDaSaida
+  {
+  public:
+    DesvioDaSaida(ostream *saida) : anterior(getSaidaDosBuiltins()) { setSaidaDosBuiltins(saida); }
+    ~DesvioDaSaida() { setSaidaDosBuiltins(anterior); }
+
+  private:
+    ostream *anterior;
+  };
+}
+
+Compilador::Compilador(const OpcoesDoCompilador &opcoes)
+    : opcoes(opcoes), atual(nullptr), vm(nullptr), relogio(0), compilacoes(0), execucoes(0), acertosDoCache(0)
+{
+}
+
+Compilador::~Compilador()
+{
+  reiniciar();
+  delete vm;
+}
+
+void Compilador::liberar(Unidade &unidade)
+{
+  delete unidade.interpreter;
+  delete unidade.programa;
+  delete unidade.ast;
+}
+
+void Compilador::reiniciar()
+{
+  for (auto &entrada : cache)
+  {
+    liberar(entrada.second);
+  }
+  cache.clear();
+  atual = nullptr;
+  saida.clear();
+}
+
+void Compilador::compilar(const string &codigo)
+{
+  atual = nullptr;
+  auto it = cache.find(codigo);
+  if (it != cache.end())
+  {
+    atual = &it->second;
+    atual->ultimoUso = ++relogio;
+    acertosDoCache++;
+    return;
+  }
+
+  Unidade unidade;
+  lexer.reset(codigo);
+  parser.reset(lexer.Analisar());
+  unidade.ast = parser.analisar();
+  try
+  {
+    Resolver().analisar(unidade.ast);
+    TypeChecker().analisar(unidade.ast);
+    if (opcoes.otimizar)
+    {
+      Inliner().otimizar(unidade.ast);
+      ConstantFolder().otimizar(unidade.ast);
+      DeadCodeEliminator().otimizar(unidade.ast);
+      BoundsCheckEliminator().otimizar(unidade.ast);
+    }
+    if (opcoes.motor == Motor::VM)
+    {
+      unidade.programa = BytecodeCompiler().gerar(unidade.ast);
+      if (opcoes.otimizar)
+      {
+        PeepholeOptimizer().otimizar(unidade.programa);
+      }
+    }
+  }
+  catch (exception &)
+  {
+    liberar(unidade);
+    throw;
+  }
+  compilacoes++;
+
+  // Abre espaço tirando a unidade usada há mais tempo
+  if (opcoes.limiteDoCache > 0 && cache.size() >= opcoes.limiteDoCache)
+  {
+    auto antiga = cache.begin();
+    for (auto candidata = cache.begin(); candidata != cache.end(); ++candidata)
+    {
+      if (candidata->second.ultimoUso < antiga->second.ultimoUso)
+        antiga = candidata;
+    }
+    liberar(antiga->second);
+    cache.erase(antiga);
+  }
+  unidade.ultimoUso = ++relogio;
+  atual = &cache.insert(make_pair(codigo, unidade)).first->second;
+}
+
+string Compilador::getBytecode() const
+{
+  return atual && atual->programa ? atual->programa->toString() : "";
+}
+
+Valor Compilador::executar()
+{
+  if (!atual)
+  {
+    throw runtime_error("Erro de execucao: nenhum programa compilado");
+  }
+  saida.clear();
+  SaidaEmTexto buffer(saida);
+  ostream fluxo(&buffer);
+  DesvioDaSaida desvio(&fluxo);
+  execucoes++;
+
+  if (opcoes.motor == Motor::INTERPRETER)
+  {
+    if (!atual->interpreter)
+    {
+      atual->interpreter = new Interpreter(atual->ast, opcoes.usarJit);
+    }
+    return atual->interpreter->executar();
+  }
+  if (!vm)
+  {
+    vm = new VM(atual->programa);
+    vm->setLimites(opcoes.limiteDeProfundidade, opcoes.limiteDeDespachos);
+  }
+  else
+  {
+    vm->carregar(atual->programa);
+  }
+  return vm->executar();
+}
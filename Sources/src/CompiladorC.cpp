@@ -0,0 +1,82 @@
+#include "CompiladorC.h"
+#include "Compilador.h"
+#include <exception>
+#include <new>
+
+using namespace std;
+
+// Contexto da interface C: o Compilador e as strings devolvidas ao chamador
+struct compilador
+{
+  Compilador instancia;
+  string resultado;
+  string erro;
+
+  compilador(const OpcoesDoCompilador &opcoes) : instancia(opcoes) {}
+};
+
+compilador *compilador_criar(int motor)
+{
+  OpcoesDoCompilador opcoes;
+  opcoes.motor = motor == COMPILADOR_INTERPRETER ? Motor::INTERPRETER : Motor::VM;
+  return new (nothrow) compilador(opcoes);
+}
+
+void compilador_destruir(compilador *contexto)
+{
+  delete contexto;
+}
+
+int compilador_compilar(compilador *contexto, const char *codigo)
+{
+  contexto->resultado.clear();
+  contexto->erro.clear();
+  try
+  {
+    contexto->instancia.compilar(codigo);
+    return 0;
+  }
+  catch (exception &e)
+  {
+    contexto->erro = e.what();
+    return -1;
+  }
+}
+
+int compilador_executar(compilador *contexto)
+{
+  contexto->resultado.clear();
+  contexto->erro.clear();
+  try
+  {
+    contexto->resultado = contexto->instancia.executar().toString();
+    return 0;
+  }
+  catch (exception &e)
+  {
+    contexto->erro = e.what();
+    return -1;
+  }
+}
+
+void compilador_reiniciar(compilador *contexto)
+{
+  contexto->instancia.reiniciar();
+  contexto->resultado.clear();
+  contexto->erro.clear();
+}
+
+const char *compilador_resultado(const compilador *contexto)
+{
+  return contexto->resultado.c_str();
+}
+
+const char *compilador_saida(const compilador *contexto)
+{
+  return contexto->instancia.getSaida().c_str();
+}
+
+const char *compilador_erro(const compilador *contexto)
+{
+  return contexto->erro.c_str();
+}
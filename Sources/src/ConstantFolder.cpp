@@ -0,0 +1,421 @@
+#include "ConstantFolder.h"
+#include <cmath>
+#include <cstdint>
+
+using namespace std;
+
+bool isExpressaoPura(ExpressionNode *expr)
+{
+  if (auto unary = dynamic_cast<UnaryOpNode *>(expr))
+  {
+    return unary->getOp() == "!" && isExpressaoPura(unary->getOperand());
+  }
+  if (auto binary = dynamic_cast<BinaryOpNode *>(expr))
+  {
+    if (binary->getOp() == "=")
+      return false;
+    // A divisão inteira lança "divisao por zero", a não ser que o divisor
+    // seja uma constante diferente de 0
+    if (binary->getOp() == "/" && binary->getTipo() != TipoDeDado::DOUBLE)
+    {
+      auto divisor = dynamic_cast<IntLiteralNode *>(binary->getRight());
+      if (!divisor || divisor->getValue() == 0)
+        return false;
+    }
+    return isExpressaoPura(binary->getLeft()) && isExpressaoPura(binary->getRight());
+  }
+  if (auto conversion = dynamic_cast<ConversionNode *>(expr))
+  {
+    return isExpressaoPura(conversion->getOperand());
+  }
+  if (auto access = dynamic_cast<ArrayAccessNode *>(expr))
+  {
+    // Uma leitura verificada pode lançar "indice fora dos limites"
+    return !access->needsBoundsCheck() && isExpressaoPura(access->getIndex());
+  }
+  if (dynamic_cast<FunctionCallNode *>(expr))
+  {
+    return false;
+  }
+  return true; // literais e identificadores
+}
+
+static bool isInteiro(ExpressionNode *expr, int64_t &valor)
+{
+  if (auto literal = dynamic_cast<IntLiteralNode *>(expr))
+  {
+    valor = literal->getValue();
+    return true;
+  }
+  return false;
+}
+
+static bool isReal(ExpressionNode *expr, double &valor)
+{
+  if (auto literal = dynamic_cast<RealLiteralNode *>(expr))
+  {
+    valor = literal->getValue();
+    return true;
+  }
+  return false;
+}
+
+static bool isInteiroIgual(ExpressionNode *expr, int64_t esperado)
+{
+  int64_t valor;
+  return isInteiro(expr, valor) && valor == esperado;
+}
+
+static bool isRealIgual(ExpressionNode *expr, double esperado)
+{
+  double valor;
+  // signbit distingue 0.0 de -0.0
+  return isReal(expr, valor) && valor == esperado && std::signbit(valor) == std::signbit(esperado);
+}
+
+template <typename T>
+static bool compararConstantes(const string &op, const T &a, const T &b, int64_t &resultado)
+{
+  if (op == "<")
+    resultado = a < b;
+  else if (op == ">")
+    resultado = a > b;
+  else if (op == "<=")
+    resultado = a <= b;
+  else if (op == ">=")
+    resultado = a >= b;
+  else if (op == "==")
+    resultado = a == b;
+  else if (op == "!=")
+    resultado = a != b;
+  else
+    return false;
+  return true;
+}
+
+ConstantFolder::ConstantFolder() : simplificacoes(0)
+{
+}
+
+void ConstantFolder::otimizar(ProgramNode *program)
+{
+  simplificacoes = 0;
+  for (auto function : program->getFunctions())
+  {
+    otimizarBloco(function->getBody());
+  }
+}
+
+void ConstantFolder::otimizarBloco(BlockNode *block)
+{
+  vector<StatementNode *> saida;
+  for (auto stmt : block->getStatements())
+  {
+    otimizarStatement(stmt, saida);
+  }
+  block->setStatements(saida);
+}
+
+// Move os statements de um bloco que sobreviveu à poda para o bloco externo.
+// Os nomes já foram resolvidos para slots únicos, então achatar o escopo não
+// altera o significado do programa.
+void ConstantFolder::incorporarBloco(BlockNode *block, vector<StatementNode *> &saida)
+{
+  if (!block)
+  {
+    return;
+  }
+  otimizarBloco(block);
+  for (auto stmt : block->getStatements())
+  {
+    saida.push_back(stmt);
+  }
+  block->setStatements(vector<StatementNode *>());
+}
+
+void ConstantFolder::otimizarStatement(StatementNode *stmt, vector<StatementNode *> &saida)
+{
+  if (auto decl = dynamic_cast<VariableDeclarationNode *>(stmt))
+  {
+    if (decl->getInitialValue())
+    {
+      decl->setInitialValue(dobrar(decl->getInitialValue()));
+    }
+  }
+  else if (auto assign = dynamic_cast<AssignmentNode *>(stmt))
+  {
+    assign->setValue(dobrar(assign->getValue()));
+    if (assign->getIndex())
+    {
+      assign->setIndex(dobrar(assign->getIndex()));
+    }
+  }
+  else if (auto block = dynamic_cast<BlockNode *>(stmt))
+  {
+    otimizarBloco(block);
+  }
+  else if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+  {
+    ifStmt->setCondition(dobrar(ifStmt->getCondition()));
+    int64_t condicao;
+    if (isInteiro(ifStmt->getCondition(), condicao))
+    {
+      // Apenas um dos ramos pode executar: ele substitui o if
+      BlockNode *escolhido = condicao ? ifStmt->getThenBlock() : ifStmt->getElseBlock();
+      incorporarBloco(escolhido, saida);
+      delete ifStmt;
+      simplificacoes++;
+      return;
+    }
+    otimizarBloco(ifStmt->getThenBlock());
+    if (ifStmt->getElseBlock())
+    {
+      otimizarBloco(ifStmt->getElseBlock());
+    }
+  }
+  else if (auto whileStmt = dynamic_cast<WhileStatementNode *>(stmt))
+  {
+    whileStmt->setCondition(dobrar(whileStmt->getCondition()));
+    if (isInteiroIgual(whileStmt->getCondition(), 0))
+    {
+      delete whileStmt;
+      simplificacoes++;
+      return;
+    }
+    otimizarBloco(whileStmt->getBody());
+  }
+  else if (auto forStmt = dynamic_cast<ForStatementNode *>(stmt))
+  {
+    if (forStmt->getInit())
+    {
+      vector<StatementNode *> init;
+      otimizarStatement(forStmt->getInit(), init);
+      forStmt->setInit(init.empty() ? nullptr : init[0]);
+    }
+    if (forStmt->getCondition())
+    {
+      forStmt->setCondition(dobrar(forStmt->getCondition()));
+      if (isInteiroIgual(forStmt->getCondition(), 0))
+      {
+        // O corpo nunca executa, mas a inicialização sim
+        if (forStmt->getInit())
+        {
+          saida.push_back(forStmt->getInit());
+          forStmt->setInit(nullptr);
+        }
+        delete forStmt;
+        simplificacoes++;
+        return;
+      }
+    }
+    if (forStmt->getUpdate())
+    {
+      forStmt->setUpdate(dobrar(forStmt->getUpdate()));
+    }
+    otimizarBloco(forStmt->getBody());
+  }
+  else if (auto ret = dynamic_cast<ReturnStatementNode *>(stmt))
+  {
+    if (ret->getValue())
+    {
+      ret->setValue(dobrar(ret->getValue()));
+    }
+  }
+  else if (auto exprStmt = dynamic_cast<ExpressionStatementNode *>(stmt))
+  {
+    exprStmt->setExpression(dobrar(exprStmt->getExpression()));
+  }
+  saida.push_back(stmt);
+}
+
+// Libera a subárvore antiga e devolve o nó que a substitui
+ExpressionNode *ConstantFolder::substituir(ExpressionNode *antigo, ExpressionNode *novo)
+{
+  delete antigo;
+  simplificacoes++;
+  return novo;
+}
+
+// Descarta a operação binária mantendo apenas um dos operandos
+ExpressionNode *ConstantFolder::manterOperando(BinaryOpNode *binary, bool esquerdo)
+{
+  ExpressionNode *mantido = esquerdo ? binary->getLeft() : binary->getRight();
+  if (esquerdo)
+  {
+    binary->setLeft(nullptr);
+  }
+  else
+  {
+    binary->setRight(nullptr);
+  }
+  return substituir(binary, mantido);
+}
+
+ExpressionNode *ConstantFolder::dobrar(ExpressionNode *expr)
+{
+  if (auto binary = dynamic_cast<BinaryOpNode *>(expr))
+  {
+    return dobrarBinaria(binary);
+  }
+  if (auto unary = dynamic_cast<UnaryOpNode *>(expr))
+  {
+    return dobrarUnaria(unary);
+  }
+  if (auto conversion = dynamic_cast<ConversionNode *>(expr))
+  {
+    conversion->setOperand(dobrar(conversion->getOperand()));
+    int64_t valor;
+    if (isInteiro(conversion->getOperand(), valor))
+    {
+      return substituir(conversion, new RealLiteralNode(double(valor)));
+    }
+    return conversion;
+  }
+  if (auto access = dynamic_cast<ArrayAccessNode *>(expr))
+  {
+    access->setIndex(dobrar(access->getIndex()));
+    return access;
+  }
+  if (auto call = dynamic_cast<FunctionCallNode *>(expr))
+  {
+    for (size_t i = 0; i < call->getArgs().size(); i++)
+    {
+      call->setArg(i, dobrar(call->getArgs()[i]));
+    }
+    return call;
+  }
+  return expr;
+}
+
+ExpressionNode *ConstantFolder::dobrarUnaria(UnaryOpNode *unary)
+{
+  if (unary->getOp() != "!")
+  {
+    return unary; // ++ e -- alteram a variável e não são dobráveis
+  }
+  unary->setOperand(dobrar(unary->getOperand()));
+  int64_t valor;
+  if (isInteiro(unary->getOperand(), valor))
+  {
+    return substituir(unary, new IntLiteralNode(!valor));
+  }
+  return unary;
+}
+
+ExpressionNode *ConstantFolder::dobrarBinaria(BinaryOpNode *binary)
+{
+  const string op = binary->getOp();
+  if (op == "=")
+  {
+    binary->setRight(dobrar(binary->getRight()));
+    return binary;
+  }
+
+  binary->setLeft(dobrar(binary->getLeft()));
+  binary->setRight(dobrar(binary->getRight()));
+  ExpressionNode *left = binary->getLeft();
+  ExpressionNode *right = binary->getRight();
+
+  int64_t a, b, resultado;
+  double x, y;
+
+  if (op == "&&" || op == "||")
+  {
+    // Curto-circuito: o operando direito só é avaliado se necessário
+    bool isE = op == "&&";
+    if (isInteiro(left, a))
+    {
+      if ((a != 0) != isE)
+      {
+        return substituir(binary, new IntLiteralNode(isE ? 0 : 1));
+      }
+      if (isInteiro(right, b))
+      {
+        return substituir(binary, new IntLiteralNode(b != 0));
+      }
+    }
+    else if (isInteiro(right, b) && (b != 0) != isE && isExpressaoPura(left))
+    {
+      return substituir(binary, new IntLiteralNode(isE ? 0 : 1));
+    }
+    return binary;
+  }
+
+  if (isInteiro(left, a) && isInteiro(right, b))
+  {
+    // Aritmética em uint64_t para que o estouro dê a volta sem comportamento indefinido
+    if (op == "+")
+      return substituir(binary, new IntLiteralNode(int64_t(uint64_t(a) + uint64_t(b))));
+    if (op == "-")
+      return substituir(binary, new IntLiteralNode(int64_t(uint64_t(a) - uint64_t(b))));
+    if (op == "*")
+      return substituir(binary, new IntLiteralNode(int64_t(uint64_t(a) * uint64_t(b))));
+    if (op == "/")
+    {
+      // Divisão por zero fica para o tempo de execução
+      if (b == 0 || (a == INT64_MIN && b == -1))
+      {
+        return binary;
+      }
+      return substituir(binary, new IntLiteralNode(a / b));
+    }
+    if (compararConstantes(op, a, b, resultado))
+      return substituir(binary, new IntLiteralNode(resultado));
+    return binary;
+  }
+
+  if (isReal(left, x) && isReal(right, y))
+  {
+    if (op == "+")
+      return substituir(binary, new RealLiteralNode(x + y));
+    if (op == "-")
+      return substituir(binary, new RealLiteralNode(x - y));
+    if (op == "*")
+      return substituir(binary, new RealLiteralNode(x * y));
+    if (op == "/")
+      return substituir(binary, new RealLiteralNode(x / y));
+    if (compararConstantes(op, x, y, resultado))
+      return substituir(binary, new IntLiteralNode(resultado));
+    return binary;
+  }
+
+  auto textoEsquerdo = dynamic_cast<StringLiteralNode *>(left);
+  auto textoDireito = dynamic_cast<StringLiteralNode *>(right);
+  if (textoEsquerdo && textoDireito)
+  {
+    if (op == "+")
+      return substituir(binary, new StringLiteralNode(textoEsquerdo->getValue() + textoDireito->getValue()));
+    if (compararConstantes(op, textoEsquerdo->getValue(), textoDireito->getValue(), resultado))
+      return substituir(binary, new IntLiteralNode(resultado));
+    return binary;
+  }
+
+  // Identidades algébricas
+  if (binary->getTipo() == TipoDeDado::INT)
+  {
+    if ((op == "+" || op == "-") && isInteiroIgual(right, 0))
+      return manterOperando(binary, true);
+    if (op == "+" && isInteiroIgual(left, 0))
+      return manterOperando(binary, false);
+    if ((op == "*" || op == "/") && isInteiroIgual(right, 1))
+      return manterOperando(binary, true);
+    if (op == "*" && isInteiroIgual(left, 1))
+      return manterOperando(binary, false);
+    if (op == "*" && isInteiroIgual(right, 0) && isExpressaoPura(left))
+      return manterOperando(binary, false);
+    if (op == "*" && isInteiroIgual(left, 0) && isExpressaoPura(right))
+      return manterOperando(binary, true);
+  }
+  else if (binary->getTipo() == TipoDeDado::DOUBLE)
+  {
+    // x + 0.0 não é identidade (-0.0 + 0.0 == +0.0), mas x - 0.0, x * 1.0 e x / 1.0 são
+    if (op == "-" && isRealIgual(right, 0.0))
+      return manterOperando(binary, true);
+    if ((op == "*" || op == "/") && isRealIgual(right, 1.0))
+      return manterOperando(binary, true);
+    if (op == "*" && isRealIgual(left, 1.0))
+      return manterOperando(binary, false);
+  }
+
+  return binary;
+}
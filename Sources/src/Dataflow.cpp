@@ -0,0 +1,242 @@
+#include "Dataflow.h"
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+using namespace std;
+
+ResultadoDataflow resolverDataflow(const FuncaoIR &funcao, ProblemaDataflow &problema)
+{
+  auto inicio = chrono::steady_clock::now();
+  size_t numBlocos = funcao.blocos.size();
+  size_t numBits = problema.getNumBits();
+  bool paraFrente = problema.getDirecao() == DirecaoDataflow::PARA_FRENTE;
+
+  ResultadoDataflow resultado;
+  resultado.entrada.assign(numBlocos, BitSet(numBits));
+  resultado.saida.assign(numBlocos, BitSet(numBits));
+  vector<BitSet> gen(numBlocos, BitSet(numBits)), kill(numBlocos, BitSet(numBits));
+  for (size_t b = 0; b < numBlocos; b++)
+  {
+    problema.calcularGenKill(b, gen[b], kill[b]);
+  }
+  BitSet contorno(numBits);
+  problema.inicializarContorno(contorno);
+
+  // Ordem inicial: definições antes dos usos na direção da análise
+  vector<int> ordem = funcao.ordemReversaPosOrdem();
+  if (!paraFrente)
+  {
+    reverse(ordem.begin(), ordem.end());
+  }
+  vector<int> lista(ordem.rbegin(), ordem.rend()); // pilha: o próximo é o último
+  vector<bool> naLista(numBlocos, false);
+  for (int b : lista)
+  {
+    naLista[b] = true;
+  }
+
+  while (!lista.empty())
+  {
+    int b = lista.back();
+    lista.pop_back();
+    naLista[b] = false;
+    resultado.visitas++;
+
+    const BlocoIR &bloco = funcao.blocos[b];
+    const vector<int> &anteriores = paraFrente ? bloco.predecessores : bloco.sucessores;
+    const vector<int> &seguintes = paraFrente ? bloco.sucessores : bloco.predecessores;
+    BitSet &encontro = paraFrente ? resultado.entrada[b] : resultado.saida[b];
+    BitSet &transferido = paraFrente ? resultado.saida[b] : resultado.entrada[b];
+
+    // Encontro: união dos vizinhos anteriores na direção da análise
+    if ((paraFrente && b == 0) || (!paraFrente && anteriores.empty()))
+    {
+      encontro = contorno;
+    }
+    else
+    {
+      encontro.limpar();
+    }
+    for (int a : anteriores)
+    {
+      encontro.unir(paraFrente ? resultado.saida[a] : resultado.entrada[a]);
+    }
+
+    if (transferido.transferir(gen[b], encontro, kill[b]))
+    {
+      for (int s : seguintes)
+      {
+        if (!naLista[s])
+        {
+          naLista[s] = true;
+          lista.push_back(s);
+        }
+      }
+    }
+  }
+
+  auto fim = chrono::steady_clock::now();
+  resultado.microssegundos = chrono::duration<double, micro>(fim - inicio).count();
+  return resultado;
+}
+
+void AnaliseDeVivacidade::calcularGenKill(int b, BitSet &gen, BitSet &kill)
+{
+  const BlocoIR &bloco = funcao.blocos[b];
+
+  // Os operandos dos PHIs dos sucessores que vêm deste bloco são usados no seu fim
+  for (int s : bloco.sucessores)
+  {
+    const vector<int> &preds = funcao.blocos[s].predecessores;
+    uint32_t j = find(preds.begin(), preds.end(), b) - preds.begin();
+    for (uint32_t id : funcao.blocos[s].instrucoes)
+    {
+      if (funcao.instrucoes[id].op != OpIR::PHI)
+      {
+        break;
+      }
+      gen.ativar(funcao.operando(id, j));
+    }
+  }
+
+  // De trás para frente: a definição mata o valor e os usos o tornam vivo
+  for (size_t i = bloco.instrucoes.size(); i-- > 0;)
+  {
+    uint32_t id = bloco.instrucoes[i];
+    const InstrucaoIR &ins = funcao.instrucoes[id];
+    if (ins.tipo != TipoDeDado::VOID)
+    {
+      kill.ativar(id);
+      gen.desativar(id);
+    }
+    if (ins.op == OpIR::PHI)
+    {
+      continue;
+    }
+    for (uint32_t k = 0; k < ins.numOperandos; k++)
+    {
+      gen.ativar(funcao.operando(id, k));
+    }
+  }
+}
+
+DefinicoesAlcancaveis::DefinicoesAlcancaveis(const FuncaoIR &funcao)
+    : funcao(funcao), indiceDaDefinicao(funcao.instrucoes.size(), -1)
+{
+  for (const BlocoIR &bloco : funcao.blocos)
+  {
+    for (uint32_t id : bloco.instrucoes)
+    {
+      if (funcao.instrucoes[id].op == OpIR::STORE_LOCAL)
+      {
+        indiceDaDefinicao[id] = definicoes.size();
+        definicoes.push_back(id);
+      }
+    }
+  }
+
+  size_t numSlots = funcao.tiposSlots.size();
+  doSlot.assign(numSlots, BitSet(getNumBits()));
+  for (size_t d = 0; d < definicoes.size(); d++)
+  {
+    doSlot[funcao.instrucoes[definicoes[d]].imediato].ativar(d);
+  }
+  for (size_t slot = 0; slot < numSlots; slot++)
+  {
+    doSlot[slot].ativar(definicoes.size() + slot);
+  }
+}
+
+void DefinicoesAlcancaveis::inicializarContorno(BitSet &valor)
+{
+  for (size_t slot = 0; slot < funcao.tiposSlots.size(); slot++)
+  {
+    valor.ativar(definicoes.size() + slot);
+  }
+}
+
+// Efeito de um STORE_LOCAL: substitui todas as definições do slot pela sua
+void DefinicoesAlcancaveis::aplicar(uint32_t store, BitSet &valor) const
+{
+  valor.subtrair(doSlot[funcao.instrucoes[store].imediato]);
+  valor.ativar(indiceDaDefinicao[store]);
+}
+
+void DefinicoesAlcancaveis::calcularGenKill(int b, BitSet &gen, BitSet &kill)
+{
+  for (uint32_t id : funcao.blocos[b].instrucoes)
+  {
+    if (funcao.instrucoes[id].op == OpIR::STORE_LOCAL)
+    {
+      const BitSet &mascara = doSlot[funcao.instrucoes[id].imediato];
+      kill.unir(mascara);
+      gen.subtrair(mascara);
+      gen.ativar(indiceDaDefinicao[id]);
+    }
+  }
+}
+
+vector<uint32_t> DefinicoesAlcancaveis::definicoesQueAlcancam(uint32_t instrucao, bool &podeEstarIndefinida) const
+{
+  const InstrucaoIR &alvo = funcao.instrucoes[instrucao];
+  BitSet valor = resultado.entrada[alvo.bloco];
+  for (uint32_t id : funcao.blocos[alvo.bloco].instrucoes)
+  {
+    if (id == instrucao)
+    {
+      break;
+    }
+    if (funcao.instrucoes[id].op == OpIR::STORE_LOCAL)
+    {
+      aplicar(id, valor);
+    }
+  }
+
+  int slot = alvo.imediato;
+  valor.interseccionar(doSlot[slot]);
+  podeEstarIndefinida = valor.contem(definicoes.size() + slot);
+  vector<uint32_t> stores;
+  for (size_t d = valor.proximo(0); d < definicoes.size(); d = valor.proximo(d + 1))
+  {
+    stores.push_back(definicoes[d]);
+  }
+  return stores;
+}
+
+vector<uint32_t> DefinicoesAlcancaveis::leiturasSemDefinicao() const
+{
+  vector<uint32_t> leituras;
+  for (size_t b = 0; b < funcao.blocos.size(); b++)
+  {
+    BitSet valor = resultado.entrada[b];
+    for (uint32_t id : funcao.blocos[b].instrucoes)
+    {
+      const InstrucaoIR &ins = funcao.instrucoes[id];
+      if (ins.op == OpIR::STORE_LOCAL)
+      {
+        aplicar(id, valor);
+      }
+      else if (ins.op == OpIR::LOAD_LOCAL && valor.contem(definicoes.size() + ins.imediato))
+      {
+        leituras.push_back(id);
+      }
+    }
+  }
+  return leituras;
+}
+
+string formatarConjunto(const BitSet &conjunto, const vector<uint32_t> *valores)
+{
+  stringstream ss;
+  ss << "{";
+  bool primeiro = true;
+  conjunto.paraCada([&](size_t i)
+                    {
+                      if (valores && i >= valores->size())
+                        return;
+                      ss << (primeiro ? "" : ", ") << "%" << (valores ? (*valores)[i] : i);
+                      primeiro = false; });
+  ss << "}";
+  return ss.str();
+}
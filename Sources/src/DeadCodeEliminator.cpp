@@ -0,0 +1,665 @@
+#include "DeadCodeEliminator.h"
+#include "ConstantFolder.h"
+#include "SSA.h"
+#include <algorithm>
+
+using namespace std;
+
+static bool isLocal(Binding binding, size_t numSlots)
+{
+  return binding.isResolved() && !binding.isGlobal() && size_t(binding.slot) < numSlots;
+}
+
+static bool isConstante(ExpressionNode *expr, int64_t &valor)
+{
+  if (auto literal = dynamic_cast<IntLiteralNode *>(expr))
+  {
+    valor = literal->getValue();
+    return true;
+  }
+  return false;
+}
+
+static void unir(vector<bool> &destino, const vector<bool> &origem)
+{
+  for (size_t i = 0; i < destino.size(); i++)
+  {
+    if (origem[i])
+    {
+      destino[i] = true;
+    }
+  }
+}
+
+DeadCodeEliminator::DeadCodeEliminator() : removidos(0)
+{
+}
+
+void DeadCodeEliminator::otimizar(ProgramNode *program)
+{
+  removidos = 0;
+  for (auto function : program->getFunctions())
+  {
+    removerInalcancaveis(function->getBody());
+
+    // Ao final da função nenhuma variável local está viva
+    Vivas vivas(function->getFrameSize(), false);
+    analisarBloco(function->getBody(), vivas, true);
+
+    vector<int> referencias(function->getFrameSize(), 0);
+    contarReferencias(function->getBody(), referencias);
+    removerDeclaracoesSemUso(function->getBody(), referencias);
+  }
+}
+
+// Verdadeiro se a execução do statement nunca continua no seguinte
+bool DeadCodeEliminator::sempreRetorna(StatementNode *stmt)
+{
+  if (dynamic_cast<ReturnStatementNode *>(stmt))
+  {
+    return true;
+  }
+  if (auto block = dynamic_cast<BlockNode *>(stmt))
+  {
+    for (auto s : block->getStatements())
+    {
+      if (sempreRetorna(s))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+  {
+    return ifStmt->getElseBlock() && sempreRetorna(ifStmt->getThenBlock()) && sempreRetorna(ifStmt->getElseBlock());
+  }
+  return false;
+}
+
+void DeadCodeEliminator::removerInalcancaveis(BlockNode *block)
+{
+  vector<StatementNode *> saida;
+  bool inalcancavel = false;
+  for (auto stmt : block->getStatements())
+  {
+    if (inalcancavel)
+    {
+      delete stmt;
+      removidos++;
+      continue;
+    }
+
+    int64_t condicao;
+    if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+    {
+      if (isConstante(ifStmt->getCondition(), condicao))
+      {
+        // Só um dos ramos pode executar: seus statements substituem o if
+        BlockNode *escolhido = condicao ? ifStmt->getThenBlock() : ifStmt->getElseBlock();
+        if (escolhido)
+        {
+          removerInalcancaveis(escolhido);
+          for (auto s : escolhido->getStatements())
+          {
+            saida.push_back(s);
+            inalcancavel = inalcancavel || sempreRetorna(s);
+          }
+          escolhido->setStatements(vector<StatementNode *>());
+        }
+        delete ifStmt;
+        removidos++;
+        continue;
+      }
+      removerInalcancaveis(ifStmt->getThenBlock());
+      if (ifStmt->getElseBlock())
+      {
+        removerInalcancaveis(ifStmt->getElseBlock());
+      }
+    }
+    else if (auto whileStmt = dynamic_cast<WhileStatementNode *>(stmt))
+    {
+      if (isConstante(whileStmt->getCondition(), condicao) && condicao == 0)
+      {
+        delete whileStmt;
+        removidos++;
+        continue;
+      }
+      removerInalcancaveis(whileStmt->getBody());
+    }
+    else if (auto forStmt = dynamic_cast<ForStatementNode *>(stmt))
+    {
+      if (forStmt->getCondition() && isConstante(forStmt->getCondition(), condicao) && condicao == 0)
+      {
+        // O corpo nunca executa, mas a inicialização sim
+        if (forStmt->getInit())
+        {
+          saida.push_back(forStmt->getInit());
+          forStmt->setInit(nullptr);
+        }
+        delete forStmt;
+        removidos++;
+        continue;
+      }
+      removerInalcancaveis(forStmt->getBody());
+    }
+    else if (auto inner = dynamic_cast<BlockNode *>(stmt))
+    {
+      removerInalcancaveis(inner);
+    }
+
+    saida.push_back(stmt);
+    inalcancavel = sempreRetorna(stmt);
+  }
+  block->setStatements(saida);
+}
+
+// Propaga as variáveis vivas de trás para frente pelo bloco: na entrada,
+// "vivas" são as vivas ao final do bloco; na saída, as vivas no início.
+// Com remover = false apenas calcula (usado nas iterações dos laços).
+void DeadCodeEliminator::analisarBloco(BlockNode *block, Vivas &vivas, bool remover)
+{
+  vector<StatementNode *> statements = block->getStatements();
+  vector<StatementNode *> saida;
+  for (size_t i = statements.size(); i-- > 0;)
+  {
+    StatementNode *resultado = analisarStatement(statements[i], vivas, remover);
+    if (resultado)
+    {
+      saida.push_back(resultado);
+    }
+  }
+  if (remover)
+  {
+    reverse(saida.begin(), saida.end());
+    block->setStatements(saida);
+  }
+}
+
+// Retorna o statement que fica no lugar de stmt (nullptr se foi removido)
+StatementNode *DeadCodeEliminator::analisarStatement(StatementNode *stmt, Vivas &vivas, bool remover)
+{
+  if (auto decl = dynamic_cast<VariableDeclarationNode *>(stmt))
+  {
+    ExpressionNode *valor = decl->getInitialValue();
+    Binding binding = decl->getBinding();
+    if (!isLocal(binding, vivas.size()))
+    {
+      if (valor)
+        adicionarUsos(valor, vivas);
+      return stmt;
+    }
+    bool morta = !vivas[binding.slot];
+    vivas[binding.slot] = false;
+    if (valor && morta && isExpressaoPura(valor))
+    {
+      // A declaração fica (inicializada com o valor padrão); o valor nunca é lido
+      if (remover)
+      {
+        delete valor;
+        decl->setInitialValue(nullptr);
+        removidos++;
+      }
+    }
+    else if (valor)
+    {
+      adicionarUsos(valor, vivas);
+    }
+    return stmt;
+  }
+
+  if (auto assign = dynamic_cast<AssignmentNode *>(stmt))
+  {
+    Binding binding = assign->getBinding();
+    if (assign->getIndex())
+    {
+      // Escrita num elemento: o array é usado e continua vivo
+      if (isLocal(binding, vivas.size()))
+        vivas[binding.slot] = true;
+      adicionarUsos(assign->getIndex(), vivas);
+      adicionarUsos(assign->getValue(), vivas);
+      return stmt;
+    }
+    if (isLocal(binding, vivas.size()))
+    {
+      if (!vivas[binding.slot])
+      {
+        if (isExpressaoPura(assign->getValue()))
+        {
+          if (!remover)
+            return stmt;
+          delete assign;
+          removidos++;
+          return nullptr;
+        }
+        // O valor tem efeitos colaterais: mantém apenas a sua avaliação
+        adicionarUsos(assign->getValue(), vivas);
+        if (!remover)
+          return stmt;
+        ExpressionStatementNode *avaliacao = new ExpressionStatementNode(assign->getValue());
+        assign->setValue(nullptr);
+        delete assign;
+        removidos++;
+        return avaliacao;
+      }
+      vivas[binding.slot] = false;
+    }
+    adicionarUsos(assign->getValue(), vivas);
+    return stmt;
+  }
+
+  if (auto exprStmt = dynamic_cast<ExpressionStatementNode *>(stmt))
+  {
+    if (isExpressaoPura(exprStmt->getExpression()))
+    {
+      if (!remover)
+        return stmt;
+      delete exprStmt;
+      removidos++;
+      return nullptr;
+    }
+    adicionarUsos(exprStmt->getExpression(), vivas);
+    return stmt;
+  }
+
+  if (auto ret = dynamic_cast<ReturnStatementNode *>(stmt))
+  {
+    vivas.assign(vivas.size(), false);
+    if (ret->getValue())
+    {
+      adicionarUsos(ret->getValue(), vivas);
+    }
+    return stmt;
+  }
+
+  if (auto block = dynamic_cast<BlockNode *>(stmt))
+  {
+    analisarBloco(block, vivas, remover);
+    return stmt;
+  }
+
+  if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+  {
+    Vivas senao = vivas;
+    analisarBloco(ifStmt->getThenBlock(), vivas, remover);
+    if (ifStmt->getElseBlock())
+    {
+      analisarBloco(ifStmt->getElseBlock(), senao, remover);
+    }
+    unir(vivas, senao);
+    adicionarUsos(ifStmt->getCondition(), vivas);
+    return stmt;
+  }
+
+  if (auto whileStmt = dynamic_cast<WhileStatementNode *>(stmt))
+  {
+    analisarLaco(whileStmt->getCondition(), nullptr, whileStmt->getBody(), vivas, remover);
+    return stmt;
+  }
+
+  if (auto forStmt = dynamic_cast<ForStatementNode *>(stmt))
+  {
+    analisarLaco(forStmt->getCondition(), forStmt->getUpdate(), forStmt->getBody(), vivas, remover);
+    if (forStmt->getInit())
+    {
+      StatementNode *init = analisarStatement(forStmt->getInit(), vivas, remover);
+      if (remover)
+      {
+        forStmt->setInit(init);
+      }
+    }
+    return stmt;
+  }
+
+  return stmt;
+}
+
+// As vivas no início do laço (antes da condição) dependem das vivas no
+// início do corpo, que dependem delas mesmas: itera até o ponto fixo e só
+// então remove, com o conjunto final.
+void DeadCodeEliminator::analisarLaco(ExpressionNode *condition, ExpressionNode *update, BlockNode *body, Vivas &vivas, bool remover)
+{
+  Vivas saida = vivas;
+  Vivas cabecalho = saida;
+  if (condition)
+  {
+    adicionarUsos(condition, cabecalho);
+  }
+
+  while (true)
+  {
+    Vivas corpo = cabecalho;
+    if (update)
+    {
+      adicionarUsos(update, corpo);
+    }
+    analisarBloco(body, corpo, false);
+
+    Vivas novo = saida;
+    if (condition)
+    {
+      adicionarUsos(condition, novo);
+    }
+    unir(novo, corpo);
+    if (novo == cabecalho)
+    {
+      break;
+    }
+    cabecalho = novo;
+  }
+
+  if (remover)
+  {
+    Vivas corpo = cabecalho;
+    if (update)
+    {
+      adicionarUsos(update, corpo);
+    }
+    analisarBloco(body, corpo, true);
+  }
+  vivas = cabecalho;
+}
+
+void DeadCodeEliminator::adicionarUsos(ExpressionNode *expr, Vivas &vivas)
+{
+  if (!expr)
+  {
+    return;
+  }
+  if (auto ident = dynamic_cast<IdentifierNode *>(expr))
+  {
+    if (isLocal(ident->getBinding(), vivas.size()))
+    {
+      vivas[ident->getBinding().slot] = true;
+    }
+  }
+  else if (auto access = dynamic_cast<ArrayAccessNode *>(expr))
+  {
+    if (isLocal(access->getBinding(), vivas.size()))
+    {
+      vivas[access->getBinding().slot] = true;
+    }
+    adicionarUsos(access->getIndex(), vivas);
+  }
+  else if (auto unary = dynamic_cast<UnaryOpNode *>(expr))
+  {
+    adicionarUsos(unary->getOperand(), vivas);
+  }
+  else if (auto binary = dynamic_cast<BinaryOpNode *>(expr))
+  {
+    // A atribuição da atualização do for é tratada como uso (conservador)
+    adicionarUsos(binary->getLeft(), vivas);
+    adicionarUsos(binary->getRight(), vivas);
+  }
+  else if (auto conversion = dynamic_cast<ConversionNode *>(expr))
+  {
+    adicionarUsos(conversion->getOperand(), vivas);
+  }
+  else if (auto call = dynamic_cast<FunctionCallNode *>(expr))
+  {
+    for (auto arg : call->getArgs())
+    {
+      adicionarUsos(arg, vivas);
+    }
+  }
+}
+
+void DeadCodeEliminator::contarReferencias(ExpressionNode *expr, vector<int> &referencias)
+{
+  if (!expr)
+  {
+    return;
+  }
+  if (auto ident = dynamic_cast<IdentifierNode *>(expr))
+  {
+    if (isLocal(ident->getBinding(), referencias.size()))
+      referencias[ident->getBinding().slot]++;
+  }
+  else if (auto access = dynamic_cast<ArrayAccessNode *>(expr))
+  {
+    if (isLocal(access->getBinding(), referencias.size()))
+      referencias[access->getBinding().slot]++;
+    contarReferencias(access->getIndex(), referencias);
+  }
+  else if (auto unary = dynamic_cast<UnaryOpNode *>(expr))
+  {
+    contarReferencias(unary->getOperand(), referencias);
+  }
+  else if (auto binary = dynamic_cast<BinaryOpNode *>(expr))
+  {
+    contarReferencias(binary->getLeft(), referencias);
+    contarReferencias(binary->getRight(), referencias);
+  }
+  else if (auto conversion = dynamic_cast<ConversionNode *>(expr))
+  {
+    contarReferencias(conversion->getOperand(), referencias);
+  }
+  else if (auto call = dynamic_cast<FunctionCallNode *>(expr))
+  {
+    for (auto arg : call->getArgs())
+    {
+      contarReferencias(arg, referencias);
+    }
+  }
+}
+
+void DeadCodeEliminator::contarReferencias(StatementNode *stmt, vector<int> &referencias)
+{
+  if (auto decl = dynamic_cast<VariableDeclarationNode *>(stmt))
+  {
+    contarReferencias(decl->getInitialValue(), referencias);
+  }
+  else if (auto assign = dynamic_cast<AssignmentNode *>(stmt))
+  {
+    if (isLocal(assign->getBinding(), referencias.size()))
+      referencias[assign->getBinding().slot]++;
+    contarReferencias(assign->getIndex(), referencias);
+    contarReferencias(assign->getValue(), referencias);
+  }
+  else if (auto exprStmt = dynamic_cast<ExpressionStatementNode *>(stmt))
+  {
+    contarReferencias(exprStmt->getExpression(), referencias);
+  }
+  else if (auto ret = dynamic_cast<ReturnStatementNode *>(stmt))
+  {
+    contarReferencias(ret->getValue(), referencias);
+  }
+  else if (auto block = dynamic_cast<BlockNode *>(stmt))
+  {
+    for (auto s : block->getStatements())
+    {
+      contarReferencias(s, referencias);
+    }
+  }
+  else if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+  {
+    contarReferencias(ifStmt->getCondition(), referencias);
+    contarReferencias(ifStmt->getThenBlock(), referencias);
+    if (ifStmt->getElseBlock())
+      contarReferencias(ifStmt->getElseBlock(), referencias);
+  }
+  else if (auto whileStmt = dynamic_cast<WhileStatementNode *>(stmt))
+  {
+    contarReferencias(whileStmt->getCondition(), referencias);
+    contarReferencias(whileStmt->getBody(), referencias);
+  }
+  else if (auto forStmt = dynamic_cast<ForStatementNode *>(stmt))
+  {
+    if (forStmt->getInit())
+      contarReferencias(forStmt->getInit(), referencias);
+    contarReferencias(forStmt->getCondition(), referencias);
+    contarReferencias(forStmt->getUpdate(), referencias);
+    contarReferencias(forStmt->getBody(), referencias);
+  }
+}
+
+void DeadCodeEliminator::removerDeclaracoesSemUso(BlockNode *block, const vector<int> &referencias)
+{
+  auto semUso = [&](StatementNode *stmt)
+  {
+    auto decl = dynamic_cast<VariableDeclarationNode *>(stmt);
+    return decl && !decl->getInitialValue() && isLocal(decl->getBinding(), referencias.size()) &&
+           referencias[decl->getBinding().slot] == 0;
+  };
+
+  vector<StatementNode *> saida;
+  for (auto stmt : block->getStatements())
+  {
+    if (semUso(stmt))
+    {
+      delete stmt;
+      removidos++;
+      continue;
+    }
+    if (auto inner = dynamic_cast<BlockNode *>(stmt))
+    {
+      removerDeclaracoesSemUso(inner, referencias);
+    }
+    else if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+    {
+      removerDeclaracoesSemUso(ifStmt->getThenBlock(), referencias);
+      if (ifStmt->getElseBlock())
+        removerDeclaracoesSemUso(ifStmt->getElseBlock(), referencias);
+    }
+    else if (auto whileStmt = dynamic_cast<WhileStatementNode *>(stmt))
+    {
+      removerDeclaracoesSemUso(whileStmt->getBody(), referencias);
+    }
+    else if (auto forStmt = dynamic_cast<ForStatementNode *>(stmt))
+    {
+      if (forStmt->getInit() && semUso(forStmt->getInit()))
+      {
+        delete forStmt->getInit();
+        forStmt->setInit(nullptr);
+        removidos++;
+      }
+      removerDeclaracoesSemUso(forStmt->getBody(), referencias);
+    }
+    saida.push_back(stmt);
+  }
+  block->setStatements(saida);
+}
+
+void DeadCodeEliminator::otimizar(ProgramaIR *programa)
+{
+  removidos = 0;
+  for (auto funcao : programa->funcoes)
+  {
+    otimizarFuncao(*funcao);
+  }
+}
+
+void DeadCodeEliminator::otimizarFuncao(FuncaoIR &funcao)
+{
+  int antes = funcao.numInstrucoesVivas();
+
+  // Desvios com condição constante viram saltos incondicionais
+  bool desviosRemovidos = false;
+  for (size_t b = 0; b < funcao.blocos.size(); b++)
+  {
+    if (!funcao.isTerminado(b))
+    {
+      continue;
+    }
+    uint32_t terminador = funcao.terminador(b);
+    InstrucaoIR &ins = funcao.instrucoes[terminador];
+    if (ins.op != OpIR::BRANCH)
+    {
+      continue;
+    }
+    const InstrucaoIR &condicao = funcao.instrucoes[funcao.operando(terminador, 0)];
+    if (condicao.op != OpIR::CONST_INT)
+    {
+      continue;
+    }
+    int mantido = funcao.blocos[b].sucessores[condicao.imediato ? 0 : 1];
+    int descartado = funcao.blocos[b].sucessores[condicao.imediato ? 1 : 0];
+    ins.op = OpIR::JUMP;
+    ins.numOperandos = 0;
+    funcao.blocos[b].sucessores.assign(1, mantido);
+    funcao.removerPredecessor(descartado, b);
+    desviosRemovidos = true;
+  }
+  if (desviosRemovidos)
+  {
+    funcao.removerBlocosInalcancaveis();
+    calcularDominadores(funcao);
+
+    // Blocos que ficaram com um único predecessor têm PHIs de um operando
+    vector<uint32_t> substituto(funcao.instrucoes.size(), UINT32_MAX);
+    for (auto &bloco : funcao.blocos)
+    {
+      for (uint32_t id : bloco.instrucoes)
+      {
+        if (funcao.instrucoes[id].op == OpIR::PHI && funcao.instrucoes[id].numOperandos == 1)
+        {
+          substituto[id] = funcao.operando(id, 0);
+        }
+      }
+    }
+    for (auto &bloco : funcao.blocos)
+    {
+      for (uint32_t id : bloco.instrucoes)
+      {
+        for (uint32_t i = 0; i < funcao.instrucoes[id].numOperandos; i++)
+        {
+          uint32_t valor = funcao.operando(id, i);
+          while (substituto[valor] != UINT32_MAX)
+          {
+            valor = substituto[valor];
+          }
+          funcao.setOperando(id, i, valor);
+        }
+      }
+    }
+  }
+
+  // Marca como vivas as instruções com efeitos e, a partir delas, os seus operandos
+  vector<bool> viva(funcao.instrucoes.size(), false);
+  vector<uint32_t> pendentes;
+  for (auto &bloco : funcao.blocos)
+  {
+    for (uint32_t id : bloco.instrucoes)
+    {
+      OpIR op = funcao.instrucoes[id].op;
+      if ((!isPuraIR(op) || podeFalharIR(funcao, id)) && op != OpIR::PHI && op != OpIR::PARAM && op != OpIR::INDEFINIDO)
+      {
+        viva[id] = true;
+        pendentes.push_back(id);
+      }
+    }
+  }
+  while (!pendentes.empty())
+  {
+    uint32_t id = pendentes.back();
+    pendentes.pop_back();
+    for (uint32_t i = 0; i < funcao.instrucoes[id].numOperandos; i++)
+    {
+      uint32_t operando = funcao.operando(id, i);
+      if (!viva[operando])
+      {
+        viva[operando] = true;
+        pendentes.push_back(operando);
+      }
+    }
+  }
+
+  for (auto &bloco : funcao.blocos)
+  {
+    vector<uint32_t> vivas;
+    for (uint32_t id : bloco.instrucoes)
+    {
+      if (viva[id])
+      {
+        vivas.push_back(id);
+      }
+      else
+      {
+        funcao.instrucoes[id].op = OpIR::REMOVIDA;
+      }
+    }
+    bloco.instrucoes.swap(vivas);
+  }
+
+  removidos += antes - funcao.numInstrucoesVivas();
+}
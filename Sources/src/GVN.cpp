@@ -0,0 +1,220 @@
+#include "GVN.h"
+#include "SSA.h"
+#include <cstring>
+#include <unordered_map>
+
+using namespace std;
+
+namespace
+{
+  const uint32_t SEM_VALOR = UINT32_MAX;
+
+  // Identifica uma computação pura: duas instruções com a mesma chave
+  // produzem o mesmo valor
+  struct ChaveValor
+  {
+    OpIR op;
+    TipoDeDado tipo;
+    int64_t imediato;
+    uint32_t a, b;
+
+    bool operator==(const ChaveValor &outra) const
+    {
+      return op == outra.op && tipo == outra.tipo && imediato == outra.imediato && a == outra.a && b == outra.b;
+    }
+  };
+
+  struct HashChaveValor
+  {
+    size_t operator()(const ChaveValor &chave) const
+    {
+      uint64_t h = uint64_t(chave.op) * 0x9E3779B97F4A7C15ULL;
+      h ^= uint64_t(chave.tipo) + 0x632BE59BD9B4E019ULL + (h << 6) + (h >> 2);
+      h ^= uint64_t(chave.imediato) + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+      h ^= (uint64_t(chave.a) << 32 | chave.b) + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+      return h;
+    }
+  };
+
+  bool isComutativa(OpIR op, TipoDeDado tipoOperandos)
+  {
+    // Concatenação de strings não é comutativa
+    return (op == OpIR::ADD && tipoOperandos != TipoDeDado::STRING) ||
+           op == OpIR::MUL || op == OpIR::EQ || op == OpIR::NE;
+  }
+
+  ChaveValor chaveDe(const FuncaoIR &funcao, uint32_t id)
+  {
+    const InstrucaoIR &ins = funcao.instrucoes[id];
+    ChaveValor chave;
+    chave.op = ins.op;
+    chave.tipo = ins.tipo;
+    chave.imediato = 0;
+    chave.a = ins.numOperandos > 0 ? funcao.operando(id, 0) : SEM_VALOR;
+    chave.b = ins.numOperandos > 1 ? funcao.operando(id, 1) : SEM_VALOR;
+
+    if (ins.op == OpIR::CONST_REAL)
+    {
+      // Compara os bits, distinguindo 0.0 de -0.0
+      memcpy(&chave.imediato, &ins.real, sizeof(double));
+    }
+    else if (ins.op == OpIR::CONST_INT || ins.op == OpIR::CONST_STRING)
+    {
+      chave.imediato = ins.imediato;
+    }
+
+    // "a > b" equivale a "b < a" e "a >= b" a "b <= a"
+    if (ins.op == OpIR::GT || ins.op == OpIR::GE)
+    {
+      chave.op = ins.op == OpIR::GT ? OpIR::LT : OpIR::LE;
+      swap(chave.a, chave.b);
+    }
+    else if (ins.numOperandos == 2 && isComutativa(ins.op, funcao.instrucoes[chave.a].tipo) && chave.a > chave.b)
+    {
+      swap(chave.a, chave.b);
+    }
+    return chave;
+  }
+
+  // Valor representante, seguindo substituições encadeadas
+  uint32_t representante(const vector<uint32_t> &substituto, uint32_t valor)
+  {
+    while (substituto[valor] != SEM_VALOR)
+    {
+      valor = substituto[valor];
+    }
+    return valor;
+  }
+}
+
+GVN::GVN() : eliminadas(0) {}
+
+void GVN::otimizar(ProgramaIR *programa)
+{
+  eliminadas = 0;
+  for (auto funcao : programa->funcoes)
+  {
+    otimizarFuncao(*funcao);
+  }
+}
+
+void GVN::otimizarFuncao(FuncaoIR &funcao)
+{
+  calcularDominadores(funcao);
+
+  vector<uint32_t> substituto(funcao.instrucoes.size(), SEM_VALOR);
+  unordered_map<ChaveValor, uint32_t, HashChaveValor> tabela;
+
+  // Pré-ordem da árvore de dominância com pilha explícita; cada quadro
+  // lembra as chaves que inseriu para retirá-las ao sair do bloco
+  struct Quadro
+  {
+    int bloco;
+    size_t proximoFilho;
+    vector<ChaveValor> inseridas;
+  };
+  vector<Quadro> pilha;
+  pilha.push_back(Quadro{0, 0, vector<ChaveValor>()});
+  bool entrar = true;
+
+  while (!pilha.empty())
+  {
+    if (entrar)
+    {
+      Quadro &quadro = pilha.back();
+      for (uint32_t id : funcao.blocos[quadro.bloco].instrucoes)
+      {
+        InstrucaoIR &ins = funcao.instrucoes[id];
+        for (uint32_t i = 0; i < ins.numOperandos; i++)
+        {
+          uint32_t operando = funcao.operando(id, i);
+          if (substituto[operando] != SEM_VALOR)
+          {
+            funcao.setOperando(id, i, representante(substituto, operando));
+          }
+        }
+
+        if (ins.op == OpIR::PHI)
+        {
+          // PHI trivial: todos os operandos (exceto ele mesmo) são o mesmo valor
+          uint32_t unico = SEM_VALOR;
+          bool trivial = true;
+          for (uint32_t i = 0; i < ins.numOperandos && trivial; i++)
+          {
+            uint32_t operando = funcao.operando(id, i);
+            if (operando == id || operando == unico)
+            {
+              continue;
+            }
+            trivial = unico == SEM_VALOR;
+            unico = operando;
+          }
+          if (trivial && unico != SEM_VALOR)
+          {
+            substituto[id] = unico;
+            ins.op = OpIR::REMOVIDA;
+            eliminadas++;
+          }
+          continue;
+        }
+
+        if (!isPuraIR(ins.op))
+        {
+          continue;
+        }
+        ChaveValor chave = chaveDe(funcao, id);
+        auto existente = tabela.find(chave);
+        if (existente != tabela.end())
+        {
+          substituto[id] = existente->second;
+          ins.op = OpIR::REMOVIDA;
+          eliminadas++;
+        }
+        else
+        {
+          tabela[chave] = id;
+          quadro.inseridas.push_back(chave);
+        }
+      }
+    }
+
+    Quadro &topo = pilha.back();
+    const vector<int> &filhos = funcao.blocos[topo.bloco].filhosDominancia;
+    if (topo.proximoFilho < filhos.size())
+    {
+      int filho = filhos[topo.proximoFilho++];
+      pilha.push_back(Quadro{filho, 0, vector<ChaveValor>()});
+      entrar = true;
+    }
+    else
+    {
+      for (const ChaveValor &chave : topo.inseridas)
+      {
+        tabela.erase(chave);
+      }
+      pilha.pop_back();
+      entrar = false;
+    }
+  }
+
+  // Operandos vindos de arestas de retorno (PHIs de laços) só são
+  // conhecidos depois do percurso; retira as instruções eliminadas
+  for (auto &bloco : funcao.blocos)
+  {
+    vector<uint32_t> vivas;
+    for (uint32_t id : bloco.instrucoes)
+    {
+      const InstrucaoIR &ins = funcao.instrucoes[id];
+      if (ins.op == OpIR::REMOVIDA)
+      {
+        continue;
+      }
+      for (uint32_t i = 0; i < ins.numOperandos; i++)
+      {
+        funcao.setOperando(id, i, representante(substituto, funcao.operando(id, i)));
+      }
+      vivas.push_back(id);
+    }
+    bloco.instrucoes.swap(vivas);
+  }
+}
@@ -0,0 +1,485 @@
+#include "IR.h"
+#include "Builtins.h"
+#include "Numero.h"
+#include <algorithm>
+#include <sstream>
+
+using namespace std;
+
+string opIRParaString(OpIR op)
+{
+  switch (op)
+  {
+  case OpIR::CONST_INT:
+  case OpIR::CONST_REAL:
+  case OpIR::CONST_STRING:
+    return "const";
+  case OpIR::PARAM:
+    return "param";
+  case OpIR::INDEFINIDO:
+    return "undef";
+  case OpIR::ADD:
+    return "add";
+  case OpIR::SUB:
+    return "sub";
+  case OpIR::MUL:
+    return "mul";
+  case OpIR::DIV:
+    return "div";
+  case OpIR::LT:
+    return "lt";
+  case OpIR::GT:
+    return "gt";
+  case OpIR::LE:
+    return "le";
+  case OpIR::GE:
+    return "ge";
+  case OpIR::EQ:
+    return "eq";
+  case OpIR::NE:
+    return "ne";
+  case OpIR::NOT:
+    return "not";
+  case OpIR::INT_TO_DOUBLE:
+    return "itod";
+  case OpIR::PHI:
+    return "phi";
+  case OpIR::CALL:
+    return "call";
+  case OpIR::CALL_BUILTIN:
+    return "call_builtin";
+  case OpIR::LOAD_GLOBAL:
+    return "loadg";
+  case OpIR::STORE_GLOBAL:
+    return "storeg";
+  case OpIR::NEW_ARRAY:
+    return "new_array";
+  case OpIR::LOAD_ELEM:
+    return "load_elem";
+  case OpIR::STORE_ELEM:
+    return "store_elem";
+  case OpIR::LOAD_LOCAL:
+    return "load";
+  case OpIR::STORE_LOCAL:
+    return "store";
+  case OpIR::JUMP:
+    return "jmp";
+  case OpIR::BRANCH:
+    return "br";
+  case OpIR::RETURN:
+    return "ret";
+  default:
+    return "removida";
+  }
+}
+
+bool isTerminadorIR(OpIR op)
+{
+  return op == OpIR::JUMP || op == OpIR::BRANCH || op == OpIR::RETURN;
+}
+
+bool isPuraIR(OpIR op)
+{
+  switch (op)
+  {
+  case OpIR::CONST_INT:
+  case OpIR::CONST_REAL:
+  case OpIR::CONST_STRING:
+  case OpIR::ADD:
+  case OpIR::SUB:
+  case OpIR::MUL:
+  case OpIR::DIV:
+  case OpIR::LT:
+  case OpIR::GT:
+  case OpIR::LE:
+  case OpIR::GE:
+  case OpIR::EQ:
+  case OpIR::NE:
+  case OpIR::NOT:
+  case OpIR::INT_TO_DOUBLE:
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool podeFalharIR(const FuncaoIR &funcao, uint32_t id)
+{
+  const InstrucaoIR &ins = funcao.instrucoes[id];
+  if (ins.op == OpIR::DIV && ins.tipo == TipoDeDado::INT)
+  {
+    const InstrucaoIR &divisor = funcao.instrucoes[funcao.operando(id, 1)];
+    return divisor.op != OpIR::CONST_INT || divisor.imediato == 0;
+  }
+  return false;
+}
+
+int FuncaoIR::criarBloco()
+{
+  blocos.push_back(BlocoIR());
+  return blocos.size() - 1;
+}
+
+void FuncaoIR::ligar(int de, int para)
+{
+  blocos[de].sucessores.push_back(para);
+  blocos[para].predecessores.push_back(de);
+}
+
+void FuncaoIR::removerPredecessor(int bloco, int pred)
+{
+  vector<int> &preds = blocos[bloco].predecessores;
+  uint32_t posicao = find(preds.begin(), preds.end(), pred) - preds.begin();
+  if (posicao == preds.size())
+  {
+    return;
+  }
+  preds.erase(preds.begin() + posicao);
+  for (uint32_t id : blocos[bloco].instrucoes)
+  {
+    InstrucaoIR &phi = instrucoes[id];
+    if (phi.op != OpIR::PHI)
+    {
+      break;
+    }
+    for (uint32_t i = posicao; i + 1 < phi.numOperandos; i++)
+    {
+      operandos[phi.primeiroOperando + i] = operandos[phi.primeiroOperando + i + 1];
+    }
+    phi.numOperandos--;
+  }
+}
+
+uint32_t FuncaoIR::criarInstrucao(OpIR op, TipoDeDado tipo, int bloco, const uint32_t *ops, uint32_t numOps, int64_t imediato)
+{
+  InstrucaoIR instrucao;
+  instrucao.op = op;
+  instrucao.tipo = tipo;
+  instrucao.bloco = bloco;
+  instrucao.primeiroOperando = operandos.size();
+  instrucao.numOperandos = numOps;
+  instrucao.imediato = imediato;
+  for (uint32_t i = 0; i < numOps; i++)
+  {
+    operandos.push_back(ops ? ops[i] : 0);
+  }
+  instrucoes.push_back(instrucao);
+  return instrucoes.size() - 1;
+}
+
+uint32_t FuncaoIR::adicionar(int bloco, OpIR op, TipoDeDado tipo, const uint32_t *ops, uint32_t numOps, int64_t imediato)
+{
+  uint32_t id = criarInstrucao(op, tipo, bloco, ops, numOps, imediato);
+  blocos[bloco].instrucoes.push_back(id);
+  return id;
+}
+
+uint32_t FuncaoIR::adicionar(int bloco, OpIR op, TipoDeDado tipo, uint32_t op1, int64_t imediato)
+{
+  return adicionar(bloco, op, tipo, &op1, 1, imediato);
+}
+
+uint32_t FuncaoIR::adicionarBinaria(int bloco, OpIR op, TipoDeDado tipo, uint32_t op1, uint32_t op2)
+{
+  uint32_t ops[2] = {op1, op2};
+  return adicionar(bloco, op, tipo, ops, 2);
+}
+
+uint32_t FuncaoIR::constanteInteira(int bloco, int64_t valor)
+{
+  return adicionar(bloco, OpIR::CONST_INT, TipoDeDado::INT, nullptr, 0, valor);
+}
+
+uint32_t FuncaoIR::constanteReal(int bloco, double valor)
+{
+  uint32_t id = adicionar(bloco, OpIR::CONST_REAL, TipoDeDado::DOUBLE);
+  instrucoes[id].real = valor;
+  return id;
+}
+
+bool FuncaoIR::isTerminado(int bloco) const
+{
+  return !blocos[bloco].instrucoes.empty() && isTerminadorIR(instrucoes[blocos[bloco].instrucoes.back()].op);
+}
+
+vector<int> FuncaoIR::ordemReversaPosOrdem() const
+{
+  // DFS iterativa: a pilha guarda (bloco, próximo sucessor a visitar)
+  vector<int> posOrdem;
+  vector<bool> visitado(blocos.size(), false);
+  vector<pair<int, size_t>> pilha;
+  if (blocos.empty())
+  {
+    return posOrdem;
+  }
+  pilha.push_back(make_pair(0, 0));
+  visitado[0] = true;
+  while (!pilha.empty())
+  {
+    int b = pilha.back().first;
+    size_t &proximo = pilha.back().second;
+    if (proximo < blocos[b].sucessores.size())
+    {
+      int s = blocos[b].sucessores[proximo++];
+      if (!visitado[s])
+      {
+        visitado[s] = true;
+        pilha.push_back(make_pair(s, 0));
+      }
+    }
+    else
+    {
+      posOrdem.push_back(b);
+      pilha.pop_back();
+    }
+  }
+  return vector<int>(posOrdem.rbegin(), posOrdem.rend());
+}
+
+void FuncaoIR::removerBlocosInalcancaveis()
+{
+  vector<int> alcancaveis = ordemReversaPosOrdem();
+  if (alcancaveis.size() == blocos.size())
+  {
+    return;
+  }
+
+  // Renumera os blocos vivos preservando a ordem original
+  vector<int> novoIndice(blocos.size(), -1);
+  for (int b : alcancaveis)
+  {
+    novoIndice[b] = 0;
+  }
+  int proximo = 0;
+  for (size_t b = 0; b < blocos.size(); b++)
+  {
+    if (novoIndice[b] == 0)
+    {
+      novoIndice[b] = proximo++;
+    }
+  }
+
+  vector<BlocoIR> novos(proximo);
+  for (size_t b = 0; b < blocos.size(); b++)
+  {
+    if (novoIndice[b] < 0)
+    {
+      for (uint32_t id : blocos[b].instrucoes)
+      {
+        instrucoes[id].op = OpIR::REMOVIDA;
+      }
+      continue;
+    }
+    BlocoIR &novo = novos[novoIndice[b]];
+    novo.instrucoes.swap(blocos[b].instrucoes);
+    for (int s : blocos[b].sucessores)
+    {
+      novo.sucessores.push_back(novoIndice[s]);
+    }
+    for (size_t p = 0; p < blocos[b].predecessores.size(); p++)
+    {
+      int pred = blocos[b].predecessores[p];
+      if (novoIndice[pred] >= 0)
+      {
+        novo.predecessores.push_back(novoIndice[pred]);
+      }
+      else
+      {
+        // Predecessor morto: remove o operando correspondente dos PHIs
+        for (uint32_t id : novo.instrucoes)
+        {
+          if (instrucoes[id].op == OpIR::PHI)
+          {
+            InstrucaoIR &phi = instrucoes[id];
+            uint32_t posicao = novo.predecessores.size();
+            for (uint32_t i = posicao; i + 1 < phi.numOperandos; i++)
+            {
+              operandos[phi.primeiroOperando + i] = operandos[phi.primeiroOperando + i + 1];
+            }
+            phi.numOperandos--;
+          }
+        }
+      }
+    }
+    for (uint32_t id : novo.instrucoes)
+    {
+      instrucoes[id].bloco = novoIndice[b];
+    }
+  }
+  blocos.swap(novos);
+}
+
+void FuncaoIR::dividirArestasCriticas()
+{
+  size_t total = blocos.size();
+  for (size_t b = 0; b < total; b++)
+  {
+    if (blocos[b].sucessores.size() < 2)
+    {
+      continue;
+    }
+    for (size_t i = 0; i < blocos[b].sucessores.size(); i++)
+    {
+      int destino = blocos[b].sucessores[i];
+      if (blocos[destino].predecessores.size() < 2)
+      {
+        continue;
+      }
+      int meio = criarBloco();
+      adicionar(meio, OpIR::JUMP, TipoDeDado::VOID);
+      blocos[b].sucessores[i] = meio;
+      blocos[meio].predecessores.push_back(b);
+      blocos[meio].sucessores.push_back(destino);
+      for (int &pred : blocos[destino].predecessores)
+      {
+        if (pred == int(b))
+        {
+          pred = meio;
+          break;
+        }
+      }
+    }
+  }
+}
+
+int FuncaoIR::numInstrucoesVivas() const
+{
+  int total = 0;
+  for (const BlocoIR &bloco : blocos)
+  {
+    total += bloco.instrucoes.size();
+  }
+  return total;
+}
+
+static string formatarValor(uint32_t id)
+{
+  return "%" + to_string(id);
+}
+
+string FuncaoIR::toString() const
+{
+  stringstream ss;
+  ss << "funcao " << tipoDeDadoParaString(tipoRetorno) << " " << nome << "(";
+  for (size_t i = 0; i < tiposParametros.size(); i++)
+  {
+    ss << (i ? ", " : "") << tipoDeDadoParaString(tiposParametros[i]);
+  }
+  ss << ")" << endl;
+
+  for (size_t b = 0; b < blocos.size(); b++)
+  {
+    const BlocoIR &bloco = blocos[b];
+    ss << "b" << b << ":";
+    if (!bloco.predecessores.empty())
+    {
+      ss << "  ; preds:";
+      for (int p : bloco.predecessores)
+      {
+        ss << " b" << p;
+      }
+    }
+    if (bloco.idom >= 0)
+    {
+      ss << "  ; idom: b" << bloco.idom;
+    }
+    ss << endl;
+
+    for (uint32_t id : bloco.instrucoes)
+    {
+      const InstrucaoIR &ins = instrucoes[id];
+      ss << "  ";
+      if (ins.tipo != TipoDeDado::VOID)
+      {
+        ss << formatarValor(id) << " = ";
+      }
+      ss << opIRParaString(ins.op);
+      if (ins.tipo != TipoDeDado::VOID)
+      {
+        ss << " " << tipoDeDadoParaString(ins.tipo);
+      }
+
+      switch (ins.op)
+      {
+      case OpIR::CONST_INT:
+      case OpIR::PARAM:
+      case OpIR::NEW_ARRAY:
+        ss << " " << ins.imediato;
+        break;
+      case OpIR::LOAD_ELEM:
+      case OpIR::STORE_ELEM:
+        ss << " " << formatarValor(operando(id, 0)) << "[" << formatarValor(operando(id, 1)) << "]";
+        if (ins.op == OpIR::STORE_ELEM)
+          ss << ", " << formatarValor(operando(id, 2));
+        if (ins.imediato >= 0)
+          ss << " (verifica < " << ins.imediato << ")";
+        break;
+      case OpIR::CONST_REAL:
+        ss << " " << formatarReal(ins.real);
+        break;
+      case OpIR::CONST_STRING:
+        ss << " \"" << strings[ins.imediato] << "\"";
+        break;
+      case OpIR::PHI:
+        for (uint32_t i = 0; i < ins.numOperandos; i++)
+        {
+          ss << (i ? ", " : " ") << "[" << formatarValor(operando(id, i)) << ", b" << bloco.predecessores[i] << "]";
+        }
+        break;
+      case OpIR::CALL:
+      case OpIR::CALL_BUILTIN:
+        if (ins.op == OpIR::CALL)
+          ss << " f" << ins.imediato << "(";
+        else
+          ss << " " << BUILTINS[ins.imediato].nome << "(";
+        for (uint32_t i = 0; i < ins.numOperandos; i++)
+        {
+          ss << (i ? ", " : "") << formatarValor(operando(id, i));
+        }
+        ss << ")";
+        break;
+      case OpIR::LOAD_GLOBAL:
+      case OpIR::LOAD_LOCAL:
+        ss << " @" << ins.imediato;
+        break;
+      case OpIR::STORE_GLOBAL:
+      case OpIR::STORE_LOCAL:
+        ss << " @" << ins.imediato << ", " << formatarValor(operando(id, 0));
+        break;
+      case OpIR::JUMP:
+        ss << " b" << bloco.sucessores[0];
+        break;
+      case OpIR::BRANCH:
+        ss << " " << formatarValor(operando(id, 0)) << ", b" << bloco.sucessores[0] << ", b" << bloco.sucessores[1];
+        break;
+      default:
+        for (uint32_t i = 0; i < ins.numOperandos; i++)
+        {
+          ss << (i ? ", " : " ") << formatarValor(operando(id, i));
+        }
+        break;
+      }
+      ss << endl;
+    }
+  }
+  return ss.str();
+}
+
+ProgramaIR::~ProgramaIR()
+{
+  for (auto funcao : funcoes)
+  {
+    delete funcao;
+  }
+}
+
+string ProgramaIR::toString() const
+{
+  stringstream ss;
+  for (size_t i = 0; i < funcoes.size(); i++)
+  {
+    ss << "; f" << i << endl
+       << funcoes[i]->toString() << endl;
+  }
+  return ss.str();
+}
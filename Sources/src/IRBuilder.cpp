@@ -0,0 +1,517 @@
+#include "IRBuilder.h"
+#include "SSA.h"
+#include <stdexcept>
+
+using namespace std;
+
+IRBuilder::IRBuilder() : programa(nullptr), funcao(nullptr), blocoAtual(0), lacoDeEntrada(nullptr), cabecalhoDeEntrada(-1)
+{
+}
+
+void IRBuilder::erro(const string &msg)
+{
+  throw runtime_error("Erro na geracao de IR: " + msg);
+}
+
+ProgramaIR *IRBuilder::construir(ProgramNode *program, bool ssa)
+{
+  ProgramaIR *resultado = new ProgramaIR();
+  resultado->tiposGlobais = program->getGlobalTypes();
+  try
+  {
+    for (auto function : program->getFunctions())
+    {
+      resultado->funcoes.push_back(construirFuncao(program, function, ssa));
+    }
+  }
+  catch (exception &)
+  {
+    delete resultado;
+    throw;
+  }
+  return resultado;
+}
+
+FuncaoIR *IRBuilder::construirFuncao(ProgramNode *program, FunctionNode *function, bool ssa)
+{
+  return gerarFuncao(program, function, nullptr, ssa);
+}
+
+FuncaoIR *IRBuilder::construirEntradaDeLaco(ProgramNode *program, FunctionNode *function, StatementNode *laco, bool ssa)
+{
+  return gerarFuncao(program, function, laco, ssa);
+}
+
+FuncaoIR *IRBuilder::gerarFuncao(ProgramNode *program, FunctionNode *function, StatementNode *laco, bool ssa)
+{
+  programa = program;
+  lacoDeEntrada = laco;
+  cabecalhoDeEntrada = -1;
+  funcao = new FuncaoIR();
+  funcao->nome = function->getName();
+  funcao->tipoRetorno = tipoDeDadoDeString(function->getReturnType());
+  funcao->tiposSlots = function->getSlotTypes();
+  tamanhosLocais.assign(function->getFrameSize(), -1);
+  tamanhosGlobais.assign(program->getGlobalCount(), -1);
+  for (auto outra : program->getFunctions())
+  {
+    if (!outra->isGlobalWrapper())
+      continue;
+    for (auto stmt : outra->getBody()->getStatements())
+    {
+      auto decl = dynamic_cast<VariableDeclarationNode *>(stmt);
+      if (decl && decl->isArray() && decl->getBinding().isGlobal())
+        tamanhosGlobais[decl->getBinding().slot] = decl->getArraySize();
+    }
+  }
+
+  try
+  {
+    blocoAtual = funcao->criarBloco();
+
+    // Na entrada de laço, o bloco de entrada recebe o quadro inteiro e salta
+    // para o cabeçalho do laço; o início normal da função fica inalcançável
+    int entradaDoLaco = -1;
+    if (laco)
+    {
+      entradaDoLaco = blocoAtual;
+      const vector<TipoDeDado> &tiposDoQuadro = function->getSlotTypes();
+      for (size_t s = 0; s < tiposDoQuadro.size(); s++)
+      {
+        funcao->tiposParametros.push_back(tiposDoQuadro[s]);
+        armazenar(Binding(1, s), funcao->adicionar(blocoAtual, OpIR::PARAM, tiposDoQuadro[s], nullptr, 0, s));
+      }
+      blocoAtual = funcao->criarBloco();
+    }
+
+    // Os parâmetros chegam como valores e são copiados para os seus slots
+    const vector<ParameterNode *> &params = function->getParams();
+    for (size_t i = 0; i < params.size(); i++)
+    {
+      TipoDeDado tipo = tipoDeDadoDeString(params[i]->getType());
+      if (!laco)
+      {
+        funcao->tiposParametros.push_back(tipo);
+      }
+      uint32_t valor = funcao->adicionar(blocoAtual, OpIR::PARAM, tipo, nullptr, 0, i);
+      armazenar(params[i]->getBinding(), valor);
+    }
+
+    gerarBloco(function->getBody());
+
+    // Retorno implícito no fim da função
+    if (!funcao->isTerminado(blocoAtual))
+    {
+      if (funcao->tipoRetorno == TipoDeDado::VOID)
+      {
+        funcao->adicionar(blocoAtual, OpIR::RETURN, TipoDeDado::VOID);
+      }
+      else
+      {
+        funcao->adicionar(blocoAtual, OpIR::RETURN, TipoDeDado::VOID, valorPadrao(funcao->tipoRetorno));
+      }
+    }
+
+    if (laco)
+    {
+      if (cabecalhoDeEntrada < 0)
+      {
+        erro("laco de entrada nao pertence a funcao '" + function->getName() + "'");
+      }
+      funcao->adicionar(entradaDoLaco, OpIR::JUMP, TipoDeDado::VOID);
+      funcao->ligar(entradaDoLaco, cabecalhoDeEntrada);
+    }
+
+    funcao->removerBlocosInalcancaveis();
+    funcao->dividirArestasCriticas();
+    if (ssa)
+    {
+      converterParaSSA(*funcao);
+    }
+  }
+  catch (exception &)
+  {
+    delete funcao;
+    throw;
+  }
+  return funcao;
+}
+
+uint32_t IRBuilder::valorPadrao(TipoDeDado tipo)
+{
+  // Variáveis declaradas sem inicializador começam com o valor zero do tipo
+  if (tipo == TipoDeDado::DOUBLE)
+  {
+    return funcao->constanteReal(blocoAtual, 0.0);
+  }
+  if (tipo == TipoDeDado::STRING)
+  {
+    funcao->strings.push_back("");
+    return funcao->adicionar(blocoAtual, OpIR::CONST_STRING, TipoDeDado::STRING, nullptr, 0, funcao->strings.size() - 1);
+  }
+  return funcao->constanteInteira(blocoAtual, 0);
+}
+
+int IRBuilder::novoTemporario(TipoDeDado tipo)
+{
+  funcao->tiposSlots.push_back(tipo);
+  return funcao->tiposSlots.size() - 1;
+}
+
+uint32_t IRBuilder::carregar(Binding binding, TipoDeDado tipo)
+{
+  OpIR op = binding.isGlobal() ? OpIR::LOAD_GLOBAL : OpIR::LOAD_LOCAL;
+  return funcao->adicionar(blocoAtual, op, tipo, nullptr, 0, binding.slot);
+}
+
+void IRBuilder::armazenar(Binding binding, uint32_t valor)
+{
+  OpIR op = binding.isGlobal() ? OpIR::STORE_GLOBAL : OpIR::STORE_LOCAL;
+  funcao->adicionar(blocoAtual, op, TipoDeDado::VOID, valor, binding.slot);
+}
+
+TipoDeDado IRBuilder::tipoDaVariavel(Binding binding) const
+{
+  return binding.isGlobal() ? programa->getGlobalTypes()[binding.slot] : funcao->tiposSlots[binding.slot];
+}
+
+int64_t IRBuilder::tamanhoDoArray(Binding binding)
+{
+  int64_t tamanho = binding.isGlobal() ? tamanhosGlobais[binding.slot] : tamanhosLocais[binding.slot];
+  if (tamanho < 0)
+  {
+    erro("array sem declaracao conhecida");
+  }
+  return tamanho;
+}
+
+uint32_t IRBuilder::carregarElemento(ArrayAccessNode *access)
+{
+  uint32_t ops[2];
+  ops[1] = gerarExpressao(access->getIndex());
+  ops[0] = carregar(access->getBinding(), tipoDaVariavel(access->getBinding()));
+  int64_t limite = access->needsBoundsCheck() ? tamanhoDoArray(access->getBinding()) : -1;
+  return funcao->adicionar(blocoAtual, OpIR::LOAD_ELEM, access->getTipo(), ops, 2, limite);
+}
+
+// O valor já foi avaliado: em "a[i] = v", v vem antes do índice
+void IRBuilder::armazenarElemento(Binding binding, ExpressionNode *index, bool verificar, uint32_t valor)
+{
+  uint32_t ops[3];
+  ops[1] = gerarExpressao(index);
+  ops[0] = carregar(binding, tipoDaVariavel(binding));
+  ops[2] = valor;
+  int64_t limite = verificar ? tamanhoDoArray(binding) : -1;
+  funcao->adicionar(blocoAtual, OpIR::STORE_ELEM, TipoDeDado::VOID, ops, 3, limite);
+}
+
+// Termina o bloco atual com um salto, se ele ainda não foi terminado
+void IRBuilder::saltarPara(int destino)
+{
+  if (!funcao->isTerminado(blocoAtual))
+  {
+    funcao->adicionar(blocoAtual, OpIR::JUMP, TipoDeDado::VOID);
+    funcao->ligar(blocoAtual, destino);
+  }
+}
+
+void IRBuilder::gerarBloco(BlockNode *block)
+{
+  for (auto stmt : block->getStatements())
+  {
+    gerarStatement(stmt);
+  }
+}
+
+void IRBuilder::gerarStatement(StatementNode *stmt)
+{
+  if (auto decl = dynamic_cast<VariableDeclarationNode *>(stmt))
+  {
+    if (decl->isArray())
+    {
+      Binding binding = decl->getBinding();
+      (binding.isGlobal() ? tamanhosGlobais : tamanhosLocais)[binding.slot] = decl->getArraySize();
+      TipoDeDado tipo = tipoDeArray(tipoDeDadoDeString(decl->getType()));
+      armazenar(binding, funcao->adicionar(blocoAtual, OpIR::NEW_ARRAY, tipo, nullptr, 0, decl->getArraySize()));
+      return;
+    }
+    TipoDeDado tipo = tipoDeDadoDeString(decl->getType());
+    uint32_t valor = decl->getInitialValue() ? gerarExpressao(decl->getInitialValue()) : valorPadrao(tipo);
+    armazenar(decl->getBinding(), valor);
+  }
+  else if (auto assign = dynamic_cast<AssignmentNode *>(stmt))
+  {
+    uint32_t valor = gerarExpressao(assign->getValue());
+    if (assign->getIndex())
+    {
+      armazenarElemento(assign->getBinding(), assign->getIndex(), assign->needsBoundsCheck(), valor);
+    }
+    else
+    {
+      armazenar(assign->getBinding(), valor);
+    }
+  }
+  else if (auto block = dynamic_cast<BlockNode *>(stmt))
+  {
+    gerarBloco(block);
+  }
+  else if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+  {
+    uint32_t condicao = gerarExpressao(ifStmt->getCondition());
+    int blocoThen = funcao->criarBloco();
+    int blocoElse = ifStmt->getElseBlock() ? funcao->criarBloco() : -1;
+    int blocoFim = funcao->criarBloco();
+
+    funcao->adicionar(blocoAtual, OpIR::BRANCH, TipoDeDado::VOID, condicao);
+    funcao->ligar(blocoAtual, blocoThen);
+    funcao->ligar(blocoAtual, blocoElse >= 0 ? blocoElse : blocoFim);
+
+    blocoAtual = blocoThen;
+    gerarBloco(ifStmt->getThenBlock());
+    saltarPara(blocoFim);
+
+    if (blocoElse >= 0)
+    {
+      blocoAtual = blocoElse;
+      gerarBloco(ifStmt->getElseBlock());
+      saltarPara(blocoFim);
+    }
+    blocoAtual = blocoFim;
+  }
+  else if (auto whileStmt = dynamic_cast<WhileStatementNode *>(stmt))
+  {
+    // O bloco atual termina com um salto incondicional para o cabeçalho e
+    // serve de pré-cabeçalho do laço
+    int cabecalho = funcao->criarBloco();
+    int corpo = funcao->criarBloco();
+    int saida = funcao->criarBloco();
+    saltarPara(cabecalho);
+    if (stmt == lacoDeEntrada)
+    {
+      cabecalhoDeEntrada = cabecalho;
+    }
+
+    blocoAtual = cabecalho;
+    uint32_t condicao = gerarExpressao(whileStmt->getCondition());
+    funcao->adicionar(blocoAtual, OpIR::BRANCH, TipoDeDado::VOID, condicao);
+    funcao->ligar(blocoAtual, corpo);
+    funcao->ligar(blocoAtual, saida);
+
+    blocoAtual = corpo;
+    gerarBloco(whileStmt->getBody());
+    saltarPara(cabecalho);
+
+    blocoAtual = saida;
+  }
+  else if (auto forStmt = dynamic_cast<ForStatementNode *>(stmt))
+  {
+    if (forStmt->getInit())
+    {
+      gerarStatement(forStmt->getInit());
+    }
+    int cabecalho = funcao->criarBloco();
+    int corpo = funcao->criarBloco();
+    int atualizacao = funcao->criarBloco();
+    int saida = funcao->criarBloco();
+    saltarPara(cabecalho);
+    if (stmt == lacoDeEntrada)
+    {
+      cabecalhoDeEntrada = cabecalho;
+    }
+
+    blocoAtual = cabecalho;
+    if (forStmt->getCondition())
+    {
+      uint32_t condicao = gerarExpressao(forStmt->getCondition());
+      funcao->adicionar(blocoAtual, OpIR::BRANCH, TipoDeDado::VOID, condicao);
+      funcao->ligar(blocoAtual, corpo);
+      funcao->ligar(blocoAtual, saida);
+    }
+    else
+    {
+      saltarPara(corpo);
+    }
+
+    blocoAtual = corpo;
+    gerarBloco(forStmt->getBody());
+    saltarPara(atualizacao);
+
+    blocoAtual = atualizacao;
+    if (forStmt->getUpdate())
+    {
+      gerarExpressao(forStmt->getUpdate());
+    }
+    saltarPara(cabecalho);
+
+    blocoAtual = saida;
+  }
+  else if (auto ret = dynamic_cast<ReturnStatementNode *>(stmt))
+  {
+    if (ret->getValue())
+    {
+      funcao->adicionar(blocoAtual, OpIR::RETURN, TipoDeDado::VOID, gerarExpressao(ret->getValue()));
+    }
+    else
+    {
+      funcao->adicionar(blocoAtual, OpIR::RETURN, TipoDeDado::VOID);
+    }
+    // O código após o return é inalcançável e vai para um bloco sem predecessores
+    blocoAtual = funcao->criarBloco();
+  }
+  else if (auto exprStmt = dynamic_cast<ExpressionStatementNode *>(stmt))
+  {
+    gerarExpressao(exprStmt->getExpression());
+  }
+}
+
+uint32_t IRBuilder::gerarExpressao(ExpressionNode *expr)
+{
+  if (auto literal = dynamic_cast<IntLiteralNode *>(expr))
+  {
+    return funcao->constanteInteira(blocoAtual, literal->getValue());
+  }
+  if (auto literal = dynamic_cast<RealLiteralNode *>(expr))
+  {
+    return funcao->constanteReal(blocoAtual, literal->getValue());
+  }
+  if (auto literal = dynamic_cast<StringLiteralNode *>(expr))
+  {
+    funcao->strings.push_back(literal->getValue());
+    return funcao->adicionar(blocoAtual, OpIR::CONST_STRING, TipoDeDado::STRING, nullptr, 0, funcao->strings.size() - 1);
+  }
+  if (auto ident = dynamic_cast<IdentifierNode *>(expr))
+  {
+    return carregar(ident->getBinding(), ident->getTipo());
+  }
+  if (auto binary = dynamic_cast<BinaryOpNode *>(expr))
+  {
+    return gerarBinaria(binary);
+  }
+  if (auto unary = dynamic_cast<UnaryOpNode *>(expr))
+  {
+    if (unary->getOp() == "!")
+    {
+      return funcao->adicionar(blocoAtual, OpIR::NOT, TipoDeDado::INT, gerarExpressao(unary->getOperand()));
+    }
+    return gerarIncremento(unary);
+  }
+  if (auto conversion = dynamic_cast<ConversionNode *>(expr))
+  {
+    return funcao->adicionar(blocoAtual, OpIR::INT_TO_DOUBLE, TipoDeDado::DOUBLE, gerarExpressao(conversion->getOperand()));
+  }
+  if (auto call = dynamic_cast<FunctionCallNode *>(expr))
+  {
+    vector<uint32_t> args;
+    for (auto arg : call->getArgs())
+    {
+      args.push_back(gerarExpressao(arg));
+    }
+    if (call->isBuiltin())
+    {
+      return funcao->adicionar(blocoAtual, OpIR::CALL_BUILTIN, call->getTipo(), args.data(), args.size(), call->getBuiltinIndex());
+    }
+    return funcao->adicionar(blocoAtual, OpIR::CALL, call->getTipo(), args.data(), args.size(), call->getFunctionIndex());
+  }
+  if (auto access = dynamic_cast<ArrayAccessNode *>(expr))
+  {
+    return carregarElemento(access);
+  }
+  erro("expressao desconhecida");
+  return 0;
+}
+
+uint32_t IRBuilder::gerarBinaria(BinaryOpNode *binary)
+{
+  const string &op = binary->getOp();
+  if (op == "&&" || op == "||")
+  {
+    return gerarLogica(binary);
+  }
+  if (op == "=")
+  {
+    uint32_t valor = gerarExpressao(binary->getRight());
+    if (auto access = dynamic_cast<ArrayAccessNode *>(binary->getLeft()))
+    {
+      armazenarElemento(access->getBinding(), access->getIndex(), access->needsBoundsCheck(), valor);
+    }
+    else
+    {
+      armazenar(static_cast<IdentifierNode *>(binary->getLeft())->getBinding(), valor);
+    }
+    return valor;
+  }
+
+  uint32_t left = gerarExpressao(binary->getLeft());
+  uint32_t right = gerarExpressao(binary->getRight());
+  OpIR opIR;
+  if (op == "+")
+    opIR = OpIR::ADD;
+  else if (op == "-")
+    opIR = OpIR::SUB;
+  else if (op == "*")
+    opIR = OpIR::MUL;
+  else if (op == "/")
+    opIR = OpIR::DIV;
+  else if (op == "<")
+    opIR = OpIR::LT;
+  else if (op == ">")
+    opIR = OpIR::GT;
+  else if (op == "<=")
+    opIR = OpIR::LE;
+  else if (op == ">=")
+    opIR = OpIR::GE;
+  else if (op == "==")
+    opIR = OpIR::EQ;
+  else if (op == "!=")
+    opIR = OpIR::NE;
+  else
+  {
+    erro("operador desconhecido '" + op + "'");
+    return 0;
+  }
+  return funcao->adicionarBinaria(blocoAtual, opIR, binary->getTipo(), left, right);
+}
+
+// "a && b" e "a || b" avaliam b apenas quando necessário. O resultado passa
+// por um slot temporário, que a conversão para SSA transforma em um PHI.
+uint32_t IRBuilder::gerarLogica(BinaryOpNode *binary)
+{
+  bool isE = binary->getOp() == "&&";
+  int temporario = novoTemporario(TipoDeDado::INT);
+  Binding destino(1, temporario);
+
+  uint32_t left = gerarExpressao(binary->getLeft());
+  uint32_t zero = funcao->constanteInteira(blocoAtual, 0);
+  uint32_t curto = isE ? zero : funcao->adicionarBinaria(blocoAtual, OpIR::NE, TipoDeDado::INT, left, zero);
+  armazenar(destino, curto);
+
+  int blocoDireito = funcao->criarBloco();
+  int blocoFim = funcao->criarBloco();
+  funcao->adicionar(blocoAtual, OpIR::BRANCH, TipoDeDado::VOID, left);
+  funcao->ligar(blocoAtual, isE ? blocoDireito : blocoFim);
+  funcao->ligar(blocoAtual, isE ? blocoFim : blocoDireito);
+
+  blocoAtual = blocoDireito;
+  uint32_t right = gerarExpressao(binary->getRight());
+  uint32_t zeroDireito = funcao->constanteInteira(blocoAtual, 0);
+  armazenar(destino, funcao->adicionarBinaria(blocoAtual, OpIR::NE, TipoDeDado::INT, right, zeroDireito));
+  saltarPara(blocoFim);
+
+  blocoAtual = blocoFim;
+  return carregar(destino, TipoDeDado::INT);
+}
+
+uint32_t IRBuilder::gerarIncremento(UnaryOpNode *unary)
+{
+  auto ident = dynamic_cast<IdentifierNode *>(unary->getOperand());
+  if (!ident)
+  {
+    erro("incremento de array nao suportado");
+  }
+  TipoDeDado tipo = ident->getTipo();
+  uint32_t antigo = carregar(ident->getBinding(), tipo);
+  uint32_t um = tipo == TipoDeDado::DOUBLE ? funcao->constanteReal(blocoAtual, 1.0) : funcao->constanteInteira(blocoAtual, 1);
+  uint32_t novo = funcao->adicionarBinaria(blocoAtual, unary->getOp() == "++" ? OpIR::ADD : OpIR::SUB, tipo, antigo, um);
+  armazenar(ident->getBinding(), novo);
+  return unary->isPostfix() ? antigo : novo;
+}
@@ -0,0 +1,511 @@
+#include "Inliner.h"
+
+using namespace std;
+
+int tamanhoDaAst(ASTNode *node)
+{
+  if (!node)
+  {
+    return 0;
+  }
+  if (auto unary = dynamic_cast<UnaryOpNode *>(node))
+    return 1 + tamanhoDaAst(unary->getOperand());
+  if (auto binary = dynamic_cast<BinaryOpNode *>(node))
+    return 1 + tamanhoDaAst(binary->getLeft()) + tamanhoDaAst(binary->getRight());
+  if (auto conversion = dynamic_cast<ConversionNode *>(node))
+    return 1 + tamanhoDaAst(conversion->getOperand());
+  if (auto access = dynamic_cast<ArrayAccessNode *>(node))
+    return 1 + tamanhoDaAst(access->getIndex());
+  if (auto call = dynamic_cast<FunctionCallNode *>(node))
+  {
+    int total = 1;
+    for (auto arg : call->getArgs())
+      total += tamanhoDaAst(arg);
+    return total;
+  }
+  if (auto block = dynamic_cast<BlockNode *>(node))
+  {
+    int total = 1;
+    for (auto stmt : block->getStatements())
+      total += tamanhoDaAst(stmt);
+    return total;
+  }
+  if (auto decl = dynamic_cast<VariableDeclarationNode *>(node))
+    return 1 + tamanhoDaAst(decl->getInitialValue());
+  if (auto assign = dynamic_cast<AssignmentNode *>(node))
+    return 1 + tamanhoDaAst(assign->getValue()) + tamanhoDaAst(assign->getIndex());
+  if (auto ifStmt = dynamic_cast<IfStatementNode *>(node))
+    return 1 + tamanhoDaAst(ifStmt->getCondition()) + tamanhoDaAst(ifStmt->getThenBlock()) + tamanhoDaAst(ifStmt->getElseBlock());
+  if (auto whileStmt = dynamic_cast<WhileStatementNode *>(node))
+    return 1 + tamanhoDaAst(whileStmt->getCondition()) + tamanhoDaAst(whileStmt->getBody());
+  if (auto forStmt = dynamic_cast<ForStatementNode *>(node))
+    return 1 + tamanhoDaAst(forStmt->getInit()) + tamanhoDaAst(forStmt->getCondition()) +
+           tamanhoDaAst(forStmt->getUpdate()) + tamanhoDaAst(forStmt->getBody());
+  if (auto ret = dynamic_cast<ReturnStatementNode *>(node))
+    return 1 + tamanhoDaAst(ret->getValue());
+  if (auto exprStmt = dynamic_cast<ExpressionStatementNode *>(node))
+    return 1 + tamanhoDaAst(exprStmt->getExpression());
+  return 1; // literais e identificadores
+}
+
+static int contarReturns(ASTNode *node)
+{
+  if (dynamic_cast<ReturnStatementNode *>(node))
+    return 1;
+  if (auto block = dynamic_cast<BlockNode *>(node))
+  {
+    int total = 0;
+    for (auto stmt : block->getStatements())
+      total += contarReturns(stmt);
+    return total;
+  }
+  if (auto ifStmt = dynamic_cast<IfStatementNode *>(node))
+    return contarReturns(ifStmt->getThenBlock()) + (ifStmt->getElseBlock() ? contarReturns(ifStmt->getElseBlock()) : 0);
+  if (auto whileStmt = dynamic_cast<WhileStatementNode *>(node))
+    return contarReturns(whileStmt->getBody());
+  if (auto forStmt = dynamic_cast<ForStatementNode *>(node))
+    return contarReturns(forStmt->getBody());
+  return 0;
+}
+
+static bool contemChamada(ExpressionNode *expr)
+{
+  if (!expr)
+    return false;
+  if (dynamic_cast<FunctionCallNode *>(expr))
+    return true;
+  if (auto unary = dynamic_cast<UnaryOpNode *>(expr))
+    return contemChamada(unary->getOperand());
+  if (auto binary = dynamic_cast<BinaryOpNode *>(expr))
+    return contemChamada(binary->getLeft()) || contemChamada(binary->getRight());
+  if (auto conversion = dynamic_cast<ConversionNode *>(expr))
+    return contemChamada(conversion->getOperand());
+  if (auto access = dynamic_cast<ArrayAccessNode *>(expr))
+    return contemChamada(access->getIndex());
+  return false;
+}
+
+// Troca o nó alvo por novo dentro da expressão e retorna a nova raiz
+static ExpressionNode *substituir(ExpressionNode *expr, ExpressionNode *alvo, ExpressionNode *novo)
+{
+  if (expr == alvo)
+    return novo;
+  if (auto unary = dynamic_cast<UnaryOpNode *>(expr))
+    unary->setOperand(substituir(unary->getOperand(), alvo, novo));
+  else if (auto binary = dynamic_cast<BinaryOpNode *>(expr))
+  {
+    binary->setLeft(substituir(binary->getLeft(), alvo, novo));
+    binary->setRight(substituir(binary->getRight(), alvo, novo));
+  }
+  else if (auto conversion = dynamic_cast<ConversionNode *>(expr))
+    conversion->setOperand(substituir(conversion->getOperand(), alvo, novo));
+  else if (auto access = dynamic_cast<ArrayAccessNode *>(expr))
+    access->setIndex(substituir(access->getIndex(), alvo, novo));
+  else if (auto call = dynamic_cast<FunctionCallNode *>(expr))
+  {
+    for (size_t i = 0; i < call->getArgs().size(); i++)
+      call->setArg(i, substituir(call->getArgs()[i], alvo, novo));
+  }
+  return expr;
+}
+
+namespace
+{
+  // Procura, na ordem de avaliação, a primeira chamada de uma expressão.
+  // "valida" fica falso se algo avaliado antes dela não pode ser adiado
+  // para depois da chamada: leitura de global, efeito colateral ou a
+  // chamada só ser avaliada condicionalmente (lado direito de && / ||).
+  struct Busca
+  {
+    FunctionCallNode *chamada = nullptr;
+    bool valida = true;
+
+    void buscar(ExpressionNode *expr)
+    {
+      if (chamada || !valida || !expr)
+      {
+        return;
+      }
+      if (auto ident = dynamic_cast<IdentifierNode *>(expr))
+      {
+        valida = !ident->getBinding().isGlobal();
+      }
+      else if (auto access = dynamic_cast<ArrayAccessNode *>(expr))
+      {
+        buscar(access->getIndex());
+        if (!chamada)
+          valida = valida && !access->getBinding().isGlobal();
+      }
+      else if (auto conversion = dynamic_cast<ConversionNode *>(expr))
+      {
+        buscar(conversion->getOperand());
+      }
+      else if (auto unary = dynamic_cast<UnaryOpNode *>(expr))
+      {
+        buscar(unary->getOperand());
+        if (!chamada && unary->getOp() != "!")
+          valida = false;
+      }
+      else if (auto binary = dynamic_cast<BinaryOpNode *>(expr))
+      {
+        buscar(binary->getLeft());
+        if (chamada || !valida)
+          return;
+        if (binary->getOp() == "&&" || binary->getOp() == "||")
+        {
+          valida = !contemChamada(binary->getRight());
+          return;
+        }
+        buscar(binary->getRight());
+        if (!chamada && binary->getOp() == "=")
+          valida = false;
+      }
+      else if (auto call = dynamic_cast<FunctionCallNode *>(expr))
+      {
+        // Os argumentos são avaliados antes da chamada
+        for (auto arg : call->getArgs())
+        {
+          buscar(arg);
+        }
+        // Uma função embutida não é expandida e pode ter efeitos (print)
+        if (!chamada && valida && call->isBuiltin())
+          valida = false;
+        else if (!chamada && valida)
+          chamada = call;
+      }
+    }
+  };
+
+  ExpressionNode *expressaoDe(StatementNode *stmt)
+  {
+    if (auto decl = dynamic_cast<VariableDeclarationNode *>(stmt))
+      return decl->getInitialValue();
+    if (auto assign = dynamic_cast<AssignmentNode *>(stmt))
+      return assign->getValue();
+    if (auto exprStmt = dynamic_cast<ExpressionStatementNode *>(stmt))
+      return exprStmt->getExpression();
+    if (auto ret = dynamic_cast<ReturnStatementNode *>(stmt))
+      return ret->getValue();
+    if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+      return ifStmt->getCondition();
+    return nullptr;
+  }
+
+  void setExpressao(StatementNode *stmt, ExpressionNode *expr)
+  {
+    if (auto decl = dynamic_cast<VariableDeclarationNode *>(stmt))
+      decl->setInitialValue(expr);
+    else if (auto assign = dynamic_cast<AssignmentNode *>(stmt))
+      assign->setValue(expr);
+    else if (auto exprStmt = dynamic_cast<ExpressionStatementNode *>(stmt))
+      exprStmt->setExpression(expr);
+    else if (auto ret = dynamic_cast<ReturnStatementNode *>(stmt))
+      ret->setValue(expr);
+    else if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+      ifStmt->setCondition(expr);
+  }
+}
+
+Inliner::Inliner(int limiteDeTamanho)
+    : limiteDeTamanho(limiteDeTamanho), expansoes(0), programa(nullptr), chamador(nullptr)
+{
+}
+
+void Inliner::otimizar(ProgramNode *program)
+{
+  expansoes = 0;
+  programa = program;
+  grafo.construir(program);
+
+  // Dos chamados para os chamadores: cada função já foi expandida quando
+  // o seu corpo é copiado para os chamadores
+  for (const vector<int> &componente : grafo.getComponentes())
+  {
+    for (int f : componente)
+    {
+      chamador = program->getFunctions()[f];
+      if (!chamador->isGlobalWrapper())
+      {
+        expandirBloco(chamador->getBody(), 1, false);
+      }
+    }
+  }
+  chamador = nullptr;
+}
+
+bool Inliner::isExpansivel(int indice, bool emLaco)
+{
+  FunctionNode *callee = programa->getFunctions()[indice];
+  if (limiteDeTamanho <= 0 || callee == chamador || callee->isGlobalWrapper() || grafo.isRecursiva(indice))
+  {
+    return false;
+  }
+  int limite = emLaco ? 2 * limiteDeTamanho : limiteDeTamanho;
+  if (tamanhoDaAst(callee->getBody()) > limite)
+  {
+    return false;
+  }
+
+  // O único return permitido é o último statement do corpo
+  const vector<StatementNode *> &corpo = callee->getBody()->getStatements();
+  bool retornoFinal = !corpo.empty() && dynamic_cast<ReturnStatementNode *>(corpo.back());
+  return contarReturns(callee->getBody()) == (retornoFinal ? 1 : 0);
+}
+
+void Inliner::expandirBloco(BlockNode *block, int profundidade, bool emLaco)
+{
+  vector<StatementNode *> fila = block->getStatements();
+  vector<StatementNode *> saida;
+  size_t i = 0;
+  while (i < fila.size())
+  {
+    StatementNode *stmt = fila[i];
+    vector<StatementNode *> antes;
+    StatementNode *resultado = stmt;
+    if (expandirStatement(stmt, profundidade, emLaco, antes, resultado))
+    {
+      // Os statements inseridos também são processados (chamadas aninhadas)
+      if (resultado)
+      {
+        antes.push_back(resultado);
+      }
+      fila.erase(fila.begin() + i);
+      fila.insert(fila.begin() + i, antes.begin(), antes.end());
+      continue;
+    }
+
+    if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+    {
+      expandirBloco(ifStmt->getThenBlock(), profundidade + 1, emLaco);
+      if (ifStmt->getElseBlock())
+        expandirBloco(ifStmt->getElseBlock(), profundidade + 1, emLaco);
+    }
+    else if (auto whileStmt = dynamic_cast<WhileStatementNode *>(stmt))
+    {
+      expandirBloco(whileStmt->getBody(), profundidade + 1, true);
+    }
+    else if (auto forStmt = dynamic_cast<ForStatementNode *>(stmt))
+    {
+      // O for abre um escopo para a inicialização e outro para o corpo
+      expandirBloco(forStmt->getBody(), profundidade + 2, true);
+    }
+    else if (auto inner = dynamic_cast<BlockNode *>(stmt))
+    {
+      expandirBloco(inner, profundidade + 1, emLaco);
+    }
+    saida.push_back(stmt);
+    i++;
+  }
+  block->setStatements(saida);
+}
+
+bool Inliner::expandirStatement(StatementNode *stmt, int profundidade, bool emLaco, vector<StatementNode *> &antes, StatementNode *&resultado)
+{
+  ExpressionNode *raiz = expressaoDe(stmt);
+  Busca busca;
+  busca.buscar(raiz);
+  FunctionCallNode *call = busca.chamada;
+  if (!call || call->getFunctionIndex() < 0)
+  {
+    return false;
+  }
+  FunctionNode *callee = programa->getFunctions()[call->getFunctionIndex()];
+  TipoDeDado tipoRetorno = tipoDeDadoDeString(callee->getReturnType());
+  bool semValor = tipoRetorno == TipoDeDado::VOID;
+  if (!isExpansivel(call->getFunctionIndex(), emLaco) || (semValor && raiz != call))
+  {
+    return false;
+  }
+
+  // O quadro do chamador cresce com o quadro do chamado e o temporário do resultado
+  int base = chamador->getFrameSize();
+  Deslocamento d{base, profundidade - 1};
+  vector<TipoDeDado> tipos = chamador->getSlotTypes();
+  tipos.resize(base, TipoDeDado::INDEFINIDO);
+  const vector<TipoDeDado> &tiposChamado = callee->getSlotTypes();
+  tipos.insert(tipos.end(), tiposChamado.begin(), tiposChamado.end());
+  tipos.resize(base + callee->getFrameSize(), TipoDeDado::INDEFINIDO);
+  int temporario = tipos.size();
+  if (!semValor)
+  {
+    tipos.push_back(tipoRetorno);
+  }
+  chamador->setSlotTypes(tipos);
+  chamador->setFrameSize(tipos.size());
+
+  // Parâmetros: os argumentos (já convertidos pelo TypeChecker) passam a
+  // inicializar declarações, na mesma ordem de avaliação
+  const vector<ParameterNode *> &params = callee->getParams();
+  for (size_t i = 0; i < params.size(); i++)
+  {
+    auto decl = new VariableDeclarationNode(params[i]->getType(), params[i]->getName(), call->getArgs()[i]);
+    decl->setBinding(deslocar(params[i]->getBinding(), d));
+    call->setArg(i, nullptr);
+    antes.push_back(decl);
+  }
+
+  const vector<StatementNode *> &corpo = callee->getBody()->getStatements();
+  auto retornoFinal = corpo.empty() ? nullptr : dynamic_cast<ReturnStatementNode *>(corpo.back());
+  for (size_t i = 0; i < corpo.size(); i++)
+  {
+    if (corpo[i] != retornoFinal)
+    {
+      antes.push_back(clonar(corpo[i], d));
+    }
+  }
+
+  if (semValor)
+  {
+    // Chamada usada como statement: desaparece por completo
+    delete stmt;
+    resultado = nullptr;
+  }
+  else
+  {
+    // Sem return final, a função retorna o valor padrão do tipo
+    ExpressionNode *valor = retornoFinal && retornoFinal->getValue() ? clonar(retornoFinal->getValue(), d) : nullptr;
+    string nome = callee->getName() + "_ret";
+    auto decl = new VariableDeclarationNode(callee->getReturnType(), nome, valor);
+    decl->setBinding(Binding(profundidade, temporario));
+    antes.push_back(decl);
+
+    auto ident = new IdentifierNode(nome);
+    ident->setBinding(Binding(profundidade, temporario));
+    ident->setTipo(tipoRetorno);
+    setExpressao(stmt, substituir(raiz, call, ident));
+    delete call;
+    resultado = stmt;
+  }
+  expansoes++;
+  return true;
+}
+
+Binding Inliner::deslocar(Binding binding, Deslocamento d)
+{
+  if (!binding.isResolved() || binding.isGlobal())
+  {
+    return binding;
+  }
+  return Binding(binding.depth + d.profundidade, binding.slot + d.slot);
+}
+
+ExpressionNode *Inliner::clonar(ExpressionNode *expr, Deslocamento d)
+{
+  if (!expr)
+  {
+    return nullptr;
+  }
+  ExpressionNode *copia = nullptr;
+  if (auto literal = dynamic_cast<IntLiteralNode *>(expr))
+  {
+    copia = new IntLiteralNode(literal->getValue());
+  }
+  else if (auto literal = dynamic_cast<RealLiteralNode *>(expr))
+  {
+    copia = new RealLiteralNode(literal->getValue());
+  }
+  else if (auto literal = dynamic_cast<StringLiteralNode *>(expr))
+  {
+    copia = new StringLiteralNode(literal->getValue());
+  }
+  else if (auto ident = dynamic_cast<IdentifierNode *>(expr))
+  {
+    auto novo = new IdentifierNode(ident->getName());
+    novo->setBinding(deslocar(ident->getBinding(), d));
+    copia = novo;
+  }
+  else if (auto access = dynamic_cast<ArrayAccessNode *>(expr))
+  {
+    auto novo = new ArrayAccessNode(access->getName(), clonar(access->getIndex(), d));
+    novo->setBinding(deslocar(access->getBinding(), d));
+    copia = novo;
+  }
+  else if (auto unary = dynamic_cast<UnaryOpNode *>(expr))
+  {
+    copia = new UnaryOpNode(unary->getOp(), clonar(unary->getOperand(), d), unary->isPostfix());
+  }
+  else if (auto binary = dynamic_cast<BinaryOpNode *>(expr))
+  {
+    copia = new BinaryOpNode(clonar(binary->getLeft(), d), binary->getOp(), clonar(binary->getRight(), d));
+  }
+  else if (auto conversion = dynamic_cast<ConversionNode *>(expr))
+  {
+    copia = new ConversionNode(clonar(conversion->getOperand(), d), conversion->getTipo());
+  }
+  else if (auto call = dynamic_cast<FunctionCallNode *>(expr))
+  {
+    vector<ExpressionNode *> args;
+    for (auto arg : call->getArgs())
+    {
+      args.push_back(clonar(arg, d));
+    }
+    auto novo = new FunctionCallNode(call->getName(), args);
+    novo->setFunctionIndex(call->getFunctionIndex());
+    novo->setBuiltinIndex(call->getBuiltinIndex());
+    copia = novo;
+  }
+  copia->setTipo(expr->getTipo());
+  return copia;
+}
+
+BlockNode *Inliner::clonar(BlockNode *block, Deslocamento d)
+{
+  if (!block)
+  {
+    return nullptr;
+  }
+  vector<StatementNode *> statements;
+  for (auto stmt : block->getStatements())
+  {
+    statements.push_back(clonar(stmt, d));
+  }
+  return new BlockNode(statements);
+}
+
+StatementNode *Inliner::clonar(StatementNode *stmt, Deslocamento d)
+{
+  if (!stmt)
+  {
+    return nullptr;
+  }
+  if (auto decl = dynamic_cast<VariableDeclarationNode *>(stmt))
+  {
+    auto novo = new VariableDeclarationNode(decl->getType(), decl->getName(), clonar(decl->getInitialValue(), d),
+                                            decl->getArraySize());
+    novo->setBinding(deslocar(decl->getBinding(), d));
+    return novo;
+  }
+  if (auto assign = dynamic_cast<AssignmentNode *>(stmt))
+  {
+    auto novo = new AssignmentNode(assign->getName(), clonar(assign->getValue(), d), clonar(assign->getIndex(), d));
+    novo->setBinding(deslocar(assign->getBinding(), d));
+    return novo;
+  }
+  if (auto exprStmt = dynamic_cast<ExpressionStatementNode *>(stmt))
+  {
+    return new ExpressionStatementNode(clonar(exprStmt->getExpression(), d));
+  }
+  if (auto ret = dynamic_cast<ReturnStatementNode *>(stmt))
+  {
+    return new ReturnStatementNode(clonar(ret->getValue(), d));
+  }
+  if (auto block = dynamic_cast<BlockNode *>(stmt))
+  {
+    return clonar(block, d);
+  }
+  if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+  {
+    return new IfStatementNode(clonar(ifStmt->getCondition(), d), clonar(ifStmt->getThenBlock(), d),
+                               clonar(ifStmt->getElseBlock(), d));
+  }
+  if (auto whileStmt = dynamic_cast<WhileStatementNode *>(stmt))
+  {
+    return new WhileStatementNode(clonar(whileStmt->getCondition(), d), clonar(whileStmt->getBody(), d));
+  }
+  if (auto forStmt = dynamic_cast<ForStatementNode *>(stmt))
+  {
+    return new ForStatementNode(clonar(forStmt->getInit(), d), clonar(forStmt->getCondition(), d),
+                                clonar(forStmt->getUpdate(), d), clonar(forStmt->getBody(), d));
+  }
+  return nullptr;
+}
@@ -0,0 +1,467 @@
+#include "Interpreter.h"
+#include "Builtins.h"
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+  // Conversão para a convenção do código nativo: palavras de 64 bits com o
+  // inteiro, os bits do double ou, para um array (só na troca de camada no
+  // meio de um laço), o endereço dos elementos, que o código nativo altera
+  // no lugar
+  uint64_t paraNativo(const Valor &valor)
+  {
+    if (isArray(valor.tipo))
+    {
+      return uint64_t(reinterpret_cast<uintptr_t>(valor.elementos()));
+    }
+    return valor.tipo == TipoDeDado::DOUBLE ? bitsDeReal(valor.real) : uint64_t(valor.inteiro);
+  }
+
+  Valor deNativo(uint64_t bits, TipoDeDado tipo)
+  {
+    if (tipo == TipoDeDado::DOUBLE)
+    {
+      return Valor::deReal(realDeBits(bits));
+    }
+    if (tipo == TipoDeDado::VOID)
+    {
+      return Valor();
+    }
+    return Valor::deInteiro(int64_t(bits));
+  }
+
+  // Aritmética inteira com volta no estouro, como no ConstantFolder
+  int64_t aritmeticaInteira(const string &op, int64_t a, int64_t b)
+  {
+    uint64_t ua = uint64_t(a), ub = uint64_t(b);
+    if (op == "+")
+      return int64_t(ua + ub);
+    if (op == "-")
+      return int64_t(ua - ub);
+    if (op == "*")
+      return int64_t(ua * ub);
+    if (b == 0)
+    {
+      throw runtime_error("Erro de execucao: divisao por zero");
+    }
+    return b == -1 ? int64_t(0 - ua) : a / b;
+  }
+
+  template <typename T>
+  int64_t comparar(const string &op, const T &a, const T &b)
+  {
+    if (op == "<")
+      return a < b;
+    if (op == ">")
+      return a > b;
+    if (op == "<=")
+      return a <= b;
+    if (op == ">=")
+      return a >= b;
+    if (op == "==")
+      return a == b;
+    return a != b;
+  }
+}
+
+Interpreter::Interpreter(ProgramNode *program, bool usarJit)
+    : programa(program), jit(program), usarJit(usarJit), limiteDeChamadas(100), limiteDeIteracoes(1000),
+      quadro(nullptr), funcaoAtual(-1), perfis(program->getFunctions().size()),
+      chamadasInterpretadas(0), chamadasNativas(0), promocoes(0), entradasDeLaco(0), iteracoesInterpretadas(0)
+{
+  for (TipoDeDado tipo : program->getGlobalTypes())
+  {
+    globais.push_back(Valor::padrao(tipo));
+  }
+  globais.resize(program->getGlobalCount());
+}
+
+void Interpreter::setLimites(int chamadas, int iteracoes)
+{
+  limiteDeChamadas = chamadas;
+  limiteDeIteracoes = iteracoes;
+}
+
+Valor Interpreter::executar()
+{
+  const vector<FunctionNode *> &functions = programa->getFunctions();
+  int principal = -1;
+  for (size_t i = 0; i < functions.size(); i++)
+  {
+    if (functions[i]->isGlobalWrapper())
+    {
+      chamar(i, vector<Valor>());
+    }
+    else if (functions[i]->getName() == "main" && functions[i]->getParams().empty())
+    {
+      principal = i;
+    }
+  }
+  return principal >= 0 ? chamar(principal, vector<Valor>()) : Valor();
+}
+
+Valor Interpreter::chamar(int indice, const vector<Valor> &argumentos)
+{
+  if (usarJit)
+  {
+    PerfilDeFuncao &perfil = perfis[indice];
+    if (!jit.isCompilada(indice) && !perfil.tentouCompilar && ++perfil.chamadas >= limiteDeChamadas)
+    {
+      perfil.tentouCompilar = true;
+      if (jit.compilar(indice))
+      {
+        promocoes++;
+      }
+    }
+    if (jit.isCompilada(indice))
+    {
+      return chamarNativa(indice, argumentos);
+    }
+  }
+  return interpretar(indice, argumentos);
+}
+
+Valor Interpreter::chamarNativa(int indice, const vector<Valor> &argumentos)
+{
+  vector<uint64_t> palavras;
+  for (const Valor &argumento : argumentos)
+  {
+    palavras.push_back(paraNativo(argumento));
+  }
+  chamadasNativas++;
+  uint64_t resultado = jit.chamar(indice, palavras.data());
+  return deNativo(resultado, tipoDeDadoDeString(programa->getFunctions()[indice]->getReturnType()));
+}
+
+Valor Interpreter::interpretar(int indice, const vector<Valor> &argumentos)
+{
+  FunctionNode *function = programa->getFunctions()[indice];
+  vector<Valor> slots;
+  for (TipoDeDado tipo : function->getSlotTypes())
+  {
+    slots.push_back(Valor::padrao(tipo));
+  }
+  slots.resize(function->getFrameSize());
+  const vector<ParameterNode *> &params = function->getParams();
+  for (size_t i = 0; i < params.size(); i++)
+  {
+    slots[params[i]->getBinding().slot] = argumentos[i];
+  }
+
+  vector<Valor> *quadroAnterior = quadro;
+  int funcaoAnterior = funcaoAtual;
+  quadro = &slots;
+  funcaoAtual = indice;
+  chamadasInterpretadas++;
+  Valor resultado;
+  try
+  {
+    if (executarBloco(function->getBody()) == Fluxo::RETORNO)
+    {
+      resultado = retorno;
+    }
+    else
+    {
+      // Retorno implícito no fim da função
+      TipoDeDado tipoRetorno = tipoDeDadoDeString(function->getReturnType());
+      resultado = tipoRetorno == TipoDeDado::VOID ? Valor() : Valor::padrao(tipoRetorno);
+    }
+  }
+  catch (exception &)
+  {
+    quadro = quadroAnterior;
+    funcaoAtual = funcaoAnterior;
+    throw;
+  }
+  quadro = quadroAnterior;
+  funcaoAtual = funcaoAnterior;
+  return resultado;
+}
+
+// Chamado a cada iteração completa de um laço, antes do novo teste da
+// condição (o ponto que corresponde ao cabeçalho do laço na IR). Retorna
+// true se a função terminou no código nativo, com o valor em "retorno".
+bool Interpreter::trocarDeCamada(StatementNode *laco, PerfilDeLaco &perfil)
+{
+  iteracoesInterpretadas++;
+  if (!usarJit || perfil.falhou || ++perfil.iteracoes < limiteDeIteracoes)
+  {
+    return false;
+  }
+  if (perfil.entrada < 0)
+  {
+    string motivo;
+    perfil.entrada = jit.compilarEntradaDeLaco(funcaoAtual, laco, motivo);
+    if (perfil.entrada < 0)
+    {
+      perfil.falhou = true;
+      return false;
+    }
+  }
+  vector<uint64_t> palavras;
+  for (const Valor &valor : *quadro)
+  {
+    palavras.push_back(paraNativo(valor));
+  }
+  entradasDeLaco++;
+  uint64_t resultado = jit.chamarEntradaDeLaco(perfil.entrada, palavras.data());
+  retorno = deNativo(resultado, tipoDeDadoDeString(programa->getFunctions()[funcaoAtual]->getReturnType()));
+  return true;
+}
+
+Interpreter::Fluxo Interpreter::executarBloco(BlockNode *block)
+{
+  for (auto stmt : block->getStatements())
+  {
+    if (executarStatement(stmt) == Fluxo::RETORNO)
+    {
+      return Fluxo::RETORNO;
+    }
+  }
+  return Fluxo::NORMAL;
+}
+
+Interpreter::Fluxo Interpreter::executarStatement(StatementNode *stmt)
+{
+  if (auto decl = dynamic_cast<VariableDeclarationNode *>(stmt))
+  {
+    TipoDeDado tipo = tipoDeDadoDeString(decl->getType());
+    if (decl->isArray())
+    {
+      // Cada execução da declaração cria um array novo, zerado
+      variavel(decl->getBinding()) = Valor::novoArray(tipoDeArray(tipo), decl->getArraySize());
+    }
+    else
+    {
+      variavel(decl->getBinding()) = decl->getInitialValue() ? avaliar(decl->getInitialValue()) : Valor::padrao(tipo);
+    }
+  }
+  else if (auto assign = dynamic_cast<AssignmentNode *>(stmt))
+  {
+    Valor valor = avaliar(assign->getValue());
+    if (assign->getIndex())
+    {
+      atribuirElemento(assign->getBinding(), assign->getIndex(), assign->needsBoundsCheck(), valor);
+    }
+    else
+    {
+      variavel(assign->getBinding()) = valor;
+    }
+  }
+  else if (auto block = dynamic_cast<BlockNode *>(stmt))
+  {
+    return executarBloco(block);
+  }
+  else if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+  {
+    if (avaliar(ifStmt->getCondition()).inteiro)
+    {
+      return executarBloco(ifStmt->getThenBlock());
+    }
+    if (ifStmt->getElseBlock())
+    {
+      return executarBloco(ifStmt->getElseBlock());
+    }
+  }
+  else if (auto whileStmt = dynamic_cast<WhileStatementNode *>(stmt))
+  {
+    PerfilDeLaco &perfil = lacos[stmt];
+    perfil.iteracoes = 0;
+    while (avaliar(whileStmt->getCondition()).inteiro)
+    {
+      if (executarBloco(whileStmt->getBody()) == Fluxo::RETORNO || trocarDeCamada(stmt, perfil))
+      {
+        return Fluxo::RETORNO;
+      }
+    }
+  }
+  else if (auto forStmt = dynamic_cast<ForStatementNode *>(stmt))
+  {
+    if (forStmt->getInit())
+    {
+      executarStatement(forStmt->getInit());
+    }
+    PerfilDeLaco &perfil = lacos[stmt];
+    perfil.iteracoes = 0;
+    while (!forStmt->getCondition() || avaliar(forStmt->getCondition()).inteiro)
+    {
+      if (executarBloco(forStmt->getBody()) == Fluxo::RETORNO)
+      {
+        return Fluxo::RETORNO;
+      }
+      if (forStmt->getUpdate())
+      {
+        avaliar(forStmt->getUpdate());
+      }
+      if (trocarDeCamada(stmt, perfil))
+      {
+        return Fluxo::RETORNO;
+      }
+    }
+  }
+  else if (auto ret = dynamic_cast<ReturnStatementNode *>(stmt))
+  {
+    retorno = ret->getValue() ? avaliar(ret->getValue()) : Valor();
+    return Fluxo::RETORNO;
+  }
+  else if (auto exprStmt = dynamic_cast<ExpressionStatementNode *>(stmt))
+  {
+    avaliar(exprStmt->getExpression());
+  }
+  return Fluxo::NORMAL;
+}
+
+Valor &Interpreter::variavel(Binding binding)
+{
+  return binding.isGlobal() ? globais[binding.slot] : (*quadro)[binding.slot];
+}
+
+Valor Interpreter::avaliar(ExpressionNode *expr)
+{
+  if (auto literal = dynamic_cast<IntLiteralNode *>(expr))
+  {
+    return Valor::deInteiro(literal->getValue());
+  }
+  if (auto literal = dynamic_cast<RealLiteralNode *>(expr))
+  {
+    return Valor::deReal(literal->getValue());
+  }
+  if (auto literal = dynamic_cast<StringLiteralNode *>(expr))
+  {
+    return literais.internar(literal->getValue());
+  }
+  if (auto ident = dynamic_cast<IdentifierNode *>(expr))
+  {
+    return variavel(ident->getBinding());
+  }
+  if (auto binary = dynamic_cast<BinaryOpNode *>(expr))
+  {
+    return avaliarBinaria(binary);
+  }
+  if (auto unary = dynamic_cast<UnaryOpNode *>(expr))
+  {
+    if (unary->getOp() == "!")
+    {
+      return Valor::deInteiro(!avaliar(unary->getOperand()).inteiro);
+    }
+    auto ident = dynamic_cast<IdentifierNode *>(unary->getOperand());
+    if (!ident)
+    {
+      throw runtime_error("Erro de execucao: incremento de elemento de array nao suportado");
+    }
+    Valor &alvo = variavel(ident->getBinding());
+    Valor antigo = alvo;
+    int delta = unary->getOp() == "++" ? 1 : -1;
+    if (alvo.tipo == TipoDeDado::DOUBLE)
+      alvo.real += delta;
+    else
+      alvo.inteiro = int64_t(uint64_t(alvo.inteiro) + uint64_t(int64_t(delta)));
+    return unary->isPostfix() ? antigo : alvo;
+  }
+  if (auto conversion = dynamic_cast<ConversionNode *>(expr))
+  {
+    return Valor::deReal(double(avaliar(conversion->getOperand()).inteiro));
+  }
+  if (auto call = dynamic_cast<FunctionCallNode *>(expr))
+  {
+    if (call->isBuiltin())
+    {
+      // Versão já escolhida pelo TypeChecker: argumentos num vetor local
+      // e chamada direta pelo ponteiro
+      Valor argumentos[MAX_PARAMETROS_BUILTIN];
+      const vector<ExpressionNode *> &args = call->getArgs();
+      for (size_t i = 0; i < args.size(); i++)
+      {
+        argumentos[i] = avaliar(args[i]);
+      }
+      return BUILTINS[call->getBuiltinIndex()].implementacao(argumentos);
+    }
+    vector<Valor> argumentos;
+    for (auto arg : call->getArgs())
+    {
+      argumentos.push_back(avaliar(arg));
+    }
+    return chamar(call->getFunctionIndex(), argumentos);
+  }
+  if (auto access = dynamic_cast<ArrayAccessNode *>(expr))
+  {
+    int64_t indice = avaliar(access->getIndex()).inteiro;
+    const Valor &array = variavel(access->getBinding());
+    if (access->needsBoundsCheck())
+    {
+      array.verificarIndice(indice);
+    }
+    return array.elemento(indice);
+  }
+  throw runtime_error("Erro de execucao: expressao desconhecida");
+}
+
+void Interpreter::atribuirElemento(Binding binding, ExpressionNode *index, bool verificar, const Valor &valor)
+{
+  int64_t indice = avaliar(index).inteiro;
+  Valor &array = variavel(binding);
+  if (verificar)
+  {
+    array.verificarIndice(indice);
+  }
+  array.atribuirElemento(indice, valor);
+}
+
+Valor Interpreter::avaliarBinaria(BinaryOpNode *binary)
+{
+  const string &op = binary->getOp();
+  if (op == "&&")
+  {
+    return Valor::deInteiro(avaliar(binary->getLeft()).inteiro && avaliar(binary->getRight()).inteiro);
+  }
+  if (op == "||")
+  {
+    return Valor::deInteiro(avaliar(binary->getLeft()).inteiro || avaliar(binary->getRight()).inteiro);
+  }
+  if (op == "=")
+  {
+    // O valor é avaliado antes do índice, como na VM
+    Valor valor = avaliar(binary->getRight());
+    if (auto access = dynamic_cast<ArrayAccessNode *>(binary->getLeft()))
+    {
+      atribuirElemento(access->getBinding(), access->getIndex(), access->needsBoundsCheck(), valor);
+    }
+    else
+    {
+      variavel(static_cast<IdentifierNode *>(binary->getLeft())->getBinding()) = valor;
+    }
+    return valor;
+  }
+
+  Valor a = avaliar(binary->getLeft());
+  Valor b = avaliar(binary->getRight());
+  bool aritmetico = op == "+" || op == "-" || op == "*" || op == "/";
+  if (a.tipo == TipoDeDado::STRING)
+  {
+    if (!aritmetico)
+    {
+      return Valor::deInteiro(comparar(op, a.compararTexto(b), 0));
+    }
+    a.concatenar(b);
+    return a;
+  }
+  if (a.tipo == TipoDeDado::DOUBLE)
+  {
+    if (!aritmetico)
+      return Valor::deInteiro(comparar(op, a.real, b.real));
+    if (op == "+")
+      return Valor::deReal(a.real + b.real);
+    if (op == "-")
+      return Valor::deReal(a.real - b.real);
+    if (op == "*")
+      return Valor::deReal(a.real * b.real);
+    return Valor::deReal(a.real / b.real);
+  }
+  if (!aritmetico)
+  {
+    return Valor::deInteiro(comparar(op, a.inteiro, b.inteiro));
+  }
+  return Valor::deInteiro(aritmeticaInteira(op, a.inteiro, b.inteiro));
+}
@@ -0,0 +1,1426 @@
+#include "Jit.h"
+#include "Builtins.h"
+#include "DeadCodeEliminator.h"
+#include "GVN.h"
+#include "IRBuilder.h"
+#include "LoopOptimizer.h"
+#include "RegisterAllocator.h"
+#include <csetjmp>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+#define JIT_X86_64 1
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+
+uint64_t bitsDeReal(double valor)
+{
+  uint64_t bits;
+  memcpy(&bits, &valor, sizeof(bits));
+  return bits;
+}
+
+double realDeBits(uint64_t bits)
+{
+  double valor;
+  memcpy(&valor, &bits, sizeof(valor));
+  return valor;
+}
+
+namespace
+{
+  // Destino do longjmp dos erros de execução, armado por Jit::chamar, e a
+  // mensagem do erro
+  thread_local jmp_buf *retornoDeErro = nullptr;
+  thread_local string mensagemDeErro;
+
+  // Palavras de 64 bits que os arrays de uma função podem ocupar na pilha
+  const int64_t LIMITE_DE_ELEMENTOS = 1 << 16;
+
+  // Chamadas pelo código nativo (nunca retornam)
+  void erroDeDivisaoPorZero()
+  {
+    mensagemDeErro = "Erro de execucao: divisao por zero";
+    longjmp(*retornoDeErro, 1);
+  }
+
+  void erroDeIndice(int64_t indice, int64_t tamanho)
+  {
+    mensagemDeErro = "Erro de execucao: indice " + to_string(indice) + " fora dos limites do array de tamanho " +
+                     to_string(tamanho);
+    longjmp(*retornoDeErro, 1);
+  }
+
+  enum Registrador
+  {
+    RAX = 0,
+    RCX = 1,
+    RDX = 2,
+    RSP = 4,
+    RBP = 5,
+    RSI = 6,
+    RDI = 7
+  };
+  const int XMM_TEMP_A = 14;
+  const int XMM_TEMP_B = 15;
+
+  // Códigos de condição (segundo nibble de jcc/setcc)
+  enum Condicao
+  {
+    CC_B = 0x2,
+    CC_AE = 0x3,
+    CC_E = 0x4,
+    CC_NE = 0x5,
+    CC_BE = 0x6,
+    CC_A = 0x7,
+    CC_P = 0xA,
+    CC_NP = 0xB,
+    CC_L = 0xC,
+    CC_GE = 0xD,
+    CC_LE = 0xE,
+    CC_G = 0xF
+  };
+
+  // Codificador das poucas instruções x86-64 que o gerador usa. Operandos
+  // de memória são [base + deslocamento de 32 bits] ou, para elementos de
+  // arrays, [base + índice * 8].
+  class Montador
+  {
+  public:
+    vector<uint8_t> codigo;
+
+    size_t posicao() const { return codigo.size(); }
+    void byte(uint8_t b) { codigo.push_back(b); }
+    void dword(uint32_t v)
+    {
+      for (int i = 0; i < 4; i++)
+        byte(v >> (8 * i));
+    }
+    void qword(uint64_t v)
+    {
+      for (int i = 0; i < 8; i++)
+        byte(v >> (8 * i));
+    }
+    // Corrige um deslocamento relativo de 32 bits para apontar para destino
+    void ajustar(size_t rel32, size_t destino)
+    {
+      uint32_t v = uint32_t(int32_t(destino - (rel32 + 4)));
+      memcpy(&codigo[rel32], &v, 4);
+    }
+
+    void rex(bool w, int reg, int rm)
+    {
+      uint8_t r = 0x40 | (w << 3) | (((reg >> 3) & 1) << 2) | ((rm >> 3) & 1);
+      if (r != 0x40)
+        byte(r);
+    }
+    void modrm(int reg, int rm) { byte(0xC0 | ((reg & 7) << 3) | (rm & 7)); }
+    void memoria(int reg, int base, int32_t deslocamento)
+    {
+      byte(0x80 | ((reg & 7) << 3) | (base & 7));
+      if ((base & 7) == RSP)
+        byte(0x24); // SIB: base sem índice
+      dword(deslocamento);
+    }
+
+    // Inteiros (64 bits)
+    void alu(uint8_t op, int destino, int origem) // add 01, sub 29, cmp 39, test 85, mov 89
+    {
+      rex(true, origem, destino);
+      byte(op);
+      modrm(origem, destino);
+    }
+    void mov(int destino, int origem)
+    {
+      if (destino != origem)
+        alu(0x89, destino, origem);
+    }
+    void carregar(int destino, int base, int32_t deslocamento)
+    {
+      rex(true, destino, base);
+      byte(0x8B);
+      memoria(destino, base, deslocamento);
+    }
+    void guardar(int base, int32_t deslocamento, int origem)
+    {
+      rex(true, origem, base);
+      byte(0x89);
+      memoria(origem, base, deslocamento);
+    }
+    void lea(int destino, int base, int32_t deslocamento)
+    {
+      rex(true, destino, base);
+      byte(0x8D);
+      memoria(destino, base, deslocamento);
+    }
+    // [base + índice * 8]
+    void rexElemento(bool w, int reg, int base, int indice)
+    {
+      uint8_t r = 0x40 | (w << 3) | (((reg >> 3) & 1) << 2) | (((indice >> 3) & 1) << 1) | ((base >> 3) & 1);
+      if (r != 0x40)
+        byte(r);
+    }
+    void elemento(int reg, int base, int indice)
+    {
+      // Com base rbp ou r13 o modo sem deslocamento não existe: usa um de 8 bits
+      bool deslocamento = (base & 7) == RBP;
+      byte((deslocamento ? 0x44 : 0x04) | ((reg & 7) << 3));
+      byte(0xC0 | ((indice & 7) << 3) | (base & 7));
+      if (deslocamento)
+        byte(0);
+    }
+    void carregarElemento(int destino, int base, int indice)
+    {
+      rexElemento(true, destino, base, indice);
+      byte(0x8B);
+      elemento(destino, base, indice);
+    }
+    void guardarElemento(int base, int indice, int origem)
+    {
+      rexElemento(true, origem, base, indice);
+      byte(0x89);
+      elemento(origem, base, indice);
+    }
+    // Não altera as flags só quando o valor não é zero
+    void imediato(int destino, int64_t valor)
+    {
+      if (valor == 0)
+      {
+        rex(false, destino, destino);
+        byte(0x31); // xor r32, r32 zera os 64 bits
+        modrm(destino, destino);
+      }
+      else if (valor >= INT32_MIN && valor <= INT32_MAX)
+      {
+        rex(true, 0, destino);
+        byte(0xC7);
+        modrm(0, destino);
+        dword(uint32_t(valor));
+      }
+      else
+      {
+        rex(true, 0, destino);
+        byte(0xB8 + (destino & 7));
+        qword(uint64_t(valor));
+      }
+    }
+    void imul(int destino, int origem)
+    {
+      rex(true, destino, origem);
+      byte(0x0F);
+      byte(0xAF);
+      modrm(destino, origem);
+    }
+    void grupoF7(int extensao, int r) // neg /3, idiv /7
+    {
+      rex(true, 0, r);
+      byte(0xF7);
+      modrm(extensao, r);
+    }
+    void cmpImediato8(int r, int8_t valor)
+    {
+      rex(true, 0, r);
+      byte(0x83);
+      modrm(7, r);
+      byte(uint8_t(valor));
+    }
+    void cmpImediato32(int r, int32_t valor)
+    {
+      rex(true, 0, r);
+      byte(0x81);
+      modrm(7, r);
+      dword(uint32_t(valor));
+    }
+    void cqo()
+    {
+      byte(0x48);
+      byte(0x99);
+    }
+    void setcc(int cc, int r8) // r8: al ou cl
+    {
+      byte(0x0F);
+      byte(0x90 | cc);
+      modrm(0, r8);
+    }
+    void movzxEaxAl()
+    {
+      byte(0x0F);
+      byte(0xB6);
+      byte(0xC0);
+    }
+    size_t jcc(int cc)
+    {
+      byte(0x0F);
+      byte(0x80 | cc);
+      dword(0);
+      return posicao() - 4;
+    }
+    size_t jmp()
+    {
+      byte(0xE9);
+      dword(0);
+      return posicao() - 4;
+    }
+    void push(int r)
+    {
+      if (r >= 8)
+        byte(0x41);
+      byte(0x50 + (r & 7));
+    }
+    void pop(int r)
+    {
+      if (r >= 8)
+        byte(0x41);
+      byte(0x58 + (r & 7));
+    }
+
+    // SSE2 (double)
+    void sse(uint8_t prefixo, uint8_t op, int xmm, int rm)
+    {
+      byte(prefixo);
+      rex(false, xmm, rm);
+      byte(0x0F);
+      byte(op);
+      modrm(xmm, rm);
+    }
+    void sseMemoria(uint8_t prefixo, uint8_t op, int xmm, int base, int32_t deslocamento)
+    {
+      byte(prefixo);
+      rex(false, xmm, base);
+      byte(0x0F);
+      byte(op);
+      memoria(xmm, base, deslocamento);
+    }
+    void movsd(int destino, int origem)
+    {
+      if (destino != origem)
+        sse(0xF2, 0x10, destino, origem);
+    }
+    void carregarReal(int destino, int base, int32_t deslocamento) { sseMemoria(0xF2, 0x10, destino, base, deslocamento); }
+    void guardarReal(int base, int32_t deslocamento, int origem) { sseMemoria(0xF2, 0x11, origem, base, deslocamento); }
+    void sseElemento(uint8_t op, int xmm, int base, int indice)
+    {
+      byte(0xF2);
+      rexElemento(false, xmm, base, indice);
+      byte(0x0F);
+      byte(op);
+      elemento(xmm, base, indice);
+    }
+    void carregarElementoReal(int destino, int base, int indice) { sseElemento(0x10, destino, base, indice); }
+    void guardarElementoReal(int base, int indice, int origem) { sseElemento(0x11, origem, base, indice); }
+    void movqDeInteiro(int xmm, int r) // movq xmm, r64
+    {
+      byte(0x66);
+      rex(true, xmm, r);
+      byte(0x0F);
+      byte(0x6E);
+      modrm(xmm, r);
+    }
+    void movqParaInteiro(int r, int xmm) // movq r64, xmm
+    {
+      byte(0x66);
+      rex(true, xmm, r);
+      byte(0x0F);
+      byte(0x7E);
+      modrm(xmm, r);
+    }
+    void cvtsi2sd(int xmm, int r)
+    {
+      byte(0xF2);
+      rex(true, xmm, r);
+      byte(0x0F);
+      byte(0x2A);
+      modrm(xmm, r);
+    }
+  };
+
+  // Onde um valor vive durante toda a função
+  struct Local
+  {
+    enum Tipo
+    {
+      REGISTRADOR,
+      XMM,
+      PILHA
+    } tipo;
+    int numero;
+    bool operator==(const Local &outro) const { return tipo == outro.tipo && numero == outro.numero; }
+  };
+
+  // Cópia de um PHI; a instrução vem da classe dos locais, já que slots
+  // da pilha e temporários podem receber valores int e double
+  struct Copia
+  {
+    Local destino;
+    Local origem;
+  };
+
+  // Tradução de uma função da IR (com a sua alocação) para x86-64
+  class GeradorX86
+  {
+  public:
+    GeradorX86(const FuncaoIR &funcao, const Alocacao &alocacao, FuncaoNativa *tabela)
+        : funcao(funcao), alocacao(alocacao), tabela(tabela), numSalvos(0), palavrasDeArrays(0) {}
+
+    vector<uint8_t> gerar();
+
+  private:
+    const FuncaoIR &funcao;
+    const Alocacao &alocacao;
+    FuncaoNativa *tabela;
+    Montador m;
+    vector<int> salvos; // registradores preservados usados, na ordem dos push
+    int numSalvos;
+    int numArgumentos;
+    vector<uint32_t> usos;
+    vector<bool> fundida; // comparações geradas junto com o BRANCH seguinte
+    vector<size_t> inicioDoBloco;
+    vector<pair<size_t, int>> saltos;  // (rel32, bloco)
+    vector<size_t> saltosParaErro;
+    // Elementos dos arrays criados por NEW_ARRAY: ficam no quadro, depois
+    // dos slots de spill; inicioDoArray é a primeira palavra de cada um
+    vector<int> inicioDoArray;
+    int palavrasDeArrays;
+    struct VerificacaoDeIndice
+    {
+      size_t rel32;
+      int registrador; // com o índice
+      int64_t tamanho;
+    };
+    vector<VerificacaoDeIndice> verificacoes;
+
+    bool isReal(uint32_t valor) const { return funcao.instrucoes[valor].tipo == TipoDeDado::DOUBLE; }
+    Local local(uint32_t valor) const;
+    int32_t deslocamento(int slot) const { return -8 * (numSalvos + slot + 1); }
+
+    int lerInteiro(uint32_t valor, int temporario);
+    int lerReal(uint32_t valor, int temporario);
+    void carregarInteiro(int destino, uint32_t valor);
+    void carregarReal(int destino, uint32_t valor);
+    void escreverInteiro(uint32_t valor, int origem);
+    void escreverReal(uint32_t valor, int origem);
+
+    void prologo();
+    void epilogo();
+    void gerarInstrucao(uint32_t id, int proximoBloco);
+    void gerarBinariaInteira(uint32_t id);
+    void gerarDivisaoInteira(uint32_t id);
+    void gerarBinariaReal(uint32_t id);
+    int gerarComparacao(uint32_t comparacao); // retorna a condição verdadeira
+    void gerarDesvio(uint32_t id, int proximoBloco);
+    void gerarChamada(uint32_t id);
+    void gerarNovoArray(uint32_t id);
+    void gerarAcessoAElemento(uint32_t id);
+    void saltarPara(int bloco, int proximoBloco);
+    void copiarPhis(int de, int para);
+    void copiasParalelas(vector<Copia> copias);
+    void mover(const Local &destino, const Local &origem);
+  };
+
+  Local GeradorX86::local(uint32_t valor) const
+  {
+    int r = alocacao.registrador[valor];
+    if (r >= 0)
+    {
+      if (isReal(valor))
+        return Local{Local::XMM, r};
+      return Local{Local::REGISTRADOR, codigoDoRegistrador(ClasseRegistrador::INTEIRO, r)};
+    }
+    return Local{Local::PILHA, alocacao.slotDePilha[valor]};
+  }
+
+  // Registrador com o valor: o seu, ou o temporário carregado da pilha
+  int GeradorX86::lerInteiro(uint32_t valor, int temporario)
+  {
+    Local l = local(valor);
+    if (l.tipo == Local::REGISTRADOR)
+      return l.numero;
+    m.carregar(temporario, RBP, deslocamento(l.numero));
+    return temporario;
+  }
+
+  int GeradorX86::lerReal(uint32_t valor, int temporario)
+  {
+    Local l = local(valor);
+    if (l.tipo == Local::XMM)
+      return l.numero;
+    m.carregarReal(temporario, RBP, deslocamento(l.numero));
+    return temporario;
+  }
+
+  void GeradorX86::carregarInteiro(int destino, uint32_t valor)
+  {
+    Local l = local(valor);
+    if (l.tipo == Local::REGISTRADOR)
+      m.mov(destino, l.numero);
+    else
+      m.carregar(destino, RBP, deslocamento(l.numero));
+  }
+
+  void GeradorX86::carregarReal(int destino, uint32_t valor)
+  {
+    Local l = local(valor);
+    if (l.tipo == Local::XMM)
+      m.movsd(destino, l.numero);
+    else
+      m.carregarReal(destino, RBP, deslocamento(l.numero));
+  }
+
+  void GeradorX86::escreverInteiro(uint32_t valor, int origem)
+  {
+    Local l = local(valor);
+    if (l.tipo == Local::REGISTRADOR)
+      m.mov(l.numero, origem);
+    else
+      m.guardar(RBP, deslocamento(l.numero), origem);
+  }
+
+  void GeradorX86::escreverReal(uint32_t valor, int origem)
+  {
+    Local l = local(valor);
+    if (l.tipo == Local::XMM)
+      m.movsd(l.numero, origem);
+    else
+      m.guardarReal(RBP, deslocamento(l.numero), origem);
+  }
+
+  // Quadro: rbp salvo, registradores preservados, slots de spill, elementos
+  // dos arrays e, no topo, a área dos argumentos das chamadas; rsp fica
+  // alinhado em 16 bytes
+  void GeradorX86::prologo()
+  {
+    m.push(RBP);
+    m.mov(RBP, RSP);
+    for (int r : salvos)
+    {
+      m.push(r);
+    }
+    int palavras = alocacao.numSlotsDePilha + palavrasDeArrays + numArgumentos;
+    if ((numSalvos + palavras) % 2)
+    {
+      palavras++;
+    }
+    if (palavras)
+    {
+      m.rex(true, 0, RSP);
+      m.byte(0x81);
+      m.modrm(5, RSP); // sub rsp, imm32
+      m.dword(8 * palavras);
+    }
+  }
+
+  void GeradorX86::epilogo()
+  {
+    // lea rsp, [rbp - 8 * numSalvos]
+    m.rex(true, RSP, RBP);
+    m.byte(0x8D);
+    m.memoria(RSP, RBP, -8 * numSalvos);
+    for (size_t i = salvos.size(); i-- > 0;)
+    {
+      m.pop(salvos[i]);
+    }
+    m.pop(RBP);
+    m.byte(0xC3);
+  }
+
+  vector<uint8_t> GeradorX86::gerar()
+  {
+    size_t numValores = funcao.instrucoes.size();
+    usos.assign(numValores, 0);
+    fundida.assign(numValores, false);
+    inicioDoArray.assign(numValores, -1);
+    numArgumentos = 0;
+    vector<bool> usado(16, false);
+    for (int b : alocacao.ordemDosBlocos)
+    {
+      for (uint32_t id : funcao.blocos[b].instrucoes)
+      {
+        const InstrucaoIR &ins = funcao.instrucoes[id];
+        for (uint32_t k = 0; k < ins.numOperandos; k++)
+        {
+          usos[funcao.operando(id, k)]++;
+        }
+        if (ins.op == OpIR::CALL || ins.op == OpIR::CALL_BUILTIN)
+        {
+          numArgumentos = max(numArgumentos, int(ins.numOperandos));
+        }
+        if (ins.op == OpIR::NEW_ARRAY)
+        {
+          inicioDoArray[id] = palavrasDeArrays;
+          palavrasDeArrays += int(ins.imediato);
+        }
+        int r = alocacao.registrador[id];
+        if (r >= PRIMEIRO_PRESERVADO && !isReal(id))
+        {
+          usado[codigoDoRegistrador(ClasseRegistrador::INTEIRO, r)] = true;
+        }
+      }
+    }
+    for (int r = 0; r < 16; r++)
+    {
+      if (usado[r])
+      {
+        salvos.push_back(r);
+      }
+    }
+    numSalvos = salvos.size();
+
+    // Comparação usada só pelo BRANCH logo a seguir: vira cmp + jcc
+    for (int b : alocacao.ordemDosBlocos)
+    {
+      const vector<uint32_t> &instrucoes = funcao.blocos[b].instrucoes;
+      if (instrucoes.size() < 2)
+        continue;
+      uint32_t desvio = instrucoes.back();
+      uint32_t anterior = instrucoes[instrucoes.size() - 2];
+      if (funcao.instrucoes[desvio].op != OpIR::BRANCH || funcao.operando(desvio, 0) != anterior || usos[anterior] != 1)
+        continue;
+      OpIR op = funcao.instrucoes[anterior].op;
+      bool real = isReal(funcao.operando(anterior, 0));
+      // Em double, == e != precisam testar também o caso não ordenado (NaN)
+      if (op == OpIR::LT || op == OpIR::GT || op == OpIR::LE || op == OpIR::GE ||
+          (!real && (op == OpIR::EQ || op == OpIR::NE)))
+      {
+        fundida[anterior] = true;
+      }
+    }
+
+    prologo();
+    inicioDoBloco.assign(funcao.blocos.size(), 0);
+    const vector<int> &ordem = alocacao.ordemDosBlocos;
+    for (size_t i = 0; i < ordem.size(); i++)
+    {
+      int b = ordem[i];
+      int proximo = i + 1 < ordem.size() ? ordem[i + 1] : -1;
+      inicioDoBloco[b] = m.posicao();
+      const BlocoIR &bloco = funcao.blocos[b];
+      if (bloco.predecessores.size() == 1)
+      {
+        copiarPhis(bloco.predecessores[0], b);
+      }
+      for (uint32_t id : bloco.instrucoes)
+      {
+        gerarInstrucao(id, proximo);
+      }
+    }
+
+    // Destino dos erros de execução: alinha a pilha e chama o tratador
+    size_t erro = m.posicao();
+    m.byte(0x48);
+    m.byte(0x83);
+    m.byte(0xE4);
+    m.byte(0xF0); // and rsp, -16
+    m.imediato(RAX, int64_t(reinterpret_cast<uintptr_t>(&erroDeDivisaoPorZero)));
+    m.byte(0xFF);
+    m.byte(0xD0); // call rax
+
+    // Índices fora do array: o tratador recebe o índice e o tamanho
+    for (const VerificacaoDeIndice &verificacao : verificacoes)
+    {
+      m.ajustar(verificacao.rel32, m.posicao());
+      m.mov(RDI, verificacao.registrador);
+      m.imediato(RSI, verificacao.tamanho);
+      m.byte(0x48);
+      m.byte(0x83);
+      m.byte(0xE4);
+      m.byte(0xF0); // and rsp, -16
+      m.imediato(RAX, int64_t(reinterpret_cast<uintptr_t>(&erroDeIndice)));
+      m.byte(0xFF);
+      m.byte(0xD0); // call rax
+    }
+
+    for (auto &salto : saltos)
+    {
+      m.ajustar(salto.first, inicioDoBloco[salto.second]);
+    }
+    for (size_t rel32 : saltosParaErro)
+    {
+      m.ajustar(rel32, erro);
+    }
+    return m.codigo;
+  }
+
+  void GeradorX86::gerarInstrucao(uint32_t id, int proximoBloco)
+  {
+    const InstrucaoIR &ins = funcao.instrucoes[id];
+    if (fundida[id])
+    {
+      return;
+    }
+    switch (ins.op)
+    {
+    case OpIR::PHI:
+      break; // copiado nas arestas
+    case OpIR::CONST_INT:
+    case OpIR::INDEFINIDO:
+    case OpIR::CONST_REAL:
+    {
+      int64_t bits = ins.op == OpIR::CONST_INT ? ins.imediato : ins.op == OpIR::CONST_REAL ? int64_t(bitsDeReal(ins.real)) : 0;
+      Local l = local(id);
+      if (l.tipo == Local::REGISTRADOR)
+      {
+        m.imediato(l.numero, bits);
+      }
+      else if (l.tipo == Local::XMM && bits == 0)
+      {
+        m.sse(0x66, 0x57, l.numero, l.numero); // xorpd
+      }
+      else
+      {
+        m.imediato(RAX, bits);
+        if (l.tipo == Local::XMM)
+          m.movqDeInteiro(l.numero, RAX);
+        else
+          m.guardar(RBP, deslocamento(l.numero), RAX);
+      }
+      break;
+    }
+    case OpIR::PARAM:
+    {
+      // rdi aponta para os argumentos; os PARAMs vêm antes de qualquer chamada
+      Local l = local(id);
+      int32_t d = 8 * int32_t(ins.imediato);
+      if (l.tipo == Local::REGISTRADOR)
+        m.carregar(l.numero, RDI, d);
+      else if (l.tipo == Local::XMM)
+        m.carregarReal(l.numero, RDI, d);
+      else
+      {
+        m.carregar(RAX, RDI, d);
+        m.guardar(RBP, deslocamento(l.numero), RAX);
+      }
+      break;
+    }
+    case OpIR::ADD:
+    case OpIR::SUB:
+    case OpIR::MUL:
+      if (isReal(id))
+        gerarBinariaReal(id);
+      else
+        gerarBinariaInteira(id);
+      break;
+    case OpIR::DIV:
+      if (isReal(id))
+        gerarBinariaReal(id);
+      else
+        gerarDivisaoInteira(id);
+      break;
+    case OpIR::LT:
+    case OpIR::GT:
+    case OpIR::LE:
+    case OpIR::GE:
+    case OpIR::EQ:
+    case OpIR::NE:
+    {
+      int cc = gerarComparacao(id);
+      if (cc == -1) // == em double: ZF e não PF
+      {
+        m.setcc(CC_E, RAX);
+        m.setcc(CC_NP, RCX);
+        m.byte(0x20);
+        m.byte(0xC8); // and al, cl
+      }
+      else if (cc == -2) // != em double: não ZF ou PF
+      {
+        m.setcc(CC_NE, RAX);
+        m.setcc(CC_P, RCX);
+        m.byte(0x08);
+        m.byte(0xC8); // or al, cl
+      }
+      else
+      {
+        m.setcc(cc, RAX);
+      }
+      m.movzxEaxAl();
+      escreverInteiro(id, RAX);
+      break;
+    }
+    case OpIR::NOT:
+    {
+      int r = lerInteiro(funcao.operando(id, 0), RAX);
+      m.alu(0x85, r, r);
+      m.setcc(CC_E, RAX);
+      m.movzxEaxAl();
+      escreverInteiro(id, RAX);
+      break;
+    }
+    case OpIR::INT_TO_DOUBLE:
+    {
+      int r = lerInteiro(funcao.operando(id, 0), RAX);
+      Local l = local(id);
+      int x = l.tipo == Local::XMM ? l.numero : XMM_TEMP_A;
+      m.cvtsi2sd(x, r);
+      escreverReal(id, x);
+      break;
+    }
+    case OpIR::CALL:
+    case OpIR::CALL_BUILTIN:
+      gerarChamada(id);
+      break;
+    case OpIR::NEW_ARRAY:
+      gerarNovoArray(id);
+      break;
+    case OpIR::LOAD_ELEM:
+    case OpIR::STORE_ELEM:
+      gerarAcessoAElemento(id);
+      break;
+    case OpIR::JUMP:
+    {
+      // Com as arestas críticas divididas, só um JUMP leva a um bloco com
+      // vários predecessores: as cópias dos PHIs ficam aqui
+      int destino = funcao.blocos[ins.bloco].sucessores[0];
+      if (funcao.blocos[destino].predecessores.size() > 1)
+        copiarPhis(ins.bloco, destino);
+      saltarPara(destino, proximoBloco);
+      break;
+    }
+    case OpIR::BRANCH:
+      gerarDesvio(id, proximoBloco);
+      break;
+    case OpIR::RETURN:
+      if (ins.numOperandos == 0)
+        m.imediato(RAX, 0);
+      else if (isReal(funcao.operando(id, 0)))
+      {
+        Local l = local(funcao.operando(id, 0));
+        if (l.tipo == Local::XMM)
+          m.movqParaInteiro(RAX, l.numero);
+        else
+          m.carregar(RAX, RBP, deslocamento(l.numero));
+      }
+      else
+        carregarInteiro(RAX, funcao.operando(id, 0));
+      epilogo();
+      break;
+    default:
+      throw runtime_error("Erro no JIT: instrucao nao suportada: " + opIRParaString(ins.op));
+    }
+  }
+
+  void GeradorX86::gerarBinariaInteira(uint32_t id)
+  {
+    OpIR op = funcao.instrucoes[id].op;
+    uint32_t a = funcao.operando(id, 0), b = funcao.operando(id, 1);
+    int rb = lerInteiro(b, RCX);
+    Local l = local(id);
+    // Calcula direto no destino, a menos que ele seja o registrador de b
+    int destino = l.tipo == Local::REGISTRADOR && l.numero != rb ? l.numero : RAX;
+    carregarInteiro(destino, a);
+    if (op == OpIR::ADD)
+      m.alu(0x01, destino, rb);
+    else if (op == OpIR::SUB)
+      m.alu(0x29, destino, rb);
+    else
+      m.imul(destino, rb);
+    escreverInteiro(id, destino);
+  }
+
+  void GeradorX86::gerarDivisaoInteira(uint32_t id)
+  {
+    carregarInteiro(RAX, funcao.operando(id, 0));
+    int rb = lerInteiro(funcao.operando(id, 1), RCX);
+    m.alu(0x85, rb, rb);
+    saltosParaErro.push_back(m.jcc(CC_E));
+    // INT64_MIN / -1 estoura no idiv: dividir por -1 é negar, dando a volta
+    m.cmpImediato8(rb, -1);
+    size_t paraDivisao = m.jcc(CC_NE);
+    m.grupoF7(3, RAX); // neg rax
+    size_t paraFim = m.jmp();
+    m.ajustar(paraDivisao, m.posicao());
+    m.cqo();
+    m.grupoF7(7, rb); // idiv
+    m.ajustar(paraFim, m.posicao());
+    escreverInteiro(id, RAX);
+  }
+
+  void GeradorX86::gerarBinariaReal(uint32_t id)
+  {
+    OpIR op = funcao.instrucoes[id].op;
+    uint8_t codigo = op == OpIR::ADD ? 0x58 : op == OpIR::MUL ? 0x59 : op == OpIR::SUB ? 0x5C : 0x5E;
+    int xb = lerReal(funcao.operando(id, 1), XMM_TEMP_B);
+    Local l = local(id);
+    int destino = l.tipo == Local::XMM && l.numero != xb ? l.numero : XMM_TEMP_A;
+    carregarReal(destino, funcao.operando(id, 0));
+    m.sse(0xF2, codigo, destino, xb);
+    escreverReal(id, destino);
+  }
+
+  // Emite a comparação e retorna o código de condição verdadeiro; -1 e -2
+  // indicam == e != entre doubles, que dependem também da flag de paridade
+  int GeradorX86::gerarComparacao(uint32_t comparacao)
+  {
+    OpIR op = funcao.instrucoes[comparacao].op;
+    uint32_t a = funcao.operando(comparacao, 0), b = funcao.operando(comparacao, 1);
+    if (!isReal(a))
+    {
+      int ra = lerInteiro(a, RAX);
+      int rb = lerInteiro(b, RCX);
+      m.alu(0x39, ra, rb); // cmp a, b
+      switch (op)
+      {
+      case OpIR::LT:
+        return CC_L;
+      case OpIR::GT:
+        return CC_G;
+      case OpIR::LE:
+        return CC_LE;
+      case OpIR::GE:
+        return CC_GE;
+      case OpIR::EQ:
+        return CC_E;
+      default:
+        return CC_NE;
+      }
+    }
+    // ucomisd: "acima" e "acima ou igual" são falsos quando não ordenado
+    int xa = lerReal(a, XMM_TEMP_A);
+    int xb = lerReal(b, XMM_TEMP_B);
+    switch (op)
+    {
+    case OpIR::LT:
+      m.sse(0x66, 0x2E, xb, xa);
+      return CC_A;
+    case OpIR::LE:
+      m.sse(0x66, 0x2E, xb, xa);
+      return CC_AE;
+    case OpIR::GT:
+      m.sse(0x66, 0x2E, xa, xb);
+      return CC_A;
+    case OpIR::GE:
+      m.sse(0x66, 0x2E, xa, xb);
+      return CC_AE;
+    case OpIR::EQ:
+      m.sse(0x66, 0x2E, xa, xb);
+      return -1;
+    default:
+      m.sse(0x66, 0x2E, xa, xb);
+      return -2;
+    }
+  }
+
+  void GeradorX86::gerarDesvio(uint32_t id, int proximoBloco)
+  {
+    const BlocoIR &bloco = funcao.blocos[funcao.instrucoes[id].bloco];
+    int verdadeiro = bloco.sucessores[0], falso = bloco.sucessores[1];
+    uint32_t condicao = funcao.operando(id, 0);
+    int cc;
+    if (fundida[condicao])
+    {
+      cc = gerarComparacao(condicao);
+    }
+    else
+    {
+      int r = lerInteiro(condicao, RAX);
+      m.alu(0x85, r, r);
+      cc = CC_NE;
+    }
+    // A negação de cada condição usada inverte o bit menos significativo
+    // (inclusive ja/jae com NaN, que viram jbe/jb)
+    if (verdadeiro == proximoBloco)
+    {
+      saltos.push_back(make_pair(m.jcc(cc ^ 1), falso));
+      return;
+    }
+    saltos.push_back(make_pair(m.jcc(cc), verdadeiro));
+    if (falso != proximoBloco)
+    {
+      saltos.push_back(make_pair(m.jmp(), falso));
+    }
+  }
+
+  void GeradorX86::gerarChamada(uint32_t id)
+  {
+    const InstrucaoIR &ins = funcao.instrucoes[id];
+    // Argumentos no topo da pilha; rdi aponta para eles
+    for (uint32_t k = 0; k < ins.numOperandos; k++)
+    {
+      uint32_t arg = funcao.operando(id, k);
+      Local l = local(arg);
+      if (l.tipo == Local::REGISTRADOR)
+        m.guardar(RSP, 8 * k, l.numero);
+      else if (l.tipo == Local::XMM)
+        m.guardarReal(RSP, 8 * k, l.numero);
+      else
+      {
+        m.carregar(RAX, RBP, deslocamento(l.numero));
+        m.guardar(RSP, 8 * k, RAX);
+      }
+    }
+    m.mov(RDI, RSP);
+    // Funções embutidas têm a mesma convenção e endereço fixo em BUILTINS
+    if (ins.op == OpIR::CALL_BUILTIN)
+      m.imediato(RAX, int64_t(reinterpret_cast<uintptr_t>(&BUILTINS[ins.imediato].emBits)));
+    else
+      m.imediato(RAX, int64_t(reinterpret_cast<uintptr_t>(&tabela[ins.imediato])));
+    m.byte(0xFF);
+    m.byte(0x10); // call [rax]
+    // Os valores vivos depois da chamada estão em registradores preservados
+    // ou na pilha (garantido pelo RegisterAllocator)
+    if (ins.tipo == TipoDeDado::INT)
+    {
+      escreverInteiro(id, RAX);
+    }
+    else if (ins.tipo == TipoDeDado::DOUBLE)
+    {
+      Local l = local(id);
+      if (l.tipo == Local::XMM)
+        m.movqDeInteiro(l.numero, RAX);
+      else
+        m.guardar(RBP, deslocamento(l.numero), RAX);
+    }
+  }
+
+  // Cada execução da declaração zera os elementos (rep stosq) e o valor do
+  // array é o endereço do primeiro
+  void GeradorX86::gerarNovoArray(uint32_t id)
+  {
+    int64_t tamanho = funcao.instrucoes[id].imediato;
+    int32_t inicio = deslocamento(alocacao.numSlotsDePilha + inicioDoArray[id] + int(tamanho) - 1);
+    m.push(RDI); // ponteiro dos argumentos
+    m.lea(RDI, RBP, inicio);
+    m.imediato(RCX, tamanho);
+    m.imediato(RAX, 0);
+    m.byte(0xF3);
+    m.byte(0x48);
+    m.byte(0xAB); // rep stosq
+    m.pop(RDI);
+    Local l = local(id);
+    int destino = l.tipo == Local::REGISTRADOR ? l.numero : RAX;
+    m.lea(destino, RBP, inicio);
+    escreverInteiro(id, destino);
+  }
+
+  void GeradorX86::gerarAcessoAElemento(uint32_t id)
+  {
+    const InstrucaoIR &ins = funcao.instrucoes[id];
+    int base = lerInteiro(funcao.operando(id, 0), RAX);
+    int indice = lerInteiro(funcao.operando(id, 1), RCX);
+    if (ins.imediato >= 0)
+    {
+      // Comparado sem sinal, um índice negativo também fica acima do tamanho
+      if (ins.imediato <= INT32_MAX)
+        m.cmpImediato32(indice, int32_t(ins.imediato));
+      else
+      {
+        m.imediato(RDX, ins.imediato);
+        m.alu(0x39, indice, RDX);
+      }
+      verificacoes.push_back(VerificacaoDeIndice{m.jcc(CC_AE), indice, ins.imediato});
+    }
+    if (ins.op == OpIR::LOAD_ELEM)
+    {
+      Local l = local(id);
+      if (isReal(id))
+      {
+        int x = l.tipo == Local::XMM ? l.numero : XMM_TEMP_A;
+        m.carregarElementoReal(x, base, indice);
+        escreverReal(id, x);
+      }
+      else
+      {
+        int destino = l.tipo == Local::REGISTRADOR ? l.numero : RDX;
+        m.carregarElemento(destino, base, indice);
+        escreverInteiro(id, destino);
+      }
+    }
+    else
+    {
+      uint32_t valor = funcao.operando(id, 2);
+      if (isReal(valor))
+        m.guardarElementoReal(base, indice, lerReal(valor, XMM_TEMP_A));
+      else
+        m.guardarElemento(base, indice, lerInteiro(valor, RDX));
+    }
+  }
+
+  void GeradorX86::saltarPara(int bloco, int proximoBloco)
+  {
+    if (bloco != proximoBloco)
+    {
+      saltos.push_back(make_pair(m.jmp(), bloco));
+    }
+  }
+
+  void GeradorX86::copiarPhis(int de, int para)
+  {
+    const BlocoIR &destino = funcao.blocos[para];
+    size_t j = 0;
+    while (destino.predecessores[j] != de)
+      j++;
+    vector<Copia> copias;
+    for (uint32_t id : destino.instrucoes)
+    {
+      if (funcao.instrucoes[id].op != OpIR::PHI)
+        break;
+      copias.push_back(Copia{local(id), local(funcao.operando(id, j))});
+    }
+    copiasParalelas(copias);
+  }
+
+  // Executa as cópias como se fossem simultâneas: primeiro as que não
+  // sobrescrevem a origem de outra pendente; num ciclo, o valor de um dos
+  // destinos é salvo num temporário da mesma classe dele (RAX para um
+  // slot da pilha, com a palavra copiada bit a bit)
+  void GeradorX86::copiasParalelas(vector<Copia> copias)
+  {
+    for (size_t i = 0; i < copias.size();)
+    {
+      if (copias[i].destino == copias[i].origem)
+      {
+        copias[i] = copias.back();
+        copias.pop_back();
+      }
+      else
+        i++;
+    }
+    while (!copias.empty())
+    {
+      bool progresso = false;
+      for (size_t i = 0; i < copias.size(); i++)
+      {
+        bool lido = false;
+        for (size_t k = 0; k < copias.size() && !lido; k++)
+        {
+          lido = k != i && copias[k].origem == copias[i].destino;
+        }
+        if (!lido)
+        {
+          mover(copias[i].destino, copias[i].origem);
+          copias.erase(copias.begin() + i);
+          progresso = true;
+          break;
+        }
+      }
+      if (!progresso)
+      {
+        Local salvo = copias[0].destino;
+        Local temporario = salvo.tipo == Local::XMM ? Local{Local::XMM, XMM_TEMP_B} : Local{Local::REGISTRADOR, RAX};
+        mover(temporario, salvo);
+        for (Copia &copia : copias)
+        {
+          if (copia.origem == salvo)
+            copia.origem = temporario;
+        }
+      }
+    }
+  }
+
+  // Copia a palavra de 64 bits de um local para outro, de qualquer classe
+  void GeradorX86::mover(const Local &destino, const Local &origem)
+  {
+    if (destino.tipo == Local::PILHA && origem.tipo == Local::PILHA)
+    {
+      m.carregar(RDX, RBP, deslocamento(origem.numero));
+      m.guardar(RBP, deslocamento(destino.numero), RDX);
+    }
+    else if (destino.tipo == Local::PILHA)
+    {
+      if (origem.tipo == Local::XMM)
+        m.guardarReal(RBP, deslocamento(destino.numero), origem.numero);
+      else
+        m.guardar(RBP, deslocamento(destino.numero), origem.numero);
+    }
+    else if (origem.tipo == Local::PILHA)
+    {
+      if (destino.tipo == Local::XMM)
+        m.carregarReal(destino.numero, RBP, deslocamento(origem.numero));
+      else
+        m.carregar(destino.numero, RBP, deslocamento(origem.numero));
+    }
+    else if (destino.tipo == Local::XMM && origem.tipo == Local::XMM)
+      m.movsd(destino.numero, origem.numero);
+    else if (destino.tipo == Local::XMM)
+      m.movqDeInteiro(destino.numero, origem.numero);
+    else if (origem.tipo == Local::XMM)
+      m.movqParaInteiro(destino.numero, origem.numero);
+    else
+      m.mov(destino.numero, origem.numero);
+  }
+
+  // Motivo pelo qual a IR não pode ser compilada, ou vazio
+  string verificarCompilavel(const FuncaoIR &funcao)
+  {
+    int64_t elementos = 0;
+    if (funcao.tipoRetorno == TipoDeDado::STRING)
+      return "usa string";
+    for (TipoDeDado tipo : funcao.tiposParametros)
+    {
+      if (tipo == TipoDeDado::STRING)
+        return "usa string";
+    }
+    for (const BlocoIR &bloco : funcao.blocos)
+    {
+      for (uint32_t id : bloco.instrucoes)
+      {
+        const InstrucaoIR &ins = funcao.instrucoes[id];
+        if (ins.tipo == TipoDeDado::STRING || ins.op == OpIR::CONST_STRING)
+          return "usa string";
+        if (ins.op == OpIR::LOAD_GLOBAL || ins.op == OpIR::STORE_GLOBAL)
+          return "acessa variavel global";
+        if (ins.op == OpIR::LOAD_LOCAL || ins.op == OpIR::STORE_LOCAL)
+          return "IR fora da forma SSA";
+        if (ins.op == OpIR::CALL_BUILTIN && !BUILTINS[ins.imediato].emBits)
+          return string("chama a funcao embutida '") + BUILTINS[ins.imediato].nome + "', sem versao nativa";
+        if (ins.op == OpIR::NEW_ARRAY)
+          elementos += ins.imediato;
+      }
+    }
+    if (elementos > LIMITE_DE_ELEMENTOS)
+      return "arrays com mais de " + to_string(LIMITE_DE_ELEMENTOS) + " elementos, grandes demais para a pilha";
+    return "";
+  }
+
+  void otimizar(FuncaoIR &funcao)
+  {
+    GVN().otimizarFuncao(funcao);
+    LoopOptimizer().otimizarFuncao(funcao);
+    DeadCodeEliminator().otimizarFuncao(funcao);
+  }
+
+  vector<uint8_t> traduzir(FuncaoIR &funcao, FuncaoNativa *tabela)
+  {
+    funcao.dividirArestasCriticas();
+    Alocacao alocacao = RegisterAllocator().alocarFuncao(funcao);
+    return GeradorX86(funcao, alocacao, tabela).gerar();
+  }
+}
+
+Jit::Jit(ProgramNode *program)
+    : programa(program), tabela(program->getFunctions().size(), nullptr),
+      motivos(program->getFunctions().size()), compiladas(0), bytesDeCodigo(0)
+{
+  grafo.construir(program);
+}
+
+Jit::~Jit()
+{
+#ifdef JIT_X86_64
+  for (auto &regiao : regioes)
+  {
+    munmap(regiao.first, regiao.second);
+  }
+#endif
+}
+
+bool Jit::compilar(int indice)
+{
+  if (isCompilada(indice))
+  {
+    return true;
+  }
+  if (!motivos[indice].empty())
+  {
+    return false;
+  }
+#ifndef JIT_X86_64
+  motivos[indice] = "JIT indisponivel nesta plataforma";
+  return false;
+#else
+  const vector<FunctionNode *> &functions = programa->getFunctions();
+
+  // Funções alcançáveis por chamadas e ainda não compiladas
+  vector<int> pendentes;
+  vector<bool> visitada(functions.size(), false);
+  vector<int> pilha(1, indice);
+  visitada[indice] = true;
+  while (!pilha.empty())
+  {
+    int f = pilha.back();
+    pilha.pop_back();
+    pendentes.push_back(f);
+    for (int g : grafo.getChamadas(f))
+    {
+      if (!visitada[g] && !isCompilada(g))
+      {
+        visitada[g] = true;
+        pilha.push_back(g);
+      }
+    }
+  }
+
+  // IR otimizada de cada uma, e as que não podem ser compiladas
+  vector<FuncaoIR *> irs(functions.size(), nullptr);
+  for (int f : pendentes)
+  {
+    if (functions[f]->isGlobalWrapper())
+    {
+      motivos[f] = "codigo de nivel de programa";
+      continue;
+    }
+    if (!motivos[f].empty())
+    {
+      continue;
+    }
+    irs[f] = IRBuilder().construirFuncao(programa, functions[f]);
+    otimizar(*irs[f]);
+    motivos[f] = verificarCompilavel(*irs[f]);
+  }
+  // Quem chama uma função não compilável também não é compilável
+  bool mudou = true;
+  while (mudou)
+  {
+    mudou = false;
+    for (int f : pendentes)
+    {
+      if (!motivos[f].empty())
+        continue;
+      for (int g : grafo.getChamadas(f))
+      {
+        if (!isCompilada(g) && !motivos[g].empty())
+        {
+          motivos[f] = "chama '" + functions[g]->getName() + "', que nao e compilavel";
+          mudou = true;
+          break;
+        }
+      }
+    }
+  }
+
+  // Geração: todo o código do lote vai para uma mesma região
+  vector<uint8_t> codigo;
+  vector<pair<int, size_t>> inicios;
+  try
+  {
+    for (int f : pendentes)
+    {
+      if (!motivos[f].empty())
+        continue;
+      vector<uint8_t> gerado = traduzir(*irs[f], tabela.data());
+      // Funções alinhadas em 16 bytes
+      while (codigo.size() % 16)
+        codigo.push_back(0xCC);
+      inicios.push_back(make_pair(f, codigo.size()));
+      codigo.insert(codigo.end(), gerado.begin(), gerado.end());
+    }
+  }
+  catch (exception &)
+  {
+    for (auto ir : irs)
+      delete ir;
+    throw;
+  }
+  for (auto ir : irs)
+  {
+    delete ir;
+  }
+
+  if (!inicios.empty())
+  {
+    uint8_t *regiao = instalar(codigo);
+    for (auto &inicio : inicios)
+    {
+      tabela[inicio.first] = reinterpret_cast<FuncaoNativa>(regiao + inicio.second);
+      compiladas++;
+    }
+  }
+  return isCompilada(indice);
+#endif
+}
+
+int Jit::compilarEntradaDeLaco(int indice, StatementNode *laco, string &motivo)
+{
+  FunctionNode *function = programa->getFunctions()[indice];
+  if (function->isGlobalWrapper())
+  {
+    motivo = "codigo de nivel de programa";
+    return -1;
+  }
+  // As funções chamadas precisam estar na tabela
+  for (int g : grafo.getChamadas(indice))
+  {
+    if (g != indice && !compilar(g))
+    {
+      motivo = "chama '" + programa->getFunctions()[g]->getName() + "', que nao e compilavel";
+      return -1;
+    }
+  }
+#ifndef JIT_X86_64
+  motivo = "JIT indisponivel nesta plataforma";
+  return -1;
+#else
+  FuncaoIR *ir = IRBuilder().construirEntradaDeLaco(programa, function, laco);
+  vector<uint8_t> codigo;
+  try
+  {
+    otimizar(*ir);
+    motivo = verificarCompilavel(*ir);
+    if (motivo.empty() && grafo.isRecursiva(indice) && !compilar(indice))
+    {
+      motivo = getMotivo(indice);
+    }
+    if (motivo.empty())
+    {
+      codigo = traduzir(*ir, tabela.data());
+    }
+  }
+  catch (exception &)
+  {
+    delete ir;
+    throw;
+  }
+  delete ir;
+  if (!motivo.empty())
+  {
+    return -1;
+  }
+  entradas.push_back(reinterpret_cast<FuncaoNativa>(instalar(codigo)));
+  return entradas.size() - 1;
+#endif
+}
+
+uint8_t *Jit::instalar(const vector<uint8_t> &codigo)
+{
+#ifdef JIT_X86_64
+  // Escrito com as páginas graváveis; só depois elas passam a executáveis
+  size_t tamanho = (codigo.size() + 4095) & ~size_t(4095);
+  void *regiao = mmap(nullptr, tamanho, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (regiao == MAP_FAILED)
+  {
+    throw runtime_error("Erro no JIT: mmap falhou");
+  }
+  memcpy(regiao, codigo.data(), codigo.size());
+  if (mprotect(regiao, tamanho, PROT_READ | PROT_EXEC) != 0)
+  {
+    munmap(regiao, tamanho);
+    throw runtime_error("Erro no JIT: mprotect falhou");
+  }
+  regioes.push_back(make_pair(regiao, tamanho));
+  bytesDeCodigo += codigo.size();
+  return static_cast<uint8_t *>(regiao);
+#else
+  (void)codigo;
+  throw runtime_error("Erro no JIT: JIT indisponivel nesta plataforma");
+#endif
+}
+
+uint64_t Jit::chamar(int indice, const uint64_t *argumentos)
+{
+  if (!isCompilada(indice))
+  {
+    throw runtime_error("Erro no JIT: funcao '" + programa->getFunctions()[indice]->getName() + "' nao compilada");
+  }
+  return executarNativo(tabela[indice], argumentos);
+}
+
+uint64_t Jit::chamarEntradaDeLaco(int entrada, const uint64_t *slots)
+{
+  return executarNativo(entradas[entrada], slots);
+}
+
+uint64_t Jit::executarNativo(FuncaoNativa funcao, const uint64_t *argumentos)
+{
+  jmp_buf retorno;
+  jmp_buf *anterior = retornoDeErro;
+  retornoDeErro = &retorno;
+  if (setjmp(retorno))
+  {
+    retornoDeErro = anterior;
+    throw runtime_error(mensagemDeErro);
+  }
+  uint64_t resultado = funcao(argumentos);
+  retornoDeErro = anterior;
+  return resultado;
+}
@@ -1,20 +1,75 @@
 #include "Lexer.h"
+#include <algorithm>
 #include <stdexcept>
 #include <iostream>
 #include <set>
+#include <thread>
 
-Lexer::Lexer(const string &codigo)
+namespace
 {
-  this->codigo = codigo;
+  // Abaixo disso por thread, criar as threads custa mais que analisar
+  const int TRECHO_MINIMO = 256 * 1024;
+  // Distância em que se procura uma quebra de linha para cortar
+  const int JANELA_DO_CORTE = 64 * 1024;
+  // Tokens por lote enviado ao anel na análise em pipeline
+  const size_t LOTE_DO_ANEL = 1024;
+}
+
+Lexer::Lexer() : trechosRefeitos(0), anel(nullptr)
+{
+  inicializar();
+}
+
+Lexer::Lexer(const string &codigo) : fonte(codigo), trechosRefeitos(0), anel(nullptr)
+{
+  inicializar();
+}
+
+void Lexer::reset(const string &codigo)
+{
+  fonte.assign(codigo);
   inicializar();
 }
 
 void Lexer::inicializar()
 {
-  tokens.clear();
+  tokens.reiniciar(&fonte);
+  codigo = fonte.data();
+  fim = fonte.size();
+  emTrecho = false;
+  stringAberta = -1;
   i = 0;
   estado_atual = 0;
-  lexema = "";
+  lexema.clear();
+}
+
+void Lexer::analisarTrecho(const string &fonte, int inicio, int fim, bool emTrecho)
+{
+  tokens.reiniciar(&fonte);
+  codigo = fonte.data();
+  this->fim = fim;
+  this->emTrecho = emTrecho;
+  stringAberta = -1;
+  i = inicio;
+  estado_atual = 0;
+  lexema.clear();
+  percorrer();
+}
+
+// O lexema acabou de ser lido e termina na posição atual
+void Lexer::adicionar(TipoDeToken tipo)
+{
+  adicionar(tipo, i - lexema.size(), lexema.size());
+}
+
+void Lexer::adicionar(TipoDeToken tipo, size_t inicio, size_t tamanho)
+{
+  tokens.adicionar(tipo, inicio, tamanho);
+  if (anel && tokens.size() >= LOTE_DO_ANEL)
+  {
+    anel->enviar(tokens);
+    tokens.reiniciar(&fonte);
+  }
 }
 
 bool Lexer::isEspaco(char c)
@@ -57,9 +112,138 @@ bool Lexer::isPontuacao(char c)
   return c == ';' || c == '(' || c == ')' || c == '{' || c == '}' || c == '[' || c == ']' || c == ',' || c == ':' || c == '?';
 }
 
-vector<Token> Lexer::Analisar()
+const FluxoDeTokens &Lexer::Analisar()
+{
+  percorrer();
+  return tokens;
+}
+
+const FluxoDeTokens &Lexer::AnalisarEmParalelo(int numThreads)
 {
-  while (i < codigo.size())
+  inicializar();
+  trechosRefeitos = 0;
+  if (numThreads <= 0)
+  {
+    numThreads = max(1u, thread::hardware_concurrency());
+  }
+  numThreads = min(numThreads, fim / TRECHO_MINIMO + 1);
+
+  // Cortes logo depois de um espaço, perto de frações iguais do código: um
+  // token só atravessa um espaço se for uma string. De preferência numa
+  // quebra de linha, que raramente está dentro de uma string
+  vector<int> cortes(1, 0);
+  for (int t = 1; t < numThreads; t++)
+  {
+    int corte = max(cortes.back(), static_cast<int>(static_cast<long long>(fim) * t / numThreads));
+    int limite = min(fim, corte + JANELA_DO_CORTE);
+    int linha = corte;
+    while (linha < limite && codigo[linha] != '\n')
+    {
+      linha++;
+    }
+    if (linha < limite)
+    {
+      corte = linha;
+    }
+    while (corte < fim && !isEspaco(codigo[corte]))
+    {
+      corte++;
+    }
+    if (corte + 1 < fim && corte + 1 > cortes.back())
+    {
+      cortes.push_back(corte + 1);
+    }
+  }
+  cortes.push_back(fim);
+  int numTrechos = cortes.size() - 1;
+  if (numTrechos == 1)
+  {
+    return Analisar();
+  }
+
+  vector<Lexer *> trechos(numTrechos);
+  vector<string> erros(numTrechos);
+  vector<thread> threads;
+  for (int t = 0; t < numTrechos; t++)
+  {
+    trechos[t] = new Lexer();
+    threads.push_back(thread([this, t, numTrechos, &cortes, &trechos, &erros]()
+                             {
+      try
+      {
+        trechos[t]->analisarTrecho(fonte, cortes[t], cortes[t + 1], t + 1 < numTrechos);
+      }
+      catch (exception &e)
+      {
+        erros[t] = e.what();
+      } }));
+  }
+  for (thread &t : threads)
+  {
+    t.join();
+  }
+
+  // Só o primeiro trecho começa com certeza fora de uma string. Em ordem,
+  // cada trecho aceito diz onde o seguinte realmente começa: no corte ou,
+  // se terminou dentro de uma string, na aspa que a abriu
+  string erro;
+  int inicio = 0;
+  for (int t = 0; t < numTrechos; t++)
+  {
+    Lexer *trecho = trechos[t];
+    if (inicio != cortes[t])
+    {
+      trechosRefeitos++;
+      erros[t].clear();
+      try
+      {
+        trecho->analisarTrecho(fonte, inicio, cortes[t + 1], t + 1 < numTrechos);
+      }
+      catch (exception &e)
+      {
+        erros[t] = e.what();
+      }
+    }
+    if (!erros[t].empty())
+    {
+      erro = erros[t];
+      break;
+    }
+    tokens.anexar(trecho->tokens);
+    inicio = trecho->stringAberta >= 0 ? trecho->stringAberta : cortes[t + 1];
+  }
+  for (Lexer *trecho : trechos)
+  {
+    delete trecho;
+  }
+  if (!erro.empty())
+  {
+    throw runtime_error(erro);
+  }
+  i = fim;
+  return tokens;
+}
+
+void Lexer::AnalisarParaAnel(AnelDeTokens &anel)
+{
+  inicializar();
+  this->anel = &anel;
+  try
+  {
+    percorrer();
+    anel.enviar(tokens);
+    anel.fechar();
+  }
+  catch (exception &e)
+  {
+    anel.fechar(e.what());
+  }
+  this->anel = nullptr;
+}
+
+void Lexer::percorrer()
+{
+  while (i < fim)
   {
     switch (estado_atual)
     {
@@ -100,13 +284,12 @@ vector<Token> Lexer::Analisar()
       throw runtime_error("Estado invalido");
     }
   }
-  return tokens;
 }
 
 // Estado q0: Estado inicial
 void Lexer::q0()
 {
-  if (i >= codigo.size())
+  if (i >= fim)
   {
     return;
   }
@@ -123,13 +306,13 @@ void Lexer::q0()
   }
   else if (isOperadorAritmetico(c))
   {
-    if (c == '+' && i + 1 < codigo.size() && codigo[i + 1] == '+')
+    if (c == '+' && i + 1 < fim && codigo[i + 1] == '+')
     {
       lexema = "++";
       estado_atual = 7;
       i += 2;
     }
-    else if (c == '-' && i + 1 < codigo.size() && codigo[i + 1] == '-')
+    else if (c == '-' && i + 1 < fim && codigo[i + 1] == '-')
     {
       lexema = "--";
       estado_atual = 8;
@@ -189,9 +372,9 @@ void Lexer::q0()
 // Estado q1: Reconhece números inteiros e reais
 void Lexer::q1()
 {
-  if (i >= codigo.size())
+  if (i >= fim)
   {
-    tokens.push_back(Token(TipoDeToken::NUMERO_INTEIRO, lexema));
+    adicionar(TipoDeToken::NUMERO_INTEIRO);
     estado_atual = 0;
     return;
   }
@@ -209,7 +392,7 @@ void Lexer::q1()
   }
   else
   {
-    tokens.push_back(Token(TipoDeToken::NUMERO_INTEIRO, lexema));
+    adicionar(TipoDeToken::NUMERO_INTEIRO);
     lexema = "";
     estado_atual = 0;
   }
@@ -218,7 +401,7 @@ void Lexer::q1()
 // Estado q2: Reconhece operadores aritméticos
 void Lexer::q2()
 {
-  tokens.push_back(Token(TipoDeToken::OPERADOR_ARITMETICO, lexema));
+  adicionar(TipoDeToken::OPERADOR_ARITMETICO);
   lexema = "";
   estado_atual = 0;
 }
@@ -226,17 +409,17 @@ void Lexer::q2()
 // Estado q3: Reconhece identificadores e palavras reservadas
 void Lexer::q3()
 {
-  const set<string> palavrasReservadas = {"int", "double", "string", "main", "if", "else", "while", "for", "do", "return"};
+  static const set<string> palavrasReservadas = {"int", "double", "string", "main", "if", "else", "while", "for", "do", "return"};
 
-  if (i >= codigo.size())
+  if (i >= fim)
   {
     if (palavrasReservadas.count(lexema))
     {
-      tokens.push_back(Token(TipoDeToken::PALAVRA_RESERVADA, lexema));
+      adicionar(TipoDeToken::PALAVRA_RESERVADA);
     }
     else
     {
-      tokens.push_back(Token(TipoDeToken::IDENTIFICADOR, lexema));
+      adicionar(TipoDeToken::IDENTIFICADOR);
     }
     estado_atual = 0;
     return;
@@ -252,11 +435,11 @@ void Lexer::q3()
   {
     if (palavrasReservadas.count(lexema))
     {
-      tokens.push_back(Token(TipoDeToken::PALAVRA_RESERVADA, lexema));
+      adicionar(TipoDeToken::PALAVRA_RESERVADA);
     }
     else
     {
-      tokens.push_back(Token(TipoDeToken::IDENTIFICADOR, lexema));
+      adicionar(TipoDeToken::IDENTIFICADOR);
     }
     lexema = "";
     estado_atual = 0;
@@ -266,18 +449,18 @@ void Lexer::q3()
 // Estado q4: Reconhece operadores relacionais e de atribuição
 void Lexer::q4()
 {
-  if (i < codigo.size() && codigo[i] == '=')
+  if (i < fim && codigo[i] == '=')
   {
     lexema.push_back(codigo[i]);
     i++;
   }
   if (lexema == "=")
   {
-    tokens.push_back(Token(TipoDeToken::OPERADOR_ATRIBUICAO, lexema));
+    adicionar(TipoDeToken::OPERADOR_ATRIBUICAO);
   }
   else
   {
-    tokens.push_back(Token(TipoDeToken::OPERADOR_RELACIONAL, lexema));
+    adicionar(TipoDeToken::OPERADOR_RELACIONAL);
   }
   lexema = "";
   estado_atual = 0;
@@ -336,7 +519,7 @@ void Lexer::q5()
     tipo = TipoDeToken::DESCONHECIDO;
   }
 
-  tokens.push_back(Token(tipo, lexema));
+  adicionar(tipo);
   lexema = "";
   estado_atual = 0;
 }
@@ -344,17 +527,26 @@ void Lexer::q5()
 // Estado q6: Reconhece strings
 void Lexer::q6()
 {
-  while (i < codigo.size() && codigo[i] != '"')
+  while (i < fim && codigo[i] != '"')
   {
     lexema.push_back(codigo[i]);
     i++;
   }
-  if (i >= codigo.size() || codigo[i] != '"')
+  if (i >= fim || codigo[i] != '"')
   {
+    if (emTrecho)
+    {
+      // A string continua depois do trecho: quem dividiu o código decide
+      stringAberta = i - lexema.size() - 1;
+      lexema.clear();
+      estado_atual = 0;
+      return;
+    }
     throw runtime_error("String nao terminada");
   }
   i++;
-  tokens.push_back(Token(TipoDeToken::STRING, lexema));
+  // O lexema é o texto entre as aspas
+  adicionar(TipoDeToken::STRING, i - 1 - lexema.size(), lexema.size());
   lexema = "";
   estado_atual = 0;
 }
@@ -362,7 +554,7 @@ void Lexer::q6()
 // Estado q7: Reconhece INCREMENTO (++)
 void Lexer::q7()
 {
-  tokens.push_back(Token(TipoDeToken::INCREMENTO, lexema));
+  adicionar(TipoDeToken::INCREMENTO);
   lexema = "";
   estado_atual = 0;
 }
@@ -370,7 +562,7 @@ void Lexer::q7()
 // Estado q8: Reconhece DECREMENTO (--)
 void Lexer::q8()
 {
-  tokens.push_back(Token(TipoDeToken::DECREMENTO, lexema));
+  adicionar(TipoDeToken::DECREMENTO);
   lexema = "";
   estado_atual = 0;
 }
@@ -378,25 +570,25 @@ void Lexer::q8()
 // Estado q9: Reconhece operadores lógicos (&&, ||) e negação (!)
 void Lexer::q9()
 {
-  if (i < codigo.size() && ((lexema == "&" && codigo[i] == '&') ||
+  if (i < fim && ((lexema == "&" && codigo[i] == '&') ||
                             (lexema == "|" && codigo[i] == '|')))
   {
     lexema.push_back(codigo[i]);
     i++;
-    tokens.push_back(Token(TipoDeToken::OPERADOR_LOGICO, lexema));
+    adicionar(TipoDeToken::OPERADOR_LOGICO);
   }
   else if (lexema == "!")
   {
     // Verifica se é != (operador relacional) ou apenas ! (negação lógica)
-    if (i < codigo.size() && codigo[i] == '=')
+    if (i < fim && codigo[i] == '=')
     {
       lexema.push_back(codigo[i]);
       i++;
-      tokens.push_back(Token(TipoDeToken::OPERADOR_RELACIONAL, lexema));
+      adicionar(TipoDeToken::OPERADOR_RELACIONAL);
     }
     else
     {
-      tokens.push_back(Token(TipoDeToken::OPERADOR_LOGICO, lexema));
+      adicionar(TipoDeToken::OPERADOR_LOGICO);
     }
   }
   else
@@ -411,12 +603,12 @@ void Lexer::q9()
 // Estado q10: Reconhece a parte decimal de um número real
 void Lexer::q10()
 {
-  while (i < codigo.size() && isDigito(codigo[i]))
+  while (i < fim && isDigito(codigo[i]))
   {
     lexema.push_back(codigo[i]);
     i++;
   }
-  tokens.push_back(Token(TipoDeToken::NUMERO_REAL, lexema));
+  adicionar(TipoDeToken::NUMERO_REAL);
   lexema = "";
   estado_atual = 0;
 }
@@ -0,0 +1,307 @@
+#include "LoopOptimizer.h"
+#include "SSA.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace
+{
+  const uint32_t SEM_VALOR = UINT32_MAX;
+}
+
+LoopOptimizer::LoopOptimizer() : invariantesMovidas(0), reducoesDeForca(0), funcao(nullptr) {}
+
+void LoopOptimizer::otimizar(ProgramaIR *programa)
+{
+  invariantesMovidas = 0;
+  reducoesDeForca = 0;
+  for (auto f : programa->funcoes)
+  {
+    otimizarFuncao(*f);
+  }
+}
+
+void LoopOptimizer::otimizarFuncao(FuncaoIR &f)
+{
+  funcao = &f;
+  substituto.assign(f.instrucoes.size(), SEM_VALOR);
+  calcularDominadores(f);
+
+  vector<Laco> lacos = encontrarLacos();
+  for (Laco &laco : lacos)
+  {
+    moverInvariantes(laco);
+    reduzirForca(laco);
+  }
+
+  // Os usos das multiplicações reduzidas passam a usar as novas variáveis
+  for (auto &bloco : f.blocos)
+  {
+    for (uint32_t id : bloco.instrucoes)
+    {
+      for (uint32_t i = 0; i < f.instrucoes[id].numOperandos; i++)
+      {
+        f.setOperando(id, i, valor(f.operando(id, i)));
+      }
+    }
+  }
+  funcao = nullptr;
+}
+
+vector<LoopOptimizer::Laco> LoopOptimizer::encontrarLacos()
+{
+  vector<BlocoIR> &blocos = funcao->blocos;
+  vector<Laco> lacos;
+  vector<int> lacoDoCabecalho(blocos.size(), -1);
+
+  for (size_t b = 0; b < blocos.size(); b++)
+  {
+    for (int h : blocos[b].sucessores)
+    {
+      if (!domina(*funcao, h, b))
+      {
+        continue;
+      }
+      // Aresta de retorno b -> h: o corpo são os blocos que alcançam b sem passar por h
+      if (lacoDoCabecalho[h] < 0)
+      {
+        lacoDoCabecalho[h] = lacos.size();
+        Laco novo;
+        novo.cabecalho = h;
+        novo.preCabecalho = -1;
+        novo.contem.assign(blocos.size(), false);
+        novo.contem[h] = true;
+        novo.blocos.push_back(h);
+        lacos.push_back(novo);
+      }
+      Laco &laco = lacos[lacoDoCabecalho[h]];
+      vector<int> pendentes;
+      if (!laco.contem[b])
+      {
+        laco.contem[b] = true;
+        laco.blocos.push_back(b);
+        pendentes.push_back(b);
+      }
+      while (!pendentes.empty())
+      {
+        int atual = pendentes.back();
+        pendentes.pop_back();
+        for (int p : blocos[atual].predecessores)
+        {
+          if (!laco.contem[p])
+          {
+            laco.contem[p] = true;
+            laco.blocos.push_back(p);
+            pendentes.push_back(p);
+          }
+        }
+      }
+    }
+  }
+
+  // Mantém só os laços com pré-cabeçalho, dos internos para os externos
+  vector<Laco> validos;
+  for (Laco &laco : lacos)
+  {
+    int externos = 0;
+    for (int p : blocos[laco.cabecalho].predecessores)
+    {
+      if (!laco.contem[p])
+      {
+        externos++;
+        laco.preCabecalho = p;
+      }
+    }
+    if (externos == 1 && blocos[laco.preCabecalho].sucessores.size() == 1)
+    {
+      validos.push_back(laco);
+    }
+  }
+  stable_sort(validos.begin(), validos.end(), [](const Laco &a, const Laco &b)
+              { return a.blocos.size() < b.blocos.size(); });
+  return validos;
+}
+
+uint32_t LoopOptimizer::valor(uint32_t id) const
+{
+  while (id < substituto.size() && substituto[id] != SEM_VALOR)
+  {
+    id = substituto[id];
+  }
+  return id;
+}
+
+bool LoopOptimizer::isInvariante(const Laco &laco, uint32_t id) const
+{
+  return !laco.contem[funcao->instrucoes[valor(id)].bloco];
+}
+
+uint32_t LoopOptimizer::inserirNoFim(int bloco, OpIR op, TipoDeDado tipo, uint32_t a, uint32_t b)
+{
+  uint32_t ops[2] = {a, b};
+  uint32_t id = funcao->criarInstrucao(op, tipo, bloco, ops, 2);
+  vector<uint32_t> &instrucoes = funcao->blocos[bloco].instrucoes;
+  instrucoes.insert(instrucoes.end() - 1, id);
+  substituto.push_back(SEM_VALOR);
+  return id;
+}
+
+void LoopOptimizer::moverInvariantes(Laco &laco)
+{
+  // Em pós-ordem reversa, as definições são visitadas antes dos usos, então
+  // uma única passada move cadeias inteiras de computações invariantes
+  vector<int> rpo = funcao->ordemReversaPosOrdem();
+  vector<uint32_t> &destino = funcao->blocos[laco.preCabecalho].instrucoes;
+  for (int b : rpo)
+  {
+    if (!laco.contem[b])
+    {
+      continue;
+    }
+    vector<uint32_t> restantes;
+    for (uint32_t id : funcao->blocos[b].instrucoes)
+    {
+      InstrucaoIR &ins = funcao->instrucoes[id];
+      bool mover = isPuraIR(ins.op);
+      for (uint32_t i = 0; i < ins.numOperandos && mover; i++)
+      {
+        mover = isInvariante(laco, funcao->operando(id, i));
+      }
+      if (mover && ins.op == OpIR::DIV && ins.tipo == TipoDeDado::INT)
+      {
+        // A divisão inteira pode falhar: só é antecipada se o divisor é uma constante não nula
+        const InstrucaoIR &divisor = funcao->instrucoes[valor(funcao->operando(id, 1))];
+        mover = divisor.op == OpIR::CONST_INT && divisor.imediato != 0;
+      }
+
+      if (mover)
+      {
+        ins.bloco = laco.preCabecalho;
+        destino.insert(destino.end() - 1, id);
+        invariantesMovidas++;
+      }
+      else
+      {
+        restantes.push_back(id);
+      }
+    }
+    funcao->blocos[b].instrucoes.swap(restantes);
+  }
+}
+
+void LoopOptimizer::reduzirForca(Laco &laco)
+{
+  const vector<int> &preds = funcao->blocos[laco.cabecalho].predecessores;
+  if (preds.size() != 2)
+  {
+    return;
+  }
+  uint32_t indicePre = preds[0] == laco.preCabecalho ? 0 : 1;
+  uint32_t indiceRetorno = 1 - indicePre;
+  int retorno = preds[indiceRetorno];
+
+  // Variáveis de indução básicas: i = phi(inicial, i + c) ou phi(inicial, i - c), c invariante
+  struct Inducao
+  {
+    uint32_t phi, inicial, passo;
+    OpIR op;
+  };
+  vector<Inducao> inducoes;
+  for (uint32_t id : funcao->blocos[laco.cabecalho].instrucoes)
+  {
+    const InstrucaoIR &phi = funcao->instrucoes[id];
+    if (phi.op != OpIR::PHI)
+    {
+      break;
+    }
+    if (phi.tipo != TipoDeDado::INT)
+    {
+      continue;
+    }
+    uint32_t proximo = valor(funcao->operando(id, indiceRetorno));
+    const InstrucaoIR &atualizacao = funcao->instrucoes[proximo];
+    if ((atualizacao.op != OpIR::ADD && atualizacao.op != OpIR::SUB) || atualizacao.numOperandos != 2)
+    {
+      continue;
+    }
+    uint32_t a = valor(funcao->operando(proximo, 0));
+    uint32_t b = valor(funcao->operando(proximo, 1));
+    if (atualizacao.op == OpIR::ADD && b == id && a != id)
+    {
+      swap(a, b);
+    }
+    if (a == id && b != id && isInvariante(laco, b))
+    {
+      inducoes.push_back(Inducao{id, funcao->operando(id, indicePre), b, atualizacao.op});
+    }
+  }
+  if (inducoes.empty())
+  {
+    return;
+  }
+
+  for (int b : laco.blocos)
+  {
+    // Cópia: o cabeçalho e o bloco de retorno recebem instruções durante a varredura
+    vector<uint32_t> instrucoes = funcao->blocos[b].instrucoes;
+    bool reduziu = false;
+    for (uint32_t id : instrucoes)
+    {
+      const InstrucaoIR &ins = funcao->instrucoes[id];
+      const Inducao *inducao = nullptr;
+      uint32_t fator = SEM_VALOR;
+      if (ins.op == OpIR::MUL && ins.tipo == TipoDeDado::INT)
+      {
+        uint32_t x = valor(funcao->operando(id, 0));
+        uint32_t y = valor(funcao->operando(id, 1));
+        for (const Inducao &candidata : inducoes)
+        {
+          if (x == candidata.phi && isInvariante(laco, y))
+            fator = y;
+          else if (y == candidata.phi && isInvariante(laco, x))
+            fator = x;
+          else
+            continue;
+          inducao = &candidata;
+          break;
+        }
+      }
+      if (!inducao)
+      {
+        continue;
+      }
+
+      // j = i * k vira j = phi(inicial * k, j + c * k)
+      uint32_t inicial = valor(inducao->inicial);
+      bool inicioZero = funcao->instrucoes[inicial].op == OpIR::CONST_INT && funcao->instrucoes[inicial].imediato == 0;
+      uint32_t inicioReduzido = inicioZero ? inicial : inserirNoFim(laco.preCabecalho, OpIR::MUL, TipoDeDado::INT, inicial, fator);
+      uint32_t passoReduzido = inserirNoFim(laco.preCabecalho, OpIR::MUL, TipoDeDado::INT, inducao->passo, fator);
+
+      uint32_t novoPhi = funcao->criarInstrucao(OpIR::PHI, TipoDeDado::INT, laco.cabecalho, nullptr, 2);
+      substituto.push_back(SEM_VALOR);
+      vector<uint32_t> &cabecalho = funcao->blocos[laco.cabecalho].instrucoes;
+      cabecalho.insert(cabecalho.begin(), novoPhi);
+      uint32_t proximo = inserirNoFim(retorno, inducao->op, TipoDeDado::INT, novoPhi, passoReduzido);
+      funcao->setOperando(novoPhi, indicePre, inicioReduzido);
+      funcao->setOperando(novoPhi, indiceRetorno, proximo);
+
+      substituto[id] = novoPhi;
+      funcao->instrucoes[id].op = OpIR::REMOVIDA;
+      reducoesDeForca++;
+      reduziu = true;
+    }
+
+    if (reduziu)
+    {
+      vector<uint32_t> vivas;
+      for (uint32_t id : funcao->blocos[b].instrucoes)
+      {
+        if (funcao->instrucoes[id].op != OpIR::REMOVIDA)
+        {
+          vivas.push_back(id);
+        }
+      }
+      funcao->blocos[b].instrucoes.swap(vivas);
+    }
+  }
+}
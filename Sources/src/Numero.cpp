@@ -0,0 +1,99 @@
+#include "Numero.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+bool converterInteiro(const char *texto, size_t tamanho, int64_t &resultado)
+{
+  uint64_t valor = 0;
+  for (size_t i = 0; i < tamanho; i++)
+  {
+    uint64_t digito = texto[i] - '0';
+    if (valor > (uint64_t(INT64_MAX) - digito) / 10)
+    {
+      return false;
+    }
+    valor = valor * 10 + digito;
+  }
+  resultado = int64_t(valor);
+  return true;
+}
+
+bool converterReal(const char *texto, size_t tamanho, double &resultado)
+{
+  // Caminho rápido (Clinger): se a mantissa cabe em 53 bits e o expoente
+  // decimal é no máximo 22, mantissa / 10^n é exata com uma única divisão
+  static const double potencias[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  uint64_t mantissa = 0;
+  int digitos = 0;
+  int casasDecimais = 0;
+  bool aposPonto = false;
+  bool rapido = true;
+
+  for (size_t i = 0; i < tamanho; i++)
+  {
+    char c = texto[i];
+    if (c == '.')
+    {
+      aposPonto = true;
+      continue;
+    }
+    if (digitos == 0 && c == '0' && !aposPonto)
+    {
+      continue; // zeros à esquerda não contam
+    }
+    if (++digitos > 19)
+    {
+      rapido = false;
+      break;
+    }
+    mantissa = mantissa * 10 + (c - '0');
+    if (aposPonto)
+    {
+      casasDecimais++;
+    }
+  }
+
+  if (rapido && mantissa < (uint64_t(1) << 53) && casasDecimais <= 22)
+  {
+    resultado = double(mantissa) / potencias[casasDecimais];
+    return true;
+  }
+
+  // Caminho lento: strtod exige texto terminado em '\0'
+  char buffer[128];
+  if (tamanho < sizeof(buffer))
+  {
+    memcpy(buffer, texto, tamanho);
+    buffer[tamanho] = '\0';
+    resultado = strtod(buffer, nullptr);
+  }
+  else
+  {
+    resultado = strtod(string(texto, tamanho).c_str(), nullptr);
+  }
+  return std::isfinite(resultado);
+}
+
+string formatarReal(double valor)
+{
+  char buffer[32];
+  for (int precisao = 15; precisao <= 17; precisao++)
+  {
+    snprintf(buffer, sizeof(buffer), "%.*g", precisao, valor);
+    if (strtod(buffer, nullptr) == valor)
+    {
+      break;
+    }
+  }
+  string texto = buffer;
+  if (texto.find_first_of(".eni") == string::npos)
+  {
+    texto += ".0";
+  }
+  return texto;
+}
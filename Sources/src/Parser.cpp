@@ -5,28 +5,114 @@ T  -> IDENTIFICADOR | NUMERO_INTEIRO
 */
 #include "Parser.h"
 #include "AST.h"
+#include "Lexer.h"
+#include "Numero.h"
 #include <iostream>
 #include <stdexcept>
 #include <sstream>
+#include <thread>
 using namespace std;
 
-Parser::Parser(vector<Token> tokens)
-    : tokens(tokens),
-      posicao_atual(0),
-      token_atual(tokens.empty() ? Token(TipoDeToken::DESCONHECIDO, "") : tokens[0])
+namespace
 {
+  const FluxoDeTokens semTokens;
+  const size_t CAPACIDADE_DO_ANEL = 1 << 16;
+  // Tokens copiados do anel de cada vez e tokens já lidos que a janela
+  // acumula antes de descartá-los
+  const size_t LOTE_DA_JANELA = 4096;
+}
+
+Parser::Parser()
+    : tokens(&semTokens),
+      anel(nullptr),
+      base(0),
+      posicao_atual(0)
+{
+}
+
+Parser::Parser(const FluxoDeTokens &tokens)
+{
+  reset(tokens);
+}
+
+void Parser::reset(const FluxoDeTokens &tokens)
+{
+  this->tokens = &tokens;
+  anel = nullptr;
+  base = 0;
+  posicao_atual = 0;
+  token_atual = tokens.empty() ? Token() : tokens[0];
+}
+
+ProgramNode *Parser::analisarEmPipeline(Lexer &lexer)
+{
+  AnelDeTokens canal(CAPACIDADE_DO_ANEL);
+  thread produtor([&lexer, &canal]()
+                  { lexer.AnalisarParaAnel(canal); });
+
+  janela.reiniciar(&lexer.getCodigo());
+  tokens = &janela;
+  anel = &canal;
+  base = 0;
+  posicao_atual = -1;
+  ProgramNode *ast = nullptr;
+  string erroSintatico;
+  try
+  {
+    avancar();
+    ast = parseProgram();
+  }
+  catch (exception &e)
+  {
+    erroSintatico = e.what();
+  }
+  // O Lexer vai até o fim, como na análise sequencial, para que um erro
+  // léxico mais adiante seja o erro informado
+  while (canal.receber(janela, LOTE_DA_JANELA) > 0)
+  {
+    janela.reiniciar(&lexer.getCodigo());
+  }
+  produtor.join();
+  reset(semTokens);
+
+  if (!canal.getErro().empty())
+  {
+    delete ast;
+    throw runtime_error(canal.getErro());
+  }
+  if (!erroSintatico.empty())
+  {
+    throw runtime_error(erroSintatico);
+  }
+  return ast;
 }
 
 void Parser::avancar()
 {
   posicao_atual++;
-  if (posicao_atual < tokens.size())
+  size_t indice = posicao_atual - base;
+  while (anel && indice >= tokens->size() && anel->receber(janela, LOTE_DA_JANELA) > 0)
   {
-    token_atual = tokens[posicao_atual];
+  }
+  if (indice < tokens->size())
+  {
+    token_atual = (*tokens)[indice];
   }
   else
   {
-    token_atual = Token(TipoDeToken::DESCONHECIDO, "");
+    token_atual = Token();
+  }
+}
+
+// Na análise em pipeline, esquece os tokens antes do atual. Só é chamada no
+// início de um statement ou declaração, quando nenhuma análise que volta
+// atrás (isInicioDeFuncao, atribuição a array, for) está em andamento
+void Parser::descartarLidos()
+{
+  if (anel && static_cast<size_t>(posicao_atual - base) >= LOTE_DA_JANELA)
+  {
+    janela.descartarInicio(posicao_atual - base);
+    base = posicao_atual;
   }
 }
 
@@ -40,17 +126,17 @@ bool Parser::isTipo(const Token &token)
 {
   if (token.getTipo() == TipoDeToken::PALAVRA_RESERVADA)
   {
-    return token.getLexema() == "int" ||
-           token.getLexema() == "double" ||
-           token.getLexema() == "string";
+    return token.isLexema("int") ||
+           token.isLexema("double") ||
+           token.isLexema("string");
   }
   return false;
 }
 
-bool Parser::isPalavraReservada(const string &palavra)
+bool Parser::isPalavraReservada(const char *palavra)
 {
   return token_atual.getTipo() == TipoDeToken::PALAVRA_RESERVADA &&
-         token_atual.getLexema() == palavra;
+         token_atual.isLexema(palavra);
 }
 
 ProgramNode *Parser::analisar()
@@ -64,26 +150,11 @@ ProgramNode *Parser::parseProgram()
 
   while (token_atual.getTipo() != TipoDeToken::DESCONHECIDO)
   {
+    descartarLidos();
     // Verifica se é uma função (tipo seguido de identificador e parênteses)
     if (isTipo(token_atual))
     {
-      int saved_pos = posicao_atual;
-      Token saved_token = token_atual;
-
-      avancar();
-      bool isFunction = false;
-      if (token_atual.getTipo() == TipoDeToken::IDENTIFICADOR ||
-          token_atual.getTipo() == TipoDeToken::PALAVRA_RESERVADA)
-      {
-        avancar();
-        if (token_atual.getTipo() == TipoDeToken::ABRE_PARENTESES)
-        {
-          isFunction = true;
-        }
-      }
-
-      posicao_atual = saved_pos;
-      token_atual = saved_token;
+      bool isFunction = isInicioDeFuncao();
 
       if (isFunction)
       {
@@ -97,8 +168,9 @@ ProgramNode *Parser::parseProgram()
         vector<StatementNode *> statements;
         while (token_atual.getTipo() != TipoDeToken::DESCONHECIDO)
         {
-          if (isTipo(token_atual))
+          if (isTipo(token_atual) && !isInicioDeFuncao())
           {
+            descartarLidos();
             statements.push_back(parseVariableDeclaration());
           }
           else
@@ -144,6 +216,29 @@ ProgramNode *Parser::parseProgram()
   return new ProgramNode(functions);
 }
 
+bool Parser::isInicioDeFuncao()
+{
+  // Olha adiante sem consumir: TIPO (IDENTIFICADOR | PALAVRA_RESERVADA) "("
+  int saved_pos = posicao_atual;
+  Token saved_token = token_atual;
+
+  avancar();
+  bool isFunction = false;
+  if (token_atual.getTipo() == TipoDeToken::IDENTIFICADOR ||
+      token_atual.getTipo() == TipoDeToken::PALAVRA_RESERVADA)
+  {
+    avancar();
+    if (token_atual.getTipo() == TipoDeToken::ABRE_PARENTESES)
+    {
+      isFunction = true;
+    }
+  }
+
+  posicao_atual = saved_pos;
+  token_atual = saved_token;
+  return isFunction;
+}
+
 FunctionNode *Parser::parseFunction()
 {
   // TIPO IDENTIFICADOR "(" ParamList? ")" Block
@@ -250,6 +345,7 @@ BlockNode *Parser::parseBlock()
 StatementNode *Parser::parseStatement()
 {
   // Statement -> VariableDeclaration | Assignment | IfStatement | WhileStatement | ForStatement | ReturnStatement | ExpressionStatement
+  descartarLidos();
 
   if (isTipo(token_atual))
   {
@@ -281,8 +377,8 @@ StatementNode *Parser::parseStatement()
     if (token_atual.getTipo() == TipoDeToken::ABRE_COLCHETES)
     {
       // É acesso a array - pode ser atribuição a array
-      avancar();         // consome [
-      parseExpression(); // consome índice
+      avancar();                // consome [
+      delete parseExpression(); // consome índice
       if (token_atual.getTipo() != TipoDeToken::FECHA_COLCHETES)
       {
         erro("Esperado ']'");
@@ -343,7 +439,7 @@ StatementNode *Parser::parseStatement()
 
 VariableDeclarationNode *Parser::parseVariableDeclaration()
 {
-  // TIPO IDENTIFICADOR ("=" Expression)? ("," IDENTIFICADOR ("=" Expression)?)* ";"
+  // TIPO IDENTIFICADOR ("[" NUMERO_INTEIRO "]")? ("=" Expression)? ("," IDENTIFICADOR ("=" Expression)?)* ";"
   if (!isTipo(token_atual))
   {
     erro("Esperado tipo para declaracao de variavel");
@@ -358,6 +454,24 @@ VariableDeclarationNode *Parser::parseVariableDeclaration()
   string name = token_atual.getLexema();
   avancar();
 
+  // "[" NUMERO_INTEIRO "]": array de tamanho fixo
+  int64_t arraySize = -1;
+  if (token_atual.getTipo() == TipoDeToken::ABRE_COLCHETES)
+  {
+    avancar();
+    if (token_atual.getTipo() != TipoDeToken::NUMERO_INTEIRO ||
+        !converterInteiro(token_atual.getTexto(), token_atual.getTamanho(), arraySize))
+    {
+      erro("Esperado tamanho inteiro do array");
+    }
+    avancar();
+    if (token_atual.getTipo() != TipoDeToken::FECHA_COLCHETES)
+    {
+      erro("Esperado ']' apos tamanho do array");
+    }
+    avancar();
+  }
+
   ExpressionNode *initialValue = nullptr;
   if (token_atual.getTipo() == TipoDeToken::OPERADOR_ATRIBUICAO)
   {
@@ -389,7 +503,7 @@ VariableDeclarationNode *Parser::parseVariableDeclaration()
   }
   avancar();
 
-  return new VariableDeclarationNode(type, name, initialValue);
+  return new VariableDeclarationNode(type, name, initialValue, arraySize);
 }
 
 StatementNode *Parser::parseAssignment()
@@ -402,10 +516,11 @@ StatementNode *Parser::parseAssignment()
   string name = token_atual.getLexema();
   avancar();
 
+  ExpressionNode *index = nullptr;
   if (token_atual.getTipo() == TipoDeToken::ABRE_COLCHETES)
   {
     avancar();
-    parseExpression(); // Parseia a expressão do índice
+    index = parseExpression();
     if (token_atual.getTipo() != TipoDeToken::FECHA_COLCHETES)
     {
       erro("Esperado ']' apos indice do array");
@@ -427,7 +542,7 @@ StatementNode *Parser::parseAssignment()
   }
   avancar();
 
-  return new AssignmentNode(name, value);
+  return new AssignmentNode(name, value, index);
 }
 
 StatementNode *Parser::parseIf()
@@ -673,9 +788,9 @@ ExpressionNode *Parser::parseExpression()
   // Processar operadores relacionais e lógicos
   while (token_atual.getTipo() == TipoDeToken::OPERADOR_RELACIONAL ||
          token_atual.getTipo() == TipoDeToken::OPERADOR_LOGICO ||
-         (token_atual.getTipo() == TipoDeToken::OPERADOR_ATRIBUICAO && token_atual.getLexema() == "==") ||
+         (token_atual.getTipo() == TipoDeToken::OPERADOR_ATRIBUICAO && token_atual.isLexema("==")) ||
          (token_atual.getTipo() == TipoDeToken::OPERADOR_RELACIONAL &&
-          (token_atual.getLexema() == "==" || token_atual.getLexema() == "!=")))
+          (token_atual.isLexema("==") || token_atual.isLexema("!="))))
   {
     string op = token_atual.getLexema();
     avancar();
@@ -697,7 +812,7 @@ ExpressionNode *Parser::E()
 ExpressionNode *Parser::ELinha(ExpressionNode *left)
 {
   if (token_atual.getTipo() == TipoDeToken::OPERADOR_ARITMETICO &&
-      (token_atual.getLexema() == "+" || token_atual.getLexema() == "-"))
+      (token_atual.isLexema("+") || token_atual.isLexema("-")))
   {
     string op = token_atual.getLexema();
     avancar();
@@ -719,7 +834,7 @@ ExpressionNode *Parser::T()
 ExpressionNode *Parser::TLinha(ExpressionNode *left)
 {
   if (token_atual.getTipo() == TipoDeToken::OPERADOR_ARITMETICO &&
-      (token_atual.getLexema() == "*" || token_atual.getLexema() == "/"))
+      (token_atual.isLexema("*") || token_atual.isLexema("/")))
   {
     string op = token_atual.getLexema();
     avancar();
@@ -734,7 +849,7 @@ ExpressionNode *Parser::TLinha(ExpressionNode *left)
 ExpressionNode *Parser::F()
 {
   // Operadores unários (pré-fixos)
-  if (token_atual.getTipo() == TipoDeToken::OPERADOR_LOGICO && token_atual.getLexema() == "!")
+  if (token_atual.getTipo() == TipoDeToken::OPERADOR_LOGICO && token_atual.isLexema("!"))
   {
     string op = token_atual.getLexema();
     avancar();
@@ -815,12 +930,12 @@ ExpressionNode *Parser::F()
       if (token_atual.getTipo() == TipoDeToken::INCREMENTO)
       {
         avancar();
-        return new UnaryOpNode("++", new IdentifierNode(name));
+        return new UnaryOpNode("++", new IdentifierNode(name), true);
       }
       else if (token_atual.getTipo() == TipoDeToken::DECREMENTO)
       {
         avancar();
-        return new UnaryOpNode("--", new IdentifierNode(name));
+        return new UnaryOpNode("--", new IdentifierNode(name), true);
       }
       else
       {
@@ -828,18 +943,33 @@ ExpressionNode *Parser::F()
       }
     }
   }
-  else if (token_atual.getTipo() == TipoDeToken::NUMERO_INTEIRO ||
-           token_atual.getTipo() == TipoDeToken::NUMERO_REAL)
+  else if (token_atual.getTipo() == TipoDeToken::NUMERO_INTEIRO)
   {
-    string value = token_atual.getLexema();
+    // O lexema é convertido uma única vez aqui, direto do código-fonte; a
+    // AST guarda o valor nativo
+    int64_t value;
+    if (!converterInteiro(token_atual.getTexto(), token_atual.getTamanho(), value))
+    {
+      erro("Literal inteiro fora do intervalo de int");
+    }
+    avancar();
+    return new IntLiteralNode(value);
+  }
+  else if (token_atual.getTipo() == TipoDeToken::NUMERO_REAL)
+  {
+    double value;
+    if (!converterReal(token_atual.getTexto(), token_atual.getTamanho(), value))
+    {
+      erro("Literal real fora do intervalo de double");
+    }
     avancar();
-    return new LiteralNode(value);
+    return new RealLiteralNode(value);
   }
   else if (token_atual.getTipo() == TipoDeToken::STRING)
   {
     string value = token_atual.getLexema();
     avancar();
-    return new LiteralNode(value);
+    return new StringLiteralNode(value);
   }
   else
   {
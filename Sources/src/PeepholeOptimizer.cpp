@@ -0,0 +1,194 @@
+#include "PeepholeOptimizer.h"
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+namespace
+{
+  bool isComparacaoInteira(OpBC op)
+  {
+    return op >= OpBC::LT_INT && op <= OpBC::NE_INT;
+  }
+
+  // Quantas vezes o perfil viu a sequência: o par menos frequente dela
+  uint64_t frequencia(const PerfilBC &perfil, const vector<OpBC> &sequencia)
+  {
+    uint64_t menor = UINT64_MAX;
+    for (size_t i = 0; i + 1 < sequencia.size(); i++)
+    {
+      menor = min(menor, perfil.getContagem(sequencia[i], sequencia[i + 1]));
+    }
+    return menor;
+  }
+}
+
+PeepholeOptimizer::PeepholeOptimizer(const PerfilBC *perfil, double limiar) : fusoes(0), removidas(0)
+{
+  vector<pair<uint64_t, OpBC>> candidatas;
+  if (perfil)
+  {
+    uint64_t comparacoes = 0;
+    for (int op = int(OpBC::LT_INT); op <= int(OpBC::NE_INT); op++)
+    {
+      comparacoes += perfil->getContagem(OpBC(op), OpBC::JUMP_IF_FALSE);
+    }
+    candidatas.push_back(make_pair(frequencia(*perfil, {OpBC::LOAD_LOCAL, OpBC::LOAD_LOCAL, OpBC::ADD_INT}), OpBC::ADD_INT_LL));
+    candidatas.push_back(make_pair(frequencia(*perfil, {OpBC::LOAD_LOCAL, OpBC::CONST, OpBC::ADD_INT, OpBC::STORE_LOCAL}) +
+                                       frequencia(*perfil, {OpBC::LOAD_LOCAL, OpBC::CONST, OpBC::SUB_INT, OpBC::STORE_LOCAL}),
+                                   OpBC::INC_LOCAL));
+    candidatas.push_back(make_pair(comparacoes, OpBC::JUMP_IF_NOT_CMP));
+    candidatas.push_back(make_pair(perfil->getContagem(OpBC::LOAD_LOCAL, OpBC::LOAD_ELEM) +
+                                       perfil->getContagem(OpBC::LOAD_LOCAL, OpBC::LOAD_ELEM_NC),
+                                   OpBC::LOAD_ELEM_L));
+    candidatas.push_back(make_pair(perfil->getContagem(OpBC::LOAD_LOCAL, OpBC::LOAD_LOCAL), OpBC::LOAD_LOCAL_2));
+    candidatas.push_back(make_pair(perfil->getContagem(OpBC::LOAD_LOCAL, OpBC::CONST), OpBC::LOAD_LOCAL_CONST));
+    stable_sort(candidatas.begin(), candidatas.end(), [](const pair<uint64_t, OpBC> &a, const pair<uint64_t, OpBC> &b)
+                { return a.first > b.first; });
+    uint64_t minimo = uint64_t(limiar * perfil->getTotal());
+    for (auto &candidata : candidatas)
+    {
+      if (candidata.first > 0 && candidata.first >= minimo)
+      {
+        habilitadas.push_back(candidata.second);
+      }
+    }
+  }
+  else
+  {
+    habilitadas = {OpBC::ADD_INT_LL, OpBC::INC_LOCAL, OpBC::JUMP_IF_NOT_CMP, OpBC::LOAD_ELEM_L, OpBC::LOAD_LOCAL_2,
+                   OpBC::LOAD_LOCAL_CONST};
+  }
+}
+
+bool PeepholeOptimizer::isHabilitada(OpBC super) const
+{
+  return find(habilitadas.begin(), habilitadas.end(), super) != habilitadas.end();
+}
+
+void PeepholeOptimizer::otimizar(ProgramaBC *programa)
+{
+  int totalFusoes = 0, totalRemovidas = 0;
+  for (FuncaoBC &funcao : programa->funcoes)
+  {
+    otimizarFuncao(funcao);
+    totalFusoes += fusoes;
+    totalRemovidas += removidas;
+  }
+  fusoes = totalFusoes;
+  removidas = totalRemovidas;
+}
+
+void PeepholeOptimizer::otimizarFuncao(FuncaoBC &funcao)
+{
+  fusoes = 0;
+  removidas = 0;
+  vector<InstrucaoBC> &codigo = funcao.codigo;
+  vector<bool> destinos(codigo.size() + 1, false);
+  for (const InstrucaoBC &ins : codigo)
+  {
+    if (isSaltoBC(ins.op))
+    {
+      destinos[ins.a] = true;
+    }
+  }
+
+  vector<InstrucaoBC> saida;
+  vector<int> novoIndice(codigo.size() + 1, -1);
+  for (size_t i = 0; i < codigo.size();)
+  {
+    novoIndice[i] = saida.size();
+    int consumidas = fundir(funcao, i, destinos, saida);
+    if (consumidas == 0)
+    {
+      saida.push_back(codigo[i]);
+      consumidas = 1;
+    }
+    else
+    {
+      fusoes++;
+      removidas += consumidas - 1;
+    }
+    i += consumidas;
+  }
+  novoIndice[codigo.size()] = saida.size();
+
+  // Destinos de salto nunca ficam no meio de uma sequência fundida
+  for (InstrucaoBC &ins : saida)
+  {
+    if (isSaltoBC(ins.op))
+    {
+      ins.a = novoIndice[ins.a];
+    }
+  }
+  codigo = saida;
+}
+
+int PeepholeOptimizer::fundir(FuncaoBC &funcao, size_t i, const vector<bool> &destinos, vector<InstrucaoBC> &saida)
+{
+  const vector<InstrucaoBC> &codigo = funcao.codigo;
+  // A sequência de n instruções a partir de i existe e só a primeira pode
+  // ser destino de salto
+  auto disponivel = [&](size_t n)
+  {
+    if (i + n > codigo.size())
+      return false;
+    for (size_t k = i + 1; k < i + n; k++)
+    {
+      if (destinos[k])
+        return false;
+    }
+    return true;
+  };
+  auto op = [&](size_t k)
+  { return codigo[i + k].op; };
+
+  if (isHabilitada(OpBC::INC_LOCAL) && disponivel(4) && op(0) == OpBC::LOAD_LOCAL && op(1) == OpBC::CONST &&
+      (op(2) == OpBC::ADD_INT || op(2) == OpBC::SUB_INT) && op(3) == OpBC::STORE_LOCAL && codigo[i].a == codigo[i + 3].a)
+  {
+    const Valor &k = funcao.constantes[codigo[i + 1].a];
+    if (k.tipo == TipoDeDado::INT && k.inteiro > INT32_MIN && k.inteiro <= INT32_MAX)
+    {
+      int32_t incremento = op(2) == OpBC::ADD_INT ? int32_t(k.inteiro) : -int32_t(k.inteiro);
+      saida.push_back(InstrucaoBC(OpBC::INC_LOCAL, codigo[i].a, incremento));
+      return 4;
+    }
+  }
+  if (isHabilitada(OpBC::ADD_INT_LL) && disponivel(3) && op(0) == OpBC::LOAD_LOCAL && op(1) == OpBC::LOAD_LOCAL &&
+      op(2) == OpBC::ADD_INT)
+  {
+    saida.push_back(InstrucaoBC(OpBC::ADD_INT_LL, codigo[i].a, codigo[i + 1].a));
+    return 3;
+  }
+  if (isHabilitada(OpBC::JUMP_IF_NOT_CMP) && disponivel(2) && isComparacaoInteira(op(0)) && op(1) == OpBC::JUMP_IF_FALSE)
+  {
+    saida.push_back(InstrucaoBC(OpBC::JUMP_IF_NOT_CMP, codigo[i + 1].a, int32_t(op(0))));
+    return 2;
+  }
+  // load @i; load_elem @a com o array também local (b = 0 em load_elem)
+  // a partir da instrução i + k
+  auto acessoLocal = [&](size_t k)
+  {
+    return isHabilitada(OpBC::LOAD_ELEM_L) && disponivel(k + 2) && op(k) == OpBC::LOAD_LOCAL &&
+           (op(k + 1) == OpBC::LOAD_ELEM || op(k + 1) == OpBC::LOAD_ELEM_NC) && codigo[i + k + 1].b == 0;
+  };
+  if (acessoLocal(0))
+  {
+    OpBC super = op(1) == OpBC::LOAD_ELEM ? OpBC::LOAD_ELEM_L : OpBC::LOAD_ELEM_L_NC;
+    saida.push_back(InstrucaoBC(super, codigo[i + 1].a, codigo[i].a));
+    return 2;
+  }
+  // Em "load; load @i; load_elem @a" o segundo load fica para o acesso
+  if (isHabilitada(OpBC::LOAD_LOCAL_2) && disponivel(2) && op(0) == OpBC::LOAD_LOCAL && op(1) == OpBC::LOAD_LOCAL &&
+      !acessoLocal(1))
+  {
+    saida.push_back(InstrucaoBC(OpBC::LOAD_LOCAL_2, codigo[i].a, codigo[i + 1].a));
+    return 2;
+  }
+  if (isHabilitada(OpBC::LOAD_LOCAL_CONST) && disponivel(2) && op(0) == OpBC::LOAD_LOCAL && op(1) == OpBC::CONST)
+  {
+    saida.push_back(InstrucaoBC(OpBC::LOAD_LOCAL_CONST, codigo[i].a, codigo[i + 1].a));
+    return 2;
+  }
+  return 0;
+}
@@ -0,0 +1,501 @@
+#include "RegisterAllocator.h"
+#include "Dataflow.h"
+#include "SSA.h"
+#include <algorithm>
+#include <climits>
+#include <sstream>
+
+using namespace std;
+
+namespace
+{
+  // Ordem de preferência: primeiro os não preservados entre chamadas, que
+  // não exigem salvar nada no prólogo
+  const char *const NOMES_INTEIROS[NUM_REGISTRADORES_INTEIROS] = {"rsi", "r8", "r9", "r10", "r11", "rbx", "r12", "r13", "r14", "r15"};
+  const int CODIGOS_INTEIROS[NUM_REGISTRADORES_INTEIROS] = {6, 8, 9, 10, 11, 3, 12, 13, 14, 15};
+
+  // A profundidade de laço pesa o custo de spill até este limite
+  const int PROFUNDIDADE_MAXIMA = 6;
+
+  double pesoDaProfundidade(int profundidade)
+  {
+    double peso = 1;
+    for (int i = 0; i < min(profundidade, PROFUNDIDADE_MAXIMA); i++)
+    {
+      peso *= 10;
+    }
+    return peso;
+  }
+
+  bool isConstante(OpIR op)
+  {
+    return op == OpIR::CONST_INT || op == OpIR::CONST_REAL || op == OpIR::CONST_STRING;
+  }
+}
+
+ClasseRegistrador classeDoTipo(TipoDeDado tipo)
+{
+  return tipo == TipoDeDado::DOUBLE ? ClasseRegistrador::REAL : ClasseRegistrador::INTEIRO;
+}
+
+string nomeDoRegistrador(ClasseRegistrador classe, int registrador)
+{
+  if (classe == ClasseRegistrador::INTEIRO)
+  {
+    return NOMES_INTEIROS[registrador];
+  }
+  return "xmm" + to_string(registrador);
+}
+
+int codigoDoRegistrador(ClasseRegistrador classe, int registrador)
+{
+  return classe == ClasseRegistrador::INTEIRO ? CODIGOS_INTEIROS[registrador] : registrador;
+}
+
+RegisterAllocator::RegisterAllocator(size_t limiteDeBits)
+    : limiteDeBits(limiteDeBits), emRegistrador(0), naPilha(0), funcoesNoModoRapido(0) {}
+
+vector<Alocacao> RegisterAllocator::alocar(ProgramaIR *programa)
+{
+  emRegistrador = 0;
+  naPilha = 0;
+  funcoesNoModoRapido = 0;
+  vector<Alocacao> alocacoes;
+  for (auto f : programa->funcoes)
+  {
+    alocacoes.push_back(alocarFuncao(*f));
+  }
+  return alocacoes;
+}
+
+// Numera as instruções na ordem linear dos blocos, em posições pares. O fim
+// de um bloco é a posição ímpar depois do terminador: é onde ficam as cópias
+// dos PHIs dos sucessores, e onde os seus operandos são usados.
+void RegisterAllocator::calcularPosicoes(const FuncaoIR &funcao, const vector<int> &ordem, vector<int> &posicao, vector<int> &inicioDoBloco, vector<int> &fimDoBloco)
+{
+  posicao.assign(funcao.instrucoes.size(), -1);
+  inicioDoBloco.assign(funcao.blocos.size(), -1);
+  fimDoBloco.assign(funcao.blocos.size(), -1);
+  int proxima = 0;
+  for (int b : ordem)
+  {
+    inicioDoBloco[b] = proxima;
+    for (uint32_t id : funcao.blocos[b].instrucoes)
+    {
+      posicao[id] = proxima;
+      proxima += 2;
+    }
+    fimDoBloco[b] = proxima - 1;
+  }
+}
+
+// Profundidade de laço de cada bloco, pelos laços naturais das arestas de
+// retorno; fimDoLaco recebe, para cada cabeçalho, a última posição do laço
+vector<int> RegisterAllocator::calcularProfundidades(FuncaoIR &funcao, vector<int> &fimDoLaco, const vector<int> &fimDoBloco)
+{
+  size_t numBlocos = funcao.blocos.size();
+  vector<int> profundidade(numBlocos, 0);
+  vector<vector<bool>> corpo(numBlocos);
+  fimDoLaco.assign(numBlocos, -1);
+  calcularDominadores(funcao);
+
+  for (size_t b = 0; b < numBlocos; b++)
+  {
+    if (fimDoBloco[b] < 0)
+    {
+      continue;
+    }
+    for (int h : funcao.blocos[b].sucessores)
+    {
+      if (!domina(funcao, h, b))
+      {
+        continue;
+      }
+      // Corpo do laço: blocos que alcançam b sem passar por h
+      if (corpo[h].empty())
+      {
+        corpo[h].assign(numBlocos, false);
+        corpo[h][h] = true;
+      }
+      vector<int> pilha;
+      if (!corpo[h][b])
+      {
+        corpo[h][b] = true;
+        pilha.push_back(b);
+      }
+      while (!pilha.empty())
+      {
+        int x = pilha.back();
+        pilha.pop_back();
+        for (int p : funcao.blocos[x].predecessores)
+        {
+          if (!corpo[h][p] && fimDoBloco[p] >= 0)
+          {
+            corpo[h][p] = true;
+            pilha.push_back(p);
+          }
+        }
+      }
+    }
+  }
+
+  for (size_t h = 0; h < numBlocos; h++)
+  {
+    for (size_t b = 0; b < corpo[h].size(); b++)
+    {
+      if (corpo[h][b])
+      {
+        profundidade[b]++;
+        fimDoLaco[h] = max(fimDoLaco[h], fimDoBloco[b]);
+      }
+    }
+  }
+  return profundidade;
+}
+
+Alocacao RegisterAllocator::alocarFuncao(FuncaoIR &funcao)
+{
+  size_t numValores = funcao.instrucoes.size();
+  size_t numBlocos = funcao.blocos.size();
+  Alocacao alocacao;
+  alocacao.registrador.assign(numValores, -1);
+  alocacao.slotDePilha.assign(numValores, -1);
+  alocacao.ordemDosBlocos = funcao.ordemReversaPosOrdem();
+  alocacao.modoRapido = numValores * numBlocos > limiteDeBits;
+  const vector<int> &ordem = alocacao.ordemDosBlocos;
+
+  vector<int> posicao, inicioDoBloco, fimDoBloco, fimDoLaco;
+  calcularPosicoes(funcao, ordem, posicao, inicioDoBloco, fimDoBloco);
+  vector<int> profundidade = calcularProfundidades(funcao, fimDoLaco, fimDoBloco);
+
+  // Definições e usos: início e fim de cada intervalo e o custo de spill
+  vector<int> inicio(numValores, INT_MAX), fim(numValores, -1);
+  vector<double> custo(numValores, 0);
+  vector<int> chamadas;
+  auto estender = [&](uint32_t valor, int p)
+  {
+    inicio[valor] = min(inicio[valor], p);
+    fim[valor] = max(fim[valor], p);
+  };
+  for (int b : ordem)
+  {
+    const BlocoIR &bloco = funcao.blocos[b];
+    double peso = pesoDaProfundidade(profundidade[b]);
+    for (uint32_t id : bloco.instrucoes)
+    {
+      const InstrucaoIR &ins = funcao.instrucoes[id];
+      int p = posicao[id];
+      if (ins.tipo != TipoDeDado::VOID)
+      {
+        estender(id, p);
+        custo[id] += isConstante(ins.op) ? 0 : peso;
+      }
+      if (ins.op == OpIR::CALL || ins.op == OpIR::CALL_BUILTIN)
+      {
+        chamadas.push_back(p);
+      }
+      for (uint32_t k = 0; k < ins.numOperandos; k++)
+      {
+        uint32_t v = funcao.operando(id, k);
+        if (ins.op == OpIR::PHI)
+        {
+          int pred = bloco.predecessores[k];
+          estender(v, fimDoBloco[pred]);
+          custo[v] += pesoDaProfundidade(profundidade[pred]);
+        }
+        else
+        {
+          estender(v, p);
+          custo[v] += peso;
+        }
+      }
+    }
+  }
+
+  if (!alocacao.modoRapido)
+  {
+    AnaliseDeVivacidade vivacidade(funcao);
+    vivacidade.executar();
+    for (int b : ordem)
+    {
+      vivacidade.getVivasNaEntrada(b).paraCada([&](size_t v)
+                                               { estender(v, inicioDoBloco[b]); });
+      vivacidade.getVivasNaSaida(b).paraCada([&](size_t v)
+                                             { estender(v, fimDoBloco[b]); });
+    }
+  }
+  else
+  {
+    // Um valor definido antes de um laço e vivo no seu cabeçalho fica vivo
+    // no laço inteiro. Cabeçalhos internos primeiro; repete-se até
+    // estabilizar porque um laço interno pode estender o valor para dentro
+    // de um externo
+    vector<int> cabecalhos;
+    for (size_t h = 0; h < numBlocos; h++)
+    {
+      if (fimDoLaco[h] >= 0)
+      {
+        cabecalhos.push_back(h);
+      }
+    }
+    sort(cabecalhos.begin(), cabecalhos.end(), [&](int a, int b)
+         { return inicioDoBloco[a] > inicioDoBloco[b]; });
+    bool mudou = true;
+    while (mudou)
+    {
+      mudou = false;
+      for (size_t v = 0; v < numValores; v++)
+      {
+        for (int h : cabecalhos)
+        {
+          if (inicio[v] < inicioDoBloco[h] && fim[v] >= inicioDoBloco[h] && fim[v] < fimDoLaco[h])
+          {
+            fim[v] = fimDoLaco[h];
+            mudou = true;
+          }
+        }
+      }
+    }
+  }
+
+  vector<Intervalo> intervalos;
+  for (size_t v = 0; v < numValores; v++)
+  {
+    if (fim[v] < 0 || funcao.instrucoes[v].tipo == TipoDeDado::VOID)
+    {
+      continue;
+    }
+    Intervalo intervalo;
+    intervalo.valor = v;
+    intervalo.inicio = inicio[v];
+    intervalo.fim = fim[v];
+    intervalo.classe = classeDoTipo(funcao.instrucoes[v].tipo);
+    intervalo.custo = custo[v];
+    auto c = upper_bound(chamadas.begin(), chamadas.end(), inicio[v]);
+    intervalo.cruzaChamada = c != chamadas.end() && *c < fim[v];
+    intervalos.push_back(intervalo);
+  }
+
+  varrer(intervalos, alocacao.modoRapido, alocacao);
+  emRegistrador += alocacao.emRegistrador;
+  naPilha += alocacao.naPilha;
+  funcoesNoModoRapido += alocacao.modoRapido;
+  return alocacao;
+}
+
+void RegisterAllocator::varrer(vector<Intervalo> &intervalos, bool modoRapido, Alocacao &alocacao)
+{
+  sort(intervalos.begin(), intervalos.end(), [](const Intervalo &a, const Intervalo &b)
+       { return a.inicio != b.inicio ? a.inicio < b.inicio : a.valor < b.valor; });
+
+  // Por classe: intervalos com registrador ainda vivos e registradores ocupados
+  vector<const Intervalo *> ativos[2];
+  vector<bool> ocupado[2] = {vector<bool>(NUM_REGISTRADORES_INTEIROS, false), vector<bool>(NUM_REGISTRADORES_REAIS, false)};
+  // Slots da pilha em uso e livres, com o fim do intervalo que os ocupa (ou
+  // ocupou por último)
+  vector<pair<int, int>> pilhaAtiva;
+  vector<pair<int, int>> slotsLivres;
+
+  auto peso = [](const Intervalo &intervalo)
+  { return intervalo.custo / (intervalo.fim - intervalo.inicio + 1); };
+  // Um slot livre só serve se o seu último ocupante terminou antes do início
+  // do intervalo: quem é tirado de um registrador começou antes do intervalo
+  // atual e já estava vivo quando slots liberados agora ainda estavam ocupados
+  auto paraPilha = [&](const Intervalo &intervalo)
+  {
+    int slot = -1;
+    for (size_t i = slotsLivres.size(); i-- > 0;)
+    {
+      if (slotsLivres[i].first < intervalo.inicio)
+      {
+        slot = slotsLivres[i].second;
+        slotsLivres.erase(slotsLivres.begin() + i);
+        break;
+      }
+    }
+    if (slot < 0)
+    {
+      slot = alocacao.numSlotsDePilha++;
+    }
+    alocacao.slotDePilha[intervalo.valor] = slot;
+    pilhaAtiva.push_back(make_pair(intervalo.fim, slot));
+  };
+
+  for (const Intervalo &atual : intervalos)
+  {
+    // Libera registradores e slots de intervalos que já terminaram
+    for (int c = 0; c < 2; c++)
+    {
+      for (size_t i = 0; i < ativos[c].size();)
+      {
+        if (ativos[c][i]->fim < atual.inicio)
+        {
+          ocupado[c][alocacao.registrador[ativos[c][i]->valor]] = false;
+          ativos[c][i] = ativos[c].back();
+          ativos[c].pop_back();
+        }
+        else
+        {
+          i++;
+        }
+      }
+    }
+    for (size_t i = 0; i < pilhaAtiva.size();)
+    {
+      if (pilhaAtiva[i].first < atual.inicio)
+      {
+        slotsLivres.push_back(pilhaAtiva[i]);
+        pilhaAtiva[i] = pilhaAtiva.back();
+        pilhaAtiva.pop_back();
+      }
+      else
+      {
+        i++;
+      }
+    }
+
+    int c = atual.classe == ClasseRegistrador::INTEIRO ? 0 : 1;
+    int numRegistradores = c == 0 ? NUM_REGISTRADORES_INTEIROS : NUM_REGISTRADORES_REAIS;
+    // Intervalos que atravessam uma chamada só podem usar registradores
+    // preservados por ela (não há nenhum SSE preservado)
+    int primeiro = !atual.cruzaChamada ? 0 : c == 0 ? PRIMEIRO_PRESERVADO : numRegistradores;
+
+    int livre = -1;
+    for (int r = primeiro; r < numRegistradores && livre < 0; r++)
+    {
+      if (!ocupado[c][r])
+      {
+        livre = r;
+      }
+    }
+    if (livre >= 0)
+    {
+      alocacao.registrador[atual.valor] = livre;
+      ocupado[c][livre] = true;
+      ativos[c].push_back(&atual);
+      continue;
+    }
+
+    // Sem registrador livre: vai para a pilha quem tiver o menor custo por
+    // unidade de comprimento (no modo rápido, quem terminar mais tarde)
+    int vitima = -1;
+    for (size_t i = 0; i < ativos[c].size(); i++)
+    {
+      const Intervalo *candidato = ativos[c][i];
+      if (alocacao.registrador[candidato->valor] < primeiro)
+      {
+        continue;
+      }
+      bool melhor = vitima < 0 || (modoRapido ? candidato->fim > ativos[c][vitima]->fim : peso(*candidato) < peso(*ativos[c][vitima]));
+      if (melhor)
+      {
+        vitima = i;
+      }
+    }
+    bool trocar = vitima >= 0 && (modoRapido ? ativos[c][vitima]->fim > atual.fim : peso(*ativos[c][vitima]) < peso(atual));
+    if (trocar)
+    {
+      const Intervalo *anterior = ativos[c][vitima];
+      alocacao.registrador[atual.valor] = alocacao.registrador[anterior->valor];
+      alocacao.registrador[anterior->valor] = -1;
+      paraPilha(*anterior);
+      ativos[c][vitima] = &atual;
+    }
+    else
+    {
+      paraPilha(atual);
+    }
+  }
+
+  for (const Intervalo &intervalo : intervalos)
+  {
+    if (alocacao.registrador[intervalo.valor] >= 0)
+    {
+      alocacao.emRegistrador++;
+    }
+    else
+    {
+      alocacao.naPilha++;
+    }
+  }
+}
+
+int contarConflitos(const FuncaoIR &funcao, const Alocacao &alocacao)
+{
+  AnaliseDeVivacidade vivacidade(funcao);
+  vivacidade.executar();
+  int conflitos = 0;
+  // Mesmo registrador da mesma classe, ou mesmo slot na pilha (de qualquer classe)
+  auto interferem = [&](uint32_t a, uint32_t b)
+  {
+    if (a == b)
+      return false;
+    if (alocacao.slotDePilha[a] >= 0 && alocacao.slotDePilha[a] == alocacao.slotDePilha[b])
+      return true;
+    return alocacao.registrador[a] >= 0 && alocacao.registrador[a] == alocacao.registrador[b] &&
+           classeDoTipo(funcao.instrucoes[a].tipo) == classeDoTipo(funcao.instrucoes[b].tipo);
+  };
+
+  // Dois valores interferem se um está vivo na definição do outro
+  for (int b : alocacao.ordemDosBlocos)
+  {
+    const BlocoIR &bloco = funcao.blocos[b];
+    BitSet vivas = vivacidade.getVivasNaSaida(b);
+    for (size_t i = bloco.instrucoes.size(); i-- > 0;)
+    {
+      uint32_t id = bloco.instrucoes[i];
+      const InstrucaoIR &ins = funcao.instrucoes[id];
+      if (ins.tipo != TipoDeDado::VOID)
+      {
+        vivas.paraCada([&](size_t v)
+                       { conflitos += interferem(id, v); });
+        vivas.desativar(id);
+      }
+      if (ins.op == OpIR::PHI)
+      {
+        continue;
+      }
+      for (uint32_t k = 0; k < ins.numOperandos; k++)
+      {
+        vivas.ativar(funcao.operando(id, k));
+      }
+    }
+  }
+  return conflitos;
+}
+
+string formatarAlocacao(const FuncaoIR &funcao, const Alocacao &alocacao)
+{
+  stringstream ss;
+  int porLinha = 0;
+  for (int b : alocacao.ordemDosBlocos)
+  {
+    for (uint32_t id : funcao.blocos[b].instrucoes)
+    {
+      const InstrucaoIR &ins = funcao.instrucoes[id];
+      if (ins.tipo == TipoDeDado::VOID)
+      {
+        continue;
+      }
+      ss << "  %" << id << ": ";
+      if (alocacao.registrador[id] >= 0)
+      {
+        ss << nomeDoRegistrador(classeDoTipo(ins.tipo), alocacao.registrador[id]);
+      }
+      else
+      {
+        ss << "[pilha " << alocacao.slotDePilha[id] << "]";
+      }
+      if (++porLinha == 8)
+      {
+        ss << endl;
+        porLinha = 0;
+      }
+    }
+  }
+  if (porLinha != 0)
+  {
+    ss << endl;
+  }
+  return ss.str();
+}
@@ -0,0 +1,248 @@
+#include "Resolver.h"
+#include "Builtins.h"
+#include <stdexcept>
+
+using namespace std;
+
+Resolver::Resolver() : proximoSlot(0), numGlobais(0)
+{
+}
+
+void Resolver::erro(const string &msg)
+{
+  throw runtime_error("Erro semantico: " + msg);
+}
+
+void Resolver::analisar(ProgramNode *program)
+{
+  simbolos.clear();
+  escopos.clear();
+  funcoes.clear();
+  numGlobais = 0;
+
+  // Registra todas as funções antes de resolver os corpos, permitindo
+  // chamadas recursivas e chamadas a funções definidas mais adiante
+  const vector<FunctionNode *> &functions = program->getFunctions();
+  for (size_t i = 0; i < functions.size(); i++)
+  {
+    if (functions[i]->isGlobalWrapper())
+    {
+      continue;
+    }
+    if (funcoes.count(functions[i]->getName()))
+    {
+      erro("funcao '" + functions[i]->getName() + "' ja declarada");
+    }
+    funcoes[functions[i]->getName()] = i;
+  }
+
+  abrirEscopo(); // escopo global (profundidade 0)
+  for (auto function : functions)
+  {
+    resolverFuncao(function);
+  }
+  fecharEscopo();
+
+  program->setGlobalCount(numGlobais);
+}
+
+void Resolver::abrirEscopo()
+{
+  escopos.push_back(vector<string>());
+}
+
+void Resolver::fecharEscopo()
+{
+  for (const string &name : escopos.back())
+  {
+    vector<Simbolo> &pilha = simbolos[name];
+    pilha.pop_back();
+    if (pilha.empty())
+    {
+      simbolos.erase(name);
+    }
+  }
+  escopos.pop_back();
+}
+
+Binding Resolver::declarar(const string &name)
+{
+  int depth = escopos.size() - 1;
+  auto it = simbolos.find(name);
+  if (it != simbolos.end() && it->second.back().depth == depth)
+  {
+    erro("variavel '" + name + "' ja declarada neste escopo");
+  }
+
+  Simbolo simbolo;
+  simbolo.depth = depth;
+  simbolo.slot = depth == 0 ? numGlobais++ : proximoSlot++;
+  simbolos[name].push_back(simbolo);
+  escopos.back().push_back(name);
+  return Binding(simbolo.depth, simbolo.slot);
+}
+
+Binding Resolver::buscar(const string &name)
+{
+  auto it = simbolos.find(name);
+  if (it == simbolos.end())
+  {
+    erro("variavel '" + name + "' nao declarada");
+  }
+  const Simbolo &simbolo = it->second.back();
+  return Binding(simbolo.depth, simbolo.slot);
+}
+
+void Resolver::resolverFuncao(FunctionNode *function)
+{
+  proximoSlot = 0;
+
+  if (function->isGlobalWrapper())
+  {
+    // As declarações de nível de programa ficam no escopo global
+    resolverStatements(function->getBody());
+  }
+  else
+  {
+    // Parâmetros e o bloco principal compartilham o mesmo escopo, como em C
+    abrirEscopo();
+    for (auto param : function->getParams())
+    {
+      param->setBinding(declarar(param->getName()));
+    }
+    resolverStatements(function->getBody());
+    fecharEscopo();
+  }
+
+  function->setFrameSize(proximoSlot);
+}
+
+void Resolver::resolverBloco(BlockNode *block)
+{
+  abrirEscopo();
+  resolverStatements(block);
+  fecharEscopo();
+}
+
+void Resolver::resolverStatements(BlockNode *block)
+{
+  for (auto stmt : block->getStatements())
+  {
+    resolverStatement(stmt);
+  }
+}
+
+void Resolver::resolverStatement(StatementNode *stmt)
+{
+  if (auto decl = dynamic_cast<VariableDeclarationNode *>(stmt))
+  {
+    // O inicializador é resolvido antes da declaração: em "int x = x;" o
+    // "x" da direita se refere a um nome externo
+    if (decl->getInitialValue())
+    {
+      resolverExpressao(decl->getInitialValue());
+    }
+    decl->setBinding(declarar(decl->getName()));
+  }
+  else if (auto assign = dynamic_cast<AssignmentNode *>(stmt))
+  {
+    resolverExpressao(assign->getValue());
+    if (assign->getIndex())
+    {
+      resolverExpressao(assign->getIndex());
+    }
+    assign->setBinding(buscar(assign->getName()));
+  }
+  else if (auto block = dynamic_cast<BlockNode *>(stmt))
+  {
+    resolverBloco(block);
+  }
+  else if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+  {
+    resolverExpressao(ifStmt->getCondition());
+    resolverBloco(ifStmt->getThenBlock());
+    if (ifStmt->getElseBlock())
+    {
+      resolverBloco(ifStmt->getElseBlock());
+    }
+  }
+  else if (auto whileStmt = dynamic_cast<WhileStatementNode *>(stmt))
+  {
+    resolverExpressao(whileStmt->getCondition());
+    resolverBloco(whileStmt->getBody());
+  }
+  else if (auto forStmt = dynamic_cast<ForStatementNode *>(stmt))
+  {
+    // A inicialização do for abre um escopo próprio que envolve o corpo
+    abrirEscopo();
+    if (forStmt->getInit())
+    {
+      resolverStatement(forStmt->getInit());
+    }
+    if (forStmt->getCondition())
+    {
+      resolverExpressao(forStmt->getCondition());
+    }
+    if (forStmt->getUpdate())
+    {
+      resolverExpressao(forStmt->getUpdate());
+    }
+    resolverBloco(forStmt->getBody());
+    fecharEscopo();
+  }
+  else if (auto ret = dynamic_cast<ReturnStatementNode *>(stmt))
+  {
+    if (ret->getValue())
+    {
+      resolverExpressao(ret->getValue());
+    }
+  }
+  else if (auto exprStmt = dynamic_cast<ExpressionStatementNode *>(stmt))
+  {
+    resolverExpressao(exprStmt->getExpression());
+  }
+}
+
+void Resolver::resolverExpressao(ExpressionNode *expr)
+{
+  if (auto ident = dynamic_cast<IdentifierNode *>(expr))
+  {
+    ident->setBinding(buscar(ident->getName()));
+  }
+  else if (auto access = dynamic_cast<ArrayAccessNode *>(expr))
+  {
+    resolverExpressao(access->getIndex());
+    access->setBinding(buscar(access->getName()));
+  }
+  else if (auto unary = dynamic_cast<UnaryOpNode *>(expr))
+  {
+    resolverExpressao(unary->getOperand());
+  }
+  else if (auto binary = dynamic_cast<BinaryOpNode *>(expr))
+  {
+    resolverExpressao(binary->getLeft());
+    resolverExpressao(binary->getRight());
+  }
+  else if (auto call = dynamic_cast<FunctionCallNode *>(expr))
+  {
+    // Funções do programa têm precedência sobre as embutidas de mesmo nome
+    auto it = funcoes.find(call->getName());
+    if (it != funcoes.end())
+    {
+      call->setFunctionIndex(it->second);
+    }
+    else
+    {
+      int builtin = buscarBuiltin(call->getName());
+      if (builtin < 0)
+      {
+        erro("funcao '" + call->getName() + "' nao declarada");
+      }
+      call->setBuiltinIndex(builtin);
+    }
+    for (auto arg : call->getArgs())
+    {
+      resolverExpressao(arg);
+    }
+  }
+}
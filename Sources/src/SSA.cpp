@@ -0,0 +1,333 @@
+#include "SSA.h"
+#include <algorithm>
+
+using namespace std;
+
+void calcularDominadores(FuncaoIR &funcao)
+{
+  vector<BlocoIR> &blocos = funcao.blocos;
+  vector<int> rpo = funcao.ordemReversaPosOrdem();
+  vector<int> posicao(blocos.size(), -1);
+  for (size_t i = 0; i < rpo.size(); i++)
+  {
+    posicao[rpo[i]] = i;
+  }
+
+  vector<int> idom(blocos.size(), -1);
+  idom[0] = 0;
+  bool mudou = true;
+  while (mudou)
+  {
+    mudou = false;
+    for (size_t i = 1; i < rpo.size(); i++)
+    {
+      int b = rpo[i];
+      int novo = -1;
+      for (int p : blocos[b].predecessores)
+      {
+        if (idom[p] < 0)
+        {
+          continue; // predecessor ainda não processado
+        }
+        if (novo < 0)
+        {
+          novo = p;
+          continue;
+        }
+        // Interseção: sobe pelos dominadores até os dois caminhos se encontrarem
+        int a = p, c = novo;
+        while (a != c)
+        {
+          while (posicao[a] > posicao[c])
+            a = idom[a];
+          while (posicao[c] > posicao[a])
+            c = idom[c];
+        }
+        novo = a;
+      }
+      if (idom[b] != novo)
+      {
+        idom[b] = novo;
+        mudou = true;
+      }
+    }
+  }
+
+  for (auto &bloco : blocos)
+  {
+    bloco.filhosDominancia.clear();
+  }
+  for (size_t b = 0; b < blocos.size(); b++)
+  {
+    blocos[b].idom = b == 0 ? -1 : idom[b];
+    if (b != 0 && idom[b] >= 0)
+    {
+      blocos[idom[b]].filhosDominancia.push_back(b);
+    }
+  }
+}
+
+bool domina(const FuncaoIR &funcao, int a, int b)
+{
+  while (b >= 0 && b != a)
+  {
+    b = funcao.blocos[b].idom;
+  }
+  return b == a;
+}
+
+vector<vector<int>> calcularFronteirasDeDominancia(const FuncaoIR &funcao)
+{
+  const vector<BlocoIR> &blocos = funcao.blocos;
+  vector<vector<int>> fronteiras(blocos.size());
+  for (size_t b = 0; b < blocos.size(); b++)
+  {
+    if (blocos[b].predecessores.size() < 2)
+    {
+      continue;
+    }
+    for (int p : blocos[b].predecessores)
+    {
+      int corredor = p;
+      while (corredor >= 0 && corredor != blocos[b].idom)
+      {
+        vector<int> &fronteira = fronteiras[corredor];
+        if (fronteira.empty() || fronteira.back() != int(b))
+        {
+          fronteira.push_back(b);
+        }
+        corredor = blocos[corredor].idom;
+      }
+    }
+  }
+  return fronteiras;
+}
+
+namespace
+{
+  const uint32_t SEM_VALOR = UINT32_MAX;
+
+  // Estado da renomeação de slots para valores SSA
+  struct Renomeador
+  {
+    FuncaoIR &funcao;
+    vector<int> slotDoPhi;               // por instrução: slot do PHI inserido (-1 se não é)
+    vector<vector<uint32_t>> pilhas;     // por slot: valor atual no topo
+    vector<uint32_t> indefinidos;        // por slot: instrução INDEFINIDO (criada sob demanda)
+    vector<uint32_t> substituto;         // por instrução: valor que substitui um LOAD_LOCAL
+
+    Renomeador(FuncaoIR &f)
+        : funcao(f), slotDoPhi(f.instrucoes.size(), -1), pilhas(f.tiposSlots.size()),
+          indefinidos(f.tiposSlots.size(), SEM_VALOR), substituto(f.instrucoes.size(), SEM_VALOR)
+    {
+    }
+
+    uint32_t valorAtual(int slot)
+    {
+      if (!pilhas[slot].empty())
+      {
+        return pilhas[slot].back();
+      }
+      if (indefinidos[slot] == SEM_VALOR)
+      {
+        // Lido antes de qualquer atribuição: o valor é definido na entrada
+        indefinidos[slot] = funcao.criarInstrucao(OpIR::INDEFINIDO, funcao.tiposSlots[slot], 0, nullptr, 0);
+        vector<uint32_t> &entrada = funcao.blocos[0].instrucoes;
+        entrada.insert(entrada.begin(), indefinidos[slot]);
+        substituto.push_back(SEM_VALOR);
+        slotDoPhi.push_back(-1);
+      }
+      return indefinidos[slot];
+    }
+
+    void renomearBloco(int b, vector<int> &empilhados)
+    {
+      // Cópia: INDEFINIDOs podem ser inseridos na entrada durante a iteração
+      vector<uint32_t> instrucoes = funcao.blocos[b].instrucoes;
+      for (uint32_t id : instrucoes)
+      {
+        InstrucaoIR &ins = funcao.instrucoes[id];
+        if (ins.op == OpIR::PHI)
+        {
+          if (slotDoPhi[id] >= 0)
+          {
+            pilhas[slotDoPhi[id]].push_back(id);
+            empilhados.push_back(slotDoPhi[id]);
+          }
+          continue;
+        }
+
+        for (uint32_t i = 0; i < ins.numOperandos; i++)
+        {
+          uint32_t operando = funcao.operando(id, i);
+          if (substituto[operando] != SEM_VALOR)
+          {
+            funcao.setOperando(id, i, substituto[operando]);
+          }
+        }
+
+        // valorAtual pode crescer a arena, invalidando a referência "ins"
+        OpIR op = ins.op;
+        int slot = ins.imediato;
+        if (op == OpIR::LOAD_LOCAL)
+        {
+          uint32_t valor = valorAtual(slot);
+          substituto[id] = valor;
+          funcao.instrucoes[id].op = OpIR::REMOVIDA;
+        }
+        else if (op == OpIR::STORE_LOCAL)
+        {
+          pilhas[slot].push_back(funcao.operando(id, 0));
+          empilhados.push_back(slot);
+          funcao.instrucoes[id].op = OpIR::REMOVIDA;
+        }
+      }
+
+      // Preenche os operandos dos PHIs dos sucessores vindos deste bloco
+      for (int s : funcao.blocos[b].sucessores)
+      {
+        const vector<int> &preds = funcao.blocos[s].predecessores;
+        uint32_t j = find(preds.begin(), preds.end(), b) - preds.begin();
+        for (uint32_t id : funcao.blocos[s].instrucoes)
+        {
+          if (funcao.instrucoes[id].op != OpIR::PHI)
+          {
+            break;
+          }
+          if (slotDoPhi[id] >= 0)
+          {
+            uint32_t valor = valorAtual(slotDoPhi[id]);
+            funcao.setOperando(id, j, valor);
+          }
+        }
+      }
+    }
+
+    void renomear()
+    {
+      // Percurso em pré-ordem da árvore de dominância com pilha explícita,
+      // para suportar funções com aninhamento muito profundo
+      struct Quadro
+      {
+        int bloco;
+        size_t proximoFilho;
+        vector<int> empilhados;
+      };
+      vector<Quadro> pilha;
+      pilha.push_back(Quadro{0, 0, vector<int>()});
+      renomearBloco(0, pilha.back().empilhados);
+
+      while (!pilha.empty())
+      {
+        Quadro &topo = pilha.back();
+        const vector<int> &filhos = funcao.blocos[topo.bloco].filhosDominancia;
+        if (topo.proximoFilho < filhos.size())
+        {
+          int filho = filhos[topo.proximoFilho++];
+          pilha.push_back(Quadro{filho, 0, vector<int>()});
+          renomearBloco(filho, pilha.back().empilhados);
+        }
+        else
+        {
+          for (int slot : topo.empilhados)
+          {
+            pilhas[slot].pop_back();
+          }
+          pilha.pop_back();
+        }
+      }
+    }
+  };
+}
+
+void converterParaSSA(FuncaoIR &funcao)
+{
+  calcularDominadores(funcao);
+  vector<vector<int>> fronteiras = calcularFronteirasDeDominancia(funcao);
+
+  size_t numSlots = funcao.tiposSlots.size();
+  size_t numBlocos = funcao.blocos.size();
+
+  // Blocos que atribuem cada slot e slots lidos antes de serem atribuídos
+  // no mesmo bloco (os únicos que precisam de PHI)
+  vector<vector<int>> blocosComDefinicao(numSlots);
+  vector<bool> vivoEntreBlocos(numSlots, false);
+  vector<int> definidoNoBloco(numSlots, -1);
+  for (size_t b = 0; b < numBlocos; b++)
+  {
+    for (uint32_t id : funcao.blocos[b].instrucoes)
+    {
+      const InstrucaoIR &ins = funcao.instrucoes[id];
+      if (ins.op == OpIR::LOAD_LOCAL && definidoNoBloco[ins.imediato] != int(b))
+      {
+        vivoEntreBlocos[ins.imediato] = true;
+      }
+      else if (ins.op == OpIR::STORE_LOCAL && definidoNoBloco[ins.imediato] != int(b))
+      {
+        definidoNoBloco[ins.imediato] = b;
+        blocosComDefinicao[ins.imediato].push_back(b);
+      }
+    }
+  }
+
+  // Inserção de PHIs na fronteira de dominância iterada
+  vector<pair<uint32_t, int>> phisInseridos;
+  vector<int> temPhi(numBlocos, -1);
+  vector<int> naLista(numBlocos, -1);
+  for (size_t slot = 0; slot < numSlots; slot++)
+  {
+    if (!vivoEntreBlocos[slot])
+    {
+      continue;
+    }
+    vector<int> lista = blocosComDefinicao[slot];
+    for (int b : lista)
+    {
+      naLista[b] = slot;
+    }
+    while (!lista.empty())
+    {
+      int b = lista.back();
+      lista.pop_back();
+      for (int f : fronteiras[b])
+      {
+        if (temPhi[f] == int(slot))
+        {
+          continue;
+        }
+        temPhi[f] = slot;
+        uint32_t phi = funcao.criarInstrucao(OpIR::PHI, funcao.tiposSlots[slot], f, nullptr,
+                                             funcao.blocos[f].predecessores.size());
+        funcao.blocos[f].instrucoes.insert(funcao.blocos[f].instrucoes.begin(), phi);
+        phisInseridos.push_back(make_pair(phi, slot));
+        if (naLista[f] != int(slot))
+        {
+          naLista[f] = slot;
+          lista.push_back(f);
+        }
+      }
+    }
+  }
+
+  Renomeador renomeador(funcao);
+  for (auto &phi : phisInseridos)
+  {
+    renomeador.slotDoPhi[phi.first] = phi.second;
+  }
+  renomeador.renomear();
+
+  // Retira dos blocos os LOAD_LOCAL/STORE_LOCAL eliminados
+  for (auto &bloco : funcao.blocos)
+  {
+    vector<uint32_t> vivas;
+    for (uint32_t id : bloco.instrucoes)
+    {
+      if (funcao.instrucoes[id].op != OpIR::REMOVIDA)
+      {
+        vivas.push_back(id);
+      }
+    }
+    bloco.instrucoes.swap(vivas);
+  }
+  funcao.emSSA = true;
+}
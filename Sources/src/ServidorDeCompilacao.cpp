@@ -0,0 +1,356 @@
+#include "ServidorDeCompilacao.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace
+{
+  const size_t LIMITE_DO_CABECALHO = 64;
+  const size_t LIMITE_DO_CODIGO = 64 << 20;
+  // Dígitos que sempre cabem num unsigned long long
+  const size_t LIMITE_DE_DIGITOS = 19;
+  const int TEMPO_DE_ESPERA = 30000;
+  // Limites padrão de RUN; o quadro de cada chamada na VM ocupa menos de
+  // 1 KB da pilha de 8 MB de uma thread
+  const int LIMITE_DE_PROFUNDIDADE = 2000;
+  const uint64_t LIMITE_DE_DESPACHOS = 1000000000;
+
+  [[noreturn]] void erroDoSistema(const string &operacao)
+  {
+    throw runtime_error("Erro no servidor: " + operacao + ": " + strerror(errno));
+  }
+
+  sockaddr_un endereco(const string &caminho)
+  {
+    sockaddr_un endereco;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    if (caminho.size() >= sizeof(endereco.sun_path))
+    {
+      throw runtime_error("Erro no servidor: caminho do socket muito longo: " + caminho);
+    }
+    memcpy(endereco.sun_path, caminho.c_str(), caminho.size() + 1);
+    return endereco;
+  }
+
+  // Lê do socket para "buffer" até haver pelo menos "n" bytes; false se a
+  // conexão terminou antes
+  bool receber(int descritor, string &buffer, size_t n)
+  {
+    char bloco[4096];
+    while (buffer.size() < n)
+    {
+      ssize_t lidos = recv(descritor, bloco, sizeof(bloco), 0);
+      if (lidos < 0 && errno == EINTR)
+        continue;
+      if (lidos <= 0)
+        return false;
+      buffer.append(bloco, lidos);
+    }
+    return true;
+  }
+
+  // Lê "<palavra> <tamanho>\n" e os <tamanho> bytes seguintes. Um
+  // cabeçalho inválido fica no buffer, para que quem chama saiba que a
+  // requisição era malformada
+  bool lerMensagem(int descritor, string &buffer, string &palavra, string &conteudo)
+  {
+    size_t fim;
+    while ((fim = buffer.find('\n')) == string::npos)
+    {
+      if (buffer.size() > LIMITE_DO_CABECALHO || !receber(descritor, buffer, buffer.size() + 1))
+        return false;
+    }
+    string cabecalho = buffer.substr(0, fim);
+    size_t espaco = cabecalho.find(' ');
+    if (espaco == string::npos || espaco + 1 == cabecalho.size() || cabecalho.size() - espaco - 1 > LIMITE_DE_DIGITOS ||
+        cabecalho.find_first_not_of("0123456789", espaco + 1) != string::npos)
+      return false;
+    unsigned long long tamanho = stoull(cabecalho.substr(espaco + 1));
+    if (tamanho > LIMITE_DO_CODIGO)
+      return false;
+    palavra = cabecalho.substr(0, espaco);
+    buffer.erase(0, fim + 1);
+    if (!receber(descritor, buffer, tamanho))
+      return false;
+    conteudo = buffer.substr(0, tamanho);
+    buffer.erase(0, tamanho);
+    return true;
+  }
+
+  bool enviarMensagem(int descritor, const string &palavra, const string &conteudo)
+  {
+    string mensagem = palavra + " " + to_string(conteudo.size()) + "\n" + conteudo;
+    size_t enviados = 0;
+    while (enviados < mensagem.size())
+    {
+      // MSG_NOSIGNAL: um cliente que fechou a conexão não gera SIGPIPE
+      ssize_t n = send(descritor, mensagem.data() + enviados, mensagem.size() - enviados, MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return false;
+      enviados += n;
+    }
+    return true;
+  }
+}
+
+ServidorDeCompilacao::ServidorDeCompilacao(const string &caminho, int numThreads, const OpcoesDoCompilador &opcoes)
+    : caminho(caminho), numThreads(numThreads), opcoes(opcoes), tempoDeEspera(TEMPO_DE_ESPERA), descritor(-1),
+      ativo(false), requisicoes(0), acertosDoCache(0), conexoes(0)
+{
+  if (this->opcoes.limiteDeProfundidade <= 0)
+    this->opcoes.limiteDeProfundidade = LIMITE_DE_PROFUNDIDADE;
+  if (this->opcoes.limiteDeDespachos == 0)
+    this->opcoes.limiteDeDespachos = LIMITE_DE_DESPACHOS;
+}
+
+ServidorDeCompilacao::~ServidorDeCompilacao()
+{
+  parar();
+}
+
+void ServidorDeCompilacao::iniciar()
+{
+  sockaddr_un local = endereco(caminho);
+  descritor = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (descritor < 0)
+  {
+    erroDoSistema("socket");
+  }
+  unlink(caminho.c_str());
+  if (bind(descritor, reinterpret_cast<sockaddr *>(&local), sizeof(local)) < 0 || listen(descritor, 128) < 0)
+  {
+    int erro = errno;
+    close(descritor);
+    descritor = -1;
+    errno = erro;
+    erroDoSistema("bind/listen em " + caminho);
+  }
+
+  ativo = true;
+  for (int t = 0; t < numThreads; t++)
+  {
+    trabalhadores.push_back(thread(&ServidorDeCompilacao::trabalhar, this));
+  }
+  aceitacao = thread(&ServidorDeCompilacao::aceitar, this);
+}
+
+void ServidorDeCompilacao::parar()
+{
+  if (!ativo.exchange(false))
+  {
+    return;
+  }
+  // No Linux, shutdown num socket em escuta acorda o accept bloqueado
+  shutdown(descritor, SHUT_RDWR);
+  aceitacao.join();
+  close(descritor);
+  descritor = -1;
+  {
+    lock_guard<mutex> guarda(trava);
+    for (int cliente : abertas)
+    {
+      shutdown(cliente, SHUT_RDWR);
+    }
+    for (int cliente : pendentes)
+    {
+      close(cliente);
+    }
+    pendentes.clear();
+  }
+  haConexoes.notify_all();
+  for (thread &trabalhador : trabalhadores)
+  {
+    trabalhador.join();
+  }
+  trabalhadores.clear();
+  unlink(caminho.c_str());
+}
+
+void ServidorDeCompilacao::aceitar()
+{
+  while (ativo)
+  {
+    int cliente = accept(descritor, nullptr, nullptr);
+    if (cliente < 0)
+    {
+      if (!ativo)
+        break;
+      if (errno != EINTR)
+        this_thread::sleep_for(chrono::milliseconds(10)); // sem descritores livres, por exemplo
+      continue;
+    }
+    conexoes++;
+    // Um cliente parado libera a thread quando o tempo se esgota (recv e
+    // send falham com EAGAIN)
+    timeval tempo;
+    tempo.tv_sec = tempoDeEspera / 1000;
+    tempo.tv_usec = (tempoDeEspera % 1000) * 1000;
+    setsockopt(cliente, SOL_SOCKET, SO_RCVTIMEO, &tempo, sizeof(tempo));
+    setsockopt(cliente, SOL_SOCKET, SO_SNDTIMEO, &tempo, sizeof(tempo));
+    lock_guard<mutex> guarda(trava);
+    if (!ativo)
+    {
+      close(cliente);
+      break;
+    }
+    pendentes.push_back(cliente);
+    haConexoes.notify_one();
+  }
+}
+
+void ServidorDeCompilacao::trabalhar()
+{
+  // O contexto e o seu cache duram tanto quanto a thread
+  Compilador compilador(opcoes);
+  while (true)
+  {
+    int cliente;
+    {
+      unique_lock<mutex> guarda(trava);
+      haConexoes.wait(guarda, [this]()
+                      { return !pendentes.empty() || !ativo; });
+      if (pendentes.empty())
+      {
+        return;
+      }
+      cliente = pendentes.front();
+      pendentes.pop_front();
+      abertas.insert(cliente);
+    }
+    atender(cliente, compilador);
+    {
+      lock_guard<mutex> guarda(trava);
+      abertas.erase(cliente);
+    }
+    close(cliente);
+  }
+}
+
+void ServidorDeCompilacao::atender(int cliente, Compilador &compilador)
+{
+  string buffer;
+  string comando;
+  string codigo;
+  while (true)
+  {
+    errno = 0;
+    if (!lerMensagem(cliente, buffer, comando, codigo))
+      break;
+    requisicoes++;
+    string corpo;
+    bool ok = responder(comando, codigo, compilador, corpo);
+    if (!enviarMensagem(cliente, ok ? "OK" : "ERRO", corpo))
+    {
+      return;
+    }
+  }
+  // Fim da conexão, tempo esgotado ou requisição malformada (o cliente já
+  // não está em sincronia); só uma requisição pela metade recebe resposta
+  if (!buffer.empty())
+  {
+    bool esgotado = errno == EAGAIN || errno == EWOULDBLOCK;
+    enviarMensagem(cliente, "ERRO", esgotado ? "Erro no servidor: tempo de espera esgotado" : "Erro no servidor: requisicao malformada");
+  }
+}
+
+bool ServidorDeCompilacao::responder(const string &comando, const string &codigo, Compilador &compilador, string &corpo)
+{
+  if (comando == "STATS")
+  {
+    corpo = "requisicoes " + to_string(requisicoes) + "\n" +
+            "conexoes " + to_string(conexoes) + "\n" +
+            "acertos do cache " + to_string(acertosDoCache) + "\n" +
+            "threads " + to_string(numThreads) + "\n";
+    return true;
+  }
+  if (comando != "CHECK" && comando != "COMPILE" && comando != "RUN")
+  {
+    corpo = "Erro no servidor: comando desconhecido '" + comando + "'";
+    return false;
+  }
+  if (comando == "RUN" && opcoes.motor != Motor::VM)
+  {
+    corpo = "Erro no servidor: RUN so executa na VM, que limita chamadas e instrucoes";
+    return false;
+  }
+  try
+  {
+    int acertos = compilador.getAcertosDoCache();
+    compilador.compilar(codigo);
+    acertosDoCache += compilador.getAcertosDoCache() - acertos;
+    if (comando == "COMPILE")
+    {
+      corpo = compilador.getBytecode();
+    }
+    else if (comando == "RUN")
+    {
+      Valor resultado = compilador.executar();
+      corpo = resultado.toString() + "\n" + compilador.getSaida();
+    }
+    return true;
+  }
+  catch (exception &e)
+  {
+    corpo = e.what();
+    return false;
+  }
+}
+
+ClienteDeCompilacao::ClienteDeCompilacao() : descritor(-1)
+{
+}
+
+ClienteDeCompilacao::~ClienteDeCompilacao()
+{
+  desconectar();
+}
+
+void ClienteDeCompilacao::conectar(const string &caminho)
+{
+  desconectar();
+  sockaddr_un remoto = endereco(caminho);
+  descritor = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (descritor < 0)
+  {
+    erroDoSistema("socket");
+  }
+  if (connect(descritor, reinterpret_cast<sockaddr *>(&remoto), sizeof(remoto)) < 0)
+  {
+    int erro = errno;
+    desconectar();
+    errno = erro;
+    erroDoSistema("connect em " + caminho);
+  }
+}
+
+string ClienteDeCompilacao::requisitar(const string &comando, const string &codigo, bool &ok)
+{
+  string palavra;
+  string resposta;
+  if (descritor < 0 || !enviarMensagem(descritor, comando, codigo) || !lerMensagem(descritor, buffer, palavra, resposta))
+  {
+    throw runtime_error("Erro no servidor: conexao encerrada");
+  }
+  ok = palavra == "OK";
+  return resposta;
+}
+
+void ClienteDeCompilacao::desconectar()
+{
+  if (descritor >= 0)
+  {
+    close(descritor);
+    descritor = -1;
+  }
+  buffer.clear();
+}
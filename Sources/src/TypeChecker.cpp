@@ -0,0 +1,434 @@
+#include "TypeChecker.h"
+#include "Builtins.h"
+#include <stdexcept>
+
+using namespace std;
+
+TypeChecker::TypeChecker() : programa(nullptr), tipoRetorno(TipoDeDado::VOID)
+{
+}
+
+void TypeChecker::erro(const string &msg)
+{
+  throw runtime_error("Erro de tipo: " + msg);
+}
+
+void TypeChecker::analisar(ProgramNode *program)
+{
+  programa = program;
+  tiposGlobais.assign(program->getGlobalCount(), TipoDeDado::INDEFINIDO);
+
+  for (auto function : program->getFunctions())
+  {
+    verificarFuncao(function);
+  }
+
+  program->setGlobalTypes(tiposGlobais);
+}
+
+TipoDeDado TypeChecker::tipoDeclarado(const string &nome)
+{
+  TipoDeDado tipo = tipoDeDadoDeString(nome);
+  if (tipo == TipoDeDado::INDEFINIDO)
+  {
+    erro("tipo desconhecido '" + nome + "'");
+  }
+  return tipo;
+}
+
+void TypeChecker::registrarVariavel(Binding binding, TipoDeDado tipo)
+{
+  if (binding.isGlobal())
+  {
+    tiposGlobais[binding.slot] = tipo;
+  }
+  else
+  {
+    tiposLocais[binding.slot] = tipo;
+  }
+}
+
+TipoDeDado TypeChecker::tipoDaVariavel(Binding binding)
+{
+  if (!binding.isResolved())
+  {
+    erro("nome nao resolvido (execute o Resolver antes do TypeChecker)");
+  }
+  return binding.isGlobal() ? tiposGlobais[binding.slot] : tiposLocais[binding.slot];
+}
+
+TipoDeDado TypeChecker::tipoDoArray(const string &nome, Binding binding)
+{
+  TipoDeDado tipo = tipoDaVariavel(binding);
+  if (!isArray(tipo))
+  {
+    erro("variavel '" + nome + "' nao e um array");
+  }
+  return tipoDoElemento(tipo);
+}
+
+ExpressionNode *TypeChecker::verificarIndice(ExpressionNode *index)
+{
+  index = verificarExpressao(index);
+  if (index->getTipo() != TipoDeDado::INT)
+  {
+    erro("indice de array deve ser int, encontrado " + tipoDeDadoParaString(index->getTipo()));
+  }
+  return index;
+}
+
+bool TypeChecker::isLvalue(ExpressionNode *expr)
+{
+  return dynamic_cast<IdentifierNode *>(expr) || dynamic_cast<ArrayAccessNode *>(expr);
+}
+
+ExpressionNode *TypeChecker::converter(ExpressionNode *expr, TipoDeDado destino)
+{
+  TipoDeDado origem = expr->getTipo();
+  if (origem == destino)
+  {
+    return expr;
+  }
+  if (origem == TipoDeDado::INT && destino == TipoDeDado::DOUBLE)
+  {
+    return new ConversionNode(expr, TipoDeDado::DOUBLE);
+  }
+  erro("nao e possivel converter " + tipoDeDadoParaString(origem) + " para " + tipoDeDadoParaString(destino));
+  return nullptr;
+}
+
+void TypeChecker::verificarFuncao(FunctionNode *function)
+{
+  tiposLocais.assign(function->getFrameSize(), TipoDeDado::INDEFINIDO);
+  tipoRetorno = tipoDeDadoDeString(function->getReturnType());
+
+  for (auto param : function->getParams())
+  {
+    registrarVariavel(param->getBinding(), tipoDeclarado(param->getType()));
+  }
+  verificarBloco(function->getBody());
+
+  function->setSlotTypes(tiposLocais);
+}
+
+void TypeChecker::verificarBloco(BlockNode *block)
+{
+  for (auto stmt : block->getStatements())
+  {
+    verificarStatement(stmt);
+  }
+}
+
+void TypeChecker::verificarStatement(StatementNode *stmt)
+{
+  if (auto decl = dynamic_cast<VariableDeclarationNode *>(stmt))
+  {
+    TipoDeDado tipo = tipoDeclarado(decl->getType());
+    if (decl->isArray())
+    {
+      if (tipoDeArray(tipo) == TipoDeDado::INDEFINIDO)
+      {
+        erro("arrays de " + tipoDeDadoParaString(tipo) + " nao sao suportados");
+      }
+      if (decl->getArraySize() == 0 || decl->getArraySize() > UINT32_MAX)
+      {
+        erro("tamanho invalido para o array '" + decl->getName() + "'");
+      }
+      if (decl->getInitialValue())
+      {
+        erro("array '" + decl->getName() + "' nao pode ter inicializador");
+      }
+      tipo = tipoDeArray(tipo);
+    }
+    if (decl->getInitialValue())
+    {
+      decl->setInitialValue(converter(verificarExpressao(decl->getInitialValue()), tipo));
+    }
+    registrarVariavel(decl->getBinding(), tipo);
+  }
+  else if (auto assign = dynamic_cast<AssignmentNode *>(stmt))
+  {
+    TipoDeDado tipo = tipoDaVariavel(assign->getBinding());
+    if (assign->getIndex())
+    {
+      tipo = tipoDoArray(assign->getName(), assign->getBinding());
+      assign->setIndex(verificarIndice(assign->getIndex()));
+    }
+    else if (isArray(tipo))
+    {
+      erro("atribuicao ao array '" + assign->getName() + "' exige um indice");
+    }
+    assign->setValue(converter(verificarExpressao(assign->getValue()), tipo));
+  }
+  else if (auto block = dynamic_cast<BlockNode *>(stmt))
+  {
+    verificarBloco(block);
+  }
+  else if (auto ifStmt = dynamic_cast<IfStatementNode *>(stmt))
+  {
+    ifStmt->setCondition(verificarCondicao(ifStmt->getCondition()));
+    verificarBloco(ifStmt->getThenBlock());
+    if (ifStmt->getElseBlock())
+    {
+      verificarBloco(ifStmt->getElseBlock());
+    }
+  }
+  else if (auto whileStmt = dynamic_cast<WhileStatementNode *>(stmt))
+  {
+    whileStmt->setCondition(verificarCondicao(whileStmt->getCondition()));
+    verificarBloco(whileStmt->getBody());
+  }
+  else if (auto forStmt = dynamic_cast<ForStatementNode *>(stmt))
+  {
+    if (forStmt->getInit())
+    {
+      verificarStatement(forStmt->getInit());
+    }
+    if (forStmt->getCondition())
+    {
+      forStmt->setCondition(verificarCondicao(forStmt->getCondition()));
+    }
+    if (forStmt->getUpdate())
+    {
+      forStmt->setUpdate(verificarExpressao(forStmt->getUpdate()));
+    }
+    verificarBloco(forStmt->getBody());
+  }
+  else if (auto ret = dynamic_cast<ReturnStatementNode *>(stmt))
+  {
+    if (ret->getValue())
+    {
+      if (tipoRetorno == TipoDeDado::VOID)
+      {
+        erro("return com valor em funcao void");
+      }
+      ret->setValue(converter(verificarExpressao(ret->getValue()), tipoRetorno));
+    }
+    else if (tipoRetorno != TipoDeDado::VOID)
+    {
+      erro("return sem valor em funcao " + tipoDeDadoParaString(tipoRetorno));
+    }
+  }
+  else if (auto exprStmt = dynamic_cast<ExpressionStatementNode *>(stmt))
+  {
+    exprStmt->setExpression(verificarExpressao(exprStmt->getExpression()));
+  }
+}
+
+ExpressionNode *TypeChecker::verificarCondicao(ExpressionNode *expr)
+{
+  expr = verificarExpressao(expr);
+  if (expr->getTipo() == TipoDeDado::INT)
+  {
+    return expr;
+  }
+  if (expr->getTipo() == TipoDeDado::DOUBLE)
+  {
+    BinaryOpNode *teste = new BinaryOpNode(expr, "!=", new RealLiteralNode(0.0));
+    teste->setTipo(TipoDeDado::INT);
+    return teste;
+  }
+  erro("condicao deve ser numerica, encontrado " + tipoDeDadoParaString(expr->getTipo()));
+  return nullptr;
+}
+
+ExpressionNode *TypeChecker::verificarExpressao(ExpressionNode *expr)
+{
+  if (dynamic_cast<LiteralNode *>(expr))
+  {
+    // O tipo do literal é definido pelo parser a partir do token
+  }
+  else if (auto ident = dynamic_cast<IdentifierNode *>(expr))
+  {
+    TipoDeDado tipo = tipoDaVariavel(ident->getBinding());
+    if (isArray(tipo))
+    {
+      erro("array '" + ident->getName() + "' usado sem indice");
+    }
+    ident->setTipo(tipo);
+  }
+  else if (auto access = dynamic_cast<ArrayAccessNode *>(expr))
+  {
+    access->setTipo(tipoDoArray(access->getName(), access->getBinding()));
+    access->setIndex(verificarIndice(access->getIndex()));
+  }
+  else if (auto unary = dynamic_cast<UnaryOpNode *>(expr))
+  {
+    if (unary->getOp() == "!")
+    {
+      unary->setOperand(verificarCondicao(unary->getOperand()));
+      unary->setTipo(TipoDeDado::INT);
+    }
+    else
+    {
+      // "++" e "--" exigem uma variável numérica
+      if (!isLvalue(unary->getOperand()))
+      {
+        erro("operando de '" + unary->getOp() + "' deve ser uma variavel");
+      }
+      if (dynamic_cast<ArrayAccessNode *>(unary->getOperand()))
+      {
+        erro("operador '" + unary->getOp() + "' nao suportado para elementos de array");
+      }
+      ExpressionNode *operand = verificarExpressao(unary->getOperand());
+      if (!isNumerico(operand->getTipo()))
+      {
+        erro("operador '" + unary->getOp() + "' invalido para " + tipoDeDadoParaString(operand->getTipo()));
+      }
+      unary->setTipo(operand->getTipo());
+    }
+  }
+  else if (auto binary = dynamic_cast<BinaryOpNode *>(expr))
+  {
+    return verificarBinaria(binary);
+  }
+  else if (auto conversion = dynamic_cast<ConversionNode *>(expr))
+  {
+    conversion->setOperand(verificarExpressao(conversion->getOperand()));
+  }
+  else if (auto call = dynamic_cast<FunctionCallNode *>(expr))
+  {
+    if (call->isBuiltin())
+    {
+      verificarChamadaEmbutida(call);
+      return expr;
+    }
+    FunctionNode *callee = programa->getFunctions()[call->getFunctionIndex()];
+    const vector<ParameterNode *> &params = callee->getParams();
+    if (params.size() != call->getArgs().size())
+    {
+      erro("funcao '" + call->getName() + "' espera " + to_string(params.size()) +
+           " argumento(s), recebeu " + to_string(call->getArgs().size()));
+    }
+    for (size_t i = 0; i < params.size(); i++)
+    {
+      ExpressionNode *arg = verificarExpressao(call->getArgs()[i]);
+      call->setArg(i, converter(arg, tipoDeclarado(params[i]->getType())));
+    }
+    call->setTipo(tipoDeDadoDeString(callee->getReturnType()));
+  }
+  return expr;
+}
+
+void TypeChecker::verificarChamadaEmbutida(FunctionCallNode *call)
+{
+  vector<TipoDeDado> tipos;
+  for (size_t i = 0; i < call->getArgs().size(); i++)
+  {
+    call->setArg(i, verificarExpressao(call->getArgs()[i]));
+    tipos.push_back(call->getArgs()[i]->getTipo());
+  }
+
+  // Entre as versões com o número certo de parâmetros, a que recebe
+  // exatamente esses tipos, ou senão a primeira que os aceita com
+  // conversões int -> double
+  int escolhida = -1;
+  bool exata = false;
+  bool numeroCerto = false;
+  for (int b = call->getBuiltinIndex(); b < NUM_BUILTINS && call->getName() == BUILTINS[b].nome && !exata; b++)
+  {
+    const Builtin &builtin = BUILTINS[b];
+    if (size_t(builtin.numParametros) != tipos.size())
+    {
+      continue;
+    }
+    numeroCerto = true;
+    bool aceita = true;
+    exata = true;
+    for (size_t i = 0; i < tipos.size(); i++)
+    {
+      exata = exata && tipos[i] == builtin.parametros[i];
+      aceita = aceita && (tipos[i] == builtin.parametros[i] ||
+                          (tipos[i] == TipoDeDado::INT && builtin.parametros[i] == TipoDeDado::DOUBLE));
+    }
+    if (exata || (aceita && escolhida < 0))
+    {
+      escolhida = b;
+    }
+  }
+  if (escolhida < 0)
+  {
+    string recebidos;
+    for (size_t i = 0; i < tipos.size(); i++)
+    {
+      recebidos += (i ? ", " : "") + tipoDeDadoParaString(tipos[i]);
+    }
+    if (!numeroCerto)
+    {
+      erro("funcao embutida '" + call->getName() + "' espera " + to_string(BUILTINS[call->getBuiltinIndex()].numParametros) +
+           " argumento(s), recebeu " + to_string(tipos.size()));
+    }
+    erro("funcao embutida '" + call->getName() + "' nao aceita argumentos (" + recebidos + ")");
+  }
+
+  const Builtin &builtin = BUILTINS[escolhida];
+  for (size_t i = 0; i < tipos.size(); i++)
+  {
+    call->setArg(i, converter(call->getArgs()[i], builtin.parametros[i]));
+  }
+  call->setBuiltinIndex(escolhida);
+  call->setTipo(builtin.tipoRetorno);
+}
+
+ExpressionNode *TypeChecker::verificarBinaria(BinaryOpNode *binary)
+{
+  const string &op = binary->getOp();
+
+  if (op == "&&" || op == "||")
+  {
+    binary->setLeft(verificarCondicao(binary->getLeft()));
+    binary->setRight(verificarCondicao(binary->getRight()));
+    binary->setTipo(TipoDeDado::INT);
+    return binary;
+  }
+
+  if (op == "=")
+  {
+    // Atribuição usada como expressão (update do for)
+    if (!isLvalue(binary->getLeft()))
+    {
+      erro("lado esquerdo de '=' deve ser uma variavel");
+    }
+    ExpressionNode *left = verificarExpressao(binary->getLeft());
+    binary->setRight(converter(verificarExpressao(binary->getRight()), left->getTipo()));
+    binary->setTipo(left->getTipo());
+    return binary;
+  }
+
+  binary->setLeft(verificarExpressao(binary->getLeft()));
+  binary->setRight(verificarExpressao(binary->getRight()));
+  TipoDeDado esquerda = binary->getLeft()->getTipo();
+  TipoDeDado direita = binary->getRight()->getTipo();
+
+  bool relacional = op == "<" || op == ">" || op == "<=" || op == ">=" || op == "==" || op == "!=";
+
+  if (isNumerico(esquerda) && isNumerico(direita))
+  {
+    // Promoção numérica: se um dos lados é double, o outro é convertido
+    TipoDeDado comum = (esquerda == TipoDeDado::DOUBLE || direita == TipoDeDado::DOUBLE)
+                           ? TipoDeDado::DOUBLE
+                           : TipoDeDado::INT;
+    binary->setLeft(converter(binary->getLeft(), comum));
+    binary->setRight(converter(binary->getRight(), comum));
+    binary->setTipo(relacional ? TipoDeDado::INT : comum);
+    return binary;
+  }
+
+  if (esquerda == TipoDeDado::STRING && direita == TipoDeDado::STRING)
+  {
+    if (relacional)
+    {
+      binary->setTipo(TipoDeDado::INT);
+      return binary;
+    }
+    if (op == "+")
+    {
+      binary->setTipo(TipoDeDado::STRING);
+      return binary;
+    }
+  }
+
+  erro("operador '" + op + "' invalido para " + tipoDeDadoParaString(esquerda) +
+       " e " + tipoDeDadoParaString(direita));
+  return nullptr;
+}
@@ -0,0 +1,399 @@
+#include "VM.h"
+#include "Builtins.h"
+#include <stdexcept>
+
+using namespace std;
+
+VM::VM(const ProgramaBC *programa)
+    : programa(nullptr), perfilar(false), despachos(0), profundidade(0), limiteDeProfundidade(INT32_MAX),
+      limiteDeDespachos(0), fimDosDespachos(UINT64_MAX)
+{
+  pilha.reserve(1024);
+  carregar(programa);
+}
+
+void VM::carregar(const ProgramaBC *programa)
+{
+  this->programa = programa;
+  globais.clear();
+  for (TipoDeDado tipo : programa->tiposGlobais)
+  {
+    globais.push_back(Valor::padrao(tipo));
+  }
+  pilha.clear();
+}
+
+Valor VM::executar()
+{
+  for (size_t i = 0; i < programa->funcoes.size(); i++)
+  {
+    if (programa->funcoes[i].isGlobalWrapper)
+    {
+      chamar(i, vector<Valor>());
+    }
+  }
+  return programa->principal >= 0 ? chamar(programa->principal, vector<Valor>()) : Valor();
+}
+
+void VM::setLimites(int profundidade, uint64_t despachos)
+{
+  limiteDeProfundidade = profundidade > 0 ? profundidade : INT32_MAX;
+  limiteDeDespachos = despachos;
+}
+
+Valor VM::chamar(int indice, const vector<Valor> &argumentos)
+{
+  size_t base = pilha.size();
+  int profundidadeInicial = profundidade;
+  if (profundidade == 0)
+  {
+    fimDosDespachos = limiteDeDespachos ? despachos + limiteDeDespachos : UINT64_MAX;
+  }
+  pilha.insert(pilha.end(), argumentos.begin(), argumentos.end());
+  try
+  {
+    return executarFuncao(indice, base);
+  }
+  catch (exception &)
+  {
+    // Erros de execução abandonam todos os quadros da chamada
+    pilha.resize(base);
+    profundidade = profundidadeInicial;
+    throw;
+  }
+}
+
+Valor VM::executarFuncao(int indice, size_t base)
+{
+  const FuncaoBC &funcao = programa->funcoes[indice];
+  if (++profundidade > limiteDeProfundidade)
+  {
+    throw runtime_error("Erro de execucao: mais de " + to_string(limiteDeProfundidade) + " chamadas aninhadas");
+  }
+  for (size_t s = funcao.numParametros; s < funcao.tiposSlots.size(); s++)
+  {
+    pilha.push_back(Valor::padrao(funcao.tiposSlots[s]));
+  }
+  const InstrucaoBC *codigo = funcao.codigo.data();
+  const Valor *constantes = funcao.constantes.data();
+  size_t pc = 0;
+  OpBC anterior = OpBC::NUM_OPS;
+
+  // Operações sobre o topo da pilha
+  auto topo = [&]() -> Valor & { return pilha.back(); };
+  auto desempilhar = [&]() -> Valor
+  {
+    Valor valor = std::move(pilha.back());
+    pilha.pop_back();
+    return valor;
+  };
+  auto inteiros = [&](int64_t &a, int64_t &b)
+  {
+    b = pilha.back().inteiro;
+    pilha.pop_back();
+    a = pilha.back().inteiro;
+  };
+  auto reais = [&](double &a, double &b)
+  {
+    b = pilha.back().real;
+    pilha.pop_back();
+    a = pilha.back().real;
+  };
+  auto textos = [&]() -> int
+  {
+    Valor b = desempilhar();
+    int comparacao = pilha.back().compararTexto(b);
+    return comparacao;
+  };
+  auto compararInteiros = [](OpBC op, int64_t a, int64_t b) -> bool
+  {
+    switch (op)
+    {
+    case OpBC::LT_INT:
+      return a < b;
+    case OpBC::GT_INT:
+      return a > b;
+    case OpBC::LE_INT:
+      return a <= b;
+    case OpBC::GE_INT:
+      return a >= b;
+    case OpBC::EQ_INT:
+      return a == b;
+    default:
+      return a != b;
+    }
+  };
+
+  for (;;)
+  {
+    const InstrucaoBC &ins = codigo[pc++];
+    if (++despachos > fimDosDespachos)
+    {
+      throw runtime_error("Erro de execucao: limite de " + to_string(limiteDeDespachos) + " instrucoes executadas excedido");
+    }
+    if (perfilar)
+    {
+      if (anterior != OpBC::NUM_OPS)
+      {
+        perfil.registrar(anterior, ins.op);
+      }
+      anterior = ins.op;
+    }
+    int64_t a, b;
+    double x, y;
+    switch (ins.op)
+    {
+    case OpBC::CONST:
+      pilha.push_back(constantes[ins.a]);
+      break;
+    case OpBC::LOAD_LOCAL:
+      pilha.push_back(pilha[base + ins.a]);
+      break;
+    case OpBC::STORE_LOCAL:
+      pilha[base + ins.a] = desempilhar();
+      break;
+    case OpBC::LOAD_GLOBAL:
+      pilha.push_back(globais[ins.a]);
+      break;
+    case OpBC::STORE_GLOBAL:
+      globais[ins.a] = desempilhar();
+      break;
+    case OpBC::POP:
+      pilha.pop_back();
+      break;
+    case OpBC::DUP:
+      pilha.push_back(topo());
+      break;
+
+    // Aritmética inteira com volta no estouro, como no ConstantFolder
+    case OpBC::ADD_INT:
+      inteiros(a, b);
+      topo().inteiro = int64_t(uint64_t(a) + uint64_t(b));
+      break;
+    case OpBC::SUB_INT:
+      inteiros(a, b);
+      topo().inteiro = int64_t(uint64_t(a) - uint64_t(b));
+      break;
+    case OpBC::MUL_INT:
+      inteiros(a, b);
+      topo().inteiro = int64_t(uint64_t(a) * uint64_t(b));
+      break;
+    case OpBC::DIV_INT:
+      inteiros(a, b);
+      if (b == 0)
+      {
+        throw runtime_error("Erro de execucao: divisao por zero");
+      }
+      topo().inteiro = b == -1 ? int64_t(0 - uint64_t(a)) : a / b;
+      break;
+    case OpBC::ADD_REAL:
+      reais(x, y);
+      topo().real = x + y;
+      break;
+    case OpBC::SUB_REAL:
+      reais(x, y);
+      topo().real = x - y;
+      break;
+    case OpBC::MUL_REAL:
+      reais(x, y);
+      topo().real = x * y;
+      break;
+    case OpBC::DIV_REAL:
+      reais(x, y);
+      topo().real = x / y;
+      break;
+    case OpBC::CONCAT:
+    {
+      Valor direito = desempilhar();
+      topo().concatenar(direito);
+      break;
+    }
+
+    case OpBC::LT_INT:
+    case OpBC::GT_INT:
+    case OpBC::LE_INT:
+    case OpBC::GE_INT:
+    case OpBC::EQ_INT:
+    case OpBC::NE_INT:
+      inteiros(a, b);
+      topo().inteiro = compararInteiros(ins.op, a, b);
+      break;
+    case OpBC::LT_REAL:
+      reais(x, y);
+      topo() = Valor::deInteiro(x < y);
+      break;
+    case OpBC::GT_REAL:
+      reais(x, y);
+      topo() = Valor::deInteiro(x > y);
+      break;
+    case OpBC::LE_REAL:
+      reais(x, y);
+      topo() = Valor::deInteiro(x <= y);
+      break;
+    case OpBC::GE_REAL:
+      reais(x, y);
+      topo() = Valor::deInteiro(x >= y);
+      break;
+    case OpBC::EQ_REAL:
+      reais(x, y);
+      topo() = Valor::deInteiro(x == y);
+      break;
+    case OpBC::NE_REAL:
+      reais(x, y);
+      topo() = Valor::deInteiro(x != y);
+      break;
+    case OpBC::LT_STR:
+      a = textos();
+      topo() = Valor::deInteiro(a < 0);
+      break;
+    case OpBC::GT_STR:
+      a = textos();
+      topo() = Valor::deInteiro(a > 0);
+      break;
+    case OpBC::LE_STR:
+      a = textos();
+      topo() = Valor::deInteiro(a <= 0);
+      break;
+    case OpBC::GE_STR:
+      a = textos();
+      topo() = Valor::deInteiro(a >= 0);
+      break;
+    case OpBC::EQ_STR:
+      a = textos();
+      topo() = Valor::deInteiro(a == 0);
+      break;
+    case OpBC::NE_STR:
+      a = textos();
+      topo() = Valor::deInteiro(a != 0);
+      break;
+    case OpBC::NOT:
+      topo().inteiro = !topo().inteiro;
+      break;
+    case OpBC::INT_TO_DOUBLE:
+      topo() = Valor::deReal(double(topo().inteiro));
+      break;
+
+    case OpBC::JUMP:
+      pc = ins.a;
+      break;
+    case OpBC::JUMP_IF_FALSE:
+      if (!desempilhar().inteiro)
+      {
+        pc = ins.a;
+      }
+      break;
+    case OpBC::JUMP_IF_TRUE:
+      if (desempilhar().inteiro)
+      {
+        pc = ins.a;
+      }
+      break;
+    case OpBC::CALL:
+    {
+      Valor resultado = executarFuncao(ins.a, pilha.size() - ins.b);
+      pilha.push_back(resultado);
+      break;
+    }
+    case OpBC::CALL_BUILTIN:
+    {
+      // Os argumentos são lidos no próprio topo da pilha
+      size_t inicio = pilha.size() - ins.b;
+      Valor resultado = BUILTINS[ins.a].implementacao(&pilha[inicio]);
+      pilha.resize(inicio);
+      pilha.push_back(std::move(resultado));
+      break;
+    }
+    case OpBC::RETURN:
+    {
+      Valor resultado = desempilhar();
+      pilha.resize(base);
+      profundidade--;
+      return resultado;
+    }
+    case OpBC::RETURN_VOID:
+      pilha.resize(base);
+      profundidade--;
+      return Valor();
+
+    // Arrays: o elemento é lido ou escrito diretamente nos dados contíguos
+    case OpBC::NEW_ARRAY:
+      pilha.push_back(Valor::novoArray(TipoDeDado(ins.b), uint32_t(ins.a)));
+      break;
+    case OpBC::LOAD_ELEM:
+    {
+      const Valor &array = ins.b ? globais[ins.a] : pilha[base + ins.a];
+      array.verificarIndice(topo().inteiro);
+      topo() = array.elemento(topo().inteiro);
+      break;
+    }
+    case OpBC::LOAD_ELEM_NC:
+    {
+      const Valor &array = ins.b ? globais[ins.a] : pilha[base + ins.a];
+      topo() = array.elemento(topo().inteiro);
+      break;
+    }
+    case OpBC::STORE_ELEM:
+    {
+      Valor &array = ins.b ? globais[ins.a] : pilha[base + ins.a];
+      a = pilha.back().inteiro;
+      pilha.pop_back();
+      array.verificarIndice(a);
+      array.atribuirElemento(a, topo());
+      pilha.pop_back();
+      break;
+    }
+    case OpBC::STORE_ELEM_NC:
+    {
+      Valor &array = ins.b ? globais[ins.a] : pilha[base + ins.a];
+      a = pilha.back().inteiro;
+      pilha.pop_back();
+      array.atribuirElemento(a, topo());
+      pilha.pop_back();
+      break;
+    }
+
+    // Superinstruções
+    case OpBC::LOAD_LOCAL_2:
+      pilha.push_back(pilha[base + ins.a]);
+      pilha.push_back(pilha[base + ins.b]);
+      break;
+    case OpBC::LOAD_LOCAL_CONST:
+      pilha.push_back(pilha[base + ins.a]);
+      pilha.push_back(constantes[ins.b]);
+      break;
+    case OpBC::ADD_INT_LL:
+      pilha.push_back(Valor::deInteiro(int64_t(uint64_t(pilha[base + ins.a].inteiro) + uint64_t(pilha[base + ins.b].inteiro))));
+      break;
+    case OpBC::INC_LOCAL:
+    {
+      Valor &local = pilha[base + ins.a];
+      local.inteiro = int64_t(uint64_t(local.inteiro) + uint64_t(int64_t(ins.b)));
+      break;
+    }
+    case OpBC::JUMP_IF_NOT_CMP:
+      inteiros(a, b);
+      pilha.pop_back();
+      if (!compararInteiros(OpBC(ins.b), a, b))
+      {
+        pc = ins.a;
+      }
+      break;
+    case OpBC::LOAD_ELEM_L:
+    {
+      const Valor &array = pilha[base + ins.a];
+      a = pilha[base + ins.b].inteiro;
+      array.verificarIndice(a);
+      pilha.push_back(array.elemento(a));
+      break;
+    }
+    case OpBC::LOAD_ELEM_L_NC:
+    {
+      const Valor &array = pilha[base + ins.a];
+      pilha.push_back(array.elemento(pilha[base + ins.b].inteiro));
+      break;
+    }
+    default:
+      throw runtime_error("Erro de execucao: operacao de bytecode invalida");
+    }
+  }
+}
@@ -0,0 +1,135 @@
+#include "Valor.h"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+static_assert(sizeof(Valor) == 16, "Valor deve ocupar uma palavra e a etiqueta");
+
+atomic<long long> Valor::textosCriados(0);
+atomic<long long> Valor::textosVivos(0);
+
+TextoCompartilhado *Valor::novoTexto(size_t capacidade)
+{
+  TextoCompartilhado *texto = new TextoCompartilhado{1, string()};
+  texto->conteudo.reserve(capacidade);
+  textosCriados++;
+  textosVivos++;
+  return texto;
+}
+
+Valor Valor::deTexto(const string &v)
+{
+  Valor valor;
+  valor.tipo = TipoDeDado::STRING;
+  valor.comprimento = v.size();
+  if (v.size() <= CAPACIDADE_CURTA)
+  {
+    memcpy(valor.curto, v.data(), v.size());
+  }
+  else
+  {
+    valor.compartilhado = novoTexto(v.size());
+    valor.compartilhado->conteudo = v;
+  }
+  return valor;
+}
+
+Valor Valor::padrao(TipoDeDado tipo)
+{
+  if (tipo == TipoDeDado::DOUBLE)
+  {
+    return deReal(0.0);
+  }
+  if (tipo == TipoDeDado::STRING)
+  {
+    Valor vazio;
+    vazio.tipo = TipoDeDado::STRING;
+    return vazio;
+  }
+  return deInteiro(0);
+}
+
+Valor Valor::novoArray(TipoDeDado tipo, uint32_t tamanho)
+{
+  Valor valor;
+  valor.tipo = tipo;
+  valor.comprimento = tamanho;
+  valor.arranjo = new ArranjoCompartilhado{1, vector<Elemento>(tamanho, Elemento{0})};
+  return valor;
+}
+
+void Valor::indiceForaDosLimites(int64_t indice) const
+{
+  throw runtime_error("Erro de execucao: indice " + to_string(indice) + " fora dos limites do array de tamanho " +
+                      to_string(comprimento));
+}
+
+int Valor::compararTexto(const Valor &outro) const
+{
+  int comparacao = memcmp(dados(), outro.dados(), min(comprimento, outro.comprimento));
+  if (comparacao != 0)
+  {
+    return comparacao;
+  }
+  return comprimento < outro.comprimento ? -1 : comprimento > outro.comprimento ? 1 : 0;
+}
+
+void Valor::concatenar(const Valor &outro)
+{
+  uint32_t total = comprimento + outro.comprimento;
+  if (total <= CAPACIDADE_CURTA)
+  {
+    memcpy(curto + comprimento, outro.dados(), outro.comprimento);
+    comprimento = total;
+    return;
+  }
+  if (isTextoLongo() && compartilhado->conteudo.size() == comprimento)
+  {
+    // O std::string dobra a capacidade ao crescer; "outro" pode apontar
+    // para este mesmo buffer, o que append trata
+    compartilhado->conteudo.append(outro.dados(), outro.comprimento);
+    comprimento = total;
+    return;
+  }
+  TextoCompartilhado *novo = novoTexto(total);
+  novo->conteudo.append(dados(), comprimento);
+  novo->conteudo.append(outro.dados(), outro.comprimento);
+  liberar();
+  compartilhado = novo;
+  comprimento = total;
+}
+
+string Valor::toString() const
+{
+  switch (tipo)
+  {
+  case TipoDeDado::INT:
+    return to_string(inteiro);
+  case TipoDeDado::DOUBLE:
+  {
+    ostringstream ss;
+    ss << real;
+    return ss.str();
+  }
+  case TipoDeDado::STRING:
+    return texto();
+  case TipoDeDado::ARRAY_INT:
+  case TipoDeDado::ARRAY_DOUBLE:
+    return tipoDeDadoParaString(tipoDoElemento(tipo)) + "[" + to_string(comprimento) + "]";
+  default:
+    return "void";
+  }
+}
+
+const Valor &TabelaDeLiterais::internar(const string &texto)
+{
+  auto it = literais.find(texto);
+  if (it == literais.end())
+  {
+    it = literais.insert(make_pair(texto, Valor::deTexto(texto))).first;
+  }
+  return it->second;
+}